@@ -17,4 +17,13 @@ uint32_t read_mode_lr(int cpu_mode);
 
 void wait_cycles(unsigned long cycles);
 
+/*
+ * Hint to the core that we're busy waiting. WFE isn't used as nothing
+ * guarantees an event when the awaited state changes.
+ */
+static inline __noprof void cpu_relax(void)
+{
+	asm volatile ("yield" : : : "memory");
+}
+
 #endif /*__KERNEL_MISC_ARCH_H*/
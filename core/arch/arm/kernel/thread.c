@@ -24,6 +24,7 @@
 #include <kernel/tee_ta_manager.h>
 #include <kernel/thread.h>
 #include <kernel/thread_private.h>
+#include <kernel/trace_ext.h>
 #include <kernel/user_access.h>
 #include <kernel/user_mode_ctx_struct.h>
 #include <kernel/virtualization.h>
@@ -222,24 +223,15 @@ static void __thread_alloc_and_run(uint32_t a0, uint32_t a1, uint32_t a2,
 				   void *pc, uint32_t flags)
 {
 	struct thread_core_local *l = thread_get_core_local();
-	bool found_thread = false;
-	size_t n = 0;
+	int n = 0;
 
 	assert(l->curr_thread == THREAD_ID_INVALID);
 
 	thread_lock_global();
-
-	for (n = 0; n < CFG_NUM_THREADS; n++) {
-		if (threads[n].state == THREAD_STATE_FREE) {
-			threads[n].state = THREAD_STATE_ACTIVE;
-			found_thread = true;
-			break;
-		}
-	}
-
+	n = thread_claim_free();
 	thread_unlock_global();
 
-	if (!found_thread)
+	if (n == THREAD_ID_INVALID)
 		return;
 
 	l->curr_thread = n;
@@ -452,6 +444,9 @@ void thread_state_free(void)
 
 	assert(ct != THREAD_ID_INVALID);
 
+	/* Pending trace lines are written before returning to normal world */
+	trace_ext_drain();
+
 	thread_lazy_restore_ns_vfp();
 	tee_pager_release_phys(
 		(void *)(threads[ct].stack_va_end - STACK_THREAD_SIZE),
@@ -459,8 +454,7 @@ void thread_state_free(void)
 
 	thread_lock_global();
 
-	assert(threads[ct].state == THREAD_STATE_ACTIVE);
-	threads[ct].state = THREAD_STATE_FREE;
+	thread_set_free(ct);
 	threads[ct].flags = 0;
 	l->curr_thread = THREAD_ID_INVALID;
 
@@ -6,9 +6,16 @@
 #ifndef __KERNEL_MISC_ARCH_H
 #define __KERNEL_MISC_ARCH_H
 
+#include <riscv.h>
 #include <stdint.h>
 
 /* Bootable hart ID table */
 extern uint32_t hartids[CFG_TEE_CORE_NB_CORE];
 
+/* Hint to the hart that we're busy waiting */
+static inline __noprof void cpu_relax(void)
+{
+	riscv_cpu_pause();
+}
+
 #endif /*__KERNEL_MISC_ARCH_H*/
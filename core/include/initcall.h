@@ -6,19 +6,20 @@
 #ifndef __INITCALL_H
 #define __INITCALL_H
 
+#include <compiler.h>
 #include <scattered_array.h>
 #include <tee_api_types.h>
 #include <trace.h>
 
 struct initcall {
 	TEE_Result (*func)(void);
-#if TRACE_LEVEL >= TRACE_DEBUG
+#if TRACE_LEVEL >= TRACE_DEBUG || defined(CFG_CORE_INITCALL_PROF)
 	int level;
 	const char *func_name;
 #endif
 };
 
-#if TRACE_LEVEL >= TRACE_DEBUG
+#if TRACE_LEVEL >= TRACE_DEBUG || defined(CFG_CORE_INITCALL_PROF)
 #define __define_initcall(type, lvl, fn) \
 	SCATTERED_ARRAY_DEFINE_PG_ITEM_ORDERED(type ## call, lvl, \
 					       struct initcall) = \
@@ -139,6 +140,77 @@ struct initcall {
 
 #define boot_final(fn)			__define_initcall(final, 8, fn)
 
+/*
+ * Boot time profiling of initcalls and DT driver probes, enabled with
+ * CFG_CORE_INITCALL_PROF
+ */
+enum initcall_prof_phase {
+	INITCALL_PROF_PREINIT,
+	INITCALL_PROF_EARLY_INIT,
+	INITCALL_PROF_SERVICE_INIT,
+	INITCALL_PROF_DRIVER_INIT,
+	INITCALL_PROF_FINAL,
+	INITCALL_PROF_DT_PROBE,
+};
+
+/*
+ * struct initcall_prof_rec - Time spent in an initcall or a DT driver probe
+ * @name:	Name of the initcall function or of the DT driver
+ * @node:	Name of the probed DT node, possibly truncated, empty for
+ *		initcalls
+ * @phase:	Phase the initcall was called in or INITCALL_PROF_DT_PROBE
+ * @level:	Level of the initcall, 0 for DT driver probes
+ * @res:	Result returned
+ * @start:	Counter value when called
+ * @ticks:	Counter ticks spent until returned
+ */
+struct initcall_prof_rec {
+	const char *name;
+	char node[32];
+	enum initcall_prof_phase phase;
+	int level;
+	TEE_Result res;
+	uint64_t start;
+	uint64_t ticks;
+};
+
+#ifdef CFG_CORE_INITCALL_PROF
+/*
+ * Starts a record of @phase, returns an index to pass to
+ * initcall_prof_end() when done.
+ */
+size_t initcall_prof_begin(enum initcall_prof_phase phase, int level,
+			   const char *name, const char *node);
+void initcall_prof_end(size_t idx, TEE_Result res);
+
+/*
+ * Copies at most @max_recs records, in the order they were started, to
+ * @recs. Returns the number of records available.
+ */
+size_t initcall_prof_get_recs(struct initcall_prof_rec *recs,
+			      size_t max_recs);
+#else
+static inline size_t
+initcall_prof_begin(enum initcall_prof_phase phase __unused,
+		    int level __unused, const char *name __unused,
+		    const char *node __unused)
+{
+	return 0;
+}
+
+static inline void initcall_prof_end(size_t idx __unused,
+				     TEE_Result res __unused)
+{
+}
+
+static inline size_t
+initcall_prof_get_recs(struct initcall_prof_rec *recs __unused,
+		       size_t max_recs __unused)
+{
+	return 0;
+}
+#endif
+
 void call_preinitcalls(void);
 void call_early_initcalls(void);
 void call_service_initcalls(void);
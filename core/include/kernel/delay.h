@@ -42,6 +42,14 @@ static inline uint64_t delay_us2cnt(uint32_t us)
 	return ((uint64_t)us * (uint64_t)delay_cnt_freq()) / ULL(1000000);
 }
 
+/* Convert architecture time tick counts @cnt into microseconds */
+static inline uint64_t delay_cnt2us(uint64_t cnt)
+{
+	uint64_t freq = delay_cnt_freq();
+
+	return cnt / freq * ULL(1000000) + cnt % freq * ULL(1000000) / freq;
+}
+
 /* Return delay tick counter for a timeout expiration in @us microseconds */
 static inline uint64_t timeout_init_us(uint32_t us)
 {
@@ -0,0 +1,131 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+#ifndef __KERNEL_HASH_SET_H
+#define __KERNEL_HASH_SET_H
+
+#include <stdint.h>
+#include <sys/queue.h>
+#include <types_ext.h>
+
+/*
+ * A hash set keeps track of objects embedding a struct hash_set_elem,
+ * indexed by a 64-bit key. The key can be unique, like the address of the
+ * object or a cookie, or a hash of the identity of the object in which
+ * case several elements may have the same key and the caller compares
+ * the identity of the elements found.
+ *
+ * The set starts with a few buckets embedded in struct hash_set and grows
+ * on the heap as elements are added. Adding an element never fails, if
+ * growing the set fails the buckets are just more loaded. The set has no
+ * lock of its own, accesses are serialized by the caller.
+ */
+struct hash_set_elem {
+	SLIST_ENTRY(hash_set_elem) link;
+	uint64_t key;
+};
+
+SLIST_HEAD(hash_set_bucket, hash_set_elem);
+
+#define HASH_SET_INITIAL_BUCKETS	8
+
+/*
+ * Grow the number of buckets of a hash set when there's on average more
+ * than this number of elements per bucket.
+ */
+#define HASH_SET_MAX_LOAD		2
+
+/*
+ * Upper bound on the number of buckets. The hash in hash_set.c provides 16
+ * bits so it must not exceed 65536, the lower cap limits the memory used
+ * by a single set.
+ */
+#define HASH_SET_MAX_BUCKETS		4096
+
+struct hash_set {
+	struct hash_set_bucket *buckets;
+	size_t num_buckets;
+	size_t num_elems;
+	struct hash_set_bucket initial_buckets[HASH_SET_INITIAL_BUCKETS];
+};
+
+/* Static initializer of the hash set variable @set */
+#define HASH_SET_INITIALIZER(set) { \
+		.buckets = (set).initial_buckets, \
+		.num_buckets = HASH_SET_INITIAL_BUCKETS, \
+	}
+
+/* Initializes an empty hash set */
+void hash_set_init(struct hash_set *set);
+
+/*
+ * Frees the buckets allocated on the heap. The elements are not freed, the
+ * set must be empty and is ready for use again when this function returns.
+ */
+void hash_set_destroy(struct hash_set *set);
+
+/* Adds @elem with @key to the set, growing the set if needed */
+void hash_set_add(struct hash_set *set, struct hash_set_elem *elem,
+		  uint64_t key);
+
+/*
+ * Adds @elem with @key to the set without allocating anything, for callers
+ * holding a spinlock. Such callers grow the set with
+ * hash_set_grow_buckets() and hash_set_rehash() instead.
+ */
+void hash_set_add_no_grow(struct hash_set *set, struct hash_set_elem *elem,
+			  uint64_t key);
+
+/* Removes @elem from the set, @elem must be in the set */
+void hash_set_remove(struct hash_set *set, struct hash_set_elem *elem);
+
+/*
+ * Returns the number of buckets the set should grow to, or 0 if it's not
+ * crowded.
+ */
+size_t hash_set_grow_buckets(struct hash_set *set);
+
+/*
+ * Moves all elements to the @num_buckets zero initialized @buckets, which
+ * the set takes ownership of. Returns the previous buckets if they should
+ * be freed by the caller, or NULL.
+ */
+struct hash_set_bucket *hash_set_rehash(struct hash_set *set,
+					struct hash_set_bucket *buckets,
+					size_t num_buckets);
+
+/* Returns the first element with @key or NULL if not found */
+struct hash_set_elem *hash_set_first(struct hash_set *set, uint64_t key);
+
+/* Returns the element after @elem with the same key or NULL */
+struct hash_set_elem *hash_set_next(struct hash_set_elem *elem);
+
+#define HASH_SET_FOREACH_KEY(elem, set, key) \
+	for ((elem) = hash_set_first((set), (key)); (elem); \
+	     (elem) = hash_set_next((elem)))
+
+/* Returns an element of the set or NULL if the set is empty */
+struct hash_set_elem *hash_set_iter_first(struct hash_set *set);
+
+/*
+ * Returns the element after @elem when iterating over the whole set, in no
+ * particular order, or NULL
+ */
+struct hash_set_elem *hash_set_iter_next(struct hash_set *set,
+					 struct hash_set_elem *elem);
+
+/* Iterates over all elements, the set must not be modified meanwhile */
+#define HASH_SET_FOREACH(elem, set) \
+	for ((elem) = hash_set_iter_first((set)); (elem); \
+	     (elem) = hash_set_iter_next((set), (elem)))
+
+#define HASH_FNV1A_INIT		2166136261U
+
+/*
+ * Adds @len bytes at @data to the 32-bit FNV-1a hash @h, start with
+ * HASH_FNV1A_INIT. Used to compute keys from the identity of an object.
+ */
+uint32_t hash_fnv1a(uint32_t h, const void *data, size_t len);
+
+#endif /*__KERNEL_HASH_SET_H*/
@@ -0,0 +1,107 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+#ifndef __KERNEL_LOCK_PROF_H
+#define __KERNEL_LOCK_PROF_H
+
+#include <compiler.h>
+#include <kernel/thread.h>
+#include <stdbool.h>
+#include <types_ext.h>
+
+/*
+ * Lock contention profiler, enabled with CFG_CORE_LOCK_PROF
+ *
+ * Mutexes and spinlocks are accounted per lock site, that is, per source
+ * location where they are locked.
+ */
+
+#define LOCK_PROF_MAX_SITES	256
+
+#define LOCK_PROF_TYPE_MUTEX	0
+#define LOCK_PROF_TYPE_SPINLOCK	1
+
+struct mutex;
+
+/*
+ * struct lock_prof_site - Statistics of a lock site
+ * @fname:		Source file
+ * @lineno:		Source line
+ * @type:		LOCK_PROF_TYPE_*
+ * @acquired:		Number of times the lock was acquired
+ * @contended:		Number of times the lock had to be waited for
+ * @spin_acquired:	Contended mutex locks acquired by spinning, with
+ *			CFG_CORE_MUTEX_ADAPTIVE
+ * @sleeps:		Number of times a mutex was waited for in normal world
+ * @wait_ticks:		Total time spent waiting, in counter ticks
+ * @max_hold_ticks:	Longest time the lock was held, in counter ticks
+ */
+struct lock_prof_site {
+	const char *fname;
+	int lineno;
+	unsigned int type;
+	uint32_t acquired;
+	uint32_t contended;
+	uint32_t spin_acquired;
+	uint32_t sleeps;
+	uint64_t wait_ticks;
+	uint64_t max_hold_ticks;
+};
+
+#ifdef CFG_CORE_LOCK_PROF
+static inline uint64_t lock_prof_now(void)
+{
+	return barrier_read_counter_timer();
+}
+
+/*
+ * Records that @m was acquired at @fname:@lineno after trying since
+ * @start, called by the thread acquiring @m. @spun tells if @m was
+ * acquired after spinning and @sleeps is the number of times the thread
+ * waited in normal world for @m.
+ */
+void lock_prof_mutex_acquired(struct mutex *m, const char *fname, int lineno,
+			      bool contended, bool spun, unsigned int sleeps,
+			      uint64_t start);
+
+/* Records that @m was released, called by the thread releasing @m */
+void lock_prof_mutex_released(struct mutex *m);
+
+/*
+ * Copies the statistics of at most @max_sites lock sites to @sites.
+ * Returns the number of lock sites recorded, which may be larger than
+ * @max_sites. If all sites fit and @reset is true the statistics are
+ * reset.
+ */
+size_t lock_prof_get_sites(struct lock_prof_site *sites, size_t max_sites,
+			   bool reset);
+#else
+static inline uint64_t lock_prof_now(void)
+{
+	return 0;
+}
+
+static inline void lock_prof_mutex_acquired(struct mutex *m __unused,
+					    const char *fname __unused,
+					    int lineno __unused,
+					    bool contended __unused,
+					    bool spun __unused,
+					    unsigned int sleeps __unused,
+					    uint64_t start __unused)
+{
+}
+
+static inline void lock_prof_mutex_released(struct mutex *m __unused)
+{
+}
+
+static inline size_t lock_prof_get_sites(struct lock_prof_site *s __unused,
+					 size_t max_sites __unused,
+					 bool reset __unused)
+{
+	return 0;
+}
+#endif
+
+#endif /*__KERNEL_LOCK_PROF_H*/
@@ -14,6 +14,9 @@ struct mutex {
 	unsigned spin_lock;	/* used when operating on this struct */
 	struct wait_queue wq;
 	short state;		/* -1: write, 0: unlocked, > 0: readers */
+#ifdef CFG_CORE_MUTEX_ADAPTIVE
+	short owner;		/* thread holding the write lock */
+#endif
 };
 
 #define MUTEX_INITIALIZER { .wq = WAIT_QUEUE_INITIALIZER }
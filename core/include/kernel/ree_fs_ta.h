@@ -0,0 +1,60 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+#ifndef __KERNEL_REE_FS_TA_H
+#define __KERNEL_REE_FS_TA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CFG_REE_FS_TA_CACHE
+/*
+ * ree_fs_ta_cache_flush() - Release all TA binaries held by the cache
+ *
+ * Registered as a physical memory reclaimer, called when TA memory runs
+ * out. Binaries still in use are freed when closed.
+ *
+ * Returns true if any binary was released.
+ */
+bool ree_fs_ta_cache_flush(void);
+#else
+static inline bool ree_fs_ta_cache_flush(void)
+{
+	return false;
+}
+#endif
+
+/*
+ * struct ree_fs_ta_load_stats - Where the time loading REE FS TAs is spent
+ * @loads:		Binaries loaded from tee-supplicant
+ * @cache_hits:		Binaries served from the cache, CFG_REE_FS_TA_CACHE
+ * @bytes:		Bytes of binaries read
+ * @rpc_ticks:		Time loading binaries from tee-supplicant
+ * @verify_ticks:	Time checking signed headers
+ * @read_ticks:		Time decrypting or copying, and hashing binaries
+ *
+ * Times are in counter ticks.
+ */
+struct ree_fs_ta_load_stats {
+	size_t loads;
+	size_t cache_hits;
+	size_t bytes;
+	uint64_t rpc_ticks;
+	uint64_t verify_ticks;
+	uint64_t read_ticks;
+};
+
+#if defined(CFG_WITH_STATS) && defined(CFG_REE_FS_TA)
+/* Get the statistics accumulated since last call */
+void ree_fs_ta_get_load_stats(struct ree_fs_ta_load_stats *stats);
+#else
+static inline void
+ree_fs_ta_get_load_stats(struct ree_fs_ta_load_stats *stats)
+{
+	*stats = (struct ree_fs_ta_load_stats){ };
+}
+#endif
+
+#endif /*__KERNEL_REE_FS_TA_H*/
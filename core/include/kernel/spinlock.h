@@ -35,6 +35,15 @@ void __cpu_spin_unlock(unsigned int *lock);
 /* returns 0 on locking success, non zero on failure */
 unsigned int __cpu_spin_trylock(unsigned int *lock);
 
+#ifdef CFG_CORE_LOCK_PROF
+/* Spinlock hooks of the lock contention profiler, see <kernel/lock_prof.h> */
+void cpu_spin_lock_prof(const char *fname, int lineno, unsigned int *lock);
+bool cpu_spin_trylock_prof(const char *fname, int lineno, unsigned int *lock);
+void lock_prof_spin_released(unsigned int *lock);
+#else
+static inline void lock_prof_spin_released(unsigned int *lock __unused) { }
+#endif
+
 static inline void cpu_spin_lock_no_dldetect(unsigned int *lock)
 {
 	assert(thread_foreign_intr_disabled());
@@ -65,9 +74,6 @@ static inline void thread_spin_unlock(unsigned int *lock)
 }
 
 #ifdef CFG_TEE_CORE_DEBUG
-#define cpu_spin_lock(lock) \
-	cpu_spin_lock_dldetect(__func__, __LINE__, lock)
-
 static inline void cpu_spin_lock_dldetect(const char *func, const int line,
 					  unsigned int *lock)
 {
@@ -90,6 +96,14 @@ static inline void cpu_spin_lock_dldetect(const char *func, const int line,
 
 	spinlock_count_incr();
 }
+#endif
+
+#if defined(CFG_CORE_LOCK_PROF)
+#define cpu_spin_lock(lock) \
+	cpu_spin_lock_prof(__FILE__, __LINE__, (lock))
+#elif defined(CFG_TEE_CORE_DEBUG)
+#define cpu_spin_lock(lock) \
+	cpu_spin_lock_dldetect(__func__, __LINE__, lock)
 #else
 static inline void cpu_spin_lock(unsigned int *lock)
 {
@@ -97,6 +111,10 @@ static inline void cpu_spin_lock(unsigned int *lock)
 }
 #endif
 
+#ifdef CFG_CORE_LOCK_PROF
+#define cpu_spin_trylock(lock) \
+	cpu_spin_trylock_prof(__FILE__, __LINE__, (lock))
+#else
 static inline bool cpu_spin_trylock(unsigned int *lock)
 {
 	unsigned int rc;
@@ -107,10 +125,12 @@ static inline bool cpu_spin_trylock(unsigned int *lock)
 		spinlock_count_incr();
 	return !rc;
 }
+#endif
 
 static inline void cpu_spin_unlock(unsigned int *lock)
 {
 	assert(thread_foreign_intr_disabled());
+	lock_prof_spin_released(lock);
 	__cpu_spin_unlock(lock);
 	spinlock_count_decr();
 }
@@ -120,11 +140,23 @@ cpu_spin_lock_xsave_no_dldetect(unsigned int *lock)
 {
 	uint32_t exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
 
-	cpu_spin_lock(lock);
+	cpu_spin_lock_no_dldetect(lock);
 	return exceptions;
 }
 
-#ifdef CFG_TEE_CORE_DEBUG
+#if defined(CFG_CORE_LOCK_PROF)
+#define cpu_spin_lock_xsave(lock) \
+	cpu_spin_lock_xsave_prof(__FILE__, __LINE__, (lock))
+
+static inline uint32_t __must_check
+cpu_spin_lock_xsave_prof(const char *fname, int lineno, unsigned int *lock)
+{
+	uint32_t exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+
+	cpu_spin_lock_prof(fname, lineno, lock);
+	return exceptions;
+}
+#elif defined(CFG_TEE_CORE_DEBUG)
 #define cpu_spin_lock_xsave(lock) \
 	cpu_spin_lock_xsave_dldetect(__func__, __LINE__, lock)
 
@@ -9,6 +9,7 @@
 #define __KERNEL_TEE_TA_MANAGER_H
 
 #include <assert.h>
+#include <kernel/hash_set.h>
 #include <kernel/mutex.h>
 #include <kernel/tee_common.h>
 #include <kernel/ts_manager.h>
@@ -75,11 +76,14 @@ struct tee_ta_ctx {
 	bool busy;		/* Context is busy and cannot be entered */
 	bool is_initializing;	/* Context initialization is not completed */
 	bool is_releasing;	/* Context is about to be released */
+	struct mutex busy_mu;	/* Protects @busy */
 	struct condvar busy_cv;	/* CV used when context is busy */
 };
 
 struct tee_ta_session {
 	TAILQ_ENTRY(tee_ta_session) link;
+	struct hash_set_elem hash_link; /* Link in session hash set */
+	struct tee_ta_session_head *head; /* List of open sessions @link in */
 	struct ts_session ts_sess;
 	uint32_t id;		/* Session handle (0 is invalid) */
 	TEE_Identity clnt_id;	/* Identify of client */
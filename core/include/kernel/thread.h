@@ -115,6 +115,26 @@ short int thread_get_id(void);
  */
 short int thread_get_id_may_fail(void);
 
+/*
+ * Returns true if thread @thread_id is executing on a core, as opposed to
+ * being free or suspended, for instance waiting for an RPC to return.
+ * The answer may be outdated as soon as it's returned.
+ */
+bool thread_is_active(short int thread_id);
+
+struct thread_stats {
+	size_t num_threads;	/* Number of threads configured */
+	size_t busy;		/* Threads currently active or suspended */
+	size_t max_busy;	/* Peak of busy threads since last dump */
+	size_t alloc_fail;	/* Calls rejected with no free thread */
+};
+
+/*
+ * Returns statistics on thread usage. The peak and failure counters are
+ * reset on each call.
+ */
+void thread_get_stats(struct thread_stats *stats);
+
 /* Returns Thread Specific Data (TSD) pointer. */
 struct thread_specific_data *thread_get_tsd(void);
 
@@ -92,6 +92,19 @@ void thread_check_canaries(void);
 void thread_lock_global(void);
 void thread_unlock_global(void);
 
+/*
+ * Pops a thread from the stack of free threads and marks it
+ * THREAD_STATE_ACTIVE. Returns the thread index or THREAD_ID_INVALID if
+ * all threads are busy. Must be called with the global thread lock held.
+ */
+int thread_claim_free(void);
+
+/*
+ * Marks an active thread as THREAD_STATE_FREE and pushes it back on the
+ * stack of free threads. Must be called with the global thread lock held.
+ */
+void thread_set_free(int n);
+
 /* Frees the cache of allocated FS RPC memory */
 void thread_rpc_shm_cache_clear(struct thread_shm_cache *cache);
 #endif /*__ASSEMBLER__*/
@@ -0,0 +1,68 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+#ifndef __KERNEL_TRACE_EXT_H
+#define __KERNEL_TRACE_EXT_H
+
+#include <tee_api_types.h>
+#include <types_ext.h>
+
+/*
+ * struct trace_ext_ring_stats - Statistics of a per-core trace ring
+ * @lines:		Lines added to the ring
+ * @dropped_lines:	Lines dropped because the ring was full
+ * @dropped_bytes:	Bytes of the dropped lines
+ * @max_used:		Highest number of bytes waiting to be drained
+ */
+struct trace_ext_ring_stats {
+	uint32_t lines;
+	uint32_t dropped_lines;
+	uint32_t dropped_bytes;
+	uint32_t max_used;
+};
+
+#if defined(CFG_CORE_TRACE_RING)
+/*
+ * Writes pending trace lines of all cores to the console unless another
+ * core is already doing that. Called when returning to normal world.
+ */
+void trace_ext_drain(void);
+
+/*
+ * Writes pending trace lines to the console, trace lines of threads are
+ * buffered from then on. Called when the boot thread is released.
+ */
+void trace_ext_boot_done(void);
+
+/*
+ * Writes pending trace lines to the console ignoring any other core
+ * currently doing that, trace lines are written synchronously from then
+ * on. Called when panicking.
+ */
+void trace_ext_panic_flush(void);
+
+TEE_Result trace_ext_get_ring_stats(size_t core_pos,
+				    struct trace_ext_ring_stats *stats);
+#else
+static inline void trace_ext_drain(void)
+{
+}
+
+static inline void trace_ext_boot_done(void)
+{
+}
+
+static inline void trace_ext_panic_flush(void)
+{
+}
+
+static inline TEE_Result
+trace_ext_get_ring_stats(size_t core_pos __unused,
+			 struct trace_ext_ring_stats *stats __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
+#endif /*__KERNEL_TRACE_EXT_H*/
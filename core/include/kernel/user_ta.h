@@ -7,6 +7,7 @@
 #define __KERNEL_USER_TA_H
 
 #include <assert.h>
+#include <kernel/hash_set.h>
 #include <kernel/tee_ta_manager.h>
 #include <kernel/user_mode_ctx_struct.h>
 #include <kernel/thread.h>
@@ -26,7 +27,9 @@ SLIST_HEAD(load_seg_head, load_seg);
  * struct user_ta_ctx - user TA context
  * @open_sessions:	List of sessions opened by this TA
  * @cryp_states:	List of cryp states created by this TA
+ * @cryp_state_set:	Handles of the cryp states in @cryp_states
  * @objects:		List of storage objects opened by this TA
+ * @object_set:		Handles of the objects in @objects
  * @storage_enums:	List of storage enumerators opened by this TA
  * @uctx:		Generic user mode context
  * @ctx:		Generic TA context
@@ -34,7 +37,9 @@ SLIST_HEAD(load_seg_head, load_seg);
 struct user_ta_ctx {
 	struct tee_ta_session_head open_sessions;
 	struct tee_cryp_state_head cryp_states;
+	struct hash_set cryp_state_set;
 	struct tee_obj_head objects;
+	struct hash_set object_set;
 	struct tee_storage_enum_head storage_enums;
 	struct user_mode_ctx uctx;
 	struct tee_ta_ctx ta_ctx;
@@ -7,6 +7,7 @@
 #define __MM_PHYS_MEM_H
 
 #include <mm/tee_mm.h>
+#include <scattered_array.h>
 #include <types_ext.h>
 
 void nex_phys_mem_init(paddr_t core_base, paddr_size_t core_size,
@@ -74,4 +75,30 @@ static inline void phys_mem_stats(struct pta_stats_alloc *stats, bool reset)
  */
 tee_mm_entry_t *phys_mem_alloc_flags(size_t size, uint32_t flags);
 
+/*
+ * struct phys_mem_reclaimer - Gives back physical memory held by a cache
+ * @name:	Name of the reclaimer, for debug traces
+ * @reclaim:	Releases what the cache holds, returns true if anything
+ *		was released
+ */
+struct phys_mem_reclaimer {
+	const char *name;
+	bool (*reclaim)(void);
+};
+
+/* Registers @func as a reclaimer, called by phys_mem_reclaim() */
+#define DECLARE_PHYS_MEM_RECLAIMER(func) \
+	SCATTERED_ARRAY_DEFINE_PG_ITEM(phys_mem_reclaimers, \
+				       struct phys_mem_reclaimer) = { \
+		.name = #func, \
+		.reclaim = (func), \
+	}
+
+/*
+ * Calls all registered reclaimers, for callers of phys_mem_ta_alloc() and
+ * the like to retry when an allocation failed. Must not be called with a
+ * spinlock held. Returns true if any memory was released.
+ */
+bool phys_mem_reclaim(void);
+
 #endif /*__MM_PHYS_MEM_H*/
@@ -8,6 +8,7 @@
 
 #include <malloc.h>
 #include <pta_stats.h>
+#include <sys/queue.h>
 #include <types_ext.h>
 
 /* Define to indicate default pool initiation */
@@ -16,15 +17,29 @@
 #define TEE_MM_POOL_HI_ALLOC            MAF_HI_ALLOC
 /* Flag to indicate that pool should use nex_malloc instead of malloc */
 #define TEE_MM_POOL_NEX_MALLOC          MAF_NEX
+/*
+ * Flag to indicate that free space is found with segregated free lists,
+ * allocation then doesn't depend on the number of allocated entries
+ */
+#define TEE_MM_POOL_SEG_FIT             MAF_SEG_FIT
+
+/* Number of segregated free lists, one per power of 2 of free units */
+#define TEE_MM_NUM_GAP_CLASSES          32
 
 struct _tee_mm_entry_t {
 	struct _tee_mm_pool_t *pool;
 	struct _tee_mm_entry_t *next;
+	struct _tee_mm_entry_t *prev;
 	uint32_t offset;	/* offset in pages/sections */
 	uint32_t size;		/* size in pages/sections */
+	/* TEE_MM_POOL_SEG_FIT: free pages/sections up to the next entry */
+	uint32_t gap;
+	LIST_ENTRY(_tee_mm_entry_t) gap_link;
 };
 typedef struct _tee_mm_entry_t tee_mm_entry_t;
 
+LIST_HEAD(tee_mm_gap_head, _tee_mm_entry_t);
+
 struct _tee_mm_pool_t {
 	tee_mm_entry_t *entry;
 	paddr_t lo;		/* low boundary of the pool */
@@ -32,8 +47,17 @@ struct _tee_mm_pool_t {
 	uint32_t flags;		/* Config flags for the pool */
 	uint8_t shift;		/* size shift */
 	unsigned int lock;
+	/*
+	 * TEE_MM_POOL_SEG_FIT: array of TEE_MM_NUM_GAP_CLASSES lists of
+	 * entries followed by a gap, indexed by log2 of the gap
+	 */
+	struct tee_mm_gap_head *gaps;
 #ifdef CFG_WITH_STATS
+	size_t allocated;	/* allocated pages/sections */
 	size_t max_allocated;
+	uint32_t num_alloc_fail;
+	size_t biggest_alloc_fail;
+	size_t biggest_alloc_fail_used;
 #endif
 };
 typedef struct _tee_mm_pool_t tee_mm_pool_t;
@@ -7,6 +7,7 @@
 #ifndef __MM_TEE_MMU_TYPES_H
 #define __MM_TEE_MMU_TYPES_H
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <sys/queue.h>
 #include <util.h>
@@ -127,8 +128,23 @@ struct vm_paged_region {
 TAILQ_HEAD(vm_paged_region_head, vm_paged_region);
 TAILQ_HEAD(vm_region_head, vm_region);
 
+/*
+ * struct vm_info - User mode address space
+ * @regions:		Regions ordered by virtual address
+ * @sorted_regions:	Array of @sorted_count elements mirroring @regions
+ *			for binary search, only used if @sorted_valid
+ * @sorted_alloc:	Number of allocated elements in @sorted_regions
+ * @sorted_valid:	True if @sorted_regions is up to date
+ * @last_hit:		Region found by the last lookup or NULL
+ * @asid:		Address space identifier
+ */
 struct vm_info {
 	struct vm_region_head regions;
+	struct vm_region **sorted_regions;
+	size_t sorted_count;
+	size_t sorted_alloc;
+	bool sorted_valid;
+	struct vm_region *last_hit;
 	unsigned int asid;
 };
 
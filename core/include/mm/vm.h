@@ -97,4 +97,13 @@ void vm_set_ctx(struct ts_ctx *ctx);
 
 struct mobj *vm_get_mobj(struct user_mode_ctx *uctx, vaddr_t va, size_t *len,
 			 uint16_t *prot, size_t *offs);
+
+#ifdef CFG_TEE_CORE_EMBED_INTERNAL_TESTS
+/*
+ * Checks the sorted region index and vm_info->last_hit of a private
+ * vm_info through map, split, merge and unmap of regions. Returns
+ * TEE_SUCCESS if all checks pass.
+ */
+TEE_Result vm_regions_self_test(void);
+#endif
 #endif /*__MM_VM_H*/
@@ -322,6 +322,39 @@
  */
 #define OPTEE_RPC_FS_READDIR		U(10)
 
+/*
+ * Read from several ranges of a file
+ *
+ * [in]     value[0].a	    OPTEE_RPC_FS_READV
+ * [in]     value[0].b	    File descriptor of open file
+ * [in]     value[0].c	    Number of ranges
+ * [in]     memref[1]	    Array of ranges, each range is a 64-bit offset
+ *			    into the file followed by a 64-bit length
+ * [out]    memref[2]	    Buffer to hold returned data, the data of the
+ *			    ranges is stored back to back
+ *
+ * A request with no ranges reads nothing, OP-TEE sends one to find out if
+ * tee-supplicant supports vectored requests. Older versions don't, in that
+ * case OPTEE_RPC_FS_READ is used for each range instead.
+ */
+#define OPTEE_RPC_FS_READV		U(11)
+
+/*
+ * Write to several ranges of a file
+ *
+ * [in]     value[0].a	    OPTEE_RPC_FS_WRITEV
+ * [in]     value[0].b	    File descriptor of open file
+ * [in]     value[0].c	    Number of ranges
+ * [in]     memref[1]	    Array of ranges, each range is a 64-bit offset
+ *			    into the file followed by a 64-bit length
+ * [in]     memref[2]	    Buffer holding the data to be written, the data
+ *			    of the ranges is stored back to back
+ *
+ * Older versions of tee-supplicant don't support this request, in that
+ * case OPTEE_RPC_FS_WRITE is used for each range instead.
+ */
+#define OPTEE_RPC_FS_WRITEV		U(12)
+
 /* End of definition of protocol for command OPTEE_RPC_CMD_FS */
 
 /*
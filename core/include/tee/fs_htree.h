@@ -79,10 +79,17 @@ struct tee_fs_rpc_operation;
  *			operation
  * @rpc_write_init:	initialize a struct tee_fs_rpc_operation for an RPC
  *			write operation
+ * @rpc_read_blocks_init: optional, initialize a struct tee_fs_rpc_operation
+ *			for an RPC reading @num_blocks data blocks starting
+ *			at @idx, the version of each block is in @vers
+ * @rpc_write_blocks_init: optional, as @rpc_read_blocks_init but for an
+ *			RPC writing data blocks
  *
  * The @idx arguments starts counting from 0. The @vers arguments are either
  * 0 or 1. The @data arguments is a pointer to a buffer in non-secure shared
- * memory where the encrypted data is stored.
+ * memory where the encrypted data is stored. The multi-block operations
+ * handle at most TEE_FS_RPC_MAX_EXTENTS blocks and store the blocks back to
+ * back in @data.
  */
 struct tee_fs_htree_storage {
 	size_t block_size;
@@ -95,6 +102,17 @@ struct tee_fs_htree_storage {
 				     enum tee_fs_htree_type type, size_t idx,
 				     uint8_t vers, void **data);
 	TEE_Result (*rpc_write_final)(struct tee_fs_rpc_operation *op);
+	TEE_Result (*rpc_read_blocks_init)(void *aux,
+					   struct tee_fs_rpc_operation *op,
+					   size_t idx, size_t num_blocks,
+					   const uint8_t *vers, void **data);
+	TEE_Result (*rpc_read_blocks_final)(struct tee_fs_rpc_operation *op,
+					    size_t *bytes);
+	TEE_Result (*rpc_write_blocks_init)(void *aux,
+					    struct tee_fs_rpc_operation *op,
+					    size_t idx, size_t num_blocks,
+					    const uint8_t *vers, void **data);
+	TEE_Result (*rpc_write_blocks_final)(struct tee_fs_rpc_operation *op);
 };
 
 struct tee_fs_htree;
@@ -174,4 +192,63 @@ TEE_Result tee_fs_htree_write_block(struct tee_fs_htree **ht, size_t block_num,
 TEE_Result tee_fs_htree_read_block(struct tee_fs_htree **ht, size_t block_num,
 				   void *block);
 
+/**
+ * tee_fs_htree_write_blocks() - encrypt and write consecutive data blocks
+ * @ht:		hash tree
+ * @block_num:	number of the first block
+ * @num_blocks:	number of blocks
+ * @blocks:	pointer to @num_blocks blocks of stor->block_size size
+ *
+ * The blocks are written with as few RPCs as the storage allows.
+ *
+ * Frees the hash tree and sets *ht to NULL on failure and returns an error code
+ */
+TEE_Result tee_fs_htree_write_blocks(struct tee_fs_htree **ht,
+				     size_t block_num, size_t num_blocks,
+				     const void *blocks);
+
+/**
+ * tee_fs_htree_read_blocks() - read and decrypt consecutive data blocks
+ * @ht:		hash tree
+ * @block_num:	number of the first block
+ * @num_blocks:	number of blocks
+ * @blocks:	pointer to @num_blocks blocks of stor->block_size size
+ *
+ * The blocks are read with as few RPCs as the storage allows.
+ *
+ * Frees the hash tree and sets *ht to NULL on failure and returns an error code
+ */
+TEE_Result tee_fs_htree_read_blocks(struct tee_fs_htree **ht,
+				    size_t block_num, size_t num_blocks,
+				    void *blocks);
+
+/*
+ * struct tee_fs_htree_cache_stats - statistics of the cache of data blocks
+ * @hits:	blocks found in the cache since last call
+ * @misses:	blocks not found in the cache since last call
+ * @read_ahead:	blocks read ahead into the cache since last call
+ * @num_blocks:	blocks currently in the cache
+ * @max_blocks:	maximal number of blocks in the cache
+ */
+struct tee_fs_htree_cache_stats {
+	size_t hits;
+	size_t misses;
+	size_t read_ahead;
+	size_t num_blocks;
+	size_t max_blocks;
+};
+
+/**
+ * tee_fs_htree_get_cache_stats() - get statistics of the block cache
+ * @stats:	returned statistics
+ *
+ * The counters of hits, misses and blocks read ahead are reset.
+ */
+void tee_fs_htree_get_cache_stats(struct tee_fs_htree_cache_stats *stats);
+
+/**
+ * tee_fs_htree_flush_cache() - remove all blocks from the block cache
+ */
+void tee_fs_htree_flush_cache(void);
+
 #endif /*__TEE_FS_HTREE_H*/
@@ -16,10 +16,36 @@
 #include <tee/tee_fs.h>
 #include <kernel/thread.h>
 
+/* Maximal number of ranges in a vectored read or write */
+#define TEE_FS_RPC_MAX_EXTENTS	8
+
+/*
+ * struct tee_fs_rpc_extent - a range of a file
+ * @offs:	offset into the file
+ * @len:	length of the range
+ *
+ * This is also the format of the array of ranges passed to tee-supplicant
+ * with OPTEE_RPC_FS_READV and OPTEE_RPC_FS_WRITEV.
+ */
+struct tee_fs_rpc_extent {
+	uint64_t offs;
+	uint64_t len;
+};
+
+/*
+ * struct tee_fs_rpc_operation - an RPC operation on a file
+ * @id:		RPC command
+ * @params:	parameters of the RPC
+ * @num_params:	number of used elements in @params
+ * @ext:	ranges of a vectored operation
+ * @num_ext:	number of used elements in @ext, 0 if not vectored
+ */
 struct tee_fs_rpc_operation {
 	uint32_t id;
 	struct thread_param params[THREAD_RPC_MAX_NUM_PARAMS];
 	size_t num_params;
+	struct tee_fs_rpc_extent ext[TEE_FS_RPC_MAX_EXTENTS];
+	size_t num_ext;
 };
 
 struct tee_fs_dirfile_fileh;
@@ -42,6 +68,25 @@ TEE_Result tee_fs_rpc_write_init(struct tee_fs_rpc_operation *op,
 				 size_t data_len, void **data);
 TEE_Result tee_fs_rpc_write_final(struct tee_fs_rpc_operation *op);
 
+/*
+ * Vectored variants of the read and write operations above, the data of
+ * the @num_ext ranges in @ext is stored back to back in the buffer
+ * returned in @data. If tee-supplicant doesn't support vectored
+ * operations the ranges are transferred one by one instead.
+ */
+TEE_Result tee_fs_rpc_readv_init(struct tee_fs_rpc_operation *op,
+				 uint32_t id, int fd,
+				 const struct tee_fs_rpc_extent *ext,
+				 size_t num_ext, void **out_data);
+TEE_Result tee_fs_rpc_readv_final(struct tee_fs_rpc_operation *op,
+				  size_t *data_len);
+
+TEE_Result tee_fs_rpc_writev_init(struct tee_fs_rpc_operation *op,
+				  uint32_t id, int fd,
+				  const struct tee_fs_rpc_extent *ext,
+				  size_t num_ext, void **data);
+TEE_Result tee_fs_rpc_writev_final(struct tee_fs_rpc_operation *op);
+
 
 TEE_Result tee_fs_rpc_truncate(uint32_t id, int fd, size_t len);
 TEE_Result tee_fs_rpc_remove_dfh(uint32_t id,
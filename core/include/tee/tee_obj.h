@@ -6,6 +6,7 @@
 #ifndef __TEE_TEE_OBJ_H
 #define __TEE_TEE_OBJ_H
 
+#include <kernel/hash_set.h>
 #include <kernel/tee_ta_manager.h>
 #include <sys/queue.h>
 #include <tee_api_types.h>
@@ -15,6 +16,7 @@
 
 struct tee_obj {
 	TAILQ_ENTRY(tee_obj) link;
+	struct hash_set_elem handle_elem;
 	TEE_ObjectInfo info;
 	bool busy;		/* true if used by an operation */
 	uint32_t have_attrs;	/* bitfield identifying set properties */
@@ -6,13 +6,15 @@
 #ifndef __TEE_TEE_POBJ_H
 #define __TEE_TEE_POBJ_H
 
+#include <kernel/hash_set.h>
 #include <stdint.h>
 #include <sys/queue.h>
 #include <tee_api_types.h>
 #include <tee/tee_fs.h>
 
 struct tee_pobj {
-	TAILQ_ENTRY(tee_pobj) link;
+	/* Keyed on the hash of uuid, obj_id and fops */
+	struct hash_set_elem link;
 	uint32_t refcnt;
 	TEE_UUID uuid;
 	void *obj_id;
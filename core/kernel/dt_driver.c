@@ -488,6 +488,7 @@ static TEE_Result probe_driver_node(const void *fdt,
 	TEE_Result res = TEE_ERROR_GENERIC;
 	const char __maybe_unused *drv_name = NULL;
 	const char __maybe_unused *node_name = NULL;
+	size_t prof_idx = 0;
 
 	node_name = fdt_get_name(fdt, elt->nodeoffset, NULL);
 	drv_name = elt->dt_drv->name;
@@ -499,7 +500,10 @@ static TEE_Result probe_driver_node(const void *fdt,
 
 	FMSG("Probing %s on node %s", drv_name, node_name);
 
+	prof_idx = initcall_prof_begin(INITCALL_PROF_DT_PROBE, 0, drv_name,
+				       node_name);
 	res = elt->dt_drv->probe(fdt, elt->nodeoffset, elt->dm->compat_data);
+	initcall_prof_end(prof_idx, res);
 	switch (res) {
 	case TEE_SUCCESS:
 		TAILQ_INSERT_HEAD(&dt_driver_ready_list, elt, link);
@@ -0,0 +1,170 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+
+#include <assert.h>
+#include <kernel/hash_set.h>
+#include <stdlib.h>
+
+static struct hash_set_bucket *bucket_of(struct hash_set_bucket *buckets,
+					 size_t num_buckets, uint64_t key)
+{
+	/*
+	 * Keys may be addresses of heap allocated objects with the lowest
+	 * bits always the same due to alignment. Multiply with a large odd
+	 * constant to spread all bits over the buckets.
+	 */
+	uint32_t h = (uint32_t)(key ^ (key >> 32)) * 0x9e3779b1U;
+
+	return buckets + ((h >> 16) & (num_buckets - 1));
+}
+
+void hash_set_init(struct hash_set *set)
+{
+	size_t n = 0;
+
+	set->buckets = set->initial_buckets;
+	set->num_buckets = HASH_SET_INITIAL_BUCKETS;
+	set->num_elems = 0;
+	for (n = 0; n < HASH_SET_INITIAL_BUCKETS; n++)
+		SLIST_INIT(set->initial_buckets + n);
+}
+
+void hash_set_destroy(struct hash_set *set)
+{
+	assert(!set->num_elems);
+	if (set->buckets != set->initial_buckets)
+		free(set->buckets);
+	hash_set_init(set);
+}
+
+size_t hash_set_grow_buckets(struct hash_set *set)
+{
+	if (set->num_elems < set->num_buckets * HASH_SET_MAX_LOAD ||
+	    set->num_buckets >= HASH_SET_MAX_BUCKETS)
+		return 0;
+
+	return set->num_buckets * 2;
+}
+
+struct hash_set_bucket *hash_set_rehash(struct hash_set *set,
+					struct hash_set_bucket *buckets,
+					size_t num_buckets)
+{
+	struct hash_set_bucket *old = set->buckets;
+	struct hash_set_elem *e = NULL;
+	size_t n = 0;
+
+	assert(num_buckets && !(num_buckets & (num_buckets - 1)));
+
+	for (n = 0; n < set->num_buckets; n++) {
+		while ((e = SLIST_FIRST(old + n))) {
+			SLIST_REMOVE_HEAD(old + n, link);
+			SLIST_INSERT_HEAD(bucket_of(buckets, num_buckets,
+						    e->key), e, link);
+		}
+	}
+
+	set->buckets = buckets;
+	set->num_buckets = num_buckets;
+
+	if (old == set->initial_buckets)
+		return NULL;
+	return old;
+}
+
+void hash_set_add_no_grow(struct hash_set *set, struct hash_set_elem *elem,
+			  uint64_t key)
+{
+	elem->key = key;
+	SLIST_INSERT_HEAD(bucket_of(set->buckets, set->num_buckets, key), elem,
+			  link);
+	set->num_elems++;
+}
+
+void hash_set_add(struct hash_set *set, struct hash_set_elem *elem,
+		  uint64_t key)
+{
+	size_t num_buckets = hash_set_grow_buckets(set);
+	struct hash_set_bucket *b = NULL;
+
+	if (num_buckets) {
+		b = calloc(num_buckets, sizeof(*b));
+		if (b)
+			free(hash_set_rehash(set, b, num_buckets));
+	}
+
+	hash_set_add_no_grow(set, elem, key);
+}
+
+void hash_set_remove(struct hash_set *set, struct hash_set_elem *elem)
+{
+	assert(set->num_elems);
+	SLIST_REMOVE(bucket_of(set->buckets, set->num_buckets, elem->key), elem,
+		     hash_set_elem, link);
+	set->num_elems--;
+}
+
+struct hash_set_elem *hash_set_first(struct hash_set *set, uint64_t key)
+{
+	struct hash_set_elem *e = NULL;
+
+	SLIST_FOREACH(e, bucket_of(set->buckets, set->num_buckets, key), link)
+		if (e->key == key)
+			return e;
+
+	return NULL;
+}
+
+struct hash_set_elem *hash_set_next(struct hash_set_elem *elem)
+{
+	struct hash_set_elem *e = elem;
+
+	while ((e = SLIST_NEXT(e, link)))
+		if (e->key == elem->key)
+			return e;
+
+	return NULL;
+}
+
+static struct hash_set_elem *first_from_bucket(struct hash_set *set,
+					       size_t idx)
+{
+	for (; idx < set->num_buckets; idx++)
+		if (!SLIST_EMPTY(set->buckets + idx))
+			return SLIST_FIRST(set->buckets + idx);
+
+	return NULL;
+}
+
+struct hash_set_elem *hash_set_iter_first(struct hash_set *set)
+{
+	if (!set->num_elems)
+		return NULL;
+
+	return first_from_bucket(set, 0);
+}
+
+struct hash_set_elem *hash_set_iter_next(struct hash_set *set,
+					 struct hash_set_elem *elem)
+{
+	struct hash_set_bucket *b = NULL;
+
+	if (SLIST_NEXT(elem, link))
+		return SLIST_NEXT(elem, link);
+
+	b = bucket_of(set->buckets, set->num_buckets, elem->key);
+	return first_from_bucket(set, b - set->buckets + 1);
+}
+
+uint32_t hash_fnv1a(uint32_t h, const void *data, size_t len)
+{
+	const uint8_t *p = data;
+	size_t n = 0;
+
+	for (n = 0; n < len; n++)
+		h = (h ^ p[n]) * 16777619U;
+
+	return h;
+}
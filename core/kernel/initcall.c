@@ -4,29 +4,175 @@
  * Copyright (c) 2014, STMicroelectronics International N.V.
  */
 
+#include <config.h>
 #include <initcall.h>
-#include <trace.h>
+#include <kernel/delay.h>
 #include <kernel/linker.h>
+#include <kernel/spinlock.h>
+#include <kernel/thread.h>
+#include <kernel/virtualization.h>
+#include <string.h>
+#include <string_ext.h>
+#include <trace.h>
+#include <util.h>
+
+#ifdef CFG_CORE_INITCALL_PROF
+/* Highest initcall level, see boot_final() */
+#define INITCALL_MAX_LEVEL	8
+
+static struct initcall_prof_rec prof_recs[CFG_CORE_INITCALL_PROF_RECS]
+	__nex_bss;
+static size_t prof_rec_count __nex_bss;
+static unsigned int prof_lock __nex_data = SPINLOCK_UNLOCK;
+
+size_t initcall_prof_begin(enum initcall_prof_phase phase, int level,
+			   const char *name, const char *node)
+{
+	uint32_t exceptions = 0;
+	size_t idx = 0;
+
+	/*
+	 * With CFG_NS_VIRTUALIZATION only the nexus boot is recorded. The
+	 * initcalls done for each guest would otherwise be added to the
+	 * nexus records, which are returned to every guest.
+	 */
+	if (virt_get_current_guest_id())
+		return ARRAY_SIZE(prof_recs);
+
+	exceptions = cpu_spin_lock_xsave(&prof_lock);
+	idx = prof_rec_count;
+
+	if (idx < ARRAY_SIZE(prof_recs)) {
+		prof_recs[idx] = (struct initcall_prof_rec){
+			.name = name,
+			.phase = phase,
+			.level = level,
+			.start = delay_cnt_read(),
+		};
+		/* The FDT may be modified later on, keep a copy */
+		if (node)
+			strlcpy(prof_recs[idx].node, node,
+				sizeof(prof_recs[idx].node));
+		prof_rec_count++;
+	}
+	cpu_spin_unlock_xrestore(&prof_lock, exceptions);
+
+	return idx;
+}
+
+void initcall_prof_end(size_t idx, TEE_Result res)
+{
+	uint64_t now = delay_cnt_read();
+	uint32_t exceptions = 0;
+
+	if (idx >= ARRAY_SIZE(prof_recs))
+		return;
+
+	exceptions = cpu_spin_lock_xsave(&prof_lock);
+	prof_recs[idx].res = res;
+	prof_recs[idx].ticks = now - prof_recs[idx].start;
+	cpu_spin_unlock_xrestore(&prof_lock, exceptions);
+}
+
+size_t initcall_prof_get_recs(struct initcall_prof_rec *recs,
+			      size_t max_recs)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&prof_lock);
+	size_t count = prof_rec_count;
+
+	memcpy(recs, prof_recs, MIN(count, max_recs) * sizeof(*recs));
+	cpu_spin_unlock_xrestore(&prof_lock, exceptions);
+
+	return count;
+}
+
+/* Prints the records from @first on, then the total time of each level */
+static void print_prof(const char *type __maybe_unused, size_t first)
+{
+	uint64_t level_ticks[INITCALL_MAX_LEVEL + 1] = { };
+	unsigned int levels = 0;
+	size_t count = 0;
+	size_t n = 0;
+
+	count = MIN(prof_rec_count, ARRAY_SIZE(prof_recs));
+	for (n = first; n < count; n++) {
+		struct initcall_prof_rec *r = prof_recs + n;
+
+		if (r->phase == INITCALL_PROF_DT_PROBE) {
+			IMSG("%s: probe %s on %s: %"PRIu64" us, res %#"PRIx32,
+			     type, r->name, r->node, delay_cnt2us(r->ticks),
+			     r->res);
+			continue;
+		}
+
+		IMSG("%s level %d %s(): %"PRIu64" us", type, r->level,
+		     r->name, delay_cnt2us(r->ticks));
+		if (r->level >= 0 && r->level <= INITCALL_MAX_LEVEL) {
+			level_ticks[r->level] += r->ticks;
+			levels |= BIT(r->level);
+		}
+	}
+
+	for (n = 0; n <= INITCALL_MAX_LEVEL; n++)
+		if (levels & BIT(n))
+			IMSG("%s level %zu: %"PRIu64" us in total", type, n,
+			     delay_cnt2us(level_ticks[n]));
+}
+
+static size_t prof_next_rec(void)
+{
+	return prof_rec_count;
+}
+
+static size_t prof_call_begin(enum initcall_prof_phase phase,
+			      const struct initcall *call)
+{
+	return initcall_prof_begin(phase, call->level, call->func_name, NULL);
+}
+#else
+static void print_prof(const char *type __unused, size_t first __unused)
+{
+}
+
+static size_t prof_next_rec(void)
+{
+	return 0;
+}
+
+static size_t prof_call_begin(enum initcall_prof_phase phase __unused,
+			      const struct initcall *call __unused)
+{
+	return 0;
+}
+#endif /*CFG_CORE_INITCALL_PROF*/
 
 static void do_init_calls(const char *type __maybe_unused,
+			  enum initcall_prof_phase phase,
 			  const struct initcall *begin,
 			  const struct initcall *end)
 {
 	const struct initcall *call = NULL;
 	TEE_Result ret = TEE_SUCCESS;
+	size_t first = prof_next_rec();
+	size_t idx = 0;
 
 	for (call = begin; call < end; call++) {
 		DMSG("%s level %d %s()", type, call->level, call->func_name);
+		idx = prof_call_begin(phase, call);
 		ret = call->func();
+		initcall_prof_end(idx, ret);
 		if (ret) {
 			EMSG("%s __text_start + 0x%08"PRIxVA" failed",
 			     type, (vaddr_t)call - VCORE_START_VA);
 		}
 	}
+
+	if (IS_ENABLED(CFG_CORE_INITCALL_PROF_PRINT))
+		print_prof(type, first);
 }
 
-#define DO_INIT_CALLS(name) \
-	do_init_calls(#name, name##_begin, name##_end)
+#define DO_INIT_CALLS(name, phase) \
+	do_init_calls(#name, (phase), name##_begin, name##_end)
 
 /*
  * Note: this function is weak just to make it possible to exclude it from
@@ -34,7 +180,7 @@ static void do_init_calls(const char *type __maybe_unused,
  */
 void __weak call_preinitcalls(void)
 {
-	DO_INIT_CALLS(preinitcall);
+	DO_INIT_CALLS(preinitcall, INITCALL_PROF_PREINIT);
 }
 
 /*
@@ -43,7 +189,7 @@ void __weak call_preinitcalls(void)
  */
 void __weak call_early_initcalls(void)
 {
-	DO_INIT_CALLS(early_initcall);
+	DO_INIT_CALLS(early_initcall, INITCALL_PROF_EARLY_INIT);
 }
 
 /*
@@ -52,7 +198,7 @@ void __weak call_early_initcalls(void)
  */
 void __weak call_service_initcalls(void)
 {
-	DO_INIT_CALLS(service_initcall);
+	DO_INIT_CALLS(service_initcall, INITCALL_PROF_SERVICE_INIT);
 }
 
 /*
@@ -61,7 +207,7 @@ void __weak call_service_initcalls(void)
  */
 void __weak call_driver_initcalls(void)
 {
-	DO_INIT_CALLS(driver_initcall);
+	DO_INIT_CALLS(driver_initcall, INITCALL_PROF_DRIVER_INIT);
 }
 
 /*
@@ -70,5 +216,5 @@ void __weak call_driver_initcalls(void)
  */
 void __weak call_finalcalls(void)
 {
-	DO_INIT_CALLS(finalcall);
+	DO_INIT_CALLS(finalcall, INITCALL_PROF_FINAL);
 }
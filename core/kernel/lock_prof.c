@@ -0,0 +1,248 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+
+#include <assert.h>
+#include <kernel/lock_prof.h>
+#include <kernel/misc.h>
+#include <kernel/mutex.h>
+#include <kernel/spinlock.h>
+#include <kernel/thread.h>
+#include <string.h>
+#include <util.h>
+
+/* Max number of locks tracked for hold time per core or thread */
+#define HELD_MAX	8
+
+struct held_lock {
+	const void *lock;
+	uint64_t start;
+	unsigned int site;
+	unsigned int generation;
+};
+
+struct held_locks {
+	struct held_lock locks[HELD_MAX];
+	size_t count;
+};
+
+/*
+ * @sites is a hash table indexed by the source location of the lock
+ * sites, an entry with a NULL @fname is free. @generation is increased
+ * each time the table is reset. Accessed with @prof_lock held, which is
+ * taken directly with __cpu_spin_lock() since it must not be profiled
+ * itself.
+ */
+static struct lock_prof_site sites[LOCK_PROF_MAX_SITES] __nex_bss;
+static size_t site_count __nex_bss;
+static unsigned int generation __nex_bss;
+static unsigned int prof_lock __nex_bss;
+
+/* Spinlocks held by each core, accessed with all exceptions masked */
+static struct held_locks core_held[CFG_TEE_CORE_NB_CORE] __nex_bss;
+/* Mutexes held by each thread */
+static struct held_locks thread_held[CFG_NUM_THREADS] __nex_bss;
+
+static uint32_t prof_lock_xsave(void)
+{
+	uint32_t exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+
+	__cpu_spin_lock(&prof_lock);
+	return exceptions;
+}
+
+static void prof_unlock_xrestore(uint32_t exceptions)
+{
+	__cpu_spin_unlock(&prof_lock);
+	thread_unmask_exceptions(exceptions);
+}
+
+/*
+ * Returns the index of the site of @fname:@lineno, adding it if needed,
+ * or LOCK_PROF_MAX_SITES if the table is full. Called with @prof_lock
+ * held.
+ */
+static unsigned int get_site(const char *fname, int lineno, unsigned int type)
+{
+	unsigned int h = ((uintptr_t)fname ^ (lineno * 2654435761U) ^ type) %
+			 LOCK_PROF_MAX_SITES;
+	unsigned int n = 0;
+
+	for (n = 0; n < LOCK_PROF_MAX_SITES; n++) {
+		struct lock_prof_site *s = sites + h;
+
+		if (!s->fname) {
+			s->fname = fname;
+			s->lineno = lineno;
+			s->type = type;
+			site_count++;
+			return h;
+		}
+		if (s->fname == fname && s->lineno == lineno && s->type == type)
+			return h;
+		h = (h + 1) % LOCK_PROF_MAX_SITES;
+	}
+
+	return LOCK_PROF_MAX_SITES;
+}
+
+static void acquired(struct held_locks *held, const void *lock,
+		     const char *fname, int lineno, unsigned int type,
+		     bool contended, bool spun, unsigned int sleeps,
+		     uint64_t start)
+{
+	uint64_t now = lock_prof_now();
+	uint32_t exceptions = 0;
+	unsigned int site = 0;
+	unsigned int gen = 0;
+
+	if (!fname)
+		fname = "unknown";
+
+	exceptions = prof_lock_xsave();
+	site = get_site(fname, lineno, type);
+	gen = generation;
+
+	if (site < LOCK_PROF_MAX_SITES) {
+		sites[site].acquired++;
+		if (contended) {
+			sites[site].contended++;
+			sites[site].wait_ticks += now - start;
+		}
+		if (spun)
+			sites[site].spin_acquired++;
+		sites[site].sleeps += sleeps;
+	}
+
+	prof_unlock_xrestore(exceptions);
+
+	if (site < LOCK_PROF_MAX_SITES && held->count < HELD_MAX) {
+		held->locks[held->count] = (struct held_lock){
+			.lock = lock,
+			.start = now,
+			.site = site,
+			.generation = gen,
+		};
+		held->count++;
+	}
+}
+
+static void released(struct held_locks *held, const void *lock)
+{
+	uint64_t now = lock_prof_now();
+	uint32_t exceptions = 0;
+	struct held_lock hl = { };
+	uint64_t hold = 0;
+	size_t n = 0;
+
+	/* Locks are usually released in reverse order */
+	for (n = held->count; n > 0; n--)
+		if (held->locks[n - 1].lock == lock)
+			break;
+	if (!n)
+		return;
+
+	hl = held->locks[n - 1];
+	hold = now - hl.start;
+	held->count--;
+	held->locks[n - 1] = held->locks[held->count];
+
+	exceptions = prof_lock_xsave();
+	/* Skip if the sites were reset while the lock was held */
+	if (hl.generation == generation &&
+	    hold > sites[hl.site].max_hold_ticks)
+		sites[hl.site].max_hold_ticks = hold;
+	prof_unlock_xrestore(exceptions);
+}
+
+void cpu_spin_lock_prof(const char *fname, int lineno, unsigned int *lock)
+{
+	uint64_t start = lock_prof_now();
+	bool contended = false;
+	uint32_t exceptions = 0;
+
+	assert(thread_foreign_intr_disabled());
+
+	if (__cpu_spin_trylock(lock)) {
+		contended = true;
+		/* Keep reporting possible deadlocks as without the profiler */
+#ifdef CFG_TEE_CORE_DEBUG
+		cpu_spin_lock_dldetect(fname, lineno, lock);
+#else
+		cpu_spin_lock_no_dldetect(lock);
+#endif
+	} else {
+		spinlock_count_incr();
+	}
+
+	exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+	acquired(core_held + get_core_pos(), lock, fname, lineno,
+		 LOCK_PROF_TYPE_SPINLOCK, contended, false, 0, start);
+	thread_unmask_exceptions(exceptions);
+}
+
+bool cpu_spin_trylock_prof(const char *fname, int lineno, unsigned int *lock)
+{
+	uint32_t exceptions = 0;
+
+	assert(thread_foreign_intr_disabled());
+
+	if (__cpu_spin_trylock(lock))
+		return false;
+	spinlock_count_incr();
+
+	exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+	acquired(core_held + get_core_pos(), lock, fname, lineno,
+		 LOCK_PROF_TYPE_SPINLOCK, false, false, 0, 0);
+	thread_unmask_exceptions(exceptions);
+
+	return true;
+}
+
+void lock_prof_spin_released(unsigned int *lock)
+{
+	uint32_t exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+
+	released(core_held + get_core_pos(), lock);
+	thread_unmask_exceptions(exceptions);
+}
+
+void lock_prof_mutex_acquired(struct mutex *m, const char *fname, int lineno,
+			      bool contended, bool spun, unsigned int sleeps,
+			      uint64_t start)
+{
+	acquired(thread_held + thread_get_id(), m, fname, lineno,
+		 LOCK_PROF_TYPE_MUTEX, contended, spun, sleeps, start);
+}
+
+void lock_prof_mutex_released(struct mutex *m)
+{
+	released(thread_held + thread_get_id(), m);
+}
+
+size_t lock_prof_get_sites(struct lock_prof_site *s, size_t max_sites,
+			   bool reset)
+{
+	uint32_t exceptions = prof_lock_xsave();
+	size_t count = site_count;
+	size_t n = 0;
+	size_t i = 0;
+
+	for (n = 0; n < LOCK_PROF_MAX_SITES && i < max_sites; n++) {
+		if (sites[n].fname) {
+			s[i] = sites[n];
+			i++;
+		}
+	}
+
+	if (reset && count <= max_sites) {
+		memset(sites, 0, sizeof(sites));
+		site_count = 0;
+		generation++;
+	}
+
+	prof_unlock_xrestore(exceptions);
+
+	return count;
+}
@@ -3,6 +3,10 @@
  * Copyright (c) 2015-2017, Linaro Limited
  */
 
+#include <atomic.h>
+#include <config.h>
+#include <kernel/lock_prof.h>
+#include <kernel/misc.h>
 #include <kernel/mutex.h>
 #include <kernel/mutex_pm_aware.h>
 #include <kernel/panic.h>
@@ -23,8 +27,56 @@ void mutex_init_recursive(struct recursive_mutex *m)
 	*m = (struct recursive_mutex)RECURSIVE_MUTEX_INITIALIZER;
 }
 
+#ifdef CFG_CORE_MUTEX_ADAPTIVE
+static void mutex_set_owner(struct mutex *m)
+{
+	atomic_store_short(&m->owner, thread_get_id());
+}
+
+/*
+ * Spins while @m is write locked by a thread executing on another core,
+ * at most CFG_CORE_MUTEX_SPIN_LOOPS times. Returns true if @m was
+ * released, false if the caller should sleep instead.
+ *
+ * An owner which isn't executing, for instance waiting for an RPC to
+ * return, may hold the mutex for a long time so it's not worth spinning.
+ */
+static bool mutex_spin(struct mutex *m)
+{
+	short int self = thread_get_id();
+	short int owner = 0;
+	unsigned int n = 0;
+
+	for (n = 0; n < CFG_CORE_MUTEX_SPIN_LOOPS; n++) {
+		if (atomic_load_short(&m->state) != -1)
+			return true;
+		owner = atomic_load_short(&m->owner);
+		if (owner == self || !thread_is_active(owner))
+			return false;
+		cpu_relax();
+	}
+
+	return false;
+}
+#else
+static void mutex_set_owner(struct mutex *m __unused)
+{
+}
+
+static bool mutex_spin(struct mutex *m __unused)
+{
+	return false;
+}
+#endif
+
 static void __mutex_lock(struct mutex *m, const char *fname, int lineno)
 {
+	bool may_spin = IS_ENABLED(CFG_CORE_MUTEX_ADAPTIVE);
+	bool contended = false;
+	bool spun = false;
+	unsigned int sleeps = 0;
+	uint64_t start = lock_prof_now();
+
 	assert_have_no_spinlock();
 	assert(thread_get_id_may_fail() != THREAD_ID_INVALID);
 	assert(thread_is_in_normal_mode());
@@ -34,6 +86,7 @@ static void __mutex_lock(struct mutex *m, const char *fname, int lineno)
 	while (true) {
 		uint32_t old_itr_status;
 		bool can_lock;
+		bool do_spin = false;
 		struct wait_queue_elem wqe;
 
 		/*
@@ -41,29 +94,51 @@ static void __mutex_lock(struct mutex *m, const char *fname, int lineno)
 		 * before releasing the spinlock to guarantee that we don't
 		 * miss the wakeup from mutex_unlock().
 		 *
-		 * If the mutex is unlocked we don't need to use the wqe at
-		 * all.
+		 * If the mutex is unlocked, or if we're going to spin
+		 * waiting for it to be unlocked, we don't need to use the
+		 * wqe at all.
 		 */
 
 		old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
 		can_lock = !m->state;
 		if (!can_lock) {
-			wq_wait_init(&m->wq, &wqe, false /* wait_read */);
+			do_spin = may_spin;
+			if (!do_spin)
+				wq_wait_init(&m->wq, &wqe,
+					     false /* wait_read */);
 		} else {
 			m->state = -1; /* write locked */
+			mutex_set_owner(m);
 		}
 
 		cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
-		if (!can_lock) {
+		if (can_lock) {
+			lock_prof_mutex_acquired(m, fname, lineno, contended,
+						 spun, sleeps, start);
+			return;
+		}
+
+		contended = true;
+		if (do_spin) {
+			/*
+			 * Someone else is holding the lock, spin a while
+			 * in case it's released soon. Try again to lock
+			 * it, or to queue up for it if it wasn't released.
+			 */
+			spun = mutex_spin(m);
+			may_spin = false;
+		} else {
 			/*
 			 * Someone else is holding the lock, wait in normal
 			 * world for the lock to become available.
 			 */
 			wq_wait_final(&m->wq, &wqe, 0, m, fname, lineno);
-		} else
-			return;
+			sleeps++;
+			may_spin = IS_ENABLED(CFG_CORE_MUTEX_ADAPTIVE);
+			spun = false;
+		}
 	}
 }
 
@@ -96,6 +171,7 @@ static void __mutex_unlock(struct mutex *m, const char *fname, int lineno)
 	assert(thread_get_id_may_fail() != THREAD_ID_INVALID);
 
 	mutex_unlock_check(m);
+	lock_prof_mutex_released(m);
 
 	old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
@@ -125,8 +201,7 @@ static void __mutex_unlock_recursive(struct recursive_mutex *m,
 	}
 }
 
-static bool __mutex_trylock(struct mutex *m, const char *fname __unused,
-			int lineno __unused)
+static bool __mutex_trylock(struct mutex *m, const char *fname, int lineno)
 {
 	uint32_t old_itr_status;
 	bool can_lock_write;
@@ -137,13 +212,17 @@ static bool __mutex_trylock(struct mutex *m, const char *fname __unused,
 	old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
 	can_lock_write = !m->state;
-	if (can_lock_write)
+	if (can_lock_write) {
 		m->state = -1;
+		mutex_set_owner(m);
+	}
 
 	cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
-	if (can_lock_write)
+	if (can_lock_write) {
 		mutex_trylock_check(m);
+		lock_prof_mutex_acquired(m, fname, lineno, false, false, 0, 0);
+	}
 
 	return can_lock_write;
 }
@@ -156,6 +235,8 @@ static void __mutex_read_unlock(struct mutex *m, const char *fname, int lineno)
 	assert_have_no_spinlock();
 	assert(thread_get_id_may_fail() != THREAD_ID_INVALID);
 
+	lock_prof_mutex_released(m);
+
 	old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
 	if (m->state <= 0)
@@ -172,6 +253,12 @@ static void __mutex_read_unlock(struct mutex *m, const char *fname, int lineno)
 
 static void __mutex_read_lock(struct mutex *m, const char *fname, int lineno)
 {
+	bool may_spin = IS_ENABLED(CFG_CORE_MUTEX_ADAPTIVE);
+	bool contended = false;
+	bool spun = false;
+	unsigned int sleeps = 0;
+	uint64_t start = lock_prof_now();
+
 	assert_have_no_spinlock();
 	assert(thread_get_id_may_fail() != THREAD_ID_INVALID);
 	assert(thread_is_in_normal_mode());
@@ -179,6 +266,7 @@ static void __mutex_read_lock(struct mutex *m, const char *fname, int lineno)
 	while (true) {
 		uint32_t old_itr_status;
 		bool can_lock;
+		bool do_spin = false;
 		struct wait_queue_elem wqe;
 
 		/*
@@ -186,34 +274,55 @@ static void __mutex_read_lock(struct mutex *m, const char *fname, int lineno)
 		 * before releasing the spinlock to guarantee that we don't
 		 * miss the wakeup from mutex_unlock().
 		 *
-		 * If the mutex is unlocked we don't need to use the wqe at
-		 * all.
+		 * If the mutex is unlocked, or if we're going to spin
+		 * waiting for it to be unlocked, we don't need to use the
+		 * wqe at all.
 		 */
 
 		old_itr_status = cpu_spin_lock_xsave(&m->spin_lock);
 
 		can_lock = m->state != -1;
 		if (!can_lock) {
-			wq_wait_init(&m->wq, &wqe, true /* wait_read */);
+			do_spin = may_spin;
+			if (!do_spin)
+				wq_wait_init(&m->wq, &wqe,
+					     true /* wait_read */);
 		} else {
 			m->state++; /* read_locked */
 		}
 
 		cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
-		if (!can_lock) {
+		if (can_lock) {
+			lock_prof_mutex_acquired(m, fname, lineno, contended,
+						 spun, sleeps, start);
+			return;
+		}
+
+		contended = true;
+		if (do_spin) {
+			/*
+			 * Someone else is holding the lock, spin a while
+			 * in case it's released soon. Try again to lock
+			 * it, or to queue up for it if it wasn't released.
+			 */
+			spun = mutex_spin(m);
+			may_spin = false;
+		} else {
 			/*
 			 * Someone else is holding the lock, wait in normal
 			 * world for the lock to become available.
 			 */
 			wq_wait_final(&m->wq, &wqe, 0, m, fname, lineno);
-		} else
-			return;
+			sleeps++;
+			may_spin = IS_ENABLED(CFG_CORE_MUTEX_ADAPTIVE);
+			spun = false;
+		}
 	}
 }
 
-static bool __mutex_read_trylock(struct mutex *m, const char *fname __unused,
-				 int lineno __unused)
+static bool __mutex_read_trylock(struct mutex *m, const char *fname,
+				 int lineno)
 {
 	uint32_t old_itr_status;
 	bool can_lock;
@@ -230,6 +339,9 @@ static bool __mutex_read_trylock(struct mutex *m, const char *fname __unused,
 
 	cpu_spin_unlock_xrestore(&m->spin_lock, old_itr_status);
 
+	if (can_lock)
+		lock_prof_mutex_acquired(m, fname, lineno, false, false, 0, 0);
+
 	return can_lock;
 }
 
@@ -438,6 +550,7 @@ static TEE_Result __condvar_wait_timeout(struct condvar *cv, struct mutex *m,
 	short new_state = 0;
 
 	mutex_unlock_check(m);
+	lock_prof_mutex_released(m);
 
 	/* Link this condvar to this mutex until reinitialized */
 	old_itr_status = cpu_spin_lock_xsave(&cv->spin_lock);
@@ -473,9 +586,9 @@ static TEE_Result __condvar_wait_timeout(struct condvar *cv, struct mutex *m,
 	res = wq_wait_final(&m->wq, &wqe, timeout_ms, m, fname, lineno);
 
 	if (old_state > 0)
-		mutex_read_lock(m);
+		__mutex_read_lock(m, fname, lineno);
 	else
-		mutex_lock(m);
+		__mutex_lock(m, fname, lineno);
 
 	return res;
 }
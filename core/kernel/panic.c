@@ -9,6 +9,7 @@
 #include <kernel/misc.h>
 #include <kernel/panic.h>
 #include <kernel/thread.h>
+#include <kernel/trace_ext.h>
 #include <kernel/unwind.h>
 #include <trace.h>
 
@@ -67,6 +68,9 @@ void __do_panic(const char *file __maybe_unused,
 	/* disable preemption */
 	(void)thread_mask_exceptions(THREAD_EXCP_ALL);
 
+	/* Write pending trace lines and don't buffer any more */
+	trace_ext_panic_flush();
+
 	/* trace: Panic ['panic-string-message' ]at FILE:LINE [<FUNCTION>]" */
 	if (!file && !func && !msg)
 		EMSG_RAW("Panic");
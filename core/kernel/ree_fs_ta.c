@@ -39,10 +39,15 @@
 #include <crypto/crypto.h>
 #include <fault_mitigation.h>
 #include <initcall.h>
+#include <kernel/panic.h>
+#include <kernel/ree_fs_ta.h>
+#include <kernel/refcount.h>
+#include <kernel/spinlock.h>
 #include <kernel/thread.h>
 #include <kernel/ts_store.h>
 #include <kernel/user_access.h>
 #include <mm/core_memprot.h>
+#include <mm/file.h>
 #include <mm/mobj.h>
 #include <mm/phys_mem.h>
 #include <mm/tee_mm.h>
@@ -50,6 +55,7 @@
 #include <signed_hdr.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/queue.h>
 #include <tee/tee_pobj.h>
 #include <tee/tee_ta_enc_manager.h>
 #include <tee/uuid.h>
@@ -83,6 +89,56 @@ static const char ta_ver_db[] = "ta_ver.db";
 static const char subkey_ver_db[] = "subkey_ver.db";
 static struct mutex ver_db_mutex = MUTEX_INITIALIZER;
 
+/*
+ * The TA binary is read in chunks of this size, each chunk is decrypted
+ * or copied to secure memory and then hashed while still in the data
+ * cache. Chunks going via a temporary buffer are limited to a page to
+ * go easy on the heap.
+ */
+#define READ_CHUNK_SIZE		(16 * 1024U)
+#define READ_BUF_SIZE		SMALL_PAGE_SIZE
+
+#ifdef CFG_WITH_STATS
+static struct ree_fs_ta_load_stats load_stats;
+static unsigned int load_stats_lock = SPINLOCK_UNLOCK;
+
+static uint64_t load_stats_now(void)
+{
+	return barrier_read_counter_timer();
+}
+
+static void load_stats_add(const struct ree_fs_ta_load_stats *s)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&load_stats_lock);
+
+	load_stats.loads += s->loads;
+	load_stats.cache_hits += s->cache_hits;
+	load_stats.bytes += s->bytes;
+	load_stats.rpc_ticks += s->rpc_ticks;
+	load_stats.verify_ticks += s->verify_ticks;
+	load_stats.read_ticks += s->read_ticks;
+	cpu_spin_unlock_xrestore(&load_stats_lock, exceptions);
+}
+
+void ree_fs_ta_get_load_stats(struct ree_fs_ta_load_stats *stats)
+{
+	uint32_t exceptions = cpu_spin_lock_xsave(&load_stats_lock);
+
+	*stats = load_stats;
+	load_stats = (struct ree_fs_ta_load_stats){ };
+	cpu_spin_unlock_xrestore(&load_stats_lock, exceptions);
+}
+#else
+static uint64_t load_stats_now(void)
+{
+	return 0;
+}
+
+static void load_stats_add(const struct ree_fs_ta_load_stats *s __unused)
+{
+}
+#endif
+
 static TEE_Result check_update_version(const char *db_name,
 				       const uint8_t uuid[sizeof(TEE_UUID)],
 				       uint32_t version)
@@ -257,15 +313,20 @@ static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 	uint32_t max_depth = UINT32_MAX;
 	struct ftmn ftmn = { };
 	unsigned int incr0_count = 0;
+	struct ree_fs_ta_load_stats stats = { .loads = 1 };
+	uint64_t t = 0;
 
 	handle = calloc(1, sizeof(*handle));
 	if (!handle)
 		return TEE_ERROR_OUT_OF_MEMORY;
 
 	/* Request TA from tee-supplicant */
+	t = load_stats_now();
 	res = rpc_load(uuid, &ta, &ta_size, &mobj);
 	if (res != TEE_SUCCESS)
 		goto error;
+	stats.rpc_ticks = load_stats_now() - t;
+	t += stats.rpc_ticks;
 
 	/* Make secure copy of signed header */
 	shdr = shdr_alloc_and_copy(0, ta, ta_size);
@@ -484,6 +545,8 @@ static TEE_Result ree_fs_ta_open(const TEE_UUID *uuid,
 	handle->shdr = shdr;
 	handle->mobj = mobj;
 	*h = (struct ts_store_handle *)handle;
+	stats.verify_ticks = load_stats_now() - t;
+	load_stats_add(&stats);
 	FTMN_CALLEE_DONE_CHECK(&ftmn, FTMN_INCR1,
 			       FTMN_STEP_COUNT(incr0_count), TEE_SUCCESS);
 	return TEE_SUCCESS;
@@ -554,37 +617,39 @@ static TEE_Result ree_fs_ta_read(struct ts_store_handle *h, void *data_core,
 {
 	struct ree_fs_ta_handle *handle = (struct ree_fs_ta_handle *)h;
 	uint8_t *src = (uint8_t *)handle->nw_ta + handle->offs;
-	size_t bb_len = MIN(1024U, len);
-	size_t next_offs = 0;
+	struct ree_fs_ta_load_stats stats = { .bytes = len };
+	size_t chunk_len = MIN(READ_CHUNK_SIZE, len);
+	uint64_t t = load_stats_now();
 	TEE_Result res = TEE_SUCCESS;
+	size_t next_offs = 0;
 	size_t num_bytes = 0;
-	size_t dst_len = 0;
-	void *dst = NULL;
-	void *bb = NULL;
-
+	uint8_t *dst = NULL;
+	void *buf = NULL;
 
 	if (ADD_OVERFLOW(handle->offs, len, &next_offs) ||
 	    next_offs > handle->nw_ta_size)
 		return TEE_ERROR_BAD_PARAMETERS;
 
-	if (data_core) {
-		dst = data_core;
-		dst_len = len;
-	} else {
-		bb = bb_alloc(bb_len);
-		if (!bb)
+	/*
+	 * With @data_core the binary is decrypted or copied directly to
+	 * its destination, else a chunk sized buffer is needed as the
+	 * data must be hashed from secure memory before it's copied to
+	 * user space, if at all.
+	 */
+	if (!data_core) {
+		chunk_len = MIN(READ_BUF_SIZE, len);
+		buf = malloc(chunk_len);
+		if (!buf)
 			return TEE_ERROR_OUT_OF_MEMORY;
-		dst = bb;
-		dst_len = bb_len;
 	}
 
-	/*
-	 * This loop will only run once if data_core is non-NULL, but as
-	 * many times as needed if the bounce buffer bb is used. That's why
-	 * dst doesn't need to be updated in the loop.
-	 */
 	while (num_bytes < len) {
-		size_t n = MIN(dst_len, len - num_bytes);
+		size_t n = MIN(chunk_len, len - num_bytes);
+
+		if (data_core)
+			dst = (uint8_t *)data_core + num_bytes;
+		else
+			dst = buf;
 
 		if (handle->shdr->img_type == SHDR_ENCRYPTED_TA) {
 			res = tee_ta_decrypt_update(handle->enc_ctx, dst,
@@ -641,7 +706,9 @@ static TEE_Result ree_fs_ta_read(struct ts_store_handle *h, void *data_core,
 						   handle->bs_hdr->ta_version);
 	}
 out:
-	bb_free(bb, bb_len);
+	free(buf);
+	stats.read_ticks = load_stats_now() - t;
+	load_stats_add(&stats);
 	return res;
 }
 
@@ -677,69 +744,285 @@ REGISTER_TA_STORE(9) = {
  * The whole TA/library is read into a temporary buffer during .open(). This
  * allows the binary to be authenticated before any data is read and processed
  * by the upper layer (ELF loader).
+ *
+ * With CFG_REE_FS_TA_CACHE=y the authenticated binaries are kept in a
+ * least recently used cache when closed. The cache is keyed on the UUID
+ * and the signed hash of the binary, so once the signed header of a TA
+ * opened again has been loaded and verified, an unchanged binary is served
+ * from the cache without being decrypted and hashed once more. An updated
+ * TA has another hash and is loaded as usual. The cache is flushed when TA
+ * memory runs out.
  */
 
-struct buf_ree_fs_ta_handle {
-	struct ts_store_handle *h; /* Note: a REE FS TA store handle */
-	size_t ta_size;
+/*
+ * struct buf_ta_img - An authenticated TA binary in secure memory
+ * @uuid:	UUID of the TA
+ * @mm:		Secure memory holding the binary
+ * @buf:	Virtual address of @mm
+ * @size:	Size of the binary
+ * @tag:	Tag (hash) of the binary
+ * @tag_len:	Length of @tag
+ * @f:		File of the binary, referenced while the binary is cached to
+ *		keep the read-only pages shared by TA instances
+ * @cached:	True while in the cache
+ * @refc:	Reference counter, one for each open handle and one for the
+ *		cache
+ * @link:	Link in the cache, most recently used first
+ */
+struct buf_ta_img {
+	TEE_UUID uuid;
 	tee_mm_entry_t *mm;
 	uint8_t *buf;
-	size_t offs;
+	size_t size;
 	uint8_t *tag;
 	unsigned int tag_len;
+	struct file *f;
+	bool cached;
+	struct refcount refc;
+	TAILQ_ENTRY(buf_ta_img) link;
 };
 
-static TEE_Result buf_ta_open(const TEE_UUID *uuid,
-			      struct ts_store_handle **h)
+struct buf_ree_fs_ta_handle {
+	struct buf_ta_img *img;
+	size_t offs;
+};
+
+static void buf_ta_img_put(struct buf_ta_img *img)
 {
-	struct buf_ree_fs_ta_handle *handle = NULL;
+	if (img && refcount_dec(&img->refc)) {
+		file_put(img->f);
+		tee_mm_free(img->mm);
+		free(img->tag);
+		free(img);
+	}
+}
+
+#ifdef CFG_REE_FS_TA_CACHE
+static struct mutex ta_cache_mu = MUTEX_INITIALIZER;
+static TAILQ_HEAD(buf_ta_img_head, buf_ta_img) ta_cache_head =
+	TAILQ_HEAD_INITIALIZER(ta_cache_head);
+static size_t ta_cache_bytes;
+
+static bool ta_img_matches(struct buf_ta_img *img, const TEE_UUID *uuid,
+			   const uint8_t *tag, unsigned int tag_len)
+{
+	return !memcmp(&img->uuid, uuid, sizeof(*uuid)) &&
+	       img->tag_len == tag_len && !memcmp(img->tag, tag, tag_len);
+}
+
+static struct buf_ta_img *ta_cache_get(const TEE_UUID *uuid,
+				       const uint8_t *tag,
+				       unsigned int tag_len)
+{
+	struct buf_ta_img *img = NULL;
+
+	mutex_lock(&ta_cache_mu);
+	TAILQ_FOREACH(img, &ta_cache_head, link) {
+		if (ta_img_matches(img, uuid, tag, tag_len)) {
+			/* The cache holds a reference so this can't fail */
+			if (!refcount_inc(&img->refc))
+				panic();
+			TAILQ_REMOVE(&ta_cache_head, img, link);
+			TAILQ_INSERT_HEAD(&ta_cache_head, img, link);
+			break;
+		}
+	}
+	mutex_unlock(&ta_cache_mu);
+
+	return img;
+}
+
+/*
+ * Evicts the least recently used binaries until at most @max_bytes
+ * remain in the cache. Returns true if any binary was evicted.
+ */
+static bool ta_cache_shrink(size_t max_bytes)
+{
+	struct buf_ta_img_head evicted = TAILQ_HEAD_INITIALIZER(evicted);
+	struct buf_ta_img *img = NULL;
+	bool ret = false;
+
+	mutex_lock(&ta_cache_mu);
+	while (ta_cache_bytes > max_bytes) {
+		img = TAILQ_LAST(&ta_cache_head, buf_ta_img_head);
+		TAILQ_REMOVE(&ta_cache_head, img, link);
+		ta_cache_bytes -= img->size;
+		img->cached = false;
+		TAILQ_INSERT_TAIL(&evicted, img, link);
+	}
+	mutex_unlock(&ta_cache_mu);
+
+	/* Freeing takes other locks, do it with @ta_cache_mu released */
+	while (!TAILQ_EMPTY(&evicted)) {
+		img = TAILQ_FIRST(&evicted);
+		TAILQ_REMOVE(&evicted, img, link);
+		buf_ta_img_put(img);
+		ret = true;
+	}
+
+	return ret;
+}
+
+bool ree_fs_ta_cache_flush(void)
+{
+	return ta_cache_shrink(0);
+}
+DECLARE_PHYS_MEM_RECLAIMER(ree_fs_ta_cache_flush);
+
+static void ta_cache_add(struct buf_ta_img *img)
+{
+	struct buf_ta_img *stale = NULL;
+	struct buf_ta_img *i = NULL;
+	bool dup = false;
+
+	if (img->size > CFG_REE_FS_TA_CACHE_SIZE)
+		return;
+
+	/* Make room first, @img is inserted as most recently used */
+	ta_cache_shrink(CFG_REE_FS_TA_CACHE_SIZE - img->size);
+
+	mutex_lock(&ta_cache_mu);
+	TAILQ_FOREACH(i, &ta_cache_head, link) {
+		if (memcmp(&i->uuid, &img->uuid, sizeof(img->uuid)))
+			continue;
+		/* Another thread may have loaded the same TA concurrently */
+		if (ta_img_matches(i, &img->uuid, img->tag, img->tag_len))
+			dup = true;
+		else
+			stale = i;
+		break;
+	}
+	/* Drop the binary the TA was updated from */
+	if (stale) {
+		TAILQ_REMOVE(&ta_cache_head, stale, link);
+		ta_cache_bytes -= stale->size;
+		stale->cached = false;
+	}
+	if (!dup && refcount_inc(&img->refc)) {
+		TAILQ_INSERT_HEAD(&ta_cache_head, img, link);
+		ta_cache_bytes += img->size;
+		img->cached = true;
+	}
+	mutex_unlock(&ta_cache_mu);
+
+	buf_ta_img_put(stale);
+}
+
+/*
+ * Keeps the file of a cached binary, and with that the read-only pages
+ * shared by the TA instances, for as long as the binary is cached. The
+ * file is created by ldelf once the binary is opened so this is done when
+ * the binary is closed.
+ */
+static void ta_cache_keep_file(struct buf_ta_img *img)
+{
+	mutex_lock(&ta_cache_mu);
+	if (img->cached && !img->f)
+		img->f = file_get_by_tag(img->tag, img->tag_len);
+	mutex_unlock(&ta_cache_mu);
+}
+
+#else
+static struct buf_ta_img *ta_cache_get(const TEE_UUID *uuid __unused,
+				       const uint8_t *tag __unused,
+				       unsigned int tag_len __unused)
+{
+	return NULL;
+}
+
+static void ta_cache_add(struct buf_ta_img *img __unused)
+{
+}
+
+static void ta_cache_keep_file(struct buf_ta_img *img __unused)
+{
+}
+#endif
+
+static tee_mm_entry_t *ta_img_alloc(size_t size)
+{
+	tee_mm_entry_t *mm = phys_mem_ta_alloc(size);
+
+	/* Have the caches give their memory back and try again */
+	if (!mm && phys_mem_reclaim())
+		mm = phys_mem_ta_alloc(size);
+
+	return mm;
+}
+
+/*
+ * Loads and verifies the signed header of the TA, then serves the binary
+ * from the cache if it's there or loads all of it.
+ */
+static TEE_Result buf_ta_img_load(const TEE_UUID *uuid,
+				  struct buf_ta_img **img_ret)
+{
+	struct ts_store_handle *h = NULL;
+	struct buf_ta_img *cached = NULL;
+	struct buf_ta_img *img = NULL;
 	struct ftmn ftmn = { };
 	TEE_Result res = TEE_SUCCESS;
 
-	handle = calloc(1, sizeof(*handle));
-	if (!handle)
+	img = calloc(1, sizeof(*img));
+	if (!img)
 		return TEE_ERROR_OUT_OF_MEMORY;
+	img->uuid = *uuid;
+	refcount_set(&img->refc, 1);
+
 	FTMN_PUSH_LINKED_CALL(&ftmn, FTMN_FUNC_HASH("ree_fs_ta_open"));
-	res = ree_fs_ta_open(uuid, &handle->h);
+	res = ree_fs_ta_open(uuid, &h);
 	if (!res)
 		FTMN_SET_CHECK_RES_FROM_CALL(&ftmn, FTMN_INCR0, res);
 	FTMN_POP_LINKED_CALL(&ftmn);
 	if (res)
-		goto err_free_handle;
+		goto err_free_img;
 	ftmn_checkpoint(&ftmn, FTMN_INCR1);
 
-	res = ree_fs_ta_get_size(handle->h, &handle->ta_size);
+	res = ree_fs_ta_get_size(h, &img->size);
 	if (res)
 		goto err;
 
-	res = ree_fs_ta_get_tag(handle->h, NULL, &handle->tag_len);
+	res = ree_fs_ta_get_tag(h, NULL, &img->tag_len);
 	if (res != TEE_ERROR_SHORT_BUFFER) {
 		res = TEE_ERROR_GENERIC;
 		goto err;
 	}
-	handle->tag = malloc(handle->tag_len);
-	if (!handle->tag) {
+	img->tag = malloc(img->tag_len);
+	if (!img->tag) {
 		res = TEE_ERROR_OUT_OF_MEMORY;
 		goto err;
 	}
-	res = ree_fs_ta_get_tag(handle->h, handle->tag, &handle->tag_len);
+	res = ree_fs_ta_get_tag(h, img->tag, &img->tag_len);
 	if (res)
 		goto err;
 
-	handle->mm = phys_mem_ta_alloc(handle->ta_size);
-	if (!handle->mm) {
+	cached = ta_cache_get(uuid, img->tag, img->tag_len);
+	if (cached) {
+		struct ree_fs_ta_load_stats stats = { .cache_hits = 1 };
+
+		load_stats_add(&stats);
+		ree_fs_ta_close(h);
+		free(img->tag);
+		free(img);
+		*img_ret = cached;
+		return ftmn_return_res(&ftmn, FTMN_STEP_COUNT(1, 1),
+				       TEE_SUCCESS);
+	}
+
+	img->mm = ta_img_alloc(img->size);
+	if (!img->mm) {
 		res = TEE_ERROR_OUT_OF_MEMORY;
 		goto err;
 	}
-	handle->buf = phys_to_virt(tee_mm_get_smem(handle->mm),
-				   MEM_AREA_SEC_RAM_OVERALL, handle->ta_size);
-	if (!handle->buf) {
+	img->buf = phys_to_virt(tee_mm_get_smem(img->mm),
+				MEM_AREA_SEC_RAM_OVERALL, img->size);
+	if (!img->buf) {
 		res = TEE_ERROR_OUT_OF_MEMORY;
 		goto err;
 	}
 
 	FTMN_PUSH_LINKED_CALL(&ftmn, FTMN_FUNC_HASH("check_digest"));
-	res = ree_fs_ta_read(handle->h, handle->buf, NULL, handle->ta_size);
+	res = ree_fs_ta_read(h, img->buf, NULL, img->size);
 	if (!res)
 		FTMN_SET_CHECK_RES_FROM_CALL(&ftmn, FTMN_INCR0, res);
 	FTMN_POP_LINKED_CALL(&ftmn);
@@ -747,25 +1030,46 @@ static TEE_Result buf_ta_open(const TEE_UUID *uuid,
 		goto err;
 	ftmn_checkpoint(&ftmn, FTMN_INCR1);
 
-	*h = (struct ts_store_handle *)handle;
-	ree_fs_ta_close(handle->h);
+	ta_cache_add(img);
+	*img_ret = img;
+	ree_fs_ta_close(h);
 	return ftmn_return_res(&ftmn, FTMN_STEP_COUNT(2, 2), TEE_SUCCESS);
 
 err:
-	ree_fs_ta_close(handle->h);
-	tee_mm_free(handle->mm);
-	free(handle->tag);
-err_free_handle:
-	free(handle);
+	ree_fs_ta_close(h);
+	tee_mm_free(img->mm);
+	free(img->tag);
+err_free_img:
+	free(img);
 	return res;
 }
 
+static TEE_Result buf_ta_open(const TEE_UUID *uuid,
+			      struct ts_store_handle **h)
+{
+	struct buf_ree_fs_ta_handle *handle = NULL;
+	TEE_Result res = TEE_SUCCESS;
+
+	handle = calloc(1, sizeof(*handle));
+	if (!handle)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	res = buf_ta_img_load(uuid, &handle->img);
+	if (res) {
+		free(handle);
+		return res;
+	}
+
+	*h = (struct ts_store_handle *)handle;
+	return TEE_SUCCESS;
+}
+
 static TEE_Result buf_ta_get_size(const struct ts_store_handle *h,
 				  size_t *size)
 {
 	struct buf_ree_fs_ta_handle *handle = (struct buf_ree_fs_ta_handle *)h;
 
-	*size = handle->ta_size;
+	*size = handle->img->size;
 	return TEE_SUCCESS;
 }
 
@@ -773,12 +1077,12 @@ static TEE_Result buf_ta_read(struct ts_store_handle *h, void *data_core,
 			      void *data_user, size_t len)
 {
 	struct buf_ree_fs_ta_handle *handle = (struct buf_ree_fs_ta_handle *)h;
-	uint8_t *src = handle->buf + handle->offs;
+	uint8_t *src = handle->img->buf + handle->offs;
 	TEE_Result res = TEE_SUCCESS;
 	size_t next_offs = 0;
 
 	if (ADD_OVERFLOW(handle->offs, len, &next_offs) ||
-	    next_offs > handle->ta_size)
+	    next_offs > handle->img->size)
 		return TEE_ERROR_BAD_PARAMETERS;
 
 	if (data_core)
@@ -797,11 +1101,11 @@ static TEE_Result buf_ta_get_tag(const struct ts_store_handle *h,
 {
 	struct buf_ree_fs_ta_handle *handle = (struct buf_ree_fs_ta_handle *)h;
 
-	*tag_len = handle->tag_len;
-	if (!tag || *tag_len < handle->tag_len)
+	*tag_len = handle->img->tag_len;
+	if (!tag || *tag_len < handle->img->tag_len)
 		return TEE_ERROR_SHORT_BUFFER;
 
-	memcpy(tag, handle->tag, handle->tag_len);
+	memcpy(tag, handle->img->tag, handle->img->tag_len);
 
 	return TEE_SUCCESS;
 }
@@ -812,8 +1116,8 @@ static void buf_ta_close(struct ts_store_handle *h)
 
 	if (!handle)
 		return;
-	tee_mm_free(handle->mm);
-	free(handle->tag);
+	ta_cache_keep_file(handle->img);
+	buf_ta_img_put(handle->img);
 	free(handle);
 }
 
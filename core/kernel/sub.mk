@@ -9,6 +9,7 @@ srcs-$(CFG_DT) += dt_driver.c
 srcs-y += boot.c
 srcs-y += pm.c
 srcs-y += handle.c
+srcs-y += hash_set.c
 srcs-y += interrupt.c
 ifeq ($(CFG_WITH_USER_TA),y)
 srcs-y += ldelf_loader.c
@@ -38,6 +39,7 @@ srcs-y += initcall.c
 srcs-$(CFG_WITH_USER_TA) += user_access.c
 srcs-y += mutex.c
 srcs-$(CFG_LOCKDEP) += mutex_lockdep.c
+srcs-$(CFG_CORE_LOCK_PROF) += lock_prof.c
 srcs-y += wait_queue.c
 srcs-y += notif.c
 srcs-$(_CFG_CORE_ASYNC_NOTIF_DEFAULT_IMPL) += notif_default.c
@@ -6,6 +6,8 @@
  */
 
 #include <assert.h>
+#include <atomic.h>
+#include <kernel/hash_set.h>
 #include <kernel/mutex.h>
 #include <kernel/panic.h>
 #include <kernel/pseudo_ta.h>
@@ -52,6 +54,13 @@ struct mutex tee_ta_mutex = MUTEX_INITIALIZER;
 struct condvar tee_ta_init_cv = CONDVAR_INITIALIZER;
 struct tee_ta_ctx_head tee_ctxes = TAILQ_HEAD_INITIALIZER(tee_ctxes);
 
+/*
+ * Open sessions are also kept in a hash set keyed on the list of open
+ * sessions they belong to and their id, so finding a session doesn't
+ * require traversing the list. Protected by tee_ta_mutex.
+ */
+static struct hash_set sess_set = HASH_SET_INITIALIZER(sess_set);
+
 #ifndef CFG_CONCURRENT_SINGLE_INSTANCE_TA
 static struct condvar tee_ta_cv = CONDVAR_INITIALIZER;
 static short int tee_ta_single_instance_thread = THREAD_ID_INVALID;
@@ -74,36 +83,47 @@ static bool has_single_instance_lock(void)
 #else
 static void lock_single_instance(void)
 {
-	/* Requires tee_ta_mutex to be held */
-	if (tee_ta_single_instance_thread != thread_get_id()) {
+	short int id = thread_get_id();
+
+	mutex_lock(&tee_ta_mutex);
+	if (tee_ta_single_instance_thread != id) {
 		/* Wait until the single-instance lock is available. */
 		while (tee_ta_single_instance_thread != THREAD_ID_INVALID)
 			condvar_wait(&tee_ta_cv, &tee_ta_mutex);
 
-		tee_ta_single_instance_thread = thread_get_id();
+		atomic_store_short(&tee_ta_single_instance_thread, id);
 		assert(tee_ta_single_instance_count == 0);
 	}
 
 	tee_ta_single_instance_count++;
+	mutex_unlock(&tee_ta_mutex);
 }
 
 static void unlock_single_instance(void)
 {
-	/* Requires tee_ta_mutex to be held */
+	mutex_lock(&tee_ta_mutex);
 	assert(tee_ta_single_instance_thread == thread_get_id());
 	assert(tee_ta_single_instance_count > 0);
 
 	tee_ta_single_instance_count--;
 	if (tee_ta_single_instance_count == 0) {
-		tee_ta_single_instance_thread = THREAD_ID_INVALID;
+		atomic_store_short(&tee_ta_single_instance_thread,
+				   THREAD_ID_INVALID);
 		condvar_signal(&tee_ta_cv);
 	}
+	mutex_unlock(&tee_ta_mutex);
 }
 
 static bool has_single_instance_lock(void)
 {
-	/* Requires tee_ta_mutex to be held */
-	return tee_ta_single_instance_thread == thread_get_id();
+	/*
+	 * Only the thread holding the single-instance lock can store its
+	 * own id here, and only that thread can clear it again. So the
+	 * answer can't change under our feet and tee_ta_mutex isn't
+	 * needed.
+	 */
+	return atomic_load_short(&tee_ta_single_instance_thread) ==
+	       thread_get_id();
 }
 #endif
 
@@ -124,6 +144,11 @@ static struct tee_ta_ctx *ts_to_ta_ctx(struct ts_ctx *ctx)
 	panic("bad context");
 }
 
+/*
+ * The busy state of a context is protected by the busy_mu of the context
+ * alone, so invocations of different TAs don't contend on a shared lock.
+ * The single-instance lock, if used, is always taken before busy_mu.
+ */
 static bool tee_ta_try_set_busy(struct tee_ta_ctx *ctx)
 {
 	bool rc = true;
@@ -131,35 +156,36 @@ static bool tee_ta_try_set_busy(struct tee_ta_ctx *ctx)
 	if (ctx->flags & TA_FLAG_CONCURRENT)
 		return true;
 
-	mutex_lock(&tee_ta_mutex);
-
 	if (ctx->flags & TA_FLAG_SINGLE_INSTANCE)
 		lock_single_instance();
 
+	mutex_lock(&ctx->busy_mu);
+
 	if (has_single_instance_lock()) {
-		if (ctx->busy) {
-			/*
-			 * We're holding the single-instance lock and the
-			 * TA is busy, as waiting now would only cause a
-			 * dead-lock, we release the lock and return false.
-			 */
+		/*
+		 * We're holding the single-instance lock and if the TA is
+		 * busy, waiting now would only cause a dead-lock so we
+		 * return false instead.
+		 */
+		if (ctx->busy)
 			rc = false;
-			if (ctx->flags & TA_FLAG_SINGLE_INSTANCE)
-				unlock_single_instance();
-		}
 	} else {
 		/*
 		 * We're not holding the single-instance lock, we're free to
 		 * wait for the TA to become available.
 		 */
 		while (ctx->busy)
-			condvar_wait(&ctx->busy_cv, &tee_ta_mutex);
+			condvar_wait(&ctx->busy_cv, &ctx->busy_mu);
 	}
 
 	/* Either it's already true or we should set it to true */
 	ctx->busy = true;
 
-	mutex_unlock(&tee_ta_mutex);
+	mutex_unlock(&ctx->busy_mu);
+
+	if (!rc && (ctx->flags & TA_FLAG_SINGLE_INSTANCE))
+		unlock_single_instance();
+
 	return rc;
 }
 
@@ -174,16 +200,14 @@ static void tee_ta_clear_busy(struct tee_ta_ctx *ctx)
 	if (ctx->flags & TA_FLAG_CONCURRENT)
 		return;
 
-	mutex_lock(&tee_ta_mutex);
-
+	mutex_lock(&ctx->busy_mu);
 	assert(ctx->busy);
 	ctx->busy = false;
 	condvar_signal(&ctx->busy_cv);
+	mutex_unlock(&ctx->busy_mu);
 
 	if (ctx->flags & TA_FLAG_SINGLE_INSTANCE)
 		unlock_single_instance();
-
-	mutex_unlock(&tee_ta_mutex);
 }
 
 static void dec_session_ref_count(struct tee_ta_session *s)
@@ -207,20 +231,43 @@ void tee_ta_put_session(struct tee_ta_session *s)
 	mutex_unlock(&tee_ta_mutex);
 }
 
+static uint64_t sess_key(uint32_t id,
+			 struct tee_ta_session_head *open_sessions)
+{
+	return ((uint64_t)id << 32) ^ (vaddr_t)open_sessions;
+}
+
+/* Called with tee_ta_mutex held */
+static void sess_link(struct tee_ta_session *s,
+		      struct tee_ta_session_head *open_sessions)
+{
+	s->head = open_sessions;
+	TAILQ_INSERT_TAIL(open_sessions, s, link);
+	hash_set_add(&sess_set, &s->hash_link, sess_key(s->id, open_sessions));
+}
+
+/* Called with tee_ta_mutex held */
+static void sess_unlink(struct tee_ta_session *s,
+			struct tee_ta_session_head *open_sessions)
+{
+	assert(s->head == open_sessions);
+	TAILQ_REMOVE(open_sessions, s, link);
+	hash_set_remove(&sess_set, &s->hash_link);
+}
+
 static struct tee_ta_session *tee_ta_find_session_nolock(uint32_t id,
 			struct tee_ta_session_head *open_sessions)
 {
+	struct hash_set_elem *e = NULL;
 	struct tee_ta_session *s = NULL;
-	struct tee_ta_session *found = NULL;
 
-	TAILQ_FOREACH(s, open_sessions, link) {
-		if (s->id == id) {
-			found = s;
-			break;
-		}
+	HASH_SET_FOREACH_KEY(e, &sess_set, sess_key(id, open_sessions)) {
+		s = container_of(e, struct tee_ta_session, hash_link);
+		if (s->id == id && s->head == open_sessions)
+			return s;
 	}
 
-	return found;
+	return NULL;
 }
 
 struct tee_ta_session *tee_ta_find_session(uint32_t id,
@@ -290,7 +337,7 @@ static void tee_ta_unlink_session(struct tee_ta_session *s,
 	while (s->ref_count != 1)
 		condvar_wait(&s->refc_cv, &tee_ta_mutex);
 
-	TAILQ_REMOVE(open_sessions, s, link);
+	sess_unlink(s, open_sessions);
 
 	mutex_unlock(&tee_ta_mutex);
 }
@@ -326,6 +373,7 @@ static void destroy_context(struct tee_ta_ctx *ctx)
 	DMSG("Destroy TA ctx (0x%" PRIxVA ")",  (vaddr_t)ctx);
 
 	condvar_destroy(&ctx->busy_cv);
+	mutex_destroy(&ctx->busy_mu);
 	ctx->ts_ctx.ops->destroy(&ctx->ts_ctx);
 }
 
@@ -625,7 +673,7 @@ static TEE_Result tee_ta_init_session(TEE_ErrorOrigin *err,
 		goto err_mutex_unlock;
 	}
 
-	TAILQ_INSERT_TAIL(open_sessions, s, link);
+	sess_link(s, open_sessions);
 
 	/* Look for already loaded TA */
 	res = tee_ta_init_session_with_context(s, uuid);
@@ -664,7 +712,7 @@ out:
 	}
 
 	mutex_lock(&tee_ta_mutex);
-	TAILQ_REMOVE(open_sessions, s, link);
+	sess_unlink(s, open_sessions);
 err_mutex_unlock:
 	mutex_unlock(&tee_ta_mutex);
 	free(s);
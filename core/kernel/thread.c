@@ -15,6 +15,7 @@
 #include <kernel/spinlock.h>
 #include <kernel/thread.h>
 #include <kernel/thread_private.h>
+#include <kernel/trace_ext.h>
 #include <mm/mobj.h>
 #include <mm/page_alloc.h>
 #include <stdalign.h>
@@ -91,6 +92,18 @@ DECLARE_KEEP_PAGER(stack_tmp_stride);
 
 static unsigned int thread_global_lock __nex_bss = SPINLOCK_UNLOCK;
 
+/*
+ * Indexes of the threads in THREAD_STATE_FREE, used as a stack so that
+ * a free thread is found in constant time when allocating a thread for
+ * a standard call. Most recently freed threads are reused first as
+ * their stacks are more likely to still be cached. Protected by
+ * thread_global_lock.
+ */
+static short int thread_free_ids[CFG_NUM_THREADS];
+static size_t thread_free_count;
+static size_t thread_max_busy;
+static size_t thread_alloc_fail_count;
+
 static size_t stack_size_to_alloc_size(size_t stack_size)
 {
 	return ROUNDUP(stack_size + STACK_CANARY_SIZE + STACK_CHECK_EXTRA,
@@ -252,6 +265,64 @@ void thread_unlock_global(void)
 	cpu_spin_unlock(&thread_global_lock);
 }
 
+int thread_claim_free(void)
+{
+	size_t busy = 0;
+	int n = 0;
+
+	if (!thread_free_count) {
+		thread_alloc_fail_count++;
+		return THREAD_ID_INVALID;
+	}
+
+	n = thread_free_ids[--thread_free_count];
+	assert(threads[n].state == THREAD_STATE_FREE);
+	threads[n].state = THREAD_STATE_ACTIVE;
+
+	busy = thread_count - thread_free_count;
+	if (busy > thread_max_busy)
+		thread_max_busy = busy;
+
+	return n;
+}
+
+void __nostackcheck thread_set_free(int n)
+{
+	assert(n >= 0 && (size_t)n < thread_count);
+	assert(threads[n].state == THREAD_STATE_ACTIVE);
+	assert(thread_free_count < thread_count);
+
+	threads[n].state = THREAD_STATE_FREE;
+	thread_free_ids[thread_free_count++] = n;
+}
+
+bool thread_is_active(short int thread_id)
+{
+	if (thread_id < 0 || (size_t)thread_id >= thread_count)
+		return false;
+
+	return threads[thread_id].state == THREAD_STATE_ACTIVE;
+}
+
+void thread_get_stats(struct thread_stats *stats)
+{
+	uint32_t exceptions = thread_mask_exceptions(THREAD_EXCP_FOREIGN_INTR);
+
+	thread_lock_global();
+
+	stats->num_threads = thread_count;
+	stats->busy = thread_count - thread_free_count;
+	stats->max_busy = thread_max_busy;
+	stats->alloc_fail = thread_alloc_fail_count;
+
+	/* Peak and failure counters restart at each stats dump */
+	thread_max_busy = stats->busy;
+	thread_alloc_fail_count = 0;
+
+	thread_unlock_global();
+	thread_unmask_exceptions(exceptions);
+}
+
 static struct thread_core_local * __nostackcheck
 get_core_local(unsigned int pos)
 {
@@ -373,8 +444,8 @@ void thread_init_boot_thread(void)
 {
 	struct thread_core_local *l = thread_get_core_local();
 
-	l->curr_thread = 0;
-	threads[0].state = THREAD_STATE_ACTIVE;
+	l->curr_thread = thread_claim_free();
+	assert(l->curr_thread == 0);
 }
 
 void __nostackcheck thread_clr_boot_thread(void)
@@ -382,10 +453,10 @@ void __nostackcheck thread_clr_boot_thread(void)
 	struct thread_core_local *l = thread_get_core_local();
 
 	assert(l->curr_thread >= 0 && l->curr_thread < CFG_NUM_THREADS);
-	assert(threads[l->curr_thread].state == THREAD_STATE_ACTIVE);
-	threads[l->curr_thread].state = THREAD_STATE_FREE;
+	thread_set_free(l->curr_thread);
 	l->curr_thread = THREAD_ID_INVALID;
 	print_stack_limits();
+	trace_ext_boot_done();
 }
 
 void __nostackcheck *thread_get_tmp_sp(void)
@@ -602,6 +673,13 @@ void thread_init_threads(size_t count)
 
 	for (n = 0; n < thread_count; n++)
 		TAILQ_INIT(&threads[n].tsd.sess_stack);
+
+	/* Push in reverse order so that thread 0 is the first to be claimed */
+	thread_free_count = 0;
+	thread_max_busy = 0;
+	thread_alloc_fail_count = 0;
+	for (n = thread_count; n > 0; n--)
+		thread_free_ids[thread_free_count++] = n - 1;
 }
 
 #ifndef CFG_DYN_CONFIG
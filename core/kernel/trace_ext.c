@@ -2,14 +2,19 @@
 /*
  * Copyright (c) 2014, Linaro Limited
  */
+#include <assert.h>
 #include <stdbool.h>
+#include <string.h>
 #include <trace.h>
 #include <console.h>
 #include <kernel/misc.h>
 #include <kernel/spinlock.h>
 #include <kernel/thread.h>
+#include <kernel/trace_ext.h>
 #include <kernel/virtualization.h>
 #include <mm/core_mmu.h>
+#include <printk.h>
+#include <util.h>
 
 const char trace_ext_prefix[] = "TC";
 int trace_level __nex_data = TRACE_LEVEL;
@@ -19,6 +24,228 @@ void __weak plat_trace_ext_puts(const char *str __unused)
 {
 }
 
+#if defined(CFG_CORE_TRACE_RING)
+/*
+ * Each core adds its trace lines to a ring of its own with exceptions
+ * masked, so there's a single producer per ring which never waits for
+ * anything. The console is written by whichever core manages to take
+ * puts_lock, it drains the rings of all cores. A core that fails to take
+ * the lock leaves its lines to the current lock holder.
+ *
+ * In a thread serving a std call the lines are left in the ring until
+ * it's half full or the thread returns to normal world, to keep the
+ * console out of the latency of the call. During boot the lines are
+ * written right away so they aren't lost if the boot hangs.
+ *
+ * @head and @tail are free running byte counters, @head is only updated
+ * by the producer and @tail by the holder of puts_lock.
+ */
+#define RING_SIZE	CFG_CORE_TRACE_RING_SIZE
+
+static_assert(IS_POWER_OF_TWO(RING_SIZE));
+
+struct trace_ring {
+	uint32_t head;
+	uint32_t tail;
+	uint32_t reported_drops;
+	struct trace_ext_ring_stats stats;
+	char buf[RING_SIZE];
+};
+
+static struct trace_ring trace_rings[CFG_TEE_CORE_NB_CORE] __nex_bss;
+static bool trace_ring_bypass __nex_bss;
+static bool trace_ring_defer __nex_bss;
+
+static bool ring_put(struct trace_ring *r, const char *str)
+{
+	uint32_t head = r->head;
+	size_t len = strlen(str);
+	uint32_t used = 0;
+	size_t n = 0;
+
+	used = head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+	if (len > RING_SIZE - used) {
+		r->stats.dropped_lines++;
+		r->stats.dropped_bytes += len;
+		return false;
+	}
+
+	n = MIN(len, RING_SIZE - head % RING_SIZE);
+	memcpy(r->buf + head % RING_SIZE, str, n);
+	memcpy(r->buf, str + n, len - n);
+	__atomic_store_n(&r->head, head + len, __ATOMIC_RELEASE);
+
+	r->stats.lines++;
+	r->stats.max_used = MAX(r->stats.max_used, used + len);
+
+	return true;
+}
+
+static bool rings_are_empty(void)
+{
+	struct trace_ring *r = NULL;
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(trace_rings); n++) {
+		r = trace_rings + n;
+		if (__atomic_load_n(&r->head, __ATOMIC_ACQUIRE) != r->tail ||
+		    __atomic_load_n(&r->stats.dropped_lines,
+				    __ATOMIC_RELAXED) != r->reported_drops)
+			return false;
+	}
+
+	return true;
+}
+
+static void emit(const char *str)
+{
+	const char *p = NULL;
+
+	plat_trace_ext_puts(str);
+	for (p = str; *p; p++)
+		console_putc(*p);
+}
+
+/* Called with puts_lock held or when panicking */
+static void drain_rings(void)
+{
+	struct trace_ring *r = NULL;
+	char chunk[64] = { };
+	uint32_t drops = 0;
+	uint32_t head = 0;
+	uint32_t tail = 0;
+	size_t len = 0;
+	size_t n = 0;
+
+	console_flush();
+
+	for (n = 0; n < ARRAY_SIZE(trace_rings); n++) {
+		r = trace_rings + n;
+		head = __atomic_load_n(&r->head, __ATOMIC_ACQUIRE);
+		tail = r->tail;
+		while (tail != head) {
+			len = MIN(head - tail, sizeof(chunk) - 1);
+			len = MIN(len, RING_SIZE - tail % RING_SIZE);
+			memcpy(chunk, r->buf + tail % RING_SIZE, len);
+			chunk[len] = '\0';
+			emit(chunk);
+			tail += len;
+			__atomic_store_n(&r->tail, tail, __ATOMIC_RELEASE);
+		}
+
+		drops = __atomic_load_n(&r->stats.dropped_lines,
+					__ATOMIC_RELAXED);
+		if (drops != r->reported_drops) {
+			snprintk(chunk, sizeof(chunk),
+				 "*** %"PRIu32" lines dropped on core %zu\n",
+				 drops - r->reported_drops, n);
+			emit(chunk);
+			r->reported_drops = drops;
+		}
+	}
+
+	console_flush();
+}
+
+/*
+ * Each pass drains the rings up to where they were when it started, so a
+ * call writes at most DRAIN_PASSES times the size of all rings, even if
+ * other cores keep adding lines meanwhile.
+ */
+#define DRAIN_PASSES	2
+
+static void try_drain_rings(void)
+{
+	unsigned int n = 0;
+
+	for (n = 0; n < DRAIN_PASSES; n++) {
+		if (!cpu_spin_trylock(&puts_lock))
+			return;
+		drain_rings();
+		cpu_spin_unlock(&puts_lock);
+		/*
+		 * A core failing to take the lock just before it was
+		 * released relies on the lines being picked up here. Lines
+		 * still left after the last pass are written by the next
+		 * call, at the latest by trace_ext_drain() when returning
+		 * to normal world.
+		 */
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		if (rings_are_empty())
+			return;
+	}
+}
+
+/* Returns false if @str must be written directly to the console */
+static bool ring_puts(const char *str)
+{
+	struct trace_ring *r = NULL;
+	uint32_t used = 0;
+
+	if (__atomic_load_n(&trace_ring_bypass, __ATOMIC_RELAXED))
+		return false;
+
+	r = trace_rings + get_core_pos();
+	ring_put(r, str);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	used = r->head - __atomic_load_n(&r->tail, __ATOMIC_ACQUIRE);
+	if (!__atomic_load_n(&trace_ring_defer, __ATOMIC_RELAXED) ||
+	    thread_get_id_may_fail() == THREAD_ID_INVALID ||
+	    used >= RING_SIZE / 2)
+		try_drain_rings();
+
+	return true;
+}
+
+void trace_ext_drain(void)
+{
+	uint32_t exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+
+	if (!rings_are_empty())
+		try_drain_rings();
+
+	thread_unmask_exceptions(exceptions);
+}
+
+void trace_ext_boot_done(void)
+{
+	__atomic_store_n(&trace_ring_defer, true, __ATOMIC_RELAXED);
+	trace_ext_drain();
+}
+
+void trace_ext_panic_flush(void)
+{
+	uint32_t exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+
+	__atomic_store_n(&trace_ring_bypass, true, __ATOMIC_RELAXED);
+	/* Another core may hold puts_lock forever, drain regardless */
+	drain_rings();
+
+	thread_unmask_exceptions(exceptions);
+}
+
+TEE_Result trace_ext_get_ring_stats(size_t core_pos,
+				    struct trace_ext_ring_stats *stats)
+{
+	uint32_t exceptions = 0;
+
+	if (core_pos >= ARRAY_SIZE(trace_rings))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	exceptions = cpu_spin_lock_xsave(&puts_lock);
+	*stats = trace_rings[core_pos].stats;
+	cpu_spin_unlock_xrestore(&puts_lock, exceptions);
+
+	return TEE_SUCCESS;
+}
+#else
+static bool ring_puts(const char *str __unused)
+{
+	return false;
+}
+#endif /*CFG_CORE_TRACE_RING*/
+
 void trace_ext_puts(const char *str)
 {
 	uint32_t itr_status = thread_mask_exceptions(THREAD_EXCP_ALL);
@@ -26,6 +253,9 @@ void trace_ext_puts(const char *str)
 	bool was_contended = false;
 	const char *p;
 
+	if (mmu_enabled && ring_puts(str))
+		goto out;
+
 	if (mmu_enabled && !cpu_spin_trylock(&puts_lock)) {
 		was_contended = true;
 		cpu_spin_lock_no_dldetect(&puts_lock);
@@ -45,7 +275,7 @@ void trace_ext_puts(const char *str)
 
 	if (mmu_enabled)
 		cpu_spin_unlock(&puts_lock);
-
+out:
 	thread_unmask_exceptions(itr_status);
 }
 
@@ -390,8 +390,10 @@ static void release_utc_state(struct user_ta_ctx *utc)
 
 	/* Free cryp states created by this TA */
 	tee_svc_cryp_free_states(utc);
+	hash_set_destroy(&utc->cryp_state_set);
 	/* Close cryp objects opened by this TA */
 	tee_obj_close_all(utc);
+	hash_set_destroy(&utc->object_set);
 	/* Free emums created by this TA */
 	tee_svc_storage_close_all_enum(utc);
 }
@@ -488,8 +490,11 @@ TEE_Result tee_ta_init_user_ta_session(const TEE_UUID *uuid,
 
 	TAILQ_INIT(&utc->open_sessions);
 	TAILQ_INIT(&utc->cryp_states);
+	hash_set_init(&utc->cryp_state_set);
 	TAILQ_INIT(&utc->objects);
+	hash_set_init(&utc->object_set);
 	TAILQ_INIT(&utc->storage_enums);
+	mutex_init(&utc->ta_ctx.busy_mu);
 	condvar_init(&utc->ta_ctx.busy_cv);
 	utc->ta_ctx.ref_count = 1;
 
@@ -503,6 +508,7 @@ TEE_Result tee_ta_init_user_ta_session(const TEE_UUID *uuid,
 	res = vm_info_init(&utc->uctx, &utc->ta_ctx.ts_ctx);
 	if (res) {
 		condvar_destroy(&utc->ta_ctx.busy_cv);
+		mutex_destroy(&utc->ta_ctx.busy_mu);
 		free_utc(utc);
 		return res;
 	}
@@ -548,6 +554,7 @@ TEE_Result tee_ta_complete_user_ta_session(struct tee_ta_session *s)
 		s->ts_sess.ctx = NULL;
 		TAILQ_REMOVE(&tee_ctxes, &utc->ta_ctx, link);
 		condvar_destroy(&utc->ta_ctx.busy_cv);
+		mutex_destroy(&utc->ta_ctx.busy_mu);
 		free_utc(utc);
 	}
 
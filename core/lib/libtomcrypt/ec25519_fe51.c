@@ -0,0 +1,1108 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+
+/*
+ * Curve25519 (X25519) and Ed25519 with field elements represented as five
+ * 51-bit limbs held in 64-bit words, multiplied with 128-bit products.
+ * This replaces the tweetnacl_crypto_*() functions from
+ * src/pk/ec25519/tweetnacl.c, which uses sixteen 16-bit limbs and a
+ * generic double-and-add for every scalar multiplication.
+ *
+ * The group operations follow the "ref10" implementation by Bernstein et
+ * al.: extended twisted Edwards coordinates, a fixed-base comb using the
+ * precomputed multiples of the base point in ec25519_fe51_table.h for key
+ * generation and signing, and a sliding window double scalar
+ * multiplication for verification. X25519 uses the Montgomery ladder from
+ * RFC 7748, except for the public key computation which goes through the
+ * fixed-base comb and the birational map to the Montgomery curve.
+ *
+ * Everything involving secret data is constant time.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+#include <string_ext.h>
+#include <tomcrypt_private.h>
+
+typedef uint64_t fe[5];
+typedef unsigned __int128 uint128_t;
+
+#define MASK51		((UINT64_C(1) << 51) - 1)
+
+/* Projective (X:Y:Z) */
+struct ge_p2 {
+	fe X;
+	fe Y;
+	fe Z;
+};
+
+/* Extended (X:Y:Z:T) with XY = ZT */
+struct ge_p3 {
+	fe X;
+	fe Y;
+	fe Z;
+	fe T;
+};
+
+/* Completed ((X:Z),(Y:T)) */
+struct ge_p1p1 {
+	fe X;
+	fe Y;
+	fe Z;
+	fe T;
+};
+
+/* Affine (y + x, y - x, 2dxy) */
+struct ge_precomp {
+	fe yplusx;
+	fe yminusx;
+	fe xy2d;
+};
+
+/* Extended (Y + X, Y - X, Z, 2dT) */
+struct ge_cached {
+	fe YplusX;
+	fe YminusX;
+	fe Z;
+	fe T2d;
+};
+
+#include "ec25519_fe51_table.h"
+
+/* d = -121665 / 121666 */
+static const fe fe_d = {
+	0x34dca135978a3, 0x1a8283b156ebd, 0x5e7a26001c029,
+	0x739c663a03cbb, 0x52036cee2b6ff
+};
+
+static const fe fe_d2 = {
+	0x69b9426b2f159, 0x35050762add7a, 0x3cf44c0038052,
+	0x6738cc7407977, 0x2406d9dc56dff
+};
+
+/* sqrt(-1) */
+static const fe fe_sqrtm1 = {
+	0x61b274a0ea0b0, 0x0d5a5fc8f189d, 0x7ef5e9cbd0c60,
+	0x78595a6804c9e, 0x2b8324804fc1d
+};
+
+static uint64_t load64_le(const uint8_t *s)
+{
+	uint64_t r = 0;
+	int n = 0;
+
+	for (n = 7; n >= 0; n--)
+		r = (r << 8) | s[n];
+
+	return r;
+}
+
+static void store64_le(uint8_t *s, uint64_t v)
+{
+	int n = 0;
+
+	for (n = 0; n < 8; n++)
+		s[n] = v >> (8 * n);
+}
+
+static void fe_0(fe h)
+{
+	memset(h, 0, sizeof(fe));
+}
+
+static void fe_1(fe h)
+{
+	fe_0(h);
+	h[0] = 1;
+}
+
+static void fe_copy(fe h, const fe f)
+{
+	memcpy(h, f, sizeof(fe));
+}
+
+/*
+ * Propagates the carries so that each limb is below 2^51, except h[0]
+ * which may exceed it slightly.
+ */
+static void fe_carry(fe h)
+{
+	uint64_t c = 0;
+
+	c = h[0] >> 51;
+	h[0] &= MASK51;
+	h[1] += c;
+	c = h[1] >> 51;
+	h[1] &= MASK51;
+	h[2] += c;
+	c = h[2] >> 51;
+	h[2] &= MASK51;
+	h[3] += c;
+	c = h[3] >> 51;
+	h[3] &= MASK51;
+	h[4] += c;
+	c = h[4] >> 51;
+	h[4] &= MASK51;
+	h[0] += c * 19;
+}
+
+static void fe_add(fe h, const fe f, const fe g)
+{
+	int n = 0;
+
+	for (n = 0; n < 5; n++)
+		h[n] = f[n] + g[n];
+	fe_carry(h);
+}
+
+/* Adds 4p before subtracting to keep the limbs positive */
+static void fe_sub(fe h, const fe f, const fe g)
+{
+	h[0] = f[0] + 0x1fffffffffffb4 - g[0];
+	h[1] = f[1] + 0x1ffffffffffffc - g[1];
+	h[2] = f[2] + 0x1ffffffffffffc - g[2];
+	h[3] = f[3] + 0x1ffffffffffffc - g[3];
+	h[4] = f[4] + 0x1ffffffffffffc - g[4];
+	fe_carry(h);
+}
+
+static void fe_neg(fe h, const fe f)
+{
+	fe zero = { };
+
+	fe_sub(h, zero, f);
+}
+
+static void fe_reduce128(fe h, uint128_t r0, uint128_t r1, uint128_t r2,
+			 uint128_t r3, uint128_t r4)
+{
+	uint64_t c = 0;
+
+	r1 += (uint64_t)(r0 >> 51);
+	h[0] = (uint64_t)r0 & MASK51;
+	r2 += (uint64_t)(r1 >> 51);
+	h[1] = (uint64_t)r1 & MASK51;
+	r3 += (uint64_t)(r2 >> 51);
+	h[2] = (uint64_t)r2 & MASK51;
+	r4 += (uint64_t)(r3 >> 51);
+	h[3] = (uint64_t)r3 & MASK51;
+	c = (uint64_t)(r4 >> 51);
+	h[4] = (uint64_t)r4 & MASK51;
+	h[0] += c * 19;
+	h[1] += h[0] >> 51;
+	h[0] &= MASK51;
+}
+
+static void fe_mul(fe h, const fe f, const fe g)
+{
+	uint64_t g1_19 = g[1] * 19;
+	uint64_t g2_19 = g[2] * 19;
+	uint64_t g3_19 = g[3] * 19;
+	uint64_t g4_19 = g[4] * 19;
+	uint128_t r0 = 0;
+	uint128_t r1 = 0;
+	uint128_t r2 = 0;
+	uint128_t r3 = 0;
+	uint128_t r4 = 0;
+
+	r0 = (uint128_t)f[0] * g[0] + (uint128_t)f[1] * g4_19 +
+	     (uint128_t)f[2] * g3_19 + (uint128_t)f[3] * g2_19 +
+	     (uint128_t)f[4] * g1_19;
+	r1 = (uint128_t)f[0] * g[1] + (uint128_t)f[1] * g[0] +
+	     (uint128_t)f[2] * g4_19 + (uint128_t)f[3] * g3_19 +
+	     (uint128_t)f[4] * g2_19;
+	r2 = (uint128_t)f[0] * g[2] + (uint128_t)f[1] * g[1] +
+	     (uint128_t)f[2] * g[0] + (uint128_t)f[3] * g4_19 +
+	     (uint128_t)f[4] * g3_19;
+	r3 = (uint128_t)f[0] * g[3] + (uint128_t)f[1] * g[2] +
+	     (uint128_t)f[2] * g[1] + (uint128_t)f[3] * g[0] +
+	     (uint128_t)f[4] * g4_19;
+	r4 = (uint128_t)f[0] * g[4] + (uint128_t)f[1] * g[3] +
+	     (uint128_t)f[2] * g[2] + (uint128_t)f[3] * g[1] +
+	     (uint128_t)f[4] * g[0];
+
+	fe_reduce128(h, r0, r1, r2, r3, r4);
+}
+
+static void fe_sq(fe h, const fe f)
+{
+	uint64_t d0 = f[0] * 2;
+	uint64_t d1 = f[1] * 2;
+	uint64_t d2 = f[2] * 2;
+	uint64_t d3 = f[3] * 2;
+	uint64_t f3_19 = f[3] * 19;
+	uint64_t f4_19 = f[4] * 19;
+	uint128_t r0 = 0;
+	uint128_t r1 = 0;
+	uint128_t r2 = 0;
+	uint128_t r3 = 0;
+	uint128_t r4 = 0;
+
+	r0 = (uint128_t)f[0] * f[0] + (uint128_t)d1 * f4_19 +
+	     (uint128_t)d2 * f3_19;
+	r1 = (uint128_t)d0 * f[1] + (uint128_t)d2 * f4_19 +
+	     (uint128_t)f[3] * f3_19;
+	r2 = (uint128_t)d0 * f[2] + (uint128_t)f[1] * f[1] +
+	     (uint128_t)d3 * f4_19;
+	r3 = (uint128_t)d0 * f[3] + (uint128_t)d1 * f[2] +
+	     (uint128_t)f[4] * f4_19;
+	r4 = (uint128_t)d0 * f[4] + (uint128_t)d1 * f[3] +
+	     (uint128_t)f[2] * f[2];
+
+	fe_reduce128(h, r0, r1, r2, r3, r4);
+}
+
+/* h = f^(2^n) */
+static void fe_sq_n(fe h, const fe f, unsigned int n)
+{
+	fe_sq(h, f);
+	while (--n)
+		fe_sq(h, h);
+}
+
+static void fe_mul_small(fe h, const fe f, uint32_t n)
+{
+	fe_reduce128(h, (uint128_t)f[0] * n, (uint128_t)f[1] * n,
+		     (uint128_t)f[2] * n, (uint128_t)f[3] * n,
+		     (uint128_t)f[4] * n);
+}
+
+/* Computes z^(2^250 - 1) in @t1 and z^11 in @t0, shared by the exponents */
+static void fe_pow_2_250_1(fe t1, fe t0, const fe z)
+{
+	fe t2 = { };
+	fe t3 = { };
+
+	fe_sq(t0, z);			/* 2 */
+	fe_sq_n(t1, t0, 2);		/* 8 */
+	fe_mul(t1, z, t1);		/* 9 */
+	fe_mul(t0, t0, t1);		/* 11 */
+	fe_sq(t2, t0);			/* 22 */
+	fe_mul(t1, t1, t2);		/* 2^5 - 1 */
+	fe_sq_n(t2, t1, 5);
+	fe_mul(t1, t2, t1);		/* 2^10 - 1 */
+	fe_sq_n(t2, t1, 10);
+	fe_mul(t2, t2, t1);		/* 2^20 - 1 */
+	fe_sq_n(t3, t2, 20);
+	fe_mul(t2, t3, t2);		/* 2^40 - 1 */
+	fe_sq_n(t2, t2, 10);
+	fe_mul(t1, t2, t1);		/* 2^50 - 1 */
+	fe_sq_n(t2, t1, 50);
+	fe_mul(t2, t2, t1);		/* 2^100 - 1 */
+	fe_sq_n(t3, t2, 100);
+	fe_mul(t2, t3, t2);		/* 2^200 - 1 */
+	fe_sq_n(t2, t2, 50);
+	fe_mul(t1, t2, t1);		/* 2^250 - 1 */
+}
+
+/* h = z^(p - 2) = 1 / z */
+static void fe_invert(fe h, const fe z)
+{
+	fe t0 = { };
+	fe t1 = { };
+
+	fe_pow_2_250_1(t1, t0, z);
+	fe_sq_n(t1, t1, 5);		/* 2^255 - 2^5 */
+	fe_mul(h, t1, t0);		/* 2^255 - 21 */
+}
+
+/* h = z^((p - 5) / 8) */
+static void fe_pow22523(fe h, const fe z)
+{
+	fe t0 = { };
+	fe t1 = { };
+
+	fe_pow_2_250_1(t1, t0, z);
+	fe_sq_n(t1, t1, 2);		/* 2^252 - 4 */
+	fe_mul(h, t1, z);		/* 2^252 - 3 */
+}
+
+static void fe_frombytes(fe h, const uint8_t s[32])
+{
+	h[0] = load64_le(s) & MASK51;
+	h[1] = (load64_le(s + 6) >> 3) & MASK51;
+	h[2] = (load64_le(s + 12) >> 6) & MASK51;
+	h[3] = (load64_le(s + 19) >> 1) & MASK51;
+	h[4] = (load64_le(s + 24) >> 12) & MASK51;
+}
+
+static void fe_tobytes(uint8_t s[32], const fe f)
+{
+	uint64_t q = 0;
+	fe h = { };
+
+	fe_copy(h, f);
+	fe_carry(h);
+	fe_carry(h);
+
+	/* h < 2^255, subtract p once if h >= p */
+	q = (h[0] + 19) >> 51;
+	q = (h[1] + q) >> 51;
+	q = (h[2] + q) >> 51;
+	q = (h[3] + q) >> 51;
+	q = (h[4] + q) >> 51;
+
+	h[0] += 19 * q;
+	h[1] += h[0] >> 51;
+	h[0] &= MASK51;
+	h[2] += h[1] >> 51;
+	h[1] &= MASK51;
+	h[3] += h[2] >> 51;
+	h[2] &= MASK51;
+	h[4] += h[3] >> 51;
+	h[3] &= MASK51;
+	h[4] &= MASK51;
+
+	store64_le(s, h[0] | (h[1] << 51));
+	store64_le(s + 8, (h[1] >> 13) | (h[2] << 38));
+	store64_le(s + 16, (h[2] >> 26) | (h[3] << 25));
+	store64_le(s + 24, (h[3] >> 39) | (h[4] << 12));
+}
+
+static int fe_isnegative(const fe f)
+{
+	uint8_t s[32] = { };
+
+	fe_tobytes(s, f);
+	return s[0] & 1;
+}
+
+static int fe_isnonzero(const fe f)
+{
+	uint8_t s[32] = { };
+	uint8_t r = 0;
+	int n = 0;
+
+	fe_tobytes(s, f);
+	for (n = 0; n < 32; n++)
+		r |= s[n];
+
+	return r != 0;
+}
+
+/* Swaps f and g if b is 1, b must be 0 or 1 */
+static void fe_cswap(fe f, fe g, unsigned int b)
+{
+	uint64_t mask = -(uint64_t)b;
+	uint64_t x = 0;
+	int n = 0;
+
+	for (n = 0; n < 5; n++) {
+		x = mask & (f[n] ^ g[n]);
+		f[n] ^= x;
+		g[n] ^= x;
+	}
+}
+
+/* Replaces f with g if b is 1, b must be 0 or 1 */
+static void fe_cmov(fe f, const fe g, unsigned int b)
+{
+	uint64_t mask = -(uint64_t)b;
+	int n = 0;
+
+	for (n = 0; n < 5; n++)
+		f[n] ^= mask & (f[n] ^ g[n]);
+}
+
+static void ge_p2_0(struct ge_p2 *h)
+{
+	fe_0(h->X);
+	fe_1(h->Y);
+	fe_1(h->Z);
+}
+
+static void ge_p3_0(struct ge_p3 *h)
+{
+	fe_0(h->X);
+	fe_1(h->Y);
+	fe_1(h->Z);
+	fe_0(h->T);
+}
+
+static void ge_precomp_0(struct ge_precomp *h)
+{
+	fe_1(h->yplusx);
+	fe_1(h->yminusx);
+	fe_0(h->xy2d);
+}
+
+static void ge_p1p1_to_p2(struct ge_p2 *r, const struct ge_p1p1 *p)
+{
+	fe_mul(r->X, p->X, p->T);
+	fe_mul(r->Y, p->Y, p->Z);
+	fe_mul(r->Z, p->Z, p->T);
+}
+
+static void ge_p1p1_to_p3(struct ge_p3 *r, const struct ge_p1p1 *p)
+{
+	fe_mul(r->X, p->X, p->T);
+	fe_mul(r->Y, p->Y, p->Z);
+	fe_mul(r->Z, p->Z, p->T);
+	fe_mul(r->T, p->X, p->Y);
+}
+
+static void ge_p3_to_cached(struct ge_cached *r, const struct ge_p3 *p)
+{
+	fe_add(r->YplusX, p->Y, p->X);
+	fe_sub(r->YminusX, p->Y, p->X);
+	fe_copy(r->Z, p->Z);
+	fe_mul(r->T2d, p->T, fe_d2);
+}
+
+static void ge_p2_dbl(struct ge_p1p1 *r, const struct ge_p2 *p)
+{
+	fe t0 = { };
+
+	fe_sq(r->X, p->X);
+	fe_sq(r->Z, p->Y);
+	fe_sq(r->T, p->Z);
+	fe_add(r->T, r->T, r->T);
+	fe_add(r->Y, p->X, p->Y);
+	fe_sq(t0, r->Y);
+	fe_add(r->Y, r->Z, r->X);
+	fe_sub(r->Z, r->Z, r->X);
+	fe_sub(r->X, t0, r->Y);
+	fe_sub(r->T, r->T, r->Z);
+}
+
+static void ge_p3_dbl(struct ge_p1p1 *r, const struct ge_p3 *p)
+{
+	struct ge_p2 q = { };
+
+	fe_copy(q.X, p->X);
+	fe_copy(q.Y, p->Y);
+	fe_copy(q.Z, p->Z);
+	ge_p2_dbl(r, &q);
+}
+
+/* r = p + q */
+static void ge_add(struct ge_p1p1 *r, const struct ge_p3 *p,
+		   const struct ge_cached *q)
+{
+	fe t0 = { };
+
+	fe_add(r->X, p->Y, p->X);
+	fe_sub(r->Y, p->Y, p->X);
+	fe_mul(r->Z, r->X, q->YplusX);
+	fe_mul(r->Y, r->Y, q->YminusX);
+	fe_mul(r->T, q->T2d, p->T);
+	fe_mul(r->X, p->Z, q->Z);
+	fe_add(t0, r->X, r->X);
+	fe_sub(r->X, r->Z, r->Y);
+	fe_add(r->Y, r->Z, r->Y);
+	fe_add(r->Z, t0, r->T);
+	fe_sub(r->T, t0, r->T);
+}
+
+/* r = p - q */
+static void ge_sub(struct ge_p1p1 *r, const struct ge_p3 *p,
+		   const struct ge_cached *q)
+{
+	fe t0 = { };
+
+	fe_add(r->X, p->Y, p->X);
+	fe_sub(r->Y, p->Y, p->X);
+	fe_mul(r->Z, r->X, q->YminusX);
+	fe_mul(r->Y, r->Y, q->YplusX);
+	fe_mul(r->T, q->T2d, p->T);
+	fe_mul(r->X, p->Z, q->Z);
+	fe_add(t0, r->X, r->X);
+	fe_sub(r->X, r->Z, r->Y);
+	fe_add(r->Y, r->Z, r->Y);
+	fe_sub(r->Z, t0, r->T);
+	fe_add(r->T, t0, r->T);
+}
+
+/* r = p + q */
+static void ge_madd(struct ge_p1p1 *r, const struct ge_p3 *p,
+		    const struct ge_precomp *q)
+{
+	fe t0 = { };
+
+	fe_add(r->X, p->Y, p->X);
+	fe_sub(r->Y, p->Y, p->X);
+	fe_mul(r->Z, r->X, q->yplusx);
+	fe_mul(r->Y, r->Y, q->yminusx);
+	fe_mul(r->T, q->xy2d, p->T);
+	fe_add(t0, p->Z, p->Z);
+	fe_sub(r->X, r->Z, r->Y);
+	fe_add(r->Y, r->Z, r->Y);
+	fe_add(r->Z, t0, r->T);
+	fe_sub(r->T, t0, r->T);
+}
+
+/* r = p - q */
+static void ge_msub(struct ge_p1p1 *r, const struct ge_p3 *p,
+		    const struct ge_precomp *q)
+{
+	fe t0 = { };
+
+	fe_add(r->X, p->Y, p->X);
+	fe_sub(r->Y, p->Y, p->X);
+	fe_mul(r->Z, r->X, q->yminusx);
+	fe_mul(r->Y, r->Y, q->yplusx);
+	fe_mul(r->T, q->xy2d, p->T);
+	fe_add(t0, p->Z, p->Z);
+	fe_sub(r->X, r->Z, r->Y);
+	fe_add(r->Y, r->Z, r->Y);
+	fe_sub(r->Z, t0, r->T);
+	fe_add(r->T, t0, r->T);
+}
+
+static void ge_tobytes(uint8_t s[32], const fe X, const fe Y, const fe Z)
+{
+	fe recip = { };
+	fe x = { };
+	fe y = { };
+
+	fe_invert(recip, Z);
+	fe_mul(x, X, recip);
+	fe_mul(y, Y, recip);
+	fe_tobytes(s, y);
+	s[31] ^= fe_isnegative(x) << 7;
+}
+
+/* Decodes a point and negates it, returns -1 if it's not on the curve */
+static int ge_frombytes_negate_vartime(struct ge_p3 *h, const uint8_t s[32])
+{
+	fe check = { };
+	fe vxx = { };
+	fe v3 = { };
+	fe u = { };
+	fe v = { };
+
+	fe_frombytes(h->Y, s);
+	fe_1(h->Z);
+	fe_sq(u, h->Y);
+	fe_mul(v, u, fe_d);
+	fe_sub(u, u, h->Z);		/* u = y^2 - 1 */
+	fe_add(v, v, h->Z);		/* v = dy^2 + 1 */
+
+	fe_sq(v3, v);
+	fe_mul(v3, v3, v);		/* v3 = v^3 */
+	fe_sq(h->X, v3);
+	fe_mul(h->X, h->X, v);
+	fe_mul(h->X, h->X, u);		/* x = uv^7 */
+
+	fe_pow22523(h->X, h->X);	/* x = (uv^7)^((q - 5) / 8) */
+	fe_mul(h->X, h->X, v3);
+	fe_mul(h->X, h->X, u);		/* x = uv^3(uv^7)^((q - 5) / 8) */
+
+	fe_sq(vxx, h->X);
+	fe_mul(vxx, vxx, v);
+	fe_sub(check, vxx, u);		/* vx^2 - u */
+	if (fe_isnonzero(check)) {
+		fe_add(check, vxx, u);	/* vx^2 + u */
+		if (fe_isnonzero(check))
+			return -1;
+		fe_mul(h->X, h->X, fe_sqrtm1);
+	}
+
+	if (fe_isnegative(h->X) == (s[31] >> 7))
+		fe_neg(h->X, h->X);
+
+	fe_mul(h->T, h->X, h->Y);
+	return 0;
+}
+
+static void cmov_precomp(struct ge_precomp *t, const struct ge_precomp *u,
+			 unsigned int b)
+{
+	fe_cmov(t->yplusx, u->yplusx, b);
+	fe_cmov(t->yminusx, u->yminusx, b);
+	fe_cmov(t->xy2d, u->xy2d, b);
+}
+
+static unsigned int equal(int8_t b, int8_t c)
+{
+	uint32_t x = (uint8_t)b ^ (uint8_t)c;
+
+	return (x - 1) >> 31;
+}
+
+static unsigned int negative(int8_t b)
+{
+	return (uint64_t)(int64_t)b >> 63;
+}
+
+/* Sets t to b * 256^pos * B, with -8 <= b <= 8, in constant time */
+static void select_precomp(struct ge_precomp *t, int pos, int8_t b)
+{
+	unsigned int bnegative = negative(b);
+	int8_t babs = b - ((-(int8_t)bnegative & b) * 2);
+	struct ge_precomp minust = { };
+	int n = 0;
+
+	ge_precomp_0(t);
+	for (n = 0; n < 8; n++)
+		cmov_precomp(t, &base_table[pos][n], equal(babs, n + 1));
+
+	fe_copy(minust.yplusx, t->yminusx);
+	fe_copy(minust.yminusx, t->yplusx);
+	fe_neg(minust.xy2d, t->xy2d);
+	cmov_precomp(t, &minust, bnegative);
+}
+
+/* h = a * B, a[31] must be at most 127 */
+static void ge_scalarmult_base(struct ge_p3 *h, const uint8_t a[32])
+{
+	struct ge_precomp t = { };
+	struct ge_p1p1 r = { };
+	struct ge_p2 s = { };
+	int8_t carry = 0;
+	int8_t e[64] = { };
+	int n = 0;
+
+	for (n = 0; n < 32; n++) {
+		e[2 * n] = a[n] & 15;
+		e[2 * n + 1] = (a[n] >> 4) & 15;
+	}
+
+	/* Recode to signed digits -8 <= e[n] <= 8 */
+	for (n = 0; n < 63; n++) {
+		e[n] += carry;
+		carry = (e[n] + 8) >> 4;
+		e[n] -= carry * 16;
+	}
+	e[63] += carry;
+
+	ge_p3_0(h);
+	for (n = 1; n < 64; n += 2) {
+		select_precomp(&t, n / 2, e[n]);
+		ge_madd(&r, h, &t);
+		ge_p1p1_to_p3(h, &r);
+	}
+
+	ge_p3_dbl(&r, h);
+	ge_p1p1_to_p2(&s, &r);
+	ge_p2_dbl(&r, &s);
+	ge_p1p1_to_p2(&s, &r);
+	ge_p2_dbl(&r, &s);
+	ge_p1p1_to_p2(&s, &r);
+	ge_p2_dbl(&r, &s);
+	ge_p1p1_to_p3(h, &r);
+
+	for (n = 0; n < 64; n += 2) {
+		select_precomp(&t, n / 2, e[n]);
+		ge_madd(&r, h, &t);
+		ge_p1p1_to_p3(h, &r);
+	}
+
+	memzero_explicit(e, sizeof(e));
+}
+
+/* Recodes a into signed odd digits -15 <= r[n] <= 15 for a width-5 window */
+static void slide(int8_t r[256], const uint8_t a[32])
+{
+	int b = 0;
+	int k = 0;
+	int n = 0;
+
+	for (n = 0; n < 256; n++)
+		r[n] = 1 & (a[n >> 3] >> (n & 7));
+
+	for (n = 0; n < 256; n++) {
+		if (!r[n])
+			continue;
+		for (b = 1; b <= 6 && n + b < 256; b++) {
+			if (!r[n + b])
+				continue;
+			if (r[n] + (r[n + b] << b) <= 15) {
+				r[n] += r[n + b] << b;
+				r[n + b] = 0;
+			} else if (r[n] - (r[n + b] << b) >= -15) {
+				r[n] -= r[n + b] << b;
+				for (k = n + b; k < 256; k++) {
+					if (!r[k]) {
+						r[k] = 1;
+						break;
+					}
+					r[k] = 0;
+				}
+			} else {
+				break;
+			}
+		}
+	}
+}
+
+/* r = a * A + b * B, only for public data */
+static void ge_double_scalarmult_vartime(struct ge_p2 *r, const uint8_t a[32],
+					 const struct ge_p3 *A,
+					 const uint8_t b[32])
+{
+	struct ge_cached Ai[8] = { };	/* A, 3A, 5A, ..., 15A */
+	struct ge_p1p1 t = { };
+	int8_t aslide[256] = { };
+	int8_t bslide[256] = { };
+	struct ge_p3 A2 = { };
+	struct ge_p3 u = { };
+	int n = 0;
+
+	slide(aslide, a);
+	slide(bslide, b);
+
+	ge_p3_to_cached(Ai, A);
+	ge_p3_dbl(&t, A);
+	ge_p1p1_to_p3(&A2, &t);
+	for (n = 0; n < 7; n++) {
+		ge_add(&t, &A2, Ai + n);
+		ge_p1p1_to_p3(&u, &t);
+		ge_p3_to_cached(Ai + n + 1, &u);
+	}
+
+	ge_p2_0(r);
+	for (n = 255; n >= 0; n--)
+		if (aslide[n] || bslide[n])
+			break;
+
+	for (; n >= 0; n--) {
+		ge_p2_dbl(&t, r);
+
+		if (aslide[n] > 0) {
+			ge_p1p1_to_p3(&u, &t);
+			ge_add(&t, &u, Ai + aslide[n] / 2);
+		} else if (aslide[n] < 0) {
+			ge_p1p1_to_p3(&u, &t);
+			ge_sub(&t, &u, Ai + -aslide[n] / 2);
+		}
+
+		if (bslide[n] > 0) {
+			ge_p1p1_to_p3(&u, &t);
+			ge_madd(&t, &u, base_odd_multiples + bslide[n] / 2);
+		} else if (bslide[n] < 0) {
+			ge_p1p1_to_p3(&u, &t);
+			ge_msub(&t, &u, base_odd_multiples + -bslide[n] / 2);
+		}
+
+		ge_p1p1_to_p2(r, &t);
+	}
+}
+
+/* L = 2^252 + 27742317777372353535851937790883648493 */
+static const int64_t sc_l[32] = {
+	0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58,
+	0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+	0, 0, 0, 0, 0, 0, 0, 0,
+	0, 0, 0, 0, 0, 0, 0, 0x10
+};
+
+/* r = x mod L, x holds 64 signed radix 2^8 digits */
+static void sc_mod_l(uint8_t r[32], int64_t x[64])
+{
+	int64_t carry = 0;
+	int i = 0;
+	int j = 0;
+
+	for (i = 63; i >= 32; i--) {
+		carry = 0;
+		for (j = i - 32; j < i - 12; j++) {
+			x[j] += carry - 16 * x[i] * sc_l[j - (i - 32)];
+			carry = (x[j] + 128) >> 8;
+			x[j] -= carry * 256;
+		}
+		x[j] += carry;
+		x[i] = 0;
+	}
+
+	carry = 0;
+	for (j = 0; j < 32; j++) {
+		x[j] += carry - (x[31] >> 4) * sc_l[j];
+		carry = x[j] >> 8;
+		x[j] &= 255;
+	}
+	for (j = 0; j < 32; j++)
+		x[j] -= carry * sc_l[j];
+	for (i = 0; i < 32; i++) {
+		x[i + 1] += x[i] >> 8;
+		r[i] = x[i] & 255;
+	}
+}
+
+/* Reduces the 512-bit s modulo L, the result is in the first 32 bytes */
+static void sc_reduce(uint8_t s[64])
+{
+	int64_t x[64] = { };
+	int n = 0;
+
+	for (n = 0; n < 64; n++)
+		x[n] = s[n];
+	memset(s, 0, 64);
+	sc_mod_l(s, x);
+	memzero_explicit(x, sizeof(x));
+}
+
+/* s = (a * b + c) mod L */
+static void sc_muladd(uint8_t s[32], const uint8_t a[32], const uint8_t b[32],
+		      const uint8_t c[32])
+{
+	int64_t x[64] = { };
+	int i = 0;
+	int j = 0;
+
+	for (i = 0; i < 32; i++)
+		x[i] = c[i];
+	for (i = 0; i < 32; i++)
+		for (j = 0; j < 32; j++)
+			x[i + j] += (int64_t)a[i] * b[j];
+	sc_mod_l(s, x);
+	memzero_explicit(x, sizeof(x));
+}
+
+/* Returns true if s < L, as required from the S part of a signature */
+static bool sc_is_canonical(const uint8_t s[32])
+{
+	int n = 0;
+
+	for (n = 31; n >= 0; n--) {
+		if (s[n] < sc_l[n])
+			return true;
+		if (s[n] > sc_l[n])
+			return false;
+	}
+
+	return false;
+}
+
+static int hash_ctx(uint8_t *out, const uint8_t *m, unsigned long long n,
+		    const uint8_t *ctx, unsigned long long cs)
+{
+	int hash_idx = find_hash("sha512");
+	unsigned long len = 64;
+
+	if (n > ULONG_MAX || cs > ULONG_MAX)
+		return CRYPT_OVERFLOW;
+
+	if (!cs)
+		return hash_memory(hash_idx, m, n, out, &len);
+
+	return hash_memory_multi(hash_idx, out, &len, ctx, cs, m, n, LTC_NULL);
+}
+
+static void clamp(uint8_t s[32])
+{
+	s[0] &= 248;
+	s[31] &= 127;
+	s[31] |= 64;
+}
+
+int tweetnacl_crypto_scalarmult(unsigned char *q, const unsigned char *n,
+				const unsigned char *p)
+{
+	unsigned int swap = 0;
+	unsigned int bit = 0;
+	uint8_t e[32] = { };
+	fe x1 = { };
+	fe x2 = { };
+	fe z2 = { };
+	fe x3 = { };
+	fe z3 = { };
+	fe a = { };
+	fe aa = { };
+	fe b = { };
+	fe bb = { };
+	fe c = { };
+	fe d = { };
+	fe da = { };
+	fe cb = { };
+	fe e2 = { };
+	int pos = 0;
+
+	memcpy(e, n, sizeof(e));
+	clamp(e);
+
+	fe_frombytes(x1, p);
+	fe_1(x2);
+	fe_copy(x3, x1);
+	fe_1(z3);
+
+	for (pos = 254; pos >= 0; pos--) {
+		bit = (e[pos / 8] >> (pos & 7)) & 1;
+		swap ^= bit;
+		fe_cswap(x2, x3, swap);
+		fe_cswap(z2, z3, swap);
+		swap = bit;
+
+		fe_add(a, x2, z2);
+		fe_sq(aa, a);
+		fe_sub(b, x2, z2);
+		fe_sq(bb, b);
+		fe_sub(e2, aa, bb);
+		fe_add(c, x3, z3);
+		fe_sub(d, x3, z3);
+		fe_mul(da, d, a);
+		fe_mul(cb, c, b);
+		fe_add(x3, da, cb);
+		fe_sq(x3, x3);
+		fe_sub(z3, da, cb);
+		fe_sq(z3, z3);
+		fe_mul(z3, z3, x1);
+		fe_mul(x2, aa, bb);
+		fe_mul_small(z2, e2, 121665);
+		fe_add(z2, z2, aa);
+		fe_mul(z2, z2, e2);
+	}
+	fe_cswap(x2, x3, swap);
+	fe_cswap(z2, z3, swap);
+
+	fe_invert(z2, z2);
+	fe_mul(x2, x2, z2);
+	fe_tobytes(q, x2);
+
+	memzero_explicit(e, sizeof(e));
+	return CRYPT_OK;
+}
+
+int tweetnacl_crypto_scalarmult_base(unsigned char *q, const unsigned char *n)
+{
+	struct ge_p3 A = { };
+	uint8_t e[32] = { };
+	fe zplusy = { };
+	fe zminusy = { };
+
+	memcpy(e, n, sizeof(e));
+	clamp(e);
+	ge_scalarmult_base(&A, e);
+
+	/* u = (1 + y) / (1 - y) = (Z + Y) / (Z - Y) */
+	fe_add(zplusy, A.Z, A.Y);
+	fe_sub(zminusy, A.Z, A.Y);
+	fe_invert(zminusy, zminusy);
+	fe_mul(zplusy, zplusy, zminusy);
+	fe_tobytes(q, zplusy);
+
+	memzero_explicit(e, sizeof(e));
+	return CRYPT_OK;
+}
+
+int tweetnacl_crypto_sk_to_pk(unsigned char *pk, const unsigned char *sk)
+{
+	struct ge_p3 A = { };
+	uint8_t d[64] = { };
+	int err = CRYPT_OK;
+
+	err = hash_ctx(d, sk, 32, NULL, 0);
+	if (err == CRYPT_OK) {
+		clamp(d);
+		ge_scalarmult_base(&A, d);
+		ge_tobytes(pk, A.X, A.Y, A.Z);
+	}
+
+	memzero_explicit(d, sizeof(d));
+	return err;
+}
+
+int tweetnacl_crypto_sign_keypair(prng_state *prng, int wprng,
+				  unsigned char *pk, unsigned char *sk)
+{
+	int err = CRYPT_OK;
+
+	err = prng_is_valid(wprng);
+	if (err != CRYPT_OK)
+		return err;
+
+	if (prng_descriptor[wprng]->read(sk, 32, prng) != 32)
+		return CRYPT_ERROR_READPRNG;
+
+	/* The public key isn't appended to the secret key */
+	return tweetnacl_crypto_sk_to_pk(pk, sk);
+}
+
+int tweetnacl_crypto_sign(unsigned char *sm, unsigned long long *smlen,
+			  const unsigned char *m, unsigned long long mlen,
+			  const unsigned char *sk, const unsigned char *pk,
+			  const unsigned char *ctx, unsigned long long cs)
+{
+	struct ge_p3 R = { };
+	uint8_t d[64] = { };
+	uint8_t h[64] = { };
+	uint8_t r[64] = { };
+	int err = CRYPT_OK;
+
+	err = hash_ctx(d, sk, 32, NULL, 0);
+	if (err != CRYPT_OK)
+		goto out;
+	clamp(d);
+
+	*smlen = mlen + 64;
+	memmove(sm + 64, m, mlen);
+	memcpy(sm + 32, d + 32, 32);
+
+	err = hash_ctx(r, sm + 32, mlen + 32, ctx, cs);
+	if (err != CRYPT_OK)
+		goto out;
+	sc_reduce(r);
+	ge_scalarmult_base(&R, r);
+	ge_tobytes(sm, R.X, R.Y, R.Z);
+
+	memcpy(sm + 32, pk, 32);
+	err = hash_ctx(h, sm, mlen + 64, ctx, cs);
+	if (err != CRYPT_OK)
+		goto out;
+	sc_reduce(h);
+	sc_muladd(sm + 32, h, d, r);
+out:
+	memzero_explicit(d, sizeof(d));
+	memzero_explicit(r, sizeof(r));
+	return err;
+}
+
+int tweetnacl_crypto_sign_open(int *stat, unsigned char *m,
+			       unsigned long long *mlen,
+			       const unsigned char *sm,
+			       unsigned long long smlen,
+			       const unsigned char *ctx,
+			       unsigned long long cs,
+			       const unsigned char *pk)
+{
+	struct ge_p3 A = { };
+	struct ge_p2 R = { };
+	uint8_t s[32] = { };
+	uint8_t t[32] = { };
+	uint8_t h[64] = { };
+	int err = CRYPT_OK;
+
+	*stat = 0;
+	if (*mlen < smlen)
+		return CRYPT_BUFFER_OVERFLOW;
+	*mlen = -1;
+	if (smlen < 64)
+		return CRYPT_INVALID_ARG;
+
+	if (ge_frombytes_negate_vartime(&A, pk))
+		return CRYPT_ERROR;
+
+	memmove(m, sm, smlen);
+	memcpy(s, m + 32, 32);
+	if (!sc_is_canonical(s))
+		goto bad;
+	memcpy(m + 32, pk, 32);
+	err = hash_ctx(h, m, smlen, ctx, cs);
+	if (err != CRYPT_OK)
+		goto bad;
+	sc_reduce(h);
+
+	/* R = s * B - h * A */
+	ge_double_scalarmult_vartime(&R, h, &A, s);
+	ge_tobytes(t, R.X, R.Y, R.Z);
+
+	if (memcmp(sm, t, 32))
+		goto bad;
+
+	smlen -= 64;
+	*stat = 1;
+	memmove(m, m + 64, smlen);
+	*mlen = smlen;
+	return CRYPT_OK;
+bad:
+	zeromem(m, smlen);
+	return err;
+}
+
+int tweetnacl_crypto_ph(unsigned char *out, const unsigned char *msg,
+			unsigned long long msglen)
+{
+	return hash_ctx(out, msg, msglen, NULL, 0);
+}
@@ -0,0 +1,718 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+
+/*
+ * Point multiplication on the NIST P-256 and P-384 curves with field
+ * elements in fixed size arrays of 64-bit limbs instead of generic MPI.
+ *
+ * Field elements are kept in Montgomery form, multiplied with a word by
+ * word Montgomery reduction which for these primes is as cheap as a
+ * Solinas reduction while being the same code for both curves. Points
+ * use homogeneous projective coordinates with the complete addition and
+ * doubling formulas for a = -3 by Renes, Costello and Batina, so there
+ * are no special cases for the point at infinity or for adding a point
+ * to itself.
+ *
+ * - Multiples of the base point use a comb with COMB_TEETH teeth and a
+ *   table precomputed in ecc_nistp_table.h.
+ * - Multiples of other points use a fixed 4-bit window.
+ * - The double multiplication of signature verification uses Shamir's
+ *   trick with 4-bit windows.
+ *
+ * The first two run in constant time, all table lookups read every
+ * entry. Verification only handles public data and skips zero digits.
+ *
+ * ecc_nistp_ptmul() and ecc_nistp_mul2add() are hooked into the
+ * LibTomCrypt math descriptor and fall back to the generic functions
+ * for other curves or when the input isn't an affine point on the curve.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <string_ext.h>
+#include <tomcrypt_private.h>
+#include <tomcrypt_mp.h>
+#include <util.h>
+
+typedef unsigned __int128 uint128_t;
+
+#define MAX_LIMBS	6
+#define MAX_BYTES	(MAX_LIMBS * 8)
+#define COMB_TEETH	6
+#define COMB_SIZE	(BIT(COMB_TEETH) - 1)
+#define WIN_BITS	4
+#define WIN_SIZE	BIT(WIN_BITS)
+
+typedef uint64_t fe[MAX_LIMBS];
+
+struct nistp_curve {
+	size_t nlimbs;
+	size_t nbits;
+	size_t comb_d;		/* Spacing of the comb teeth in bits */
+	fe p;
+	fe a;			/* p - 3 */
+	fe rr;			/* R^2 mod p */
+	fe one;			/* R mod p */
+	fe b;			/* Montgomery form */
+	uint64_t p0inv;		/* -p^-1 mod 2^64 */
+	/* (j + 1) teeth combination of the base point, Montgomery form */
+	const uint64_t *comb;
+};
+
+/* Homogeneous projective (X:Y:Z) in Montgomery form, infinity is (0:1:0) */
+struct nistp_point {
+	fe x;
+	fe y;
+	fe z;
+};
+
+#include "ecc_nistp_table.h"
+
+static uint64_t limbs_add(uint64_t *r, const uint64_t *a, const uint64_t *b,
+			  size_t n)
+{
+	uint128_t t = 0;
+	size_t i = 0;
+
+	for (i = 0; i < n; i++) {
+		t += (uint128_t)a[i] + b[i];
+		r[i] = t;
+		t >>= 64;
+	}
+
+	return t;
+}
+
+static uint64_t limbs_sub(uint64_t *r, const uint64_t *a, const uint64_t *b,
+			  size_t n)
+{
+	uint64_t borrow = 0;
+	uint128_t t = 0;
+	size_t i = 0;
+
+	for (i = 0; i < n; i++) {
+		t = (uint128_t)a[i] - b[i] - borrow;
+		r[i] = t;
+		borrow = (t >> 64) & 1;
+	}
+
+	return borrow;
+}
+
+/* r = mask ? b : a, mask is 0 or all ones */
+static void limbs_select(uint64_t *r, const uint64_t *a, const uint64_t *b,
+			 uint64_t mask, size_t n)
+{
+	size_t i = 0;
+
+	for (i = 0; i < n; i++)
+		r[i] = a[i] ^ (mask & (a[i] ^ b[i]));
+}
+
+static bool limbs_equal(const uint64_t *a, const uint64_t *b, size_t n)
+{
+	uint64_t d = 0;
+	size_t i = 0;
+
+	for (i = 0; i < n; i++)
+		d |= a[i] ^ b[i];
+
+	return !d;
+}
+
+static bool limbs_is_zero(const uint64_t *a, size_t n)
+{
+	uint64_t d = 0;
+	size_t i = 0;
+
+	for (i = 0; i < n; i++)
+		d |= a[i];
+
+	return !d;
+}
+
+/* All ones if a == b, else 0 */
+static uint64_t ct_eq_mask(uint64_t a, uint64_t b)
+{
+	uint64_t x = a ^ b;
+
+	return ((x | -x) >> 63) - 1;
+}
+
+static void limbs_from_bytes(uint64_t *r, const uint8_t *s, size_t n)
+{
+	size_t i = 0;
+	size_t j = 0;
+
+	for (i = 0; i < n; i++) {
+		r[i] = 0;
+		for (j = 0; j < 8; j++)
+			r[i] |= (uint64_t)s[(n - 1 - i) * 8 + 7 - j] << (8 * j);
+	}
+}
+
+static void limbs_to_bytes(uint8_t *s, const uint64_t *a, size_t n)
+{
+	size_t i = 0;
+	size_t j = 0;
+
+	for (i = 0; i < n; i++)
+		for (j = 0; j < 8; j++)
+			s[(n - 1 - i) * 8 + 7 - j] = a[i] >> (8 * j);
+}
+
+static void fe_add(const struct nistp_curve *c, fe r, const fe a, const fe b)
+{
+	uint64_t carry = 0;
+	uint64_t borrow = 0;
+	fe t = { };
+
+	carry = limbs_add(t, a, b, c->nlimbs);
+	borrow = limbs_sub(r, t, c->p, c->nlimbs);
+	/* Keep t if it was already below p */
+	limbs_select(r, r, t, -(~carry & borrow & 1), c->nlimbs);
+}
+
+static void fe_sub(const struct nistp_curve *c, fe r, const fe a, const fe b)
+{
+	uint64_t borrow = 0;
+	fe t = { };
+
+	borrow = limbs_sub(r, a, b, c->nlimbs);
+	limbs_select(t, t, c->p, -borrow, c->nlimbs);
+	limbs_add(r, r, t, c->nlimbs);
+}
+
+/* r = a * b / R mod p, word by word Montgomery multiplication */
+static void fe_mul(const struct nistp_curve *c, fe r, const fe a, const fe b)
+{
+	uint64_t t[MAX_LIMBS + 2] = { };
+	size_t n = c->nlimbs;
+	uint64_t borrow = 0;
+	uint128_t s = 0;
+	uint64_t m = 0;
+	size_t i = 0;
+	size_t j = 0;
+
+	for (i = 0; i < n; i++) {
+		s = 0;
+		for (j = 0; j < n; j++) {
+			s += (uint128_t)a[j] * b[i] + t[j];
+			t[j] = s;
+			s >>= 64;
+		}
+		s += t[n];
+		t[n] = s;
+		t[n + 1] = s >> 64;
+
+		m = t[0] * c->p0inv;
+		s = (uint128_t)m * c->p[0] + t[0];
+		s >>= 64;
+		for (j = 1; j < n; j++) {
+			s += (uint128_t)m * c->p[j] + t[j];
+			t[j - 1] = s;
+			s >>= 64;
+		}
+		s += t[n];
+		t[n - 1] = s;
+		t[n] = t[n + 1] + (uint64_t)(s >> 64);
+	}
+
+	/* t < 2p, subtract p unless that borrows */
+	borrow = limbs_sub(r, t, c->p, n);
+	limbs_select(r, r, t, -(~t[n] & borrow & 1), n);
+}
+
+static void fe_sqr(const struct nistp_curve *c, fe r, const fe a)
+{
+	fe_mul(c, r, a, a);
+}
+
+static void fe_to_mont(const struct nistp_curve *c, fe r, const fe a)
+{
+	fe_mul(c, r, a, c->rr);
+}
+
+static void fe_from_mont(const struct nistp_curve *c, fe r, const fe a)
+{
+	fe one = { 1 };
+
+	fe_mul(c, r, a, one);
+}
+
+/* r = a^(p - 2) = 1 / a, the exponent is public */
+static void fe_inv(const struct nistp_curve *c, fe r, const fe a)
+{
+	fe two = { 2 };
+	fe e = { };
+	fe t = { };
+	int i = 0;
+
+	limbs_sub(e, c->p, two, c->nlimbs);
+	memcpy(t, c->one, sizeof(t));
+	for (i = c->nbits - 1; i >= 0; i--) {
+		fe_sqr(c, t, t);
+		if ((e[i / 64] >> (i % 64)) & 1)
+			fe_mul(c, t, t, a);
+	}
+	memcpy(r, t, sizeof(t));
+}
+
+static void point_set_infinity(const struct nistp_curve *c,
+			       struct nistp_point *p)
+{
+	memset(p, 0, sizeof(*p));
+	memcpy(p->y, c->one, sizeof(fe));
+}
+
+static void point_select(const struct nistp_curve *c, struct nistp_point *r,
+			 const struct nistp_point *p, uint64_t mask)
+{
+	limbs_select(r->x, r->x, p->x, mask, c->nlimbs);
+	limbs_select(r->y, r->y, p->y, mask, c->nlimbs);
+	limbs_select(r->z, r->z, p->z, mask, c->nlimbs);
+}
+
+/* Algorithm 4 of "Complete addition formulas for prime order elliptic curves" */
+static void point_add(const struct nistp_curve *c, struct nistp_point *r,
+		      const struct nistp_point *p, const struct nistp_point *q)
+{
+	fe t0 = { };
+	fe t1 = { };
+	fe t2 = { };
+	fe t3 = { };
+	fe t4 = { };
+	fe x3 = { };
+	fe y3 = { };
+	fe z3 = { };
+
+	fe_mul(c, t0, p->x, q->x);
+	fe_mul(c, t1, p->y, q->y);
+	fe_mul(c, t2, p->z, q->z);
+	fe_add(c, t3, p->x, p->y);
+	fe_add(c, t4, q->x, q->y);
+	fe_mul(c, t3, t3, t4);
+	fe_add(c, t4, t0, t1);
+	fe_sub(c, t3, t3, t4);
+	fe_add(c, t4, p->y, p->z);
+	fe_add(c, x3, q->y, q->z);
+	fe_mul(c, t4, t4, x3);
+	fe_add(c, x3, t1, t2);
+	fe_sub(c, t4, t4, x3);
+	fe_add(c, x3, p->x, p->z);
+	fe_add(c, y3, q->x, q->z);
+	fe_mul(c, x3, x3, y3);
+	fe_add(c, y3, t0, t2);
+	fe_sub(c, y3, x3, y3);
+	fe_mul(c, z3, c->b, t2);
+	fe_sub(c, x3, y3, z3);
+	fe_add(c, z3, x3, x3);
+	fe_add(c, x3, x3, z3);
+	fe_sub(c, z3, t1, x3);
+	fe_add(c, x3, t1, x3);
+	fe_mul(c, y3, c->b, y3);
+	fe_add(c, t1, t2, t2);
+	fe_add(c, t2, t1, t2);
+	fe_sub(c, y3, y3, t2);
+	fe_sub(c, y3, y3, t0);
+	fe_add(c, t1, y3, y3);
+	fe_add(c, y3, t1, y3);
+	fe_add(c, t1, t0, t0);
+	fe_add(c, t0, t1, t0);
+	fe_sub(c, t0, t0, t2);
+	fe_mul(c, t1, t4, y3);
+	fe_mul(c, t2, t0, y3);
+	fe_mul(c, y3, x3, z3);
+	fe_add(c, y3, y3, t2);
+	fe_mul(c, x3, x3, t3);
+	fe_sub(c, x3, x3, t1);
+	fe_mul(c, z3, z3, t4);
+	fe_mul(c, t1, t3, t0);
+	fe_add(c, z3, z3, t1);
+
+	memcpy(r->x, x3, sizeof(fe));
+	memcpy(r->y, y3, sizeof(fe));
+	memcpy(r->z, z3, sizeof(fe));
+}
+
+/* Algorithm 6 of "Complete addition formulas for prime order elliptic curves" */
+static void point_dbl(const struct nistp_curve *c, struct nistp_point *r,
+		      const struct nistp_point *p)
+{
+	fe t0 = { };
+	fe t1 = { };
+	fe t2 = { };
+	fe t3 = { };
+	fe x3 = { };
+	fe y3 = { };
+	fe z3 = { };
+
+	fe_sqr(c, t0, p->x);
+	fe_sqr(c, t1, p->y);
+	fe_sqr(c, t2, p->z);
+	fe_mul(c, t3, p->x, p->y);
+	fe_add(c, t3, t3, t3);
+	fe_mul(c, z3, p->x, p->z);
+	fe_add(c, z3, z3, z3);
+	fe_mul(c, y3, c->b, t2);
+	fe_sub(c, y3, y3, z3);
+	fe_add(c, x3, y3, y3);
+	fe_add(c, y3, x3, y3);
+	fe_sub(c, x3, t1, y3);
+	fe_add(c, y3, t1, y3);
+	fe_mul(c, y3, x3, y3);
+	fe_mul(c, x3, x3, t3);
+	fe_add(c, t3, t2, t2);
+	fe_add(c, t2, t2, t3);
+	fe_mul(c, z3, c->b, z3);
+	fe_sub(c, z3, z3, t2);
+	fe_sub(c, z3, z3, t0);
+	fe_add(c, t3, z3, z3);
+	fe_add(c, z3, z3, t3);
+	fe_add(c, t3, t0, t0);
+	fe_add(c, t0, t3, t0);
+	fe_sub(c, t0, t0, t2);
+	fe_mul(c, t0, t0, z3);
+	fe_add(c, y3, y3, t0);
+	fe_mul(c, t0, p->y, p->z);
+	fe_add(c, t0, t0, t0);
+	fe_mul(c, z3, t0, z3);
+	fe_sub(c, x3, x3, z3);
+	fe_mul(c, z3, t0, t1);
+	fe_add(c, z3, z3, z3);
+	fe_add(c, z3, z3, z3);
+
+	memcpy(r->x, x3, sizeof(fe));
+	memcpy(r->y, y3, sizeof(fe));
+	memcpy(r->z, z3, sizeof(fe));
+}
+
+/* Returns true if (x, y), in Montgomery form, satisfies y^2 = x^3 - 3x + b */
+static bool point_is_on_curve(const struct nistp_curve *c, const fe x,
+			      const fe y)
+{
+	fe l = { };
+	fe r = { };
+	fe t = { };
+
+	fe_sqr(c, l, y);
+	fe_sqr(c, r, x);
+	fe_mul(c, r, r, x);
+	fe_add(c, t, x, x);
+	fe_add(c, t, t, x);
+	fe_sub(c, r, r, t);
+	fe_add(c, r, r, c->b);
+
+	return limbs_equal(l, r, c->nlimbs);
+}
+
+/* Returns false for the point at infinity */
+static bool point_to_affine(const struct nistp_curve *c, fe x, fe y,
+			    const struct nistp_point *p)
+{
+	fe zi = { };
+
+	if (limbs_is_zero(p->z, c->nlimbs))
+		return false;
+
+	fe_inv(c, zi, p->z);
+	fe_mul(c, x, p->x, zi);
+	fe_mul(c, y, p->y, zi);
+	fe_from_mont(c, x, x);
+	fe_from_mont(c, y, y);
+	return true;
+}
+
+static unsigned int scalar_bit(const uint8_t *k, size_t nbytes, size_t bit)
+{
+	if (bit >= nbytes * 8)
+		return 0;
+	return (k[nbytes - 1 - bit / 8] >> (bit % 8)) & 1;
+}
+
+static unsigned int scalar_window(const uint8_t *k, size_t nbytes, size_t w)
+{
+	return (k[nbytes - 1 - w / 2] >> ((w % 2) * WIN_BITS)) & (WIN_SIZE - 1);
+}
+
+/* r = k * G, k is big endian of the size of the curve */
+static void mul_base(const struct nistp_curve *c, struct nistp_point *r,
+		     const uint8_t *k)
+{
+	size_t nbytes = c->nlimbs * 8;
+	size_t stride = 2 * c->nlimbs;
+	struct nistp_point t = { };
+	const uint64_t *e = NULL;
+	unsigned int v = 0;
+	uint64_t mask = 0;
+	size_t i = 0;
+	int j = 0;
+
+	point_set_infinity(c, r);
+	for (j = c->comb_d - 1; j >= 0; j--) {
+		point_dbl(c, r, r);
+
+		v = 0;
+		for (i = 0; i < COMB_TEETH; i++)
+			v |= scalar_bit(k, nbytes, j + i * c->comb_d) << i;
+
+		point_set_infinity(c, &t);
+		for (i = 0; i < COMB_SIZE; i++) {
+			e = c->comb + i * stride;
+			mask = ct_eq_mask(v, i + 1);
+			limbs_select(t.x, t.x, e, mask, c->nlimbs);
+			limbs_select(t.y, t.y, e + c->nlimbs, mask,
+				     c->nlimbs);
+			limbs_select(t.z, t.z, c->one, mask, c->nlimbs);
+		}
+		point_add(c, r, r, &t);
+	}
+
+	memzero_explicit(&t, sizeof(t));
+}
+
+/* tab[n] = n * p for 0 <= n < WIN_SIZE */
+static void precompute_window(const struct nistp_curve *c,
+			      struct nistp_point *tab,
+			      const struct nistp_point *p)
+{
+	size_t n = 0;
+
+	point_set_infinity(c, tab);
+	tab[1] = *p;
+	for (n = 2; n < WIN_SIZE; n++)
+		point_add(c, tab + n, tab + n - 1, p);
+}
+
+/* r = k * p in constant time, tab must hold WIN_SIZE points */
+static void mul_point(const struct nistp_curve *c, struct nistp_point *r,
+		      const uint8_t *k, const struct nistp_point *p,
+		      struct nistp_point *tab)
+{
+	size_t nbytes = c->nlimbs * 8;
+	struct nistp_point t = { };
+	unsigned int v = 0;
+	size_t n = 0;
+	int w = 0;
+
+	precompute_window(c, tab, p);
+
+	point_set_infinity(c, r);
+	for (w = nbytes * 2 - 1; w >= 0; w--) {
+		for (n = 0; n < WIN_BITS; n++)
+			point_dbl(c, r, r);
+
+		v = scalar_window(k, nbytes, w);
+		point_set_infinity(c, &t);
+		for (n = 1; n < WIN_SIZE; n++)
+			point_select(c, &t, tab + n, ct_eq_mask(v, n));
+		point_add(c, r, r, &t);
+	}
+
+	memzero_explicit(&t, sizeof(t));
+}
+
+/* r = ka * a + kb * b for public data, tabs must hold 2 * WIN_SIZE points */
+static void mul2add(const struct nistp_curve *c, struct nistp_point *r,
+		    const uint8_t *ka, const struct nistp_point *a,
+		    const uint8_t *kb, const struct nistp_point *b,
+		    struct nistp_point *tabs)
+{
+	struct nistp_point *taba = tabs;
+	struct nistp_point *tabb = tabs + WIN_SIZE;
+	size_t nbytes = c->nlimbs * 8;
+	bool started = false;
+	unsigned int va = 0;
+	unsigned int vb = 0;
+	size_t n = 0;
+	int w = 0;
+
+	precompute_window(c, taba, a);
+	precompute_window(c, tabb, b);
+
+	point_set_infinity(c, r);
+	for (w = nbytes * 2 - 1; w >= 0; w--) {
+		if (started)
+			for (n = 0; n < WIN_BITS; n++)
+				point_dbl(c, r, r);
+
+		va = scalar_window(ka, nbytes, w);
+		vb = scalar_window(kb, nbytes, w);
+		if (va)
+			point_add(c, r, r, taba + va);
+		if (vb)
+			point_add(c, r, r, tabb + vb);
+		started |= va || vb;
+	}
+}
+
+static const struct nistp_curve *find_curve(void *modulus, void *a)
+{
+	static const struct nistp_curve *const curves[] = { &p256, &p384 };
+	uint8_t buf[MAX_BYTES] = { };
+	const struct nistp_curve *c = NULL;
+	fe t = { };
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(curves); n++) {
+		c = curves[n];
+		if (mp_unsigned_bin_size(modulus) != c->nlimbs * 8 ||
+		    mp_unsigned_bin_size(a) != c->nlimbs * 8)
+			continue;
+		if (mp_to_unsigned_bin(modulus, buf) != CRYPT_OK)
+			return NULL;
+		limbs_from_bytes(t, buf, c->nlimbs);
+		if (!limbs_equal(t, c->p, c->nlimbs))
+			continue;
+		if (mp_to_unsigned_bin(a, buf) != CRYPT_OK)
+			return NULL;
+		limbs_from_bytes(t, buf, c->nlimbs);
+		if (!limbs_equal(t, c->a, c->nlimbs))
+			continue;
+		return c;
+	}
+
+	return NULL;
+}
+
+/* Reads a scalar as big endian of the size of the curve */
+static bool read_scalar(const struct nistp_curve *c, uint8_t *buf, void *k)
+{
+	size_t nbytes = c->nlimbs * 8;
+	size_t sz = mp_unsigned_bin_size(k);
+
+	if (sz > nbytes)
+		return false;
+	memset(buf, 0, nbytes - sz);
+	return mp_to_unsigned_bin(k, buf + nbytes - sz) == CRYPT_OK;
+}
+
+static bool read_coord(const struct nistp_curve *c, fe r, void *v)
+{
+	uint8_t buf[MAX_BYTES] = { };
+	fe t = { };
+
+	if (!read_scalar(c, buf, v))
+		return false;
+	limbs_from_bytes(r, buf, c->nlimbs);
+	/* Must be below p */
+	if (!limbs_sub(t, r, c->p, c->nlimbs))
+		return false;
+	fe_to_mont(c, r, r);
+	return true;
+}
+
+/* Reads an affine LibTomCrypt point which must be on the curve */
+static bool read_point(const struct nistp_curve *c, struct nistp_point *r,
+		       const ecc_point *p)
+{
+	if (mp_cmp_d(p->z, 1) != LTC_MP_EQ)
+		return false;
+	if (!read_coord(c, r->x, p->x) || !read_coord(c, r->y, p->y))
+		return false;
+	memcpy(r->z, c->one, sizeof(fe));
+
+	return point_is_on_curve(c, r->x, r->y);
+}
+
+static int write_point(const struct nistp_curve *c, ecc_point *r,
+		       const struct nistp_point *p)
+{
+	uint8_t buf[MAX_BYTES] = { };
+	size_t nbytes = c->nlimbs * 8;
+	int err = CRYPT_OK;
+	fe x = { };
+	fe y = { };
+
+	if (!point_to_affine(c, x, y, p))
+		return ltc_ecc_set_point_xyz(0, 0, 1, r);
+
+	limbs_to_bytes(buf, x, c->nlimbs);
+	err = mp_read_unsigned_bin(r->x, buf, nbytes);
+	if (err != CRYPT_OK)
+		return err;
+	limbs_to_bytes(buf, y, c->nlimbs);
+	err = mp_read_unsigned_bin(r->y, buf, nbytes);
+	if (err != CRYPT_OK)
+		return err;
+	return mp_set(r->z, 1);
+}
+
+int ecc_nistp_ptmul(void *k, const ecc_point *G, ecc_point *R, void *a,
+		    void *modulus, int map)
+{
+	const struct nistp_curve *c = NULL;
+	struct nistp_point *tab = NULL;
+	uint8_t kbuf[MAX_BYTES] = { };
+	struct nistp_point p = { };
+	struct nistp_point r = { };
+	int err = CRYPT_OK;
+
+	if (map)
+		c = find_curve(modulus, a);
+	if (!c || !read_scalar(c, kbuf, k) || !read_point(c, &p, G))
+		return ltc_ecc_mulmod(k, G, R, a, modulus, map);
+
+	if (limbs_equal(p.x, c->comb, c->nlimbs) &&
+	    limbs_equal(p.y, c->comb + c->nlimbs, c->nlimbs)) {
+		mul_base(c, &r, kbuf);
+	} else {
+		tab = calloc(WIN_SIZE, sizeof(*tab));
+		if (!tab) {
+			err = CRYPT_MEM;
+			goto out;
+		}
+		mul_point(c, &r, kbuf, &p, tab);
+	}
+
+	err = write_point(c, R, &r);
+out:
+	if (tab) {
+		memzero_explicit(tab, WIN_SIZE * sizeof(*tab));
+		free(tab);
+	}
+	memzero_explicit(kbuf, sizeof(kbuf));
+	return err;
+}
+
+int ecc_nistp_mul2add(const ecc_point *A, void *kA, const ecc_point *B,
+		      void *kB, ecc_point *C, void *ma, void *modulus)
+{
+	const struct nistp_curve *c = NULL;
+	uint8_t kabuf[MAX_BYTES] = { };
+	uint8_t kbbuf[MAX_BYTES] = { };
+	struct nistp_point *tabs = NULL;
+	struct nistp_point a = { };
+	struct nistp_point b = { };
+	struct nistp_point r = { };
+	int err = CRYPT_OK;
+	void *am = NULL;
+
+	/* ma is a in Montgomery form of the generic code, or NULL if -3 */
+	if (!ma) {
+		err = mp_init(&am);
+		if (err != CRYPT_OK)
+			return err;
+		err = mp_sub_d(modulus, 3, am);
+		if (err == CRYPT_OK)
+			c = find_curve(modulus, am);
+		mp_clear(am);
+		if (err != CRYPT_OK)
+			return err;
+	}
+	if (!c || !read_scalar(c, kabuf, kA) || !read_point(c, &a, A) ||
+	    !read_scalar(c, kbbuf, kB) || !read_point(c, &b, B))
+		return ltc_ecc_mul2add(A, kA, B, kB, C, ma, modulus);
+
+	tabs = calloc(2 * WIN_SIZE, sizeof(*tabs));
+	if (!tabs)
+		return CRYPT_MEM;
+
+	mul2add(c, &r, kabuf, &a, kbbuf, &b, tabs);
+	err = write_point(c, C, &r);
+
+	free(tabs);
+	return err;
+}
@@ -0,0 +1,836 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+
+/*
+ * Curve constants and base point combs for P-256 and P-384, only to be
+ * included by ecc_nistp.c. Field elements are little endian 64-bit limbs,
+ * in Montgomery form with R = 2^(64 * nlimbs) unless noted otherwise.
+ *
+ * <curve>_comb[v - 1] = sum over bits i of v of 2^(i * comb_d) * G as
+ * affine (x, y) for 1 <= v < 2^COMB_TEETH.
+ */
+
+#ifndef __ECC_NISTP_TABLE_H
+#define __ECC_NISTP_TABLE_H
+
+static const uint64_t p256_comb[63][2][4] = {
+	{
+		{ 0x79e730d418a9143c, 0x75ba95fc5fedb601, 0x79fb732b77622510,
+		  0x18905f76a53755c6 },
+		{ 0xddf25357ce95560a, 0x8b4ab8e4ba19e45c, 0xd2e88688dd21f325,
+		  0x8571ff1825885d85 },
+	},
+	{
+		{ 0x8910507903605c39, 0xf0843d9ea142c96c, 0xf374493416923684,
+		  0x732caa2ffa0a2893 },
+		{ 0xb2e8c27061160170, 0xc32788cc437fbaa3, 0x39cd818ea6eda3ac,
+		  0xe2e942399e2b2e07 },
+	},
+	{
+		{ 0xb9c0d276abc3e190, 0x610e3d4dcb55b9ca, 0xd16dbd025720f50a,
+		  0xd0ed73dca607de84 },
+		{ 0x3bbde5bf49219fb5, 0x698e12c057771843, 0xdb606a9763470a5e,
+		  0x61c71975853635d5 },
+	},
+	{
+		{ 0xeb5ddcb6ec7fae9f, 0x995f2714efb66e5a, 0xdee95d8e69445d52,
+		  0x1b6c2d4609e27620 },
+		{ 0x32621c318129d716, 0xb03909f10958c1aa, 0x8c468ef91af4af63,
+		  0x162c429ffba5cdf6 },
+	},
+	{
+		{ 0x4615d912c1d85f12, 0x1f0880b0e1f4e302, 0x336bcc896f1fca13,
+		  0xda59ad0dc70dedbc },
+		{ 0x3897efaeb0f62ece, 0xbaed81cdf4990cfd, 0xa3b1c2f260321bbb,
+		  0x2aefd95addc84f79 },
+	},
+	{
+		{ 0x2d427e3cee9e92e6, 0x43d40da0437fe629, 0x0006e4e06ab72b31,
+		  0x21ccfbb46f5c8e02 },
+		{ 0x53a2f1a753e821ec, 0x5d72d201e209d591, 0xfd84a26445e8ad41,
+		  0x86ee0e684059cc6e },
+	},
+	{
+		{ 0x3d8242d09248fce2, 0x32d4bf827f49f33d, 0x78807beb29d41fd1,
+		  0xfce48b99f8f562cb },
+		{ 0x72a7d4849f38f097, 0x1b482c10a37059ad, 0xc1aa8284472e5ed3,
+		  0xc5d6f3bbef23e9c9 },
+	},
+	{
+		{ 0x23f949feb8a24a20, 0x17ebfed1f52ca53f, 0x9b691bbebcfb4853,
+		  0x5617ff6b6278a05d },
+		{ 0x241b34c5e3c99ebd, 0xfc64242e1784156a, 0x4206482f695d67df,
+		  0xb967ce0eee27c011 },
+	},
+	{
+		{ 0x569aacdf9fc3df19, 0x0c6782c7c34c6fb2, 0xbb5f98b2c4ec873d,
+		  0x5578433b9fe9e475 },
+		{ 0xfa14f3869ca84821, 0xb8ef658d39589501, 0x4022c48e07127b8e,
+		  0xcbc4dfe35402ea12 },
+	},
+	{
+		{ 0x092ef96a2ad408a3, 0xf1e1a4c4cfbc45a3, 0x966b2676efeecdee,
+		  0xa0e2c6713a6216c5 },
+		{ 0xcd6e22a292c4bf61, 0x56d99a11d830dfc7, 0xb8c612bd259de547,
+		  0x3d8e9a72e91f8ff7 },
+	},
+	{
+		{ 0x0b885e962352b4ff, 0x6be320d2a6545766, 0xbd22a444b9a59e72,
+		  0x2f2d32d6ccc55d7d },
+		{ 0xd86e4c4cddcec70b, 0x19cdb0e97a25c934, 0x542ade069ca97e28,
+		  0x58c5927c746517f7 },
+	},
+	{
+		{ 0x24abb0f08d087091, 0x6aa2c2ef51add8de, 0xc3e1cb4ccc2a2134,
+		  0x3563112895589212 },
+		{ 0x3bf17d2a7984344b, 0xbcb6f7b2f8a142cc, 0xd6057d8a08ec9266,
+		  0x75c150d22852405a },
+	},
+	{
+		{ 0xa8f88eb5a9fee73e, 0x72a84174576ea39b, 0x671fa0ade2692e7d,
+		  0x2556288596769f9e },
+		{ 0x254323bce850a6b0, 0x74b61c18fff6c89a, 0x2e7c563fcfae2690,
+		  0x2cf454b7164afb0f },
+	},
+	{
+		{ 0xe312a5618f10f423, 0x59a1f1fff2b85df4, 0x56c5991941c48122,
+		  0x74953c1eae3d175f },
+		{ 0x4d767fc78859244c, 0xc486bc00719a4cc1, 0xdd282985df1c1787,
+		  0x1143301aae93c719 },
+	},
+	{
+		{ 0x7201a1d61fab7d71, 0x65931f5432cbbee8, 0x202955d3dcb387ee,
+		  0xa5045ba5c4678432 },
+		{ 0xcfb5ee87dca85ff6, 0xdd25a7c6dfec0f67, 0xfee47169356a87c6,
+		  0x20a8f159c3d7ece9 },
+	},
+	{
+		{ 0xe4ac8b33070d3aab, 0x2643672b9a2cd5e5, 0x52eff79b1cfc9173,
+		  0x665ca49b90a7c13f },
+		{ 0x5a8dda59b3efb998, 0x8a5b922d052f1341, 0xae9ebbab3cf9a530,
+		  0x35986e7bf56da4d7 },
+	},
+	{
+		{ 0x21e07f9abc0a70c0, 0xecfdb3a2989a0182, 0x360682c0e40e8125,
+		  0x73a637952f837f32 },
+		{ 0xf4eb8cef9c0d326b, 0xefb97fecebf4c7a5, 0xf9352123af3d5d7e,
+		  0xb71ef4ef34e22ab1 },
+	},
+	{
+		{ 0xd6bd0d810d488032, 0x1676df9971f0b92e, 0xa7acdcfcb6d215ac,
+		  0x82461a26cd0ff939 },
+		{ 0x827189c0b635d2e5, 0x18f3b6dda92f1622, 0x10d738aa05cef325,
+		  0x12c2a13f39bb0aa6 },
+	},
+	{
+		{ 0x5f94d8deb50b4e82, 0xbcd9144e34bd93e9, 0x61c3392107c08623,
+		  0xedec947e7e3de8ee },
+		{ 0x9d2da51d2f21b202, 0xc0c885cd96692a89, 0x4a613462a5e7309c,
+		  0x227788550f28dee6 },
+	},
+	{
+		{ 0x1ff0bd527695447a, 0x63534a4a42ae2627, 0xd96af0dad0cc09f2,
+		  0xb59ea545412d3e1a },
+		{ 0xd10518cf6a759072, 0xffeec37c10475dfd, 0xacbc29ccb25089c4,
+		  0xbf3dfc8521b6d4ee },
+	},
+	{
+		{ 0x8f2eacfe49388995, 0x000fc8d4841be9ed, 0x2ed8085a6955c290,
+		  0x1929cf606d8e176f },
+		{ 0x2efd26a5fd1a09db, 0x58d767ad6cb626cd, 0x13a81b95b26c6e05,
+		  0x68fe61078f61832b },
+	},
+	{
+		{ 0x4ad7de2e2d85c2f6, 0xcd552fcb510101a1, 0x638d122b02acdabf,
+		  0x117221e850bfd921 },
+		{ 0x08571ee199a99129, 0xebd046d1ba2f03a9, 0x035ed7baa6f8a181,
+		  0x8aabf98d3187c6f3 },
+	},
+	{
+		{ 0xaf8e65cae3ab5f4e, 0x8b0b8b897561a69c, 0x37e83aa0b17c1e66,
+		  0xe894d84cf8d80edc },
+		{ 0xf1e465e7ce514e22, 0xc7fa324ca72340ef, 0x08297fcae7370673,
+		  0x4f799682b119ae5e },
+	},
+	{
+		{ 0x014d6bd8f180f206, 0x56640c8b7ab44f55, 0x9a39660d93f9a5b8,
+		  0xcac069e9959b68f1 },
+		{ 0x2bf6b65e208d9918, 0xb7e45dfb3f943291, 0xad5770f0d439c712,
+		  0xfec635e17654d805 },
+	},
+	{
+		{ 0x37221cd13f031a88, 0xe4d53d2f0b5558d4, 0x2ede8e8fdafc51cd,
+		  0xb587284ca8a883ea },
+		{ 0xfa37674044fa5251, 0x5e5e18f95c5e3528, 0x8af51fac6e10b958,
+		  0x09be79032c429b30 },
+	},
+	{
+		{ 0x7a468ba47f29936d, 0xacbbe3657cfb8176, 0xe892c10a4db9cd5d,
+		  0xcb2f29d7a1aade8b },
+		{ 0x3087eef4efffcb14, 0x92a7f3ec2afe8f2e, 0x199d89b8136f29d2,
+		  0x3131604eb4836623 },
+	},
+	{
+		{ 0xf5cca5da31b5df76, 0x9431318676a4abc0, 0x5db8e6f71877c7c7,
+		  0x3ce3f5f96031ac99 },
+		{ 0x585961d07e7cef80, 0x5ed6e841d424f16a, 0x18289cd056b16a49,
+		  0x8008d03b2e5770fa },
+	},
+	{
+		{ 0xc8c2af64254e39de, 0x783cea738582571c, 0x2f2f55f1a6edd971,
+		  0x7e00cc92c86bf30a },
+		{ 0xa0db735447d7491f, 0xb3eb751ca5b12260, 0x3bc39a23297fb234,
+		  0xd1330c20b8b4bfe4 },
+	},
+	{
+		{ 0xfb776af07824d53a, 0x04709096422dea35, 0x6f480b6b5fec3ac7,
+		  0xdb2b1b62e27edda4 },
+		{ 0x0bba904cda78b494, 0x37ef59b691a147f7, 0xf880517726a4730a,
+		  0xecc9d79aa8ab368e },
+	},
+	{
+		{ 0x628e05c185a4bd0e, 0xebf7b67800e244e8, 0xf645947b8b176eeb,
+		  0xc92bf8301641ab35 },
+		{ 0x7a039c1a21be7a6f, 0x11e4354d2fd4bd92, 0x42552422886fd224,
+		  0xdbf3194cc44ced37 },
+	},
+	{
+		{ 0x832da983c56f6b04, 0x7aaa84eb8ef098ae, 0x602e3eefa6a616a2,
+		  0xc2824ddcb7b717a3 },
+		{ 0x19f50324ddb0a2e9, 0x04553a285bedfbbd, 0x37ea8b12aa1aee0a,
+		  0xc1844e79945959a1 },
+	},
+	{
+		{ 0x5043dea7e0f222c2, 0x309d42ac72e65142, 0x94fe9ddd9216cd30,
+		  0xd6539c7d0f87feec },
+		{ 0x03c5a57c432ac7d7, 0x72692cf0327fda10, 0xec28c85f280698de,
+		  0x2331fb467ec283b1 },
+	},
+	{
+		{ 0x651cfdeb43248e67, 0x2c3d72ceee561de8, 0xa48b8f33443dac8b,
+		  0xe6b042fe7991f986 },
+		{ 0xd091636de810bcd2, 0xfc1e96aea97416d7, 0x2b6087cb2892694d,
+		  0x0f8ac2459985a628 },
+	},
+	{
+		{ 0x54e908747f2326a2, 0xce43dd44fa9e1131, 0x4b2c740cd3d2d948,
+		  0x9b0b126aa86e8b07 },
+		{ 0x228ef320b77f5af2, 0x14fc8a01ca07661c, 0x1d72509ed34f1a3a,
+		  0xd169031729d9086e },
+	},
+	{
+		{ 0x13e44acc03c5fe33, 0x13f4374e0105bbc6, 0x0cba5018cb4451b8,
+		  0xa1a38e4afa29a4e1 },
+		{ 0x063fb9a8f4403917, 0x7afe108f996ea7f2, 0xec252363f93a1f87,
+		  0xc029c8117e432609 },
+	},
+	{
+		{ 0x25080c29486e548e, 0xdaa411327868ab32, 0x46891511d61d1a3a,
+		  0xc87f3f533efc8fac },
+		{ 0x984f613ff3e31393, 0x10bb15f67648f5d2, 0xe4990f2bdefaa440,
+		  0xce647f03dd51c31d },
+	},
+	{
+		{ 0x3161ebdd9c2c0abf, 0x48b7ee7bf497cf35, 0x9233e31d94dd9c97,
+		  0x4aef9a62c5d2988f },
+		{ 0x89a54161a03e6456, 0x9d25e003c1f02b47, 0x8784cdbfc1857782,
+		  0x7928cafd0222b49c },
+	},
+	{
+		{ 0x5a591abdecf4ea23, 0xb2725e8a80bd9b8a, 0xf569679f29ff348b,
+		  0xa28163d36f22536a },
+		{ 0x89e7a8f621c43971, 0x60cbe4a1c4a09567, 0x41046c8f5928b03d,
+		  0x646feda7ef74a95a },
+	},
+	{
+		{ 0x3aef6bc05d75d310, 0xf3e7f03c82476e5c, 0x9dcf3d508419b8a0,
+		  0x221a3885eaf07f07 },
+		{ 0x16d533f337bdcb7d, 0xd778066bbb49550d, 0xf6f4540936c2600c,
+		  0x7544396fc1c61709 },
+	},
+	{
+		{ 0xf79f556fde08cd42, 0x7d0aba1ee13cadc8, 0x841d9df6d4d81fef,
+		  0x8f7ae1f2602d2043 },
+		{ 0x950c4de4b57ee181, 0xfe51e045c55cf490, 0xdb60b56a1efdd0a8,
+		  0x276bccb3bf0fa497 },
+	},
+	{
+		{ 0x7926625b19e5a603, 0xf1b98e93e1bf712b, 0x933ecb52e33abecc,
+		  0x9ebfc506f826619b },
+		{ 0xd2965f67a1692c52, 0x8ac4012dfc4f9564, 0xa8af57036739f003,
+		  0x7dd2282dbc715e13 },
+	},
+	{
+		{ 0x3ec01587cf2bb490, 0x5346082c3f1ea428, 0xf2c679e26739e506,
+		  0xeab710d6930c28e4 },
+		{ 0xe9947ff8e043249a, 0x63640678ad54b0e6, 0x8cde42591854eaaf,
+		  0xf1feeaec6b25bdce },
+	},
+	{
+		{ 0x49f7e8991bdd2aa2, 0x88fd273534e3cae9, 0x5ac0510182cbfea2,
+		  0x324c9d414cf84578 },
+		{ 0xa242311719f13061, 0x69d67cf15f3b9932, 0x32ecdb3cdde2dfad,
+		  0x2f74d995b916f7a6 },
+	},
+	{
+		{ 0x35f7ed423d14bc68, 0x32f63a0445574f91, 0xd04108335e8801e7,
+		  0x63b6f13c1c9c1462 },
+		{ 0x180dcbcd9dc7201f, 0xa07b5b2c360350df, 0x2582b2774236f5cc,
+		  0x90163924a7ab06b9 },
+	},
+	{
+		{ 0x35e751b50767cdf2, 0x808372e69d8e2838, 0xcbad6b30646914d7,
+		  0x4eeeb1de6c7b3cab },
+		{ 0x3ef3af968c965004, 0xd162290fd281920b, 0x4626c313181f811b,
+		  0x5fa42f4fbe61dd14 },
+	},
+	{
+		{ 0x1f5a9c53a185e98e, 0x13c28277ea9e83c3, 0xb566e4c0b693a226,
+		  0x2ea3f1c001533e9e },
+		{ 0xb4dbcc336215a21f, 0x7df608c3cb4e98f0, 0x677df928b4dd95dd,
+		  0x4c1d7142eeed2934 },
+	},
+	{
+		{ 0x30bf236c86a2ee12, 0x74d5a12705ecb4c0, 0x9ef43b0f1601cca9,
+		  0xbe1b1bf9ac4dd202 },
+		{ 0x84943e4717b6f93b, 0x6f789757cd5214b3, 0x5e0db1a97f313dfa,
+		  0x0515efacece0b72b },
+	},
+	{
+		{ 0x433a677ca78c3f8b, 0x204a9feaf376a9c1, 0xb6bfbea444baeadf,
+		  0x5a43cafd2b48a3f4 },
+		{ 0xe25a7d0b67d1d226, 0xb2115844f6837985, 0x8c9cca3ed87c2b88,
+		  0xecd4bc73894772e1 },
+	},
+	{
+		{ 0x368abec6783490e7, 0xf26da8bdd925c359, 0xf9b643e5e8fb0679,
+		  0x7ab803d9b555d175 },
+		{ 0x1b4059994ebae595, 0x07fbbf25ba417a49, 0x02d7cf1cc617957a,
+		  0x79070ea5565c1fbb },
+	},
+	{
+		{ 0x70194602d9b028fa, 0x9c49969d9ff06760, 0xbf4add816ad27b42,
+		  0x7d1f226d8651524e },
+		{ 0xb0779b40eecd7724, 0xd356077265938707, 0xe3a61fe5d054b903,
+		  0xd6f5a3433365136b },
+	},
+	{
+		{ 0x25c87c76d2970fcf, 0x7c9f60a04d5546a8, 0x7dab072f8dd8bf8c,
+		  0x3d10907ce8ff9f28 },
+		{ 0xb08d6d0e34bb2a29, 0x5dfd4907c3fcfdaf, 0xe4a2d4b147123ba6,
+		  0x6e9eef0b42de6d8d },
+	},
+	{
+		{ 0x81255af5cbb55f9d, 0x579f27055328d39e, 0xa7bfc9173e5ae663,
+		  0xe9b55d57a1246e42 },
+		{ 0x240ecd9475629188, 0x8748d297457bd3c0, 0x50e215ef373c361c,
+		  0xaf9d8a8618c967b9 },
+	},
+	{
+		{ 0x79a041040a04143f, 0x03f7410fc700c616, 0xe8f2a3f291108ca6,
+		  0xa26d67e8f5ac679a },
+		{ 0xa15dbfebb83fbd9a, 0xf1aaebd23a0b5587, 0x639a97ddce0ead44,
+		  0xf253b00c71d12ee0 },
+	},
+	{
+		{ 0x7baecf4c9e35e57c, 0x522e26a16786e3a5, 0x600b538b8af829a2,
+		  0x19fa80b72c6de44a },
+		{ 0xb52364f0aaf0ff52, 0x2e4bc21a6714587f, 0x401377a3c245967d,
+		  0x65178766a23cf3eb },
+	},
+	{
+		{ 0xc1c81838923ac000, 0x42021f02c4abc0ee, 0xcde3bc9a47132a20,
+		  0x6f52a864c69f55fb },
+		{ 0x0bdfd3e4df89ff6a, 0x244c943bc88bd74e, 0x649e0b532612998b,
+		  0xce61ebc3d3413d4a },
+	},
+	{
+		{ 0xe31629042cba5a90, 0xa72710aedb6c224e, 0x51831390d87e44db,
+		  0xa687dc9848fe2ef3 },
+		{ 0x857e985516a21ca9, 0xe3428d8ec9a7bc12, 0x16d3bcd012b044a2,
+		  0xe6fa0c69e85f6704 },
+	},
+	{
+		{ 0xe4cca34b8fd42692, 0xc86d49a6e15f3acf, 0xbfe1f263a6b18392,
+		  0x0664c933dcd266f6 },
+		{ 0x86738cf519399d88, 0x1cbcc8c3749ce6bc, 0x28171f7bc773b884,
+		  0x306fc95701acf19e },
+	},
+	{
+		{ 0x0da7a737afb6a419, 0x637fc26a195fbc40, 0x0fc8f8769c64e8e7,
+		  0x2a68579b208c0626 },
+		{ 0x82e823108628abc3, 0xe4e09313ab23ae94, 0x66bf9adbe5155cf1,
+		  0x17909f6ce8a2dd0c },
+	},
+	{
+		{ 0x767c359643d7ad31, 0x7ba3a1aa49ccef62, 0x5261c3160242bf5a,
+		  0x85f452199eb82dfb },
+		{ 0x554cb38237b42e47, 0xc9771ec14cf66133, 0xde70617a153905a3,
+		  0x2cab26fcbc61316d },
+	},
+	{
+		{ 0x7dababbd75c10315, 0x9a8fbe88a48df64e, 0x2b076fe5e1b8f912,
+		  0x1a530ce9ccbd50dc },
+		{ 0x47361ab76647d225, 0xf84e73be4d636a15, 0xd58fcaaf5904a2fa,
+		  0x73747d4b38523a19 },
+	},
+	{
+		{ 0x6e6b0fb8b6864cc0, 0x5d8a0027ab3b623c, 0x5e6665389a1cfc9c,
+		  0x816b19de521e4ff3 },
+		{ 0x56709ad00bc447f8, 0x1d46cb1c8f1464d7, 0x49cef820a949873d,
+		  0x02804692d9d3e65f },
+	},
+	{
+		{ 0x1ae0ea28ad8b5976, 0x4e9ad48e869458fb, 0xe9437ec996cfedf8,
+		  0xa4f924a22afa74d9 },
+		{ 0xcb5b1845aaf797c0, 0xe5d6dd0eba6f557f, 0xa1496fe691dc2e7c,
+		  0xad31edac8c179fc7 },
+	},
+	{
+		{ 0xf9c5e9de44b06ed7, 0x6ce7c4f74a597159, 0xd02ec441833accb5,
+		  0xf30205996296e8fc },
+		{ 0x7df6c5c6c2afbe06, 0xff429dda9c849b09, 0x42170166f5dd78d6,
+		  0x2403ea21830c388b },
+	},
+};
+
+static const struct nistp_curve p256 = {
+	.nlimbs = 4,
+	.nbits = 256,
+	.comb_d = 43,
+	.p = {
+		0xffffffffffffffff, 0x00000000ffffffff, 0x0000000000000000,
+		0xffffffff00000001
+	},
+	.a = {
+		0xfffffffffffffffc, 0x00000000ffffffff, 0x0000000000000000,
+		0xffffffff00000001
+	},
+	.rr = {
+		0x0000000000000003, 0xfffffffbffffffff, 0xfffffffffffffffe,
+		0x00000004fffffffd
+	},
+	.one = {
+		0x0000000000000001, 0xffffffff00000000, 0xffffffffffffffff,
+		0x00000000fffffffe
+	},
+	.b = {
+		0xd89cdf6229c4bddf, 0xacf005cd78843090, 0xe5a220abf7212ed6,
+		0xdc30061d04874834
+	},
+	.p0inv = 0x0000000000000001,
+	.comb = &p256_comb[0][0][0],
+};
+
+static const uint64_t p384_comb[63][2][6] = {
+	{
+		{ 0x3dd0756649c0b528, 0x20e378e2a0d6ce38, 0x879c3afc541b4d6e,
+		  0x6454868459a30eff, 0x812ff723614ede2b, 0x4d3aadc2299e1513 },
+		{ 0x23043dad4b03a4fe, 0xa1bfa8bf7bb4a9ac, 0x8bade7562e83b050,
+		  0xc6c3521968f4ffd9, 0xdd8002263969a840, 0x2b78abc25a15c5e9 },
+	},
+	{
+		{ 0xa54768dab1b43eef, 0x13e41f47e14fda22, 0x774df203faef6863,
+		  0xf795a034bd7471b3, 0xf0958718b47de2e9, 0xc92f7888e1160cff },
+		{ 0x86ded97b0146c790, 0x015918f5480a4b7b, 0x05588920424e8459,
+		  0x37455914eecf8b2b, 0xe7d3df1fb968a6fa, 0x07a0ffd6bad0719f },
+	},
+	{
+		{ 0xda37cd535c54db6f, 0x0e37890a91f06c5c, 0x1730ef7be7ae7db5,
+		  0x2b3dcd51ff045f54, 0xf5db3c3c72cc8451, 0x3165d6efcf0c185c },
+		{ 0x177c4f6bf5958d78, 0xcb29d22f8d676a9f, 0x3bcf0068792ac96d,
+		  0x60d1c6b719df5641, 0x426e412a68a099f8, 0xf9ca0c5c9f74d52b },
+	},
+	{
+		{ 0xf186d6bcc88d568a, 0x872bc4c7528535dd, 0xc9e7432edfe64dc3,
+		  0xd9fc4832d795ea57, 0xf4ffdb81c845af2b, 0x66d7e7882b670517 },
+		{ 0xa7c1be04d7b7a1c6, 0xbed88479d5b2a249, 0x62ff8aba03f2ef6d,
+		  0x60ecaac420dc701d, 0x9f4b559f4ff10119, 0x0582c9313cd54fd0 },
+	},
+	{
+		{ 0x394fb84de86e3f64, 0xfe4a36e7ff13314e, 0xa1e44b14dc261ec2,
+		  0x3924e50a7420408f, 0x637e330242ed7626, 0xeb657b10fd711ba4 },
+		{ 0xc16d01c5340949bb, 0x30e043267f1f42c7, 0xe7465819b056d872,
+		  0x3386f1c6886fb3db, 0x5be463a5be56f774, 0xa96fd3b74694e15a },
+	},
+	{
+		{ 0x95dd5ee5a98b4254, 0xea328205aa845e67, 0x98640fb5a1e36348,
+		  0xd1bc5c251add5ee7, 0xc3158a423d11b799, 0x5feb68ed47c83d54 },
+		{ 0x7c5a1204963a207b, 0x2f2b2c7eee4671f8, 0xb63d291cd42867a6,
+		  0x0b073620139530f4, 0xbe149492abb05b99, 0x21417da455accd2a },
+	},
+	{
+		{ 0x9408555e9e5eba15, 0x416250137b7572c5, 0xfa53ee50bfff6ea7,
+		  0x3d682de1e7b178c3, 0xb3e8769dec329f53, 0x1ab8c82e9eb524f4 },
+		{ 0x5bbd538dde2f1eb9, 0x1d1b0bea2b19c51e, 0xf785f9b98cb06eee,
+		  0x5cff29c6f58f21d5, 0x44aaa52245cbaef3, 0xd60c19427de40246 },
+	},
+	{
+		{ 0x378205de2f9fbe67, 0xc4afcb837f728e44, 0xdbcec06c682e00f1,
+		  0xf2a145c3114d5423, 0xa01d98747a52463e, 0xfc0935b17d717b0a },
+		{ 0x9653bc4fd4d01f95, 0x9aa83ea89560ad34, 0xf77943dcaf8e3f3f,
+		  0x70774a10e86fe16e, 0x6b62e6f1bf9ffdcf, 0x8a72f39e588745c9 },
+	},
+	{
+		{ 0x73ade4da2341c342, 0xdd326e54ea704422, 0x336c7d983741cef3,
+		  0x1eafa00d59e61549, 0xcd3ed892bd9a3efd, 0x03faf26cc5c6c7e4 },
+		{ 0x087e2fcf3045f8ac, 0x14a65532174f1e73, 0x2cf84f28fe0af9a7,
+		  0xddfd7a842cdc935b, 0x4c0f117b6929c895, 0x356572d64c8bcfcc },
+	},
+	{
+		{ 0x984a6aed6420bc66, 0x6d90e0e0896a24a6, 0xe0adb93a18713003,
+		  0xf00d424c1a8369fc, 0x636ebf14712ae802, 0xee39ff8ebe9d739a },
+		{ 0xb330dd3e94f6d1dc, 0x6ba6780eb7731cf8, 0x4e569408198be5a2,
+		  0x6639523b0193a22c, 0x6978cc9d91aa1455, 0x62062d8f329f9763 },
+	},
+	{
+		{ 0x7159107d80efff78, 0xf8ed5f8e8e4c39d5, 0x64a2265cc15e679c,
+		  0xfc514e17a6d96c81, 0x59c86545f093e0a8, 0x804b0a588b5a336a },
+		{ 0x94c32118cb9dcbca, 0x2deb0e385d45251d, 0xd1092b0986869572,
+		  0x073bf838fb2e9f97, 0x76b6d7d6de700fcb, 0xd2a6d110f2ddce5f },
+	},
+	{
+		{ 0x6da7ccd0229de19e, 0x5050d45df0aa039d, 0xf9f01d68d9e7a861,
+		  0x6d8b9f2000aa05f2, 0xae3d9698742cd4d9, 0x43e477abd560c394 },
+		{ 0x73d594991cb6dd81, 0x689162b2fac3f62e, 0xd6187ca864d1d0d5,
+		  0xe8421a0d2f067457, 0x9b266acbea7c3a8d, 0x707e0e6e44df5cb3 },
+	},
+	{
+		{ 0x604b2a1a026511a0, 0xd4f6cf16256f4076, 0x7d823347b315a642,
+		  0x8f805833786aa438, 0x9883df85f04bb4b3, 0x02bc10305bba6d84 },
+		{ 0xfe39a024a72c03ac, 0xa980db635f2dbfd0, 0xcd53149f4f259ec6,
+		  0xe969079b43f53f97, 0xd3849fdb42f9f27c, 0xd2cfd3f842653dc9 },
+	},
+	{
+		{ 0xbf69fe6a6abe7d80, 0x4932288192bb50e2, 0xc9e2f7fb61e8b18d,
+		  0x24c74788f6c82421, 0xe79e5e3011c0b244, 0xd6612c70e0484571 },
+		{ 0x7863ff927ef82d17, 0x692790feb0a1b01c, 0xa2d6ffb5afe51546,
+		  0xacdb43f26cf550c6, 0x3b3243dfaecfaf8f, 0x9557335ac233bcd9 },
+	},
+	{
+		{ 0x25e08c8faff5b387, 0x112c11e2d06208ce, 0x61031c1765234214,
+		  0xba06f5550514764d, 0xfaacf6f39bd197d0, 0xe4b032321464a57f },
+		{ 0x00c19adfe35dcd69, 0x81b75730a1c2646c, 0x47baa4fee0c50e32,
+		  0xe9297832bcaddb3b, 0x1768d2f9d712c6cf, 0xfcef29fdb82e9eea },
+	},
+	{
+		{ 0xdbe04c3044ce3ad8, 0x995fbb1b4ce8aad5, 0xdbf8b54670911457,
+		  0x9e683b5b3f7a1757, 0x7b89a08a9c7bd62c, 0x448865a40b3fc97e },
+		{ 0x0ac9abfc3bb01e94, 0xa07760421e756124, 0x0aa6c335d9deed97,
+		  0xe270580f72603e08, 0x70857a946c783bb2, 0xa0047774caa929ae },
+	},
+	{
+		{ 0x56211190a353e889, 0x052917c3190eb198, 0xadfd85b03eee3d12,
+		  0xde1d761779fd9c91, 0x05be51b7bf500159, 0x271f07178fcb87f1 },
+		{ 0x02673e273a75ac71, 0xb1b7246eda12da8d, 0xb25647928f5fb8c0,
+		  0x0a22cbe1063b1d7f, 0xb0d7a7365649976e, 0x8f8e6e289e96b15d },
+	},
+	{
+		{ 0x8fc113f98312351c, 0xe837b9e0c5eff002, 0x7cb9ef074dad72fc,
+		  0x18a8d43eb5eb7ee3, 0x2cf3ae844925efdb, 0x376e9e857756ec6a },
+		{ 0xf77a79c8a3e3705f, 0x2d590b7d6c5fbab3, 0xa59713e27a4766c3,
+		  0xb5da6a6861544174, 0xadb04a8adab1fe76, 0x03b6138d375143b4 },
+	},
+	{
+		{ 0x20d88a80c1bfa043, 0x88806999672583ce, 0x195a89eaaea9b605,
+		  0x0b9b4e8532bac07b, 0x8279965683868df6, 0x83c58afab52711a9 },
+		{ 0xb895c13d1c869283, 0x00f98d046206dde6, 0x76caaa22884bf311,
+		  0x22b2137f995b29a5, 0x7f645809b098b07b, 0xa540c8a6050e2552 },
+	},
+	{
+		{ 0x47980509e562d904, 0xe736f89d031e112c, 0xbc6bfb0765d8ae25,
+		  0xe9ed4cc4ca459646, 0xf540e90e2fff67ff, 0x836280eb1a314e11 },
+		{ 0xa710b25041610627, 0xefc22b1573a9f9a2, 0x60f20789456498c0,
+		  0x417920438052f4e7, 0x5c850903d5c0e80d, 0x52df5275bf1d8815 },
+	},
+	{
+		{ 0x25539de98ece218d, 0xb36574a8dca420ba, 0x9d1812680e0d07fe,
+		  0xea79a5f5ad3ed34f, 0x8b739ad57c9277cf, 0xd88659886ee9a930 },
+		{ 0xaf07bfb621591a3e, 0xe0138c6508f3524f, 0xd3128f1297ee315e,
+		  0x67f8641e21045f63, 0x3e1a96b140c73a2d, 0x8976b70305f51122 },
+	},
+	{
+		{ 0xdeaf635731960db4, 0x680b054e5948d7f7, 0x0841e40fd272bb5c,
+		  0x94d37db26e36117d, 0xaf2d001547f63ec8, 0x82665cdc47493309 },
+		{ 0xfe90e844abbe3851, 0x8357709afb79bc0c, 0x811a64d2b6bcc044,
+		  0x1937c988882b3415, 0xe8b28724e267b271, 0x84d1eed0af89ed33 },
+	},
+	{
+		{ 0x52b8234f54c894a7, 0xfe54146fa2d11b70, 0x6412b5eb0aab6097,
+		  0xa62499906a13a9da, 0xd2b1eb50adc448ca, 0xe7ab51f9b115ab92 },
+		{ 0x4638ee62e76551d8, 0x74c3c1e1afe9c98d, 0x59000ad060d77322,
+		  0x0a4b105ba06adc9a, 0xcdaeb4a496a6f616, 0x8c79c4a1864b49dc },
+	},
+	{
+		{ 0xc09c32d1c0b1bf15, 0x005d510f88d74e44, 0x031f9a9afc2c089e,
+		  0x08aac7294ba183f0, 0xf227a7ceaf2245eb, 0xb4ec33cbb3a864ff },
+		{ 0xdb76decd570a24f3, 0xea59387a12283a9e, 0x81b7c569341ef9a4,
+		  0xad7c98bd8d77833a, 0x2182133b49ca80ff, 0x1de1d456085802b7 },
+	},
+	{
+		{ 0xeead25b2e1c02860, 0xb2ae43694ff42d2e, 0x4b39a2ddfd61c1b0,
+		  0x29c826ea968718a5, 0x877fdf15d9751a0a, 0x00b321dfb54affdf },
+		{ 0x3c7c0778d4d5dbf7, 0x858a0fdccfc47423, 0xbd8e6544185b3063,
+		  0xa22c3ef62da46a04, 0x5c2d84016a6c0ce1, 0x260246eddd6329ae },
+	},
+	{
+		{ 0x71753fc00c6463f6, 0x7ec14c015c6c9e33, 0x28b9ab9441ce6153,
+		  0x3a1ac251a6702c8d, 0x2b124bc49ed6cb1f, 0x7a11c4be4fc7383f },
+		{ 0x1414913509fac991, 0xf7c188d3cb1ee336, 0x754bc47391c3f406,
+		  0x71d34587cad39500, 0x213dd1a7dd0399a1, 0x8457a8f671d05899 },
+	},
+	{
+		{ 0xa921ca662e9c06d3, 0x1d8974e89ba6521f, 0xbb465c775f79f791,
+		  0x8f983f083a3954c8, 0x8492f8398b3935dc, 0x2b87d9c290c04426 },
+		{ 0xcec76ea403e60a28, 0x648e9830aa631308, 0x7b542f791eb86b73,
+		  0xfc8cc9a3150d854d, 0x2be86940bfcc83fe, 0x2e58a13ac88c7585 },
+	},
+	{
+		{ 0x19249a8fd1bc237f, 0xdec1c6a563505555, 0xc8256977bad2a93b,
+		  0x78533659fc598170, 0x888a6578ee7e53cb, 0x28783b0e33766db3 },
+		{ 0xcf791e56e42c28f2, 0xfbf8dde8f9c37f4c, 0xf0ffaf1712c05395,
+		  0xd27d21e9daf2f012, 0xf90432da9a7be009, 0xa459c036a8012f28 },
+	},
+	{
+		{ 0x4d99a7cac8b1c6d4, 0x8088818825c899c0, 0xbd27e9be2ebdeb3d,
+		  0x73c3e0aa054e77c1, 0x180c848498534ce5, 0x750d52f754ffa9cd },
+		{ 0x5f26eeb16f702f4c, 0x427fc6e4cc76d8f4, 0x93126b8d026b631d,
+		  0x5356b93917e145a7, 0xc79ca872c0be7c84, 0x3fca7cad4b615fb7 },
+	},
+	{
+		{ 0xed48fe78d0241021, 0x252b14a0142f7f8e, 0x19ab85c6db573a09,
+		  0x546c3960f3df906f, 0xc688f4b22c810ea8, 0xbccf0cca5ff9e108 },
+		{ 0x34f4609e3f2cc69b, 0xf3b1efe414afe4f4, 0x5d809cef37a8ef74,
+		  0xa8d1978a176ba328, 0x75dde11fdf59ecb9, 0x34eeeaffa9916ee2 },
+	},
+	{
+		{ 0xe7f603f248e83c85, 0xa94a539cfa581815, 0x5a61a596dba360b7,
+		  0x6cc51dd16a77ef79, 0x4ff36ae0fdbceb9d, 0xfcff65323e8a9c07 },
+		{ 0x0ba0ce5436d4d0b8, 0x98087a452464efc2, 0xd456843bcc1a2ba7,
+		  0x677384a53853e04c, 0x625d32d56c7971de, 0x86882509f724b331 },
+	},
+	{
+		{ 0xc20fb9111a42e5e7, 0x075a678b81d12863, 0x12bcbc6a5cc0aa89,
+		  0x5279c6ab4fb9f01e, 0xbc8e178911ae1b89, 0xae74a706c290003c },
+		{ 0x9949d6ec79df3f45, 0xba18e26296c8d37f, 0x68de6ee2dd2275bf,
+		  0xa9e4fff8c419f1d5, 0xbc759ca4a52b5a40, 0xff18cbd863b0996d },
+	},
+	{
+		{ 0x684a681892a5eeea, 0x1f5b193242a09264, 0x30bd8695d98a2f34,
+		  0x6e775e019a8601fc, 0x8126bdc24ca956f8, 0x149e73d9e5595daa },
+		{ 0x876428401f851e83, 0x4b8863dbd3a7c4a0, 0xe1e43b3d8c95d7d9,
+		  0x7f1e307ea60fd528, 0xbf2fa5d134341610, 0x11ad4a8181c502d3 },
+	},
+	{
+		{ 0xc7df022e782dd401, 0xd15aa9a9a7bcc543, 0x6aa42774b94df1d0,
+		  0xab2660c30592a13e, 0xaf4e40809ffc40c7, 0x01152c8d9cd52b10 },
+		{ 0x649de1d99034a33a, 0x2b9d0ef0d758abfc, 0xdddd0bc2d458addd,
+		  0xe5366ac9c09837f8, 0xa003abbb7b1ae35f, 0x880062887ab1fdde },
+	},
+	{
+		{ 0x6b6c8f055288f1b4, 0xba05407c033738b4, 0x26cac3a941a955e3,
+		  0x28f1692f8e0e0601, 0x2032cb36842c4887, 0x6adeba457d76b20f },
+		{ 0xd282c2ce654c6f5c, 0x30584ca5be9ba4f1, 0x45d766a01b2c528b,
+		  0xe918bad7c0c6f8cc, 0x1e050b2a0560f070, 0x4fc95de12d6dd010 },
+	},
+	{
+		{ 0x2bb26072150191d5, 0xea2617618108dcf6, 0x4dfa1303e6083c63,
+		  0xfa4e0709e2876fb8, 0xf901fed0b1668763, 0xf01c53aeb82c967a },
+		{ 0xb43e59d39ed827e8, 0xb58e157e57774eef, 0x57ee54e31b83dcee,
+		  0x3d896f32613aa922, 0x69d40667b5c7bfc5, 0xd402b5cb77a2c0d8 },
+	},
+	{
+		{ 0xabeb70127d3c9923, 0x412ada8dd7ecb93a, 0xeb64dc910b71ae2f,
+		  0x52ef537aa9ab061a, 0x0863970fc1b55fae, 0xfaff5fb9b1182dbd },
+		{ 0x5551d6fed0abaa17, 0x7bb3e02072d641f6, 0x939d7793aa9d288c,
+		  0x1450f8bf9078e2c2, 0x24ccd102a086b6ae, 0x57d1796f6a3f8a5f },
+	},
+	{
+		{ 0x1023120683ce1f76, 0xd16d4b9f03ee406f, 0x9d39c39883caa4b7,
+		  0x875732f5ce299b93, 0x1e6a425d2f121f4a, 0x4b1f1d835d8c3279 },
+		{ 0xe655f58856dd6a6c, 0x23f106475843fd34, 0x932b7d942bad6ce2,
+		  0x70a0580e6772a52e, 0x3240118ac88537af, 0x9ccb2ca9d2407224 },
+	},
+	{
+		{ 0xa6a40db8710f2324, 0xb3567518c2a8a09a, 0x8816442841b5650a,
+		  0x2a352ed27570ba50, 0x23ee46b94c85d77e, 0x643aceffd858a8c3 },
+		{ 0xe067908de3f02e82, 0x8d5869f2ffb8cf81, 0x4713f0820bc8ad7e,
+		  0xe1ee44c780057c40, 0xb34395087d2cf34e, 0x4307b0e10336a207 },
+	},
+	{
+		{ 0xe9c1e45746e4d003, 0xa23978c394332057, 0x0e2f300829575db6,
+		  0x50a51ff490441e9e, 0x38ce3ed0508d4a07, 0x6a997411cfd7224e },
+		{ 0x4d147c31da6b1e1d, 0xedf604b2da8a3547, 0x7a1b8cf0d5e9ceed,
+		  0xd74e501213544e6a, 0xcc49f8da4ad968f9, 0xfb87e604cc69ada9 },
+	},
+	{
+		{ 0xde79409bdf166882, 0xd645b836d46cc527, 0xda4a02f3b6c3eb28,
+		  0x845e3c5900e7cf86, 0x733bdc9b604c6d80, 0xe3a1244b847acd97 },
+		{ 0x421312d6d128842c, 0x81f71feaa1c598ef, 0xc619465545eaf796,
+		  0x1ffb85121f338b6c, 0xe7aed7106632f064, 0xf8d1ffb7f5b6e510 },
+	},
+	{
+		{ 0x7d3f031f3eace851, 0xef43ab7025923624, 0xbae811881af6cdec,
+		  0xb7e93b49ea862112, 0xe35a4fc6af23aba2, 0xc52e1fc0aecc593e },
+		{ 0xbffa292428148b99, 0xd08040fc89e3d795, 0x7da320032db47b3a,
+		  0xe78b44e5a0eb7aa3, 0xd1648ec8f0ec090b, 0x4048dba7740fe871 },
+	},
+	{
+		{ 0x6fddb89fa00a14ac, 0x844f991508aa06e7, 0x6d5ac4a9f76aca7d,
+		  0xfba1ba85e9fa4d51, 0x159633bbb2ea0fc7, 0xa2eb0e4b76ba2854 },
+		{ 0x8a858155c11f5398, 0x30a96e535e8ea044, 0x696210c197e05a47,
+		  0x86e55f9415036f4b, 0x0c93ea9c6a96d9d7, 0xb7ba506179eba3da },
+	},
+	{
+		{ 0xd305c733cd94d7b2, 0x9ea33e363e7955b2, 0x78a98855bc73812f,
+		  0xfb1b791d48a3a9a0, 0x6e5107ee04014aaf, 0x0412b2c00ea07de0 },
+		{ 0xdd3a2408ddcaca68, 0x5d18e69ae3344f29, 0x3ce65481f9017408,
+		  0x50abb4568cbd64fb, 0x442fa5098916a9eb, 0x16b3ddc7c538c410 },
+	},
+	{
+		{ 0x6757dbfd25e331ab, 0x0efde50ba3eaafbc, 0x1cd46222d531d29c,
+		  0x1b713ca93561cb2b, 0x7d07334bfb5bc99d, 0x95dba43e885a417d },
+		{ 0x1c9c3f3f77823a59, 0x43533ba83220cb7f, 0x1b918bc182e3e401,
+		  0x66a039aacd3fec87, 0x1d39dbb02dad36d5, 0x554025959dc04be4 },
+	},
+	{
+		{ 0xdf39920847744933, 0x4264f7ea82524dd6, 0xdb57ec08e5182c6d,
+		  0x2d6778e705c5e7bf, 0x3f37793f96f53ea2, 0x6472cbae05c47e48 },
+		{ 0x9e6dd60fbf78067c, 0xa2817ec2cef34088, 0xde4715b8168edde9,
+		  0x6c57105146bf31e1, 0x98113fbbc4272bc0, 0x03bb7922cc3b90c3 },
+	},
+	{
+		{ 0xe0f23be157d88fef, 0x4125c55b0ca27a01, 0xeadf527e14a71262,
+		  0x1f2e803ccc4e9a04, 0x32e07b47d68c4fcf, 0x1577fab79db5070b },
+		{ 0xd786d6e57831990a, 0xf64ff4b154fbde40, 0x4bac5b034f9450ae,
+		  0x06ae25e055116af9, 0x33d84ea2d7b4fcfc, 0x44a92e73569c3b9e },
+	},
+	{
+		{ 0xf5bdccbabad0cb7f, 0x370f43ca958edd05, 0x3dd8232b04904a26,
+		  0x3f8106682f4458e8, 0xdfcb67b99b3ace7e, 0x54e42f2d3e1241fc },
+		{ 0xe30f3fb0db889300, 0x4ca0184b483e51fc, 0x5a32d097a638dac6,
+		  0x567a2b5ec62a1db0, 0x2a756ba3c446456c, 0x6919026dd9f8d5c0 },
+	},
+	{
+		{ 0x7f6493fc4fec874a, 0x8bb8a674d47a0770, 0x90bad2a652bd4f0c,
+		  0x16badbe2f5733b07, 0x93be07cf93a1f802, 0x1e37a01541c395f7 },
+		{ 0xfe2c0fd6216582b3, 0xdcd98bc81627180d, 0x41e037268e8c9f1e,
+		  0x93dbc22cfe8f45af, 0x5728c8a6ff45e059, 0x4f2f15cfca4a98cd },
+	},
+	{
+		{ 0xdbe2ec5d656e7d76, 0x84ad1b4bae2757bb, 0xc9297e7a0d4fec75,
+		  0xfcc673eecad3ba87, 0xb0f77621dfd1671a, 0x5c386e449704a8c7 },
+		{ 0xce78f03f3e29256d, 0x0b185938c3a6ed2f, 0x7b1e2fae7824819b,
+		  0x5a85d7f1f2d9313c, 0x238bd27973595b0f, 0x5fbf6b675c1cd2dc },
+	},
+	{
+		{ 0x84d1ffb88a3e2412, 0xf01605926515f2fe, 0x0e26ea9889905340,
+		  0xbfd7a1b7203bd3d4, 0x5301273a88ea0bda, 0x2f424475b28dd43e },
+		{ 0x31014a2b33c28afa, 0xffbdea0c01e220ea, 0x681c64e8460b81d5,
+		  0xdbe6f7286a91e1d5, 0x068bf36332619ad5, 0x4946291f27976c74 },
+	},
+	{
+		{ 0xa081a9462068e4b0, 0x1a8f5df609bfdad0, 0x5fbba5bcef28dd35,
+		  0xa3e60d4f031ff71e, 0x2d47689b702ca18e, 0xd283f247c9b8e66b },
+		{ 0x63e65dd7859ea140, 0x123da61f42aacdc3, 0xa8a9e893336f680c,
+		  0x1cc4e12ac23d43ac, 0x421e80d586a1fff8, 0x833d60d543deecc9 },
+	},
+	{
+		{ 0x3c25b57c29014f8f, 0xa19fcb1e35d8e122, 0x916c0e3ceda32ac8,
+		  0x9a23d289f36b6096, 0x5099038439a39871, 0xdc5b77b661c64196 },
+		{ 0x5a7d9917942bf2b6, 0xd21853934f41cf6d, 0x90ff1016fcc45c2f,
+		  0x9891093deb8938aa, 0xe3c49b1baac4e6e9, 0x0f21a1d1d7a8e91e },
+	},
+	{
+		{ 0x3a808e336f364b7e, 0x6a96d1b8bfa17359, 0x3387ec8552b36545,
+		  0x2fde350af712180c, 0x9219d6f4703a2183, 0x8ba27e0086457946 },
+		{ 0x7446bca0ed80a9af, 0xbaf78b6f7203637a, 0x0304129d497c9d0f,
+		  0x6df1e0356a883b68, 0x93ea2bb5e8018c47, 0xc86fd77cdb46443c },
+	},
+	{
+		{ 0x8de865d255dc2427, 0x74f7f83d6f72d126, 0xee1111786c7e665a,
+		  0x272a8b3dddf44f12, 0xad3546449164eb4f, 0x2ffbdb586859d68f },
+		{ 0xbefd36c509701865, 0x63c256162c983d01, 0x15a7ba0b2eb68703,
+		  0x3318a82b5bb0fafc, 0x8e930fa9a0804f38, 0xb7459eb6be60ed1d },
+	},
+	{
+		{ 0xace01c514260b948, 0x04a6080f49210f78, 0x0d1eef6b2241b00d,
+		  0x85a25069ef63912a, 0xcc96c4ec13dd8bc2, 0x90f14d1140d7e234 },
+		{ 0xae33f18ca69c8dc3, 0x76921f2a9adfa431, 0x18158ccf048c9f49,
+		  0x90bcf7fbfb8fb345, 0x0d50b4dc38b3ff5d, 0x3914ea0b59ef84a8 },
+	},
+	{
+		{ 0x4929d3f9d4e37cf3, 0x622183d1b24c24c0, 0x65cec0675f904d34,
+		  0x65f9931a8a6f76fa, 0xeed975b0e73282f2, 0xa045552a5e1625fd },
+		{ 0xfd6b3e02f8fe8e42, 0x5f9f40256203907c, 0x8307eedb42b2c264,
+		  0x2fb3ee719f757e92, 0x4502f2ecdc157ea8, 0xd976e7755d1cc0d5 },
+	},
+	{
+		{ 0xe46fb9a28fe1946e, 0xe91df3ed63bdde6e, 0x2e995306e9c28432,
+		  0x7b3a6fe10988235b, 0xc55199f077f92a71, 0x47dd034853cb7950 },
+		{ 0xead52de2b727a6d1, 0xb87c9f75eea9c8da, 0xf3e2f3280d944f21,
+		  0xce82734edd751edd, 0xfb83225ce616cedc, 0x15850e4b4a31eb49 },
+	},
+	{
+		{ 0x92c4b6d50196ad3a, 0x0205ea484e1205e4, 0x8e08a97c0afc5aff,
+		  0xda8687c6727827eb, 0x2eace83106e398aa, 0x3a086c0f6d69e4e8 },
+		{ 0x5ff9b7aaf286e62a, 0xc428503962aae55e, 0x4ebd4258d9530a3f,
+		  0x57ea313a8afc7fcb, 0x6d30a67522c18879, 0xd3c00cc994afb659 },
+	},
+	{
+		{ 0x53ee47c5dee0d48b, 0xbd9e84ad9dfa2397, 0x2d581e12f81ba5e2,
+		  0x26269f4f132cd325, 0x9e6224df58860a5f, 0x9306c607ff55522a },
+		{ 0xb48af6d4146950e5, 0x09920ed00436805e, 0x3a1bc276cdce7eae,
+		  0x55ba728ac39a425e, 0x6a04d4e6d961d03e, 0x13891c66736e684a },
+	},
+	{
+		{ 0x7c75175a04cd04d6, 0xb76f9bd909c27a17, 0xa0cff6d408e5fe36,
+		  0xc9097695dcd5ef90, 0x26bea24585e28054, 0x658e03c61580f068 },
+		{ 0x0da9f75e811eed27, 0x086e5e04aca0d2ee, 0xd4c157faa53a6787,
+		  0x2e9266d2b40a595c, 0x8f1cb52698fa0820, 0x32a74240a1aef514 },
+	},
+	{
+		{ 0xeb42e3d91ae86e7c, 0xd6956c8ce04a5026, 0x4c0b8b980f4302eb,
+		  0xde43c938b37211fd, 0x9fa6a158e7090f80, 0x5f3c9afc73c47fb6 },
+		{ 0x2dc4f109f850a4d0, 0x56e63a4b6fd49d6a, 0x8e80a0694cbff048,
+		  0x18d8b8cf2284afb0, 0x61dd086dc89363a1, 0x034c2202c37342a4 },
+	},
+	{
+		{ 0x1ae0c4e11c718580, 0x303f48a6bf99a0bf, 0xa5551e4491ae219f,
+		  0xdc41d9bd55a05287, 0xd5aa73e36872b123, 0x6fd94b0ce6395bf6 },
+		{ 0xbb95fdbac00afbc1, 0x9cd96208497cac10, 0x8adbd8c1ca51afea,
+		  0x94fedafbf3bc5f5f, 0x29c0217bdf9f5371, 0x5c13eb4bd9024634 },
+	},
+};
+
+static const struct nistp_curve p384 = {
+	.nlimbs = 6,
+	.nbits = 384,
+	.comb_d = 64,
+	.p = {
+		0x00000000ffffffff, 0xffffffff00000000, 0xfffffffffffffffe,
+		0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff
+	},
+	.a = {
+		0x00000000fffffffc, 0xffffffff00000000, 0xfffffffffffffffe,
+		0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff
+	},
+	.rr = {
+		0xfffffffe00000001, 0x0000000200000000, 0xfffffffe00000000,
+		0x0000000200000000, 0x0000000000000001, 0x0000000000000000
+	},
+	.one = {
+		0xffffffff00000001, 0x00000000ffffffff, 0x0000000000000001,
+		0x0000000000000000, 0x0000000000000000, 0x0000000000000000
+	},
+	.b = {
+		0x081188719d412dcc, 0xf729add87a4c32ec, 0x77f2209b1920022e,
+		0xe3374bee94938ae2, 0xb62b21f41f022094, 0xcd08114b604fbff9
+	},
+	.p0inv = 0x0000000100000001,
+	.comb = &p384_comb[0][0][0],
+};
+
+#endif /* __ECC_NISTP_TABLE_H */
@@ -12,4 +12,15 @@ void init_mp_tomcrypt(void);
 static inline void init_mp_tomcrypt(void) { }
 #endif
 
+#if defined(_CFG_CORE_LTC_ECC_NISTP)
+/*
+ * P-256 and P-384 specific ecc_ptmul and ecc_mul2add for the LibTomCrypt
+ * math descriptor, other curves are passed on to the generic functions.
+ */
+int ecc_nistp_ptmul(void *k, const ecc_point *G, ecc_point *R, void *a,
+		    void *modulus, int map);
+int ecc_nistp_mul2add(const ecc_point *A, void *kA, const ecc_point *B,
+		      void *kB, ecc_point *C, void *ma, void *modulus);
+#endif
+
 #endif /* TOMCRYPT_MP_H_ */
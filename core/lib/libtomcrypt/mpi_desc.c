@@ -26,6 +26,18 @@
 #define biL		(ciL << 3)			/* bits  in limb  */
 #define BITS_TO_LIMBS(i)	((i) / biL + ((i) % biL != 0))
 
+/*
+ * Each slot of the pool serves one thread at a time, threads finding all
+ * slots busy wait for one to become idle. CFG_CORE_MPI_MEMPOOL_SLOTS=0
+ * gives one slot for each thread that can run at the same time.
+ */
+#if CFG_CORE_MPI_MEMPOOL_SLOTS
+#define MPI_MEMPOOL_SLOTS	CFG_CORE_MPI_MEMPOOL_SLOTS
+#else
+#define MPI_MEMPOOL_SLOTS \
+	MIN_UNSAFE(CFG_NUM_THREADS, CFG_TEE_CORE_NB_CORE)
+#endif
+
 #if defined(_CFG_CORE_LTC_PAGER)
 /* allocate pageable_zi vmem for mp scratch memory pool */
 static struct mempool *get_mp_scratch_memory_pool(void)
@@ -33,19 +45,22 @@ static struct mempool *get_mp_scratch_memory_pool(void)
 	size_t size;
 	void *data;
 
-	size = ROUNDUP(MPI_MEMPOOL_SIZE, SMALL_PAGE_SIZE);
+	size = ROUNDUP(MPI_MEMPOOL_SIZE, SMALL_PAGE_SIZE) * MPI_MEMPOOL_SLOTS;
 	data = tee_pager_alloc(size);
 	if (!data)
 		panic();
 
-	return mempool_alloc_pool(data, size, tee_pager_release_phys);
+	return mempool_alloc_pool_slots(data, size, MPI_MEMPOOL_SLOTS,
+					tee_pager_release_phys);
 }
 #else /* _CFG_CORE_LTC_PAGER */
 static struct mempool *get_mp_scratch_memory_pool(void)
 {
-	static uint8_t data[MPI_MEMPOOL_SIZE] __aligned(MEMPOOL_ALIGN);
+	static uint8_t data[MPI_MEMPOOL_SIZE * MPI_MEMPOOL_SLOTS]
+		__aligned(MEMPOOL_ALIGN);
 
-	return mempool_alloc_pool(data, sizeof(data), NULL);
+	return mempool_alloc_pool_slots(data, sizeof(data), MPI_MEMPOOL_SLOTS,
+					NULL);
 }
 #endif
 
@@ -678,7 +693,9 @@ ltc_math_descriptor ltc_mp = {
 	.isprime = isprime,
 
 #ifdef LTC_MECC
-#ifdef LTC_MECC_FP
+#if defined(_CFG_CORE_LTC_ECC_NISTP)
+	.ecc_ptmul = ecc_nistp_ptmul,
+#elif defined(LTC_MECC_FP)
 	.ecc_ptmul = ltc_ecc_fp_mulmod,
 #else
 	.ecc_ptmul = ltc_ecc_mulmod,
@@ -687,7 +704,9 @@ ltc_math_descriptor ltc_mp = {
 	.ecc_ptdbl = ltc_ecc_projective_dbl_point,
 	.ecc_map = ltc_ecc_map,
 #ifdef LTC_ECC_SHAMIR
-#ifdef LTC_MECC_FP
+#if defined(_CFG_CORE_LTC_ECC_NISTP)
+	.ecc_mul2add = ecc_nistp_mul2add,
+#elif defined(LTC_MECC_FP)
 	.ecc_mul2add = ltc_ecc_fp_mul2add,
 #else
 	.ecc_mul2add = ltc_ecc_mul2add,
@@ -339,6 +339,7 @@ srcs-$(_CFG_CORE_LTC_ECC) += src/pk/ecc/ltc_ecc_mul2add.c
 srcs-$(_CFG_CORE_LTC_ECC) += src/pk/ecc/ltc_ecc_points.c
 srcs-$(_CFG_CORE_LTC_ECC) += src/pk/ecc/ltc_ecc_projective_add_point.c
 srcs-$(_CFG_CORE_LTC_ECC) += src/pk/ecc/ltc_ecc_projective_dbl_point.c
+srcs-$(_CFG_CORE_LTC_ECC_NISTP) += ecc_nistp.c
 
 ifneq (,$(filter y,$(_CFG_CORE_LTC_SM2_DSA) $(_CFG_CORE_LTC_SM2_PKE)))
    cppflags-lib-y += -DLTC_ECC_SM2
@@ -350,7 +351,11 @@ srcs-$(_CFG_CORE_LTC_SM2_KEP) += sm2-kep.c
 cppflags-lib-$(_CFG_CORE_LTC_EC25519) += -DLTC_CURVE25519
 srcs-$(_CFG_CORE_LTC_EC25519) += src/pk/ec25519/ec25519_crypto_ctx.c
 srcs-$(_CFG_CORE_LTC_EC25519) += src/pk/ec25519/ec25519_export.c
+ifeq ($(_CFG_CORE_LTC_EC25519_FE51),y)
+srcs-y += ec25519_fe51.c
+else
 srcs-$(_CFG_CORE_LTC_EC25519) += src/pk/ec25519/tweetnacl.c
+endif
 
 srcs-$(_CFG_CORE_LTC_ED25519) += ed25519.c
 srcs-$(_CFG_CORE_LTC_ED25519) += src/pk/ed25519/ed25519_export.c
@@ -764,6 +764,9 @@ struct fobj *fobj_sec_mem_alloc(unsigned int num_pages)
 		goto err;
 
 	f->mm = phys_mem_ta_alloc(size);
+	/* Caches may hold the memory, have them release it and retry */
+	if (!f->mm && phys_mem_reclaim())
+		f->mm = phys_mem_ta_alloc(size);
 	if (!f->mm)
 		goto err;
 
@@ -6,6 +6,7 @@
 #include <assert.h>
 #include <initcall.h>
 #include <keep.h>
+#include <kernel/hash_set.h>
 #include <kernel/linker.h>
 #include <kernel/mutex.h>
 #include <kernel/panic.h>
@@ -31,10 +32,13 @@ static size_t shm_release_waiters;
 
 struct mobj_reg_shm {
 	struct mobj mobj;
-	SLIST_ENTRY(mobj_reg_shm) next;
+	struct hash_set_elem next;	/* Keyed on the cookie */
 	uint64_t cookie;
 	tee_mm_entry_t *mm;
 	paddr_t page_offset;
+	/* Lowest and highest page in pages[] */
+	paddr_t pa_min;
+	paddr_t pa_max;
 	struct refcount mapcount;
 	bool guarded;
 	bool releasing;
@@ -66,8 +70,8 @@ static size_t mobj_reg_shm_size(size_t nr_pages)
 	return s;
 }
 
-static SLIST_HEAD(reg_shm_head, mobj_reg_shm) reg_shm_list =
-	SLIST_HEAD_INITIALIZER(reg_shm_head);
+/* Access is serialized with reg_shm_slist_lock */
+static struct hash_set reg_shm_set = HASH_SET_INITIALIZER(reg_shm_set);
 
 static unsigned int reg_shm_slist_lock = SPINLOCK_UNLOCK;
 static unsigned int reg_shm_map_lock = SPINLOCK_UNLOCK;
@@ -78,6 +82,41 @@ static SLIST_HEAD(protmem_head, mobj_protmem) protmem_list =
 
 static struct mobj_reg_shm *to_mobj_reg_shm(struct mobj *mobj);
 
+/*
+ * Grows the hash set if it's getting crowded. The new buckets are
+ * allocated without holding reg_shm_slist_lock so failing to grow the set
+ * or losing a race with another caller is harmless.
+ */
+static void reg_shm_maybe_grow(void)
+{
+	struct hash_set_bucket *buckets = NULL;
+	uint32_t exceptions = 0;
+	size_t num_buckets = 0;
+
+	exceptions = cpu_spin_lock_xsave(&reg_shm_slist_lock);
+	num_buckets = hash_set_grow_buckets(&reg_shm_set);
+	cpu_spin_unlock_xrestore(&reg_shm_slist_lock, exceptions);
+
+	if (!num_buckets)
+		return;
+
+	buckets = calloc(num_buckets, sizeof(*buckets));
+	if (!buckets)
+		return;
+
+	exceptions = cpu_spin_lock_xsave(&reg_shm_slist_lock);
+	if (hash_set_grow_buckets(&reg_shm_set) == num_buckets)
+		buckets = hash_set_rehash(&reg_shm_set, buckets, num_buckets);
+	cpu_spin_unlock_xrestore(&reg_shm_slist_lock, exceptions);
+
+	free(buckets);
+}
+
+static struct mobj_reg_shm *to_reg_shm(struct hash_set_elem *e)
+{
+	return container_of(e, struct mobj_reg_shm, next);
+}
+
 static TEE_Result mobj_reg_shm_get_pa(struct mobj *mobj, size_t offst,
 				      size_t granule, paddr_t *pa)
 {
@@ -145,7 +184,7 @@ static void reg_shm_free_helper(struct mobj_reg_shm *mobj_reg_shm)
 
 	cpu_spin_unlock_xrestore(&reg_shm_map_lock, exceptions);
 
-	SLIST_REMOVE(&reg_shm_list, mobj_reg_shm, mobj_reg_shm, next);
+	hash_set_remove(&reg_shm_set, &mobj_reg_shm->next);
 	free(mobj_reg_shm);
 }
 
@@ -320,6 +359,11 @@ static TEE_Result check_reg_shm_conflict(struct mobj_reg_shm *r, paddr_t pa,
 {
 	size_t n = 0;
 
+	/* Only look at the pages if the range spanned by them intersects */
+	if (!core_is_buffer_intersect(pa, size, r->pa_min,
+				      r->pa_max - r->pa_min + SMALL_PAGE_SIZE))
+		return TEE_SUCCESS;
+
 	for (n = 0; n < r->mobj.size / SMALL_PAGE_SIZE; n++)
 		if (core_is_buffer_intersect(pa, size, r->pages[n],
 					     SMALL_PAGE_SIZE))
@@ -370,6 +414,9 @@ struct mobj *mobj_reg_shm_alloc(paddr_t *pages, size_t num_pages,
 	mobj_reg_shm->page_offset = page_offset;
 	memcpy(mobj_reg_shm->pages, pages, sizeof(*pages) * num_pages);
 
+	mobj_reg_shm->pa_min = pages[0];
+	mobj_reg_shm->pa_max = pages[0];
+
 	/* Ensure loaded references match format and security constraints */
 	for (i = 0; i < num_pages; i++) {
 		if (mobj_reg_shm->pages[i] & SMALL_PAGE_MASK)
@@ -379,17 +426,24 @@ struct mobj *mobj_reg_shm_alloc(paddr_t *pages, size_t num_pages,
 		if (!core_pbuf_is(CORE_MEM_NON_SEC, mobj_reg_shm->pages[i],
 				  SMALL_PAGE_SIZE))
 			goto err;
+
+		mobj_reg_shm->pa_min = MIN(mobj_reg_shm->pa_min, pages[i]);
+		mobj_reg_shm->pa_max = MAX(mobj_reg_shm->pa_max, pages[i]);
 	}
 
 	exceptions = cpu_spin_lock_xsave(&reg_shm_slist_lock);
 	res = check_protmem_conflict(mobj_reg_shm);
-	if (!res)
-		SLIST_INSERT_HEAD(&reg_shm_list, mobj_reg_shm, next);
+	if (!res) {
+		hash_set_add_no_grow(&reg_shm_set, &mobj_reg_shm->next,
+				     cookie);
+	}
 	cpu_spin_unlock_xrestore(&reg_shm_slist_lock, exceptions);
 
 	if (res)
 		goto err;
 
+	reg_shm_maybe_grow();
+
 	return &mobj_reg_shm->mobj;
 err:
 	free(mobj_reg_shm);
@@ -406,11 +460,10 @@ void mobj_reg_shm_unguard(struct mobj *mobj)
 
 static struct mobj_reg_shm *reg_shm_find_unlocked(uint64_t cookie)
 {
-	struct mobj_reg_shm *mobj_reg_shm = NULL;
+	struct hash_set_elem *e = hash_set_first(&reg_shm_set, cookie);
 
-	SLIST_FOREACH(mobj_reg_shm, &reg_shm_list, next)
-		if (mobj_reg_shm->cookie == cookie)
-			return mobj_reg_shm;
+	if (e)
+		return to_reg_shm(e);
 
 	return NULL;
 }
@@ -549,13 +602,13 @@ static struct mobj_protmem *to_mobj_protmem(struct mobj *mobj);
 
 static TEE_Result check_reg_shm_list_conflict(paddr_t pa, paddr_size_t size)
 {
-	struct mobj_reg_shm *r = NULL;
+	struct hash_set_elem *e = NULL;
 	TEE_Result res = TEE_SUCCESS;
 
-	SLIST_FOREACH(r, &reg_shm_list, next) {
-		res = check_reg_shm_conflict(r, pa, size);
+	HASH_SET_FOREACH(e, &reg_shm_set) {
+		res = check_reg_shm_conflict(to_reg_shm(e), pa, size);
 		if (res)
-			break;
+			return res;
 	}
 
 	return res;
@@ -128,7 +128,7 @@ static struct pgt_parent *alloc_pgt_parent(void)
 	return parent;
 }
 
-static struct pgt *alloc_pgt(vaddr_t vabase)
+static struct pgt *try_alloc_pgt(vaddr_t vabase)
 {
 	struct pgt_parent *parent = NULL;
 	uint32_t exceptions = 0;
@@ -158,6 +158,17 @@ out:
 	return pgt;
 }
 
+static struct pgt *alloc_pgt(vaddr_t vabase)
+{
+	struct pgt *pgt = try_alloc_pgt(vabase);
+
+	/* Caches may hold the memory, have them release it and retry */
+	if (!pgt && phys_mem_reclaim())
+		pgt = try_alloc_pgt(vabase);
+
+	return pgt;
+}
+
 static bool pgt_entry_matches(struct pgt *p, vaddr_t begin, vaddr_t last)
 {
 	if (!p)
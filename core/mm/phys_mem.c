@@ -9,6 +9,7 @@
 #include <mm/phys_mem.h>
 #include <mm/tee_mm.h>
 #include <string.h>
+#include <trace.h>
 #include <types_ext.h>
 
 static tee_mm_pool_t *nex_core_pool __nex_bss;
@@ -25,6 +26,9 @@ static tee_mm_pool_t *init_pool(paddr_t b, paddr_size_t sz, uint32_t flags)
 	    !sz || (sz & CORE_MMU_USER_CODE_MASK))
 		panic("invalid phys mem");
 
+	if (IS_ENABLED(CFG_PHYS_MEM_SEG_FIT))
+		flags |= TEE_MM_POOL_SEG_FIT;
+
 	if (flags & TEE_MM_POOL_NEX_MALLOC)
 		pool = nex_malloc(sizeof(*pool));
 	else
@@ -159,6 +163,13 @@ static void add_pool_stats(tee_mm_pool_t *pool, struct pta_stats_alloc *stats,
 		if (s.max_allocated > stats->max_allocated)
 			stats->max_allocated = s.max_allocated;
 		stats->allocated += s.allocated;
+		stats->free2_sum += s.free2_sum;
+		stats->num_alloc_fail += s.num_alloc_fail;
+		if (s.biggest_alloc_fail > stats->biggest_alloc_fail) {
+			stats->biggest_alloc_fail = s.biggest_alloc_fail;
+			stats->biggest_alloc_fail_used =
+				s.biggest_alloc_fail_used;
+		}
 	}
 }
 
@@ -240,3 +251,19 @@ tee_mm_entry_t *phys_mem_alloc_flags(size_t size, uint32_t flags)
 	else
 		return mm_alloc(ta, core, size, flags);
 }
+
+bool phys_mem_reclaim(void)
+{
+	const struct phys_mem_reclaimer *r = NULL;
+	bool ret = false;
+
+	SCATTERED_ARRAY_FOREACH(r, phys_mem_reclaimers,
+				struct phys_mem_reclaimer) {
+		if (r->reclaim()) {
+			DMSG("Reclaimed memory with %s()", r->name);
+			ret = true;
+		}
+	}
+
+	return ret;
+}
@@ -12,6 +12,78 @@
 #include <trace.h>
 #include <util.h>
 
+static bool is_seg_fit(tee_mm_pool_t *pool)
+{
+	return pool->flags & TEE_MM_POOL_SEG_FIT;
+}
+
+static unsigned int gap_class(uint32_t gap)
+{
+	return 31 - __builtin_clz(gap);
+}
+
+/* Returns the number of free pages/sections between @e and the next entry */
+static uint32_t calc_gap(tee_mm_pool_t *pool, tee_mm_entry_t *e)
+{
+	if (pool->flags & TEE_MM_POOL_HI_ALLOC) {
+		if (e->next)
+			return e->offset - e->next->offset - e->next->size;
+		return e->offset;
+	}
+
+	if (e->next)
+		return e->next->offset - e->offset - e->size;
+	return (pool->size >> pool->shift) - e->offset - e->size;
+}
+
+static void remove_gap(tee_mm_pool_t *pool, tee_mm_entry_t *e)
+{
+	if (is_seg_fit(pool) && e->gap) {
+		LIST_REMOVE(e, gap_link);
+		e->gap = 0;
+	}
+}
+
+/* Files @e in the free list matching the space following it */
+static void update_gap(tee_mm_pool_t *pool, tee_mm_entry_t *e)
+{
+	if (!is_seg_fit(pool))
+		return;
+
+	remove_gap(pool, e);
+	e->gap = calc_gap(pool, e);
+	if (e->gap)
+		LIST_INSERT_HEAD(pool->gaps + gap_class(e->gap), e, gap_link);
+}
+
+/*
+ * Returns an entry followed by at least @psize free pages/sections. All
+ * gaps in the lists above the class of @psize are large enough, only the
+ * list of the class itself may need to be searched further.
+ *
+ * The lists aren't ordered, so the search is bounded by
+ * TEE_MM_NUM_GAP_CLASSES plus the number of gaps in the class of @psize
+ * which are smaller than @psize. A gap of class n is at least 1 << n, so
+ * when @psize is a power of two the first gap of its class fits. Keeping
+ * the lists ordered would only move that cost to each update_gap(), which
+ * is called more often than find_gap().
+ */
+static tee_mm_entry_t *find_gap(tee_mm_pool_t *pool, size_t psize)
+{
+	tee_mm_entry_t *e = NULL;
+	unsigned int n = 0;
+
+	if (psize > UINT32_MAX)
+		return NULL;
+
+	for (n = gap_class(psize); n < TEE_MM_NUM_GAP_CLASSES; n++)
+		LIST_FOREACH(e, pool->gaps + n, gap_link)
+			if (e->gap >= psize)
+				return e;
+
+	return NULL;
+}
+
 bool tee_mm_init(tee_mm_pool_t *pool, paddr_t lo, paddr_size_t size,
 		 uint8_t shift, uint32_t flags)
 {
@@ -46,6 +118,19 @@ bool tee_mm_init(tee_mm_pool_t *pool, paddr_t lo, paddr_size_t size,
 	pool->entry->pool = pool;
 	pool->lock = SPINLOCK_UNLOCK;
 
+	if (is_seg_fit(pool)) {
+		pool->gaps = malloc_flags(pool->flags | MAF_ZERO_INIT, NULL,
+					  MALLOC_DEFAULT_ALIGNMENT,
+					  TEE_MM_NUM_GAP_CLASSES *
+					  sizeof(*pool->gaps));
+		if (!pool->gaps) {
+			free_flags(pool->flags, pool->entry);
+			pool->entry = NULL;
+			return false;
+		}
+		update_gap(pool, pool->entry);
+	}
+
 	return true;
 }
 
@@ -58,36 +143,27 @@ void tee_mm_final(tee_mm_pool_t *pool)
 		tee_mm_free(pool->entry->next);
 	free_flags(pool->flags, pool->entry);
 	pool->entry = NULL;
+	free_flags(pool->flags, pool->gaps);
+	pool->gaps = NULL;
 }
 
 static void tee_mm_add(tee_mm_entry_t *p, tee_mm_entry_t *nn)
 {
 	/* add to list */
 	nn->next = p->next;
+	nn->prev = p;
+	nn->gap = 0;
+	if (p->next)
+		p->next->prev = nn;
 	p->next = nn;
 }
 
 #ifdef CFG_WITH_STATS
-static size_t tee_mm_stats_allocated(tee_mm_pool_t *pool)
-{
-	tee_mm_entry_t *entry;
-	uint32_t sz = 0;
-
-	if (!pool)
-		return 0;
-
-	entry = pool->entry;
-	while (entry) {
-		sz += entry->size;
-		entry = entry->next;
-	}
-
-	return sz << pool->shift;
-}
-
 void tee_mm_get_pool_stats(tee_mm_pool_t *pool, struct pta_stats_alloc *stats,
 			   bool reset)
 {
+	tee_mm_entry_t *entry = NULL;
+	uint64_t free_bytes = 0;
 	uint32_t exceptions;
 
 	if (!pool)
@@ -99,22 +175,58 @@ void tee_mm_get_pool_stats(tee_mm_pool_t *pool, struct pta_stats_alloc *stats,
 
 	stats->size = pool->size;
 	stats->max_allocated = pool->max_allocated;
-	stats->allocated = tee_mm_stats_allocated(pool);
+	stats->allocated = pool->allocated << pool->shift;
+	stats->num_alloc_fail = pool->num_alloc_fail;
+	stats->biggest_alloc_fail = pool->biggest_alloc_fail;
+	stats->biggest_alloc_fail_used = pool->biggest_alloc_fail_used;
+
+	/* Fragmentation, one free chunk per gap between entries */
+	for (entry = pool->entry; entry; entry = entry->next) {
+		free_bytes = (uint64_t)calc_gap(pool, entry) << pool->shift;
+		stats->free2_sum += free_bytes * free_bytes;
+	}
 
-	if (reset)
+	if (reset) {
 		pool->max_allocated = 0;
+		pool->num_alloc_fail = 0;
+		pool->biggest_alloc_fail = 0;
+		pool->biggest_alloc_fail_used = 0;
+	}
 	cpu_spin_unlock_xrestore(&pool->lock, exceptions);
 }
 
-static void update_max_allocated(tee_mm_pool_t *pool)
+static void update_allocated(tee_mm_pool_t *pool, tee_mm_entry_t *mm,
+			     bool add)
 {
-	size_t sz = tee_mm_stats_allocated(pool);
+	size_t sz = 0;
+
+	if (add)
+		pool->allocated += mm->size;
+	else
+		pool->allocated -= mm->size;
 
+	sz = pool->allocated << pool->shift;
 	if (sz > pool->max_allocated)
 		pool->max_allocated = sz;
 }
+
+static void update_alloc_fail(tee_mm_pool_t *pool, size_t size)
+{
+	pool->num_alloc_fail++;
+	if (size > pool->biggest_alloc_fail) {
+		pool->biggest_alloc_fail = size;
+		pool->biggest_alloc_fail_used = pool->allocated << pool->shift;
+	}
+}
 #else /* CFG_WITH_STATS */
-static inline void update_max_allocated(tee_mm_pool_t *pool __unused)
+static inline void update_allocated(tee_mm_pool_t *pool __unused,
+				    tee_mm_entry_t *mm __unused,
+				    bool add __unused)
+{
+}
+
+static inline void update_alloc_fail(tee_mm_pool_t *pool __unused,
+				     size_t size __unused)
 {
 }
 #endif /* CFG_WITH_STATS */
@@ -147,6 +259,13 @@ tee_mm_entry_t *tee_mm_alloc_flags(tee_mm_pool_t *pool, size_t size,
 	else
 		psize = ((size - 1) >> pool->shift) + 1;
 
+	if (is_seg_fit(pool) && psize) {
+		entry = find_gap(pool, psize);
+		if (!entry)
+			goto err;
+		goto found;
+	}
+
 	/* find free slot */
 	if (pool->flags & TEE_MM_POOL_HI_ALLOC) {
 		while (entry->next != NULL && psize >
@@ -190,6 +309,7 @@ tee_mm_entry_t *tee_mm_alloc_flags(tee_mm_pool_t *pool, size_t size,
 		}
 	}
 
+found:
 	tee_mm_add(entry, nn);
 
 	if (pool->flags & TEE_MM_POOL_HI_ALLOC)
@@ -199,11 +319,14 @@ tee_mm_entry_t *tee_mm_alloc_flags(tee_mm_pool_t *pool, size_t size,
 	nn->size = psize;
 	nn->pool = pool;
 
-	update_max_allocated(pool);
+	update_gap(pool, entry);
+	update_gap(pool, nn);
+	update_allocated(pool, nn, true);
 
 	cpu_spin_unlock_xrestore(&pool->lock, exceptions);
 	return nn;
 err:
+	update_alloc_fail(pool, size);
 	cpu_spin_unlock_xrestore(&pool->lock, exceptions);
 	free_flags(flags, nn);
 	return NULL;
@@ -277,7 +400,9 @@ tee_mm_entry_t *tee_mm_alloc2(tee_mm_pool_t *pool, paddr_t base, size_t size)
 	mm->size = offshi - offslo;
 	mm->pool = pool;
 
-	update_max_allocated(pool);
+	update_gap(pool, entry);
+	update_gap(pool, mm);
+	update_allocated(pool, mm, true);
 	cpu_spin_unlock_xrestore(&pool->lock, exceptions);
 	return mm;
 err:
@@ -288,24 +413,28 @@ err:
 
 void tee_mm_free(tee_mm_entry_t *p)
 {
+	tee_mm_pool_t *pool = NULL;
 	tee_mm_entry_t *entry;
 	uint32_t exceptions;
 
 	if (!p || !p->pool)
 		return;
 
-	exceptions = cpu_spin_lock_xsave(&p->pool->lock);
-	entry = p->pool->entry;
-
-	/* remove entry from list */
-	while (entry->next != NULL && entry->next != p)
-		entry = entry->next;
+	pool = p->pool;
+	exceptions = cpu_spin_lock_xsave(&pool->lock);
+	entry = p->prev;
 
-	if (!entry->next)
+	if (!entry || entry->next != p)
 		panic("invalid mm_entry");
 
-	entry->next = entry->next->next;
-	cpu_spin_unlock_xrestore(&p->pool->lock, exceptions);
+	/* remove entry from list, the space it used joins the gap before */
+	remove_gap(pool, p);
+	entry->next = p->next;
+	if (p->next)
+		p->next->prev = entry;
+	update_gap(pool, entry);
+	update_allocated(pool, p, false);
+	cpu_spin_unlock_xrestore(&pool->lock, exceptions);
 
 	free_flags(p->pool->flags, p);
 }
@@ -41,6 +41,9 @@
 					 TEE_MATTR_PRW | TEE_MATTR_URWX | \
 					 TEE_MATTR_SECURE)
 
+/* Number of elements vm_info->sorted_regions grows by */
+#define SORTED_REGIONS_ALLOC_GRANULE	16
+
 #define TEE_MMU_UCACHE_DEFAULT_ATTR	(TEE_MATTR_MEM_TYPE_CACHED << \
 					 TEE_MATTR_MEM_TYPE_SHIFT)
 
@@ -233,6 +236,40 @@ static void set_um_region(struct user_mode_ctx *uctx, struct vm_region *r)
 	}
 }
 
+/*
+ * Updates vmi->sorted_regions after a region has been added, removed,
+ * moved or resized. If the array can't be grown lookups fall back to
+ * walking the list until the next successful update.
+ */
+static void update_sorted_regions(struct vm_info *vmi)
+{
+	struct vm_region **sr = vmi->sorted_regions;
+	struct vm_region *r = NULL;
+	size_t alloc = 0;
+	size_t n = 0;
+
+	vmi->last_hit = NULL;
+	vmi->sorted_valid = false;
+
+	TAILQ_FOREACH(r, &vmi->regions, link)
+		n++;
+
+	if (n > vmi->sorted_alloc) {
+		alloc = ROUNDUP(n, SORTED_REGIONS_ALLOC_GRANULE);
+		sr = realloc(sr, alloc * sizeof(*sr));
+		if (!sr)
+			return;
+		vmi->sorted_regions = sr;
+		vmi->sorted_alloc = alloc;
+	}
+
+	n = 0;
+	TAILQ_FOREACH(r, &vmi->regions, link)
+		sr[n++] = r;
+	vmi->sorted_count = n;
+	vmi->sorted_valid = true;
+}
+
 static TEE_Result umap_add_region(struct vm_info *vmi, struct vm_region *reg,
 				  size_t pad_begin, size_t pad_end,
 				  size_t align)
@@ -272,6 +309,7 @@ static TEE_Result umap_add_region(struct vm_info *vmi, struct vm_region *reg,
 		if (va) {
 			reg->va = va;
 			TAILQ_INSERT_BEFORE(r, reg, link);
+			update_sorted_regions(vmi);
 			return TEE_SUCCESS;
 		}
 		prev_r = r;
@@ -285,6 +323,7 @@ static TEE_Result umap_add_region(struct vm_info *vmi, struct vm_region *reg,
 	if (va) {
 		reg->va = va;
 		TAILQ_INSERT_TAIL(&vmi->regions, reg, link);
+		update_sorted_regions(vmi);
 		return TEE_SUCCESS;
 	}
 
@@ -363,6 +402,7 @@ TEE_Result vm_map_pad(struct user_mode_ctx *uctx, vaddr_t *va, size_t len,
 
 err_rem_reg:
 	TAILQ_REMOVE(&uctx->vm_info.regions, reg, link);
+	update_sorted_regions(&uctx->vm_info);
 err_put_mobj:
 	mobj_put(reg->mobj);
 err_free_reg:
@@ -370,17 +410,53 @@ err_free_reg:
 	return res;
 }
 
-static struct vm_region *find_vm_region(struct vm_info *vm_info, vaddr_t va)
+static bool va_is_in_region(const struct vm_region *r, vaddr_t va)
 {
-	struct vm_region *r = NULL;
+	return va >= r->va && va - r->va < r->size;
+}
+
+/* Finds the region holding @va without updating vm_info->last_hit */
+static struct vm_region *lookup_vm_region(const struct vm_info *vm_info,
+					  vaddr_t va)
+{
+	struct vm_region *r = vm_info->last_hit;
+	size_t hi = vm_info->sorted_count;
+	size_t lo = 0;
+	size_t n = 0;
+
+	if (r && va_is_in_region(r, va))
+		return r;
+
+	if (vm_info->sorted_valid) {
+		while (lo < hi) {
+			n = (lo + hi) / 2;
+			r = vm_info->sorted_regions[n];
+			if (va < r->va)
+				hi = n;
+			else if (va - r->va >= r->size)
+				lo = n + 1;
+			else
+				return r;
+		}
+		return NULL;
+	}
 
 	TAILQ_FOREACH(r, &vm_info->regions, link)
-		if (va >= r->va && va < r->va + r->size)
+		if (va_is_in_region(r, va))
 			return r;
 
 	return NULL;
 }
 
+static struct vm_region *find_vm_region(struct vm_info *vm_info, vaddr_t va)
+{
+	struct vm_region *r = lookup_vm_region(vm_info, va);
+
+	if (r)
+		vm_info->last_hit = r;
+	return r;
+}
+
 static bool va_range_is_contiguous(struct vm_region *r0, vaddr_t va,
 				   size_t len,
 				   bool (*cmp_regs)(const struct vm_region *r0,
@@ -409,6 +485,25 @@ static bool va_range_is_contiguous(struct vm_region *r0, vaddr_t va,
 	}
 }
 
+/* Moves the part of @r from @va and onwards into the new region @r2 */
+static void split_region(struct vm_info *vmi, struct vm_region *r,
+			 struct vm_region *r2, vaddr_t va)
+{
+	size_t diff = va - r->va;
+
+	r2->mobj = mobj_get(r->mobj);
+	r2->offset = r->offset + diff;
+	r2->va = va;
+	r2->size = r->size - diff;
+	r2->attr = r->attr;
+	r2->flags = r->flags;
+
+	r->size = diff;
+
+	TAILQ_INSERT_AFTER(&vmi->regions, r, r2, link);
+	update_sorted_regions(vmi);
+}
+
 static TEE_Result split_vm_region(struct user_mode_ctx *uctx,
 				  struct vm_region *r, vaddr_t va)
 {
@@ -430,16 +525,7 @@ static TEE_Result split_vm_region(struct user_mode_ctx *uctx,
 		}
 	}
 
-	r2->mobj = mobj_get(r->mobj);
-	r2->offset = r->offset + diff;
-	r2->va = va;
-	r2->size = r->size - diff;
-	r2->attr = r->attr;
-	r2->flags = r->flags;
-
-	r->size = diff;
-
-	TAILQ_INSERT_AFTER(&uctx->vm_info.regions, r, r2, link);
+	split_region(&uctx->vm_info, r, r2, va);
 
 	return TEE_SUCCESS;
 }
@@ -493,18 +579,13 @@ static TEE_Result split_vm_range(struct user_mode_ctx *uctx, vaddr_t va,
 	return TEE_SUCCESS;
 }
 
-static void merge_vm_range(struct user_mode_ctx *uctx, vaddr_t va, size_t len)
+/* Merges compatible adjacent regions touching [@va, @end_va] */
+static void merge_regions(struct vm_info *vmi, vaddr_t va, vaddr_t end_va)
 {
 	struct vm_region *r_next = NULL;
 	struct vm_region *r = NULL;
-	vaddr_t end_va = 0;
 
-	if (ADD_OVERFLOW(va, len, &end_va))
-		return;
-
-	tee_pager_merge_um_region(uctx, va, len);
-
-	for (r = TAILQ_FIRST(&uctx->vm_info.regions);; r = r_next) {
+	for (r = TAILQ_FIRST(&vmi->regions);; r = r_next) {
 		r_next = TAILQ_NEXT(r, link);
 		if (!r_next)
 			return;
@@ -530,14 +611,26 @@ static void merge_vm_range(struct user_mode_ctx *uctx, vaddr_t va, size_t len)
 		if (r->offset + r->size != r_next->offset)
 			continue;
 
-		TAILQ_REMOVE(&uctx->vm_info.regions, r_next, link);
+		TAILQ_REMOVE(&vmi->regions, r_next, link);
 		r->size += r_next->size;
+		update_sorted_regions(vmi);
 		mobj_put(r_next->mobj);
 		free(r_next);
 		r_next = r;
 	}
 }
 
+static void merge_vm_range(struct user_mode_ctx *uctx, vaddr_t va, size_t len)
+{
+	vaddr_t end_va = 0;
+
+	if (ADD_OVERFLOW(va, len, &end_va))
+		return;
+
+	tee_pager_merge_um_region(uctx, va, len);
+	merge_regions(&uctx->vm_info, va, end_va);
+}
+
 static bool cmp_region_for_remap(const struct vm_region *r0,
 				 const struct vm_region *r,
 				 const struct vm_region *rn)
@@ -589,6 +682,7 @@ TEE_Result vm_remap(struct user_mode_ctx *uctx, vaddr_t *new_va, vaddr_t old_va,
 		TAILQ_REMOVE(&uctx->vm_info.regions, r, link);
 		TAILQ_INSERT_TAIL(&regs, r, link);
 	}
+	update_sorted_regions(&uctx->vm_info);
 
 	/*
 	 * Synchronize change to translation tables. Even though the pager
@@ -648,6 +742,7 @@ TEE_Result vm_remap(struct user_mode_ctx *uctx, vaddr_t *new_va, vaddr_t old_va,
 					TAILQ_INSERT_HEAD(&regs, r, link);
 				r_tmp = r;
 			}
+			update_sorted_regions(&uctx->vm_info);
 
 			goto err_restore_map;
 		}
@@ -806,6 +901,7 @@ TEE_Result vm_set_prot(struct user_mode_ctx *uctx, vaddr_t va, size_t len,
 static void umap_remove_region(struct vm_info *vmi, struct vm_region *reg)
 {
 	TAILQ_REMOVE(&vmi->regions, reg, link);
+	update_sorted_regions(vmi);
 	mobj_put(reg->mobj);
 	free(reg);
 }
@@ -1077,6 +1173,8 @@ out:
 
 void vm_info_final(struct user_mode_ctx *uctx)
 {
+	struct vm_region *r = NULL;
+
 	if (!uctx->vm_info.asid)
 		return;
 
@@ -1089,25 +1187,31 @@ void vm_info_final(struct user_mode_ctx *uctx)
 	asid_free(uctx->vm_info.asid);
 	uctx->vm_info.asid = 0;
 
-	while (!TAILQ_EMPTY(&uctx->vm_info.regions))
-		umap_remove_region(&uctx->vm_info,
-				   TAILQ_FIRST(&uctx->vm_info.regions));
+	/* No lookups from here, skip updating sorted_regions for each region */
+	free(uctx->vm_info.sorted_regions);
+	uctx->vm_info.sorted_regions = NULL;
+	uctx->vm_info.sorted_count = 0;
+	uctx->vm_info.sorted_alloc = 0;
+	uctx->vm_info.sorted_valid = false;
+	uctx->vm_info.last_hit = NULL;
+
+	while (!TAILQ_EMPTY(&uctx->vm_info.regions)) {
+		r = TAILQ_FIRST(&uctx->vm_info.regions);
+		TAILQ_REMOVE(&uctx->vm_info.regions, r, link);
+		mobj_put(r->mobj);
+		free(r);
+	}
 }
 
 /* return true only if buffer fits inside TA private memory */
 bool vm_buf_is_inside_um_private(const struct user_mode_ctx *uctx,
 				 const void *va, size_t size)
 {
-	struct vm_region *r = NULL;
+	struct vm_region *r = lookup_vm_region(&uctx->vm_info, (vaddr_t)va);
 
-	TAILQ_FOREACH(r, &uctx->vm_info.regions, link) {
-		if (r->flags & VM_FLAGS_NONPRIV)
-			continue;
-		if (core_is_buffer_inside((vaddr_t)va, size, r->va, r->size))
-			return true;
-	}
-
-	return false;
+	/* Regions don't overlap, only the one holding va can hold it all */
+	return r && !(r->flags & VM_FLAGS_NONPRIV) &&
+	       core_is_buffer_inside((vaddr_t)va, size, r->va, r->size);
 }
 
 /* return true only if buffer intersects TA private memory */
@@ -1130,69 +1234,59 @@ TEE_Result vm_buf_to_mboj_offs(const struct user_mode_ctx *uctx,
 			       const void *va, size_t size,
 			       struct mobj **mobj, size_t *offs)
 {
-	struct vm_region *r = NULL;
+	struct vm_region *r = lookup_vm_region(&uctx->vm_info, (vaddr_t)va);
+	size_t poffs = 0;
 
-	TAILQ_FOREACH(r, &uctx->vm_info.regions, link) {
-		if (!r->mobj)
-			continue;
-		if (core_is_buffer_inside((vaddr_t)va, size, r->va, r->size)) {
-			size_t poffs;
-
-			poffs = mobj_get_phys_offs(r->mobj,
-						   CORE_MMU_USER_PARAM_SIZE);
-			*mobj = r->mobj;
-			*offs = (vaddr_t)va - r->va + r->offset - poffs;
-			return TEE_SUCCESS;
-		}
-	}
+	if (!r || !r->mobj ||
+	    !core_is_buffer_inside((vaddr_t)va, size, r->va, r->size))
+		return TEE_ERROR_BAD_PARAMETERS;
 
-	return TEE_ERROR_BAD_PARAMETERS;
+	poffs = mobj_get_phys_offs(r->mobj, CORE_MMU_USER_PARAM_SIZE);
+	*mobj = r->mobj;
+	*offs = (vaddr_t)va - r->va + r->offset - poffs;
+	return TEE_SUCCESS;
 }
 
 static TEE_Result tee_mmu_user_va2pa_attr(const struct user_mode_ctx *uctx,
 					  void *ua, paddr_t *pa, uint32_t *attr)
 {
-	struct vm_region *region = NULL;
+	struct vm_region *region = lookup_vm_region(&uctx->vm_info,
+						    (vaddr_t)ua);
 
-	TAILQ_FOREACH(region, &uctx->vm_info.regions, link) {
-		if (!core_is_buffer_inside((vaddr_t)ua, 1, region->va,
-					   region->size))
-			continue;
-
-		if (pa) {
-			TEE_Result res;
-			paddr_t p;
-			size_t offset;
-			size_t granule;
+	if (!region)
+		return TEE_ERROR_ACCESS_DENIED;
 
-			/*
-			 * mobj and input user address may each include
-			 * a specific offset-in-granule position.
-			 * Drop both to get target physical page base
-			 * address then apply only user address
-			 * offset-in-granule.
-			 * Mapping lowest granule is the small page.
-			 */
-			granule = MAX(region->mobj->phys_granule,
-				      (size_t)SMALL_PAGE_SIZE);
-			assert(!granule || IS_POWER_OF_TWO(granule));
+	if (pa) {
+		TEE_Result res;
+		paddr_t p;
+		size_t offset;
+		size_t granule;
 
-			offset = region->offset +
-				 ROUNDDOWN2((vaddr_t)ua - region->va, granule);
+		/*
+		 * mobj and input user address may each include
+		 * a specific offset-in-granule position.
+		 * Drop both to get target physical page base
+		 * address then apply only user address
+		 * offset-in-granule.
+		 * Mapping lowest granule is the small page.
+		 */
+		granule = MAX(region->mobj->phys_granule,
+			      (size_t)SMALL_PAGE_SIZE);
+		assert(!granule || IS_POWER_OF_TWO(granule));
 
-			res = mobj_get_pa(region->mobj, offset, granule, &p);
-			if (res != TEE_SUCCESS)
-				return res;
+		offset = region->offset +
+			 ROUNDDOWN2((vaddr_t)ua - region->va, granule);
 
-			*pa = p | ((vaddr_t)ua & (granule - 1));
-		}
-		if (attr)
-			*attr = region->attr;
+		res = mobj_get_pa(region->mobj, offset, granule, &p);
+		if (res != TEE_SUCCESS)
+			return res;
 
-		return TEE_SUCCESS;
+		*pa = p | ((vaddr_t)ua & (granule - 1));
 	}
+	if (attr)
+		*attr = region->attr;
 
-	return TEE_ERROR_ACCESS_DENIED;
+	return TEE_SUCCESS;
 }
 
 TEE_Result vm_va2pa(const struct user_mode_ctx *uctx, void *ua, paddr_t *pa)
@@ -1345,3 +1439,128 @@ struct mobj *vm_get_mobj(struct user_mode_ctx *uctx, vaddr_t va, size_t *len,
 	*prot = r->attr & TEE_MATTR_PROT_MASK;
 	return mobj_get(r->mobj);
 }
+
+#ifdef CFG_TEE_CORE_EMBED_INTERNAL_TESTS
+static bool sorted_regions_match(struct vm_info *vmi, size_t count)
+{
+	struct vm_region *prev = NULL;
+	struct vm_region *r = NULL;
+	size_t n = 0;
+
+	if (!vmi->sorted_valid || vmi->sorted_count != count)
+		return false;
+
+	TAILQ_FOREACH(r, &vmi->regions, link) {
+		if (n == count || vmi->sorted_regions[n] != r)
+			return false;
+		if (prev && prev->va + prev->size > r->va)
+			return false;
+		prev = r;
+		n++;
+	}
+
+	return n == count;
+}
+
+static bool lookup_matches(struct vm_info *vmi, vaddr_t va,
+			   struct vm_region *expect)
+{
+	struct vm_region *last_hit = vmi->last_hit;
+
+	if (find_vm_region(vmi, va) != expect)
+		return false;
+
+	/* A miss leaves last_hit alone, a hit updates it */
+	return vmi->last_hit == (expect ? expect : last_hit);
+}
+
+TEE_Result vm_regions_self_test(void)
+{
+	struct mobj mobj = { .size = 2 * SMALL_PAGE_SIZE };
+	TEE_Result res = TEE_ERROR_GENERIC;
+	struct vm_region *regs[3] = { };
+	struct vm_info vmi = { };
+	struct vm_region *r = NULL;
+	vaddr_t end_va = 0;
+	vaddr_t va = 0;
+	size_t n = 0;
+
+	TAILQ_INIT(&vmi.regions);
+	refcount_set(&mobj.refc, 1);
+
+	/* Three adjacent regions which can't be merged, offsets differ */
+	for (n = 0; n < ARRAY_SIZE(regs); n++) {
+		r = calloc(1, sizeof(*r));
+		if (!r) {
+			res = TEE_ERROR_OUT_OF_MEMORY;
+			goto out;
+		}
+		r->mobj = mobj_get(&mobj);
+		r->size = mobj.size;
+		res = umap_add_region(&vmi, r, 0, 0, 0);
+		if (res) {
+			mobj_put(r->mobj);
+			free(r);
+			goto out;
+		}
+		regs[n] = r;
+	}
+	res = TEE_ERROR_GENERIC;
+
+	end_va = regs[2]->va + regs[2]->size;
+	if (!sorted_regions_match(&vmi, 3) || vmi.last_hit)
+		goto out;
+	for (n = 0; n < ARRAY_SIZE(regs); n++)
+		if (!lookup_matches(&vmi, regs[n]->va, regs[n]) ||
+		    !lookup_matches(&vmi, regs[n]->va + regs[n]->size - 1,
+				    regs[n]))
+			goto out;
+	if (!lookup_matches(&vmi, regs[0]->va - 1, NULL) ||
+	    !lookup_matches(&vmi, end_va, NULL))
+		goto out;
+
+	/* Split the middle region, the new half follows it */
+	va = regs[1]->va + SMALL_PAGE_SIZE;
+	r = calloc(1, sizeof(*r));
+	if (!r) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+	split_region(&vmi, regs[1], r, va);
+	if (!sorted_regions_match(&vmi, 4) || vmi.last_hit ||
+	    TAILQ_NEXT(regs[1], link) != r ||
+	    !lookup_matches(&vmi, va - 1, regs[1]) ||
+	    !lookup_matches(&vmi, va, r) ||
+	    !lookup_matches(&vmi, regs[2]->va, regs[2]))
+		goto out;
+
+	/* Merging joins the two halves again, but nothing else */
+	merge_regions(&vmi, regs[0]->va, end_va);
+	if (!sorted_regions_match(&vmi, 3) || vmi.last_hit ||
+	    regs[1]->size != mobj.size ||
+	    !lookup_matches(&vmi, va, regs[1]))
+		goto out;
+
+	/* Unmap the middle region and leave a hole */
+	va = regs[1]->va;
+	umap_remove_region(&vmi, regs[1]);
+	regs[1] = NULL;
+	if (!sorted_regions_match(&vmi, 2) || vmi.last_hit ||
+	    !lookup_matches(&vmi, va, NULL) ||
+	    !lookup_matches(&vmi, regs[0]->va, regs[0]) ||
+	    !lookup_matches(&vmi, regs[2]->va, regs[2]) ||
+	    !lookup_matches(&vmi, va + SMALL_PAGE_SIZE, NULL))
+		goto out;
+
+	res = TEE_SUCCESS;
+out:
+	while (!TAILQ_EMPTY(&vmi.regions))
+		umap_remove_region(&vmi, TAILQ_FIRST(&vmi.regions));
+	if (!res && (!sorted_regions_match(&vmi, 0) ||
+		     refcount_val(&mobj.refc) != 1))
+		res = TEE_ERROR_GENERIC;
+	free(vmi.sorted_regions);
+
+	return res;
+}
+#endif
@@ -0,0 +1,468 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+
+#include <kernel/boot.h>
+#include <kernel/misc.h>
+#include <kernel/pseudo_ta.h>
+#include <kernel/spinlock.h>
+#include <kernel/tee_ta_manager.h>
+#include <kernel/thread.h>
+#include <kernel/ts_manager.h>
+#include <mm/mobj.h>
+#include <pta_bin_trace.h>
+#include <string.h>
+#include <trace.h>
+#include <util.h>
+
+#define PTA_NAME		"bin_trace.pta"
+
+#define REC_MAX_WORDS		(MAX_PRINT_SIZE / sizeof(uint64_t))
+#define STR_MAX_LEN		64
+#define RING_MAX_SIZE		BIT(30)
+
+/*
+ * The registered ring is only accessed with bin_trace_lock held. @ring is
+ * also read without the lock to skip taking it while no ring is
+ * registered. @head and @dropped are the secure copies of the fields in
+ * the ring, normal world can only update @tail.
+ */
+struct bin_trace_state {
+	struct pta_bin_trace_ring *ring;
+	struct mobj *mobj;
+	struct ts_session *owner;
+	uint32_t size;
+	uint32_t flags;
+	uint64_t head;
+	uint64_t dropped;
+};
+
+static struct bin_trace_state bin_trace __nex_bss;
+static unsigned int bin_trace_lock __nex_bss = SPINLOCK_UNLOCK;
+
+enum arg_len { ARG_INT, ARG_SHORT, ARG_CHAR, ARG_LONG, ARG_QUAD, ARG_SIZE };
+
+static bool put_word(uint64_t *buf, size_t *n, uint64_t v)
+{
+	if (*n >= REC_MAX_WORDS)
+		return false;
+	buf[(*n)++] = v;
+	return true;
+}
+
+static bool put_bytes(uint64_t *buf, size_t *n, const void *p, size_t len)
+{
+	size_t words = ROUNDUP_DIV(len, sizeof(uint64_t));
+
+	if (words > REC_MAX_WORDS - *n)
+		return false;
+	if (words)
+		buf[*n + words - 1] = 0;
+	memcpy(buf + *n, p, len);
+	*n += words;
+	return true;
+}
+
+static int64_t signed_arg(enum arg_len len, va_list *ap)
+{
+	switch (len) {
+	case ARG_CHAR:
+		return (signed char)va_arg(*ap, int);
+	case ARG_SHORT:
+		return (short)va_arg(*ap, int);
+	case ARG_LONG:
+		return va_arg(*ap, long);
+	case ARG_QUAD:
+		return va_arg(*ap, long long);
+	case ARG_SIZE:
+		return va_arg(*ap, ssize_t);
+	default:
+		return va_arg(*ap, int);
+	}
+}
+
+static uint64_t unsigned_arg(enum arg_len len, va_list *ap)
+{
+	switch (len) {
+	case ARG_CHAR:
+		return (unsigned char)va_arg(*ap, unsigned int);
+	case ARG_SHORT:
+		return (unsigned short)va_arg(*ap, unsigned int);
+	case ARG_LONG:
+		return va_arg(*ap, unsigned long);
+	case ARG_QUAD:
+		return va_arg(*ap, unsigned long long);
+	case ARG_SIZE:
+		return va_arg(*ap, size_t);
+	default:
+		return va_arg(*ap, unsigned int);
+	}
+}
+
+/*
+ * Normal world must not learn the core ASLR offset, pointers are recorded
+ * without it like the format string and function name.
+ */
+static uint64_t pointer_arg(va_list *ap)
+{
+	vaddr_t va = (vaddr_t)va_arg(*ap, void *);
+
+	if (!va)
+		return 0;
+	return va - boot_mmu_config.map_offset;
+}
+
+static bool put_string(uint64_t *buf, size_t *n, const char *s, int prec)
+{
+	size_t len = STR_MAX_LEN;
+
+	if (!s)
+		s = "(null)";
+	if (prec >= 0)
+		len = MIN(len, (size_t)prec);
+	len = strnlen(s, len);
+
+	return put_word(buf, n, len) && put_bytes(buf, n, s, len);
+}
+
+/*
+ * Saves the arguments of @fmt in the format described for
+ * struct pta_bin_trace_rec. Returns false if a conversion isn't supported
+ * or if the arguments don't fit, the message is then printed as text.
+ */
+static bool encode_args(uint64_t *buf, size_t *n, const char *fmt,
+			va_list *ap)
+{
+	enum arg_len len = ARG_INT;
+	int prec = 0;
+
+	while ((fmt = strchr(fmt, '%'))) {
+		fmt++;
+		len = ARG_INT;
+		prec = -1;
+
+		while (*fmt && strchr(" #-+0123456789", *fmt))
+			fmt++;
+		if (*fmt == '*') {
+			fmt++;
+			if (!put_word(buf, n, va_arg(*ap, int)))
+				return false;
+		}
+		if (*fmt == '.') {
+			fmt++;
+			if (*fmt == '*') {
+				fmt++;
+				prec = va_arg(*ap, int);
+				if (!put_word(buf, n, prec))
+					return false;
+			} else {
+				prec = 0;
+				while (*fmt >= '0' && *fmt <= '9')
+					prec = prec * 10 + *fmt++ - '0';
+			}
+		}
+
+		switch (*fmt) {
+		case 'h':
+			fmt++;
+			len = ARG_SHORT;
+			if (*fmt == 'h') {
+				fmt++;
+				len = ARG_CHAR;
+			}
+			break;
+		case 'l':
+			fmt++;
+			len = ARG_LONG;
+			if (*fmt == 'l') {
+				fmt++;
+				len = ARG_QUAD;
+			}
+			break;
+		case 'j':
+		case 'q':
+			fmt++;
+			len = ARG_QUAD;
+			break;
+		case 'z':
+		case 't':
+			fmt++;
+			len = ARG_SIZE;
+			break;
+		default:
+			break;
+		}
+
+		switch (*fmt++) {
+		case '%':
+			continue;
+		case 'c':
+			if (!put_word(buf, n, (uint8_t)va_arg(*ap, int)))
+				return false;
+			break;
+		case 'D':
+			len = ARG_LONG;
+			fallthrough;
+		case 'd':
+		case 'i':
+			if (!put_word(buf, n, signed_arg(len, ap)))
+				return false;
+			break;
+		case 'O':
+		case 'U':
+			len = ARG_LONG;
+			fallthrough;
+		case 'o':
+		case 'u':
+		case 'x':
+		case 'X':
+			if (!put_word(buf, n, unsigned_arg(len, ap)))
+				return false;
+			break;
+		case 'p':
+			if (fmt[0] == 'U' && fmt[1] == 'l') {
+				fmt += 2;
+				if (!put_bytes(buf, n, va_arg(*ap, void *),
+					       sizeof(TEE_UUID)))
+					return false;
+			} else if (!put_word(buf, n, pointer_arg(ap))) {
+				return false;
+			}
+			break;
+		case 's':
+			if (!put_string(buf, n, va_arg(*ap, const char *),
+					prec))
+				return false;
+			break;
+		default:
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static void ring_put(const struct pta_bin_trace_rec *rec)
+{
+	struct pta_bin_trace_ring *ring = bin_trace.ring;
+	struct pta_bin_trace_rec *pad = NULL;
+	uint64_t head = bin_trace.head;
+	uint32_t size = bin_trace.size;
+	uint32_t offs = head & (size - 1);
+	uint32_t pad_size = 0;
+	uint64_t used = 0;
+
+	if (size - offs < rec->size)
+		pad_size = size - offs;
+
+	/* A tail beyond head or too far behind can only be a bad consumer */
+	used = head - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+	if (used > size || pad_size + rec->size > size - used) {
+		bin_trace.dropped++;
+		__atomic_store_n(&ring->dropped, bin_trace.dropped,
+				 __ATOMIC_RELAXED);
+		return;
+	}
+
+	if (pad_size) {
+		pad = (void *)(ring->data + offs);
+		pad->size = pad_size;
+		pad->type = PTA_BIN_TRACE_REC_PAD;
+		head += pad_size;
+		offs = 0;
+	}
+	memcpy(ring->data + offs, rec, rec->size);
+	head += rec->size;
+
+	bin_trace.head = head;
+	__atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+}
+
+bool trace_ext_bin_vprintf(const char *func, int line, int level,
+			   bool level_ok, const char *fmt, va_list ap)
+{
+	uint64_t buf[REC_MAX_WORDS] = { };
+	struct pta_bin_trace_rec *rec = (void *)buf;
+	size_t n = sizeof(*rec) / sizeof(uint64_t);
+	uint32_t exceptions = 0;
+	bool console = true;
+	int thread_id = 0;
+	va_list aq;
+
+	if (!__atomic_load_n(&bin_trace.ring, __ATOMIC_RELAXED))
+		return false;
+
+	va_copy(aq, ap);
+	if (!encode_args(buf, &n, fmt, &aq)) {
+		va_end(aq);
+		return false;
+	}
+	va_end(aq);
+
+	rec->size = n * sizeof(uint64_t);
+	rec->type = PTA_BIN_TRACE_REC_MSG;
+	rec->level = level_ok ? level : 0;
+	rec->line = line;
+	rec->fmt = (vaddr_t)fmt - boot_mmu_config.map_offset;
+	if (func)
+		rec->func = (vaddr_t)func - boot_mmu_config.map_offset;
+
+	exceptions = cpu_spin_lock_xsave(&bin_trace_lock);
+	if (bin_trace.ring) {
+		thread_id = thread_get_id_may_fail();
+		rec->core = get_core_pos();
+		rec->thread = thread_id < 0 ? PTA_BIN_TRACE_NO_THREAD :
+					      thread_id;
+		rec->timestamp = barrier_read_counter_timer();
+		ring_put(rec);
+		console = bin_trace.flags & PTA_BIN_TRACE_FLAG_CONSOLE;
+	}
+	cpu_spin_unlock_xrestore(&bin_trace_lock, exceptions);
+
+	/*
+	 * Errors stay on the console in case normal world is stuck, messages
+	 * printed regardless of the trace level only go to the ring.
+	 */
+	return !console && (!level_ok || level > TRACE_ERROR);
+}
+
+static TEE_Result bin_trace_register(struct ts_session *s, uint32_t ptypes,
+				     TEE_Param params[TEE_NUM_PARAMS])
+{
+	uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_MEMREF_INOUT,
+					  TEE_PARAM_TYPE_VALUE_INPUT,
+					  TEE_PARAM_TYPE_NONE,
+					  TEE_PARAM_TYPE_NONE);
+	struct pta_bin_trace_ring *ring = NULL;
+	struct param_mem *mem = NULL;
+	uint32_t exceptions = 0;
+	struct mobj *mobj = NULL;
+	TEE_Result res = TEE_SUCCESS;
+	size_t size = 0;
+
+	if (ptypes != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	/*
+	 * The ring is used after this invocation, only registered shared
+	 * memory remains valid that long. Keep a reference to the shared
+	 * memory object backing the memref.
+	 */
+	mem = &to_ta_session(s)->param->u[0].mem;
+	if (!mem->mobj || !mobj_matches(mem->mobj, CORE_MEM_REG_SHM) ||
+	    mem->size < sizeof(*ring) + PTA_BIN_TRACE_MIN_SIZE)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	mobj = mobj_get(mem->mobj);
+	res = mobj_inc_map(mobj);
+	if (res)
+		goto err_put;
+	ring = mobj_get_va(mobj, mem->offs, mem->size);
+	if (!ring || !IS_ALIGNED_WITH_TYPE(ring, uint64_t)) {
+		res = TEE_ERROR_BAD_PARAMETERS;
+		goto err_dec_map;
+	}
+
+	size = PTA_BIN_TRACE_MIN_SIZE;
+	while (size < RING_MAX_SIZE && size * 2 <= mem->size - sizeof(*ring))
+		size *= 2;
+
+	ring->size = size;
+	ring->cntfrq = read_cntfrq();
+	ring->head = 0;
+	ring->tail = 0;
+	ring->dropped = 0;
+
+	exceptions = cpu_spin_lock_xsave(&bin_trace_lock);
+	if (bin_trace.ring) {
+		res = TEE_ERROR_BUSY;
+	} else {
+		bin_trace = (struct bin_trace_state){
+			.mobj = mobj,
+			.owner = s,
+			.size = size,
+			.flags = params[1].value.a,
+		};
+		__atomic_store_n(&bin_trace.ring, ring, __ATOMIC_RELAXED);
+	}
+	cpu_spin_unlock_xrestore(&bin_trace_lock, exceptions);
+
+	if (!res) {
+		DMSG("Binary trace ring of %zu bytes registered", size);
+		return TEE_SUCCESS;
+	}
+
+err_dec_map:
+	mobj_dec_map(mobj);
+err_put:
+	mobj_put(mobj);
+	return res;
+}
+
+static TEE_Result bin_trace_unregister(struct ts_session *s)
+{
+	uint32_t exceptions = 0;
+	struct mobj *mobj = NULL;
+
+	exceptions = cpu_spin_lock_xsave(&bin_trace_lock);
+	if (bin_trace.ring && bin_trace.owner == s) {
+		mobj = bin_trace.mobj;
+		__atomic_store_n(&bin_trace.ring, NULL, __ATOMIC_RELAXED);
+		bin_trace = (struct bin_trace_state){ };
+	}
+	cpu_spin_unlock_xrestore(&bin_trace_lock, exceptions);
+
+	if (!mobj)
+		return TEE_ERROR_BAD_STATE;
+
+	mobj_dec_map(mobj);
+	mobj_put(mobj);
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result open_session(uint32_t param_types __unused,
+			       TEE_Param params[TEE_NUM_PARAMS] __unused,
+			       void **sess_ctx __unused)
+{
+	/* Only normal world may register a trace ring */
+	if (ts_get_calling_session())
+		return TEE_ERROR_ACCESS_DENIED;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result invoke_command(void *pSessionContext __unused,
+				 uint32_t nCommandID, uint32_t nParamTypes,
+				 TEE_Param pParams[TEE_NUM_PARAMS])
+{
+	struct ts_session *s = ts_get_current_session();
+
+	switch (nCommandID) {
+	case PTA_BIN_TRACE_CMD_REGISTER:
+		return bin_trace_register(s, nParamTypes, pParams);
+	case PTA_BIN_TRACE_CMD_UNREGISTER:
+		if (nParamTypes != TEE_PARAM_TYPES(TEE_PARAM_TYPE_NONE,
+						   TEE_PARAM_TYPE_NONE,
+						   TEE_PARAM_TYPE_NONE,
+						   TEE_PARAM_TYPE_NONE))
+			return TEE_ERROR_BAD_PARAMETERS;
+		return bin_trace_unregister(s);
+	default:
+		break;
+	}
+
+	return TEE_ERROR_BAD_PARAMETERS;
+}
+
+static void close_session(void *pSessionContext __unused)
+{
+	bin_trace_unregister(ts_get_current_session());
+}
+
+pseudo_ta_register(.uuid = PTA_BIN_TRACE_UUID, .name = PTA_NAME,
+		   .flags = PTA_DEFAULT_FLAGS,
+		   .open_session_entry_point = open_session,
+		   .invoke_command_entry_point = invoke_command,
+		   .close_session_entry_point = close_session);
@@ -5,8 +5,14 @@
 #include <compiler.h>
 #include <drivers/clk.h>
 #include <drivers/regulator.h>
+#include <initcall.h>
+#include <kernel/delay.h>
+#include <kernel/lock_prof.h>
 #include <kernel/pseudo_ta.h>
+#include <kernel/ree_fs_ta.h>
 #include <kernel/tee_time.h>
+#include <kernel/thread.h>
+#include <kernel/trace_ext.h>
 #include <malloc.h>
 #include <mm/phys_mem.h>
 #include <mm/tee_mm.h>
@@ -15,6 +21,7 @@
 #include <string.h>
 #include <string_ext.h>
 #include <tee_api_types.h>
+#include <tee/fs_htree.h>
 #include <tee/tee_fs.h>
 #include <trace.h>
 
@@ -219,6 +226,251 @@ static TEE_Result print_driver_info(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
 	return TEE_SUCCESS;
 }
 
+static TEE_Result get_thread_stats(uint32_t type, TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct thread_stats stats = { };
+
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	thread_get_stats(&stats);
+	p[0].value.a = stats.num_threads;
+	p[0].value.b = stats.busy;
+	p[1].value.a = stats.max_busy;
+	p[1].value.b = stats.alloc_fail;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result get_fs_cache_stats(uint32_t type,
+				     TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct tee_fs_htree_cache_stats stats = { };
+
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (!IS_ENABLED(CFG_REE_FS))
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	tee_fs_htree_get_cache_stats(&stats);
+	p[0].value.a = stats.hits;
+	p[0].value.b = stats.misses;
+	p[1].value.a = stats.read_ahead;
+	p[1].value.b = stats.num_blocks;
+	p[2].value.a = stats.max_blocks;
+	p[2].value.b = 0;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result get_trace_ring_stats(uint32_t type,
+				       TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct trace_ext_ring_stats stats = { };
+	TEE_Result res = TEE_SUCCESS;
+
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	res = trace_ext_get_ring_stats(p[0].value.a, &stats);
+	if (res)
+		return res;
+
+	p[1].value.a = stats.lines;
+	p[1].value.b = stats.dropped_lines;
+	p[2].value.a = stats.dropped_bytes;
+	p[2].value.b = stats.max_used;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result get_malloc_cache_stats(uint32_t type,
+					 TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct malloc_cache_stats stats = { };
+
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (!IS_ENABLED(CFG_CORE_MALLOC_CACHE))
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	malloc_get_cache_stats(&stats);
+	p[0].value.a = stats.hits;
+	p[0].value.b = stats.misses;
+	p[1].value.a = stats.flushes;
+	p[1].value.b = stats.bytes;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result get_lock_prof_stats(uint32_t type,
+				      TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct lock_prof_site *sites = NULL;
+	struct pta_stats_lock_site *out = NULL;
+	const char *file = NULL;
+	size_t count = 0;
+	size_t len = 0;
+	size_t sz = 0;
+	size_t n = 0;
+
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+			    TEE_PARAM_TYPE_MEMREF_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (!IS_ENABLED(CFG_CORE_LOCK_PROF))
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	count = p[1].memref.size / sizeof(*out);
+	if (count > LOCK_PROF_MAX_SITES)
+		count = LOCK_PROF_MAX_SITES;
+	sites = calloc(count + 1, sizeof(*sites));
+	if (!sites)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	n = lock_prof_get_sites(sites, count, p[0].value.a);
+	if (n > count) {
+		free(sites);
+		if (MUL_OVERFLOW(n, sizeof(*out), &sz))
+			return TEE_ERROR_OVERFLOW;
+		p[1].memref.size = sz;
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+
+	out = p[1].memref.buffer;
+	p[1].memref.size = n * sizeof(*out);
+	memset(out, 0, p[1].memref.size);
+	while (n--) {
+		file = sites[n].fname;
+		len = strlen(file);
+		if (len >= sizeof(out[n].file))
+			file += len - sizeof(out[n].file) + 1;
+		strlcpy(out[n].file, file, sizeof(out[n].file));
+		out[n].line = sites[n].lineno;
+		out[n].type = sites[n].type;
+		out[n].acquired = sites[n].acquired;
+		out[n].contended = sites[n].contended;
+		out[n].spin_acquired = sites[n].spin_acquired;
+		out[n].sleeps = sites[n].sleeps;
+		out[n].wait_us = delay_cnt2us(sites[n].wait_ticks);
+		out[n].max_hold_us = delay_cnt2us(sites[n].max_hold_ticks);
+	}
+	free(sites);
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result get_ta_load_stats(uint32_t type,
+				    TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct ree_fs_ta_load_stats stats = { };
+
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_VALUE_OUTPUT,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (!IS_ENABLED(CFG_REE_FS_TA))
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	ree_fs_ta_get_load_stats(&stats);
+	p[0].value.a = stats.loads;
+	p[0].value.b = stats.cache_hits;
+	/* Cumulated microseconds would wrap in 32 bits after 71 minutes */
+	p[1].value.a = delay_cnt2us(stats.rpc_ticks) / 1000;
+	p[1].value.b = delay_cnt2us(stats.verify_ticks) / 1000;
+	p[2].value.a = delay_cnt2us(stats.read_ticks) / 1000;
+	p[2].value.b = stats.bytes / 1024;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result flush_ta_cache(uint32_t type,
+				 TEE_Param p[TEE_NUM_PARAMS] __unused)
+{
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (!IS_ENABLED(CFG_REE_FS_TA_CACHE))
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	ree_fs_ta_cache_flush();
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result get_boot_prof_stats(uint32_t type,
+				      TEE_Param p[TEE_NUM_PARAMS])
+{
+	struct initcall_prof_rec *recs = NULL;
+	struct pta_stats_boot_rec *out = NULL;
+	size_t count = 0;
+	size_t size = 0;
+	size_t n = 0;
+
+	if (TEE_PARAM_TYPES(TEE_PARAM_TYPE_MEMREF_OUTPUT,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE,
+			    TEE_PARAM_TYPE_NONE) != type)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	if (!IS_ENABLED(CFG_CORE_INITCALL_PROF))
+		return TEE_ERROR_NOT_SUPPORTED;
+
+	/* No records are added once booted */
+	count = initcall_prof_get_recs(NULL, 0);
+	if (MUL_OVERFLOW(count, sizeof(*out), &size))
+		return TEE_ERROR_OVERFLOW;
+	if (p[0].memref.size < size) {
+		p[0].memref.size = size;
+		return TEE_ERROR_SHORT_BUFFER;
+	}
+
+	recs = calloc(count, sizeof(*recs));
+	if (count && !recs)
+		return TEE_ERROR_OUT_OF_MEMORY;
+	count = MIN(initcall_prof_get_recs(recs, count), count);
+
+	out = p[0].memref.buffer;
+	p[0].memref.size = count * sizeof(*out);
+	for (n = 0; n < count; n++) {
+		out[n] = (struct pta_stats_boot_rec){
+			.phase = recs[n].phase,
+			.level = recs[n].level,
+			.result = recs[n].res,
+			.start_us = delay_cnt2us(recs[n].start),
+			.duration_us = delay_cnt2us(recs[n].ticks),
+		};
+		if (recs[n].name)
+			strlcpy(out[n].name, recs[n].name,
+				sizeof(out[n].name));
+		strlcpy(out[n].node, recs[n].node, sizeof(out[n].node));
+	}
+	free(recs);
+
+	return TEE_SUCCESS;
+}
+
 /*
  * Trusted Application Entry Points
  */
@@ -240,6 +492,22 @@ static TEE_Result invoke_command(void *psess __unused,
 		return get_system_time(ptypes, params);
 	case STATS_CMD_PRINT_DRIVER_INFO:
 		return print_driver_info(ptypes, params);
+	case STATS_CMD_THREAD_STATS:
+		return get_thread_stats(ptypes, params);
+	case STATS_CMD_FS_CACHE_STATS:
+		return get_fs_cache_stats(ptypes, params);
+	case STATS_CMD_TRACE_RING_STATS:
+		return get_trace_ring_stats(ptypes, params);
+	case STATS_CMD_MALLOC_CACHE_STATS:
+		return get_malloc_cache_stats(ptypes, params);
+	case STATS_CMD_LOCK_PROF_STATS:
+		return get_lock_prof_stats(ptypes, params);
+	case STATS_CMD_TA_CACHE_FLUSH:
+		return flush_ta_cache(ptypes, params);
+	case STATS_CMD_TA_LOAD_STATS:
+		return get_ta_load_stats(ptypes, params);
+	case STATS_CMD_BOOT_PROF_STATS:
+		return get_boot_prof_stats(ptypes, params);
 	default:
 		break;
 	}
@@ -1,6 +1,7 @@
 subdirs-$(CFG_TEE_CORE_EMBED_INTERNAL_TESTS) += tests
 
 srcs-$(CFG_ATTESTATION_PTA) += attestation.c
+srcs-$(CFG_CORE_BINARY_TRACE) += bin_trace.c
 srcs-$(CFG_DEVICE_ENUM_PTA) += device.c
 srcs-$(CFG_TA_GPROF_SUPPORT) += gprof.c
 ifeq ($(CFG_WITH_USER_TA),y)
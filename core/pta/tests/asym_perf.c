@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+
+#include <crypto/crypto.h>
+#include <kernel/tee_time.h>
+#include <pta_invoke_tests.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tee_api_defines.h>
+#include <tee_api_types.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <utee_defines.h>
+
+#include "misc.h"
+
+/*
+ * Each invocation generates a key of its own and uses it a number of
+ * times. Running invocations concurrently from several normal world
+ * threads shows how well asymmetric operations scale with the number of
+ * cores, the time spent in the operations is returned to ease
+ * comparisons.
+ */
+
+static TEE_Result rsa_perf(size_t key_size, uint32_t count,
+			   const uint8_t *digest, size_t digest_size,
+			   uint8_t *sig, size_t sig_size, TEE_Time *t)
+{
+	struct rsa_keypair key = { };
+	TEE_Time start = { };
+	TEE_Result res = TEE_SUCCESS;
+	size_t sz = 0;
+	uint32_t n = 0;
+
+	res = crypto_acipher_alloc_rsa_keypair(&key, key_size);
+	if (res)
+		return res;
+	res = crypto_acipher_gen_rsa_key(&key, key_size);
+	if (res)
+		goto out;
+
+	tee_time_get_sys_time(&start);
+	for (n = 0; n < count; n++) {
+		sz = sig_size;
+		res = crypto_acipher_rsassa_sign(TEE_ALG_RSASSA_PKCS1_V1_5_SHA256,
+						 &key, 0, digest, digest_size,
+						 sig, &sz);
+		if (res)
+			goto out;
+	}
+	tee_time_get_sys_time(t);
+	TEE_TIME_SUB(*t, start, *t);
+out:
+	crypto_acipher_free_rsa_keypair(&key);
+	return res;
+}
+
+static TEE_Result ecc_perf(uint32_t op, size_t key_size, uint32_t count,
+			   const uint8_t *digest, size_t digest_size,
+			   uint8_t *sig, size_t sig_size, TEE_Time *t)
+{
+	bool ecdh = op == PTA_INVOKE_TESTS_ASYM_PERF_ECDH;
+	struct ecc_public_key pub = { };
+	struct ecc_keypair key = { };
+	unsigned long secret_len = 0;
+	TEE_Time start = { };
+	TEE_Result res = TEE_SUCCESS;
+	uint32_t curve = 0;
+	uint32_t algo = 0;
+	size_t msg_len = 0;
+	size_t sz = 0;
+	uint32_t n = 0;
+
+	switch (key_size) {
+	case 256:
+		curve = TEE_ECC_CURVE_NIST_P256;
+		algo = TEE_ALG_ECDSA_SHA256;
+		break;
+	case 384:
+		curve = TEE_ECC_CURVE_NIST_P384;
+		algo = TEE_ALG_ECDSA_SHA384;
+		break;
+	case 521:
+		curve = TEE_ECC_CURVE_NIST_P521;
+		algo = TEE_ALG_ECDSA_SHA512;
+		break;
+	default:
+		return TEE_ERROR_NOT_SUPPORTED;
+	}
+
+	res = crypto_acipher_alloc_ecc_keypair(&key, ecdh ?
+					       TEE_TYPE_ECDH_KEYPAIR :
+					       TEE_TYPE_ECDSA_KEYPAIR,
+					       key_size);
+	if (res)
+		return res;
+	res = crypto_acipher_alloc_ecc_public_key(&pub, ecdh ?
+						  TEE_TYPE_ECDH_PUBLIC_KEY :
+						  TEE_TYPE_ECDSA_PUBLIC_KEY,
+						  key_size);
+	if (res)
+		goto out;
+	key.curve = curve;
+	pub.curve = curve;
+	msg_len = MIN(digest_size, ROUNDUP_DIV(key_size, 8));
+	res = crypto_acipher_gen_ecc_key(&key, key_size);
+	if (res)
+		goto out;
+	crypto_bignum_copy(pub.x, key.x);
+	crypto_bignum_copy(pub.y, key.y);
+
+	/* Verification needs a signature to check */
+	sz = sig_size;
+	if (op == PTA_INVOKE_TESTS_ASYM_PERF_ECDSA_VERIFY) {
+		res = crypto_acipher_ecc_sign(algo, &key, digest, msg_len,
+					      sig, &sz);
+		if (res)
+			goto out;
+	}
+
+	tee_time_get_sys_time(&start);
+	for (n = 0; n < count; n++) {
+		switch (op) {
+		case PTA_INVOKE_TESTS_ASYM_PERF_ECDSA:
+			sz = sig_size;
+			res = crypto_acipher_ecc_sign(algo, &key, digest,
+						      msg_len, sig, &sz);
+			break;
+		case PTA_INVOKE_TESTS_ASYM_PERF_ECDSA_VERIFY:
+			res = crypto_acipher_ecc_verify(algo, &pub, digest,
+							msg_len, sig, sz);
+			break;
+		default:
+			/* Agree on a secret with our own public key */
+			secret_len = sig_size;
+			res = crypto_acipher_ecc_shared_secret(&key, &pub, sig,
+							       &secret_len);
+			break;
+		}
+		if (res)
+			goto out;
+	}
+	tee_time_get_sys_time(t);
+	TEE_TIME_SUB(*t, start, *t);
+out:
+	if (pub.ops)
+		crypto_acipher_free_ecc_public_key(&pub);
+	crypto_bignum_free(&key.d);
+	crypto_bignum_free(&key.x);
+	crypto_bignum_free(&key.y);
+	return res;
+}
+
+TEE_Result core_asym_perf_tests(uint32_t param_types,
+				TEE_Param params[TEE_NUM_PARAMS])
+{
+	const uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+						TEE_PARAM_TYPE_VALUE_INPUT,
+						TEE_PARAM_TYPE_VALUE_OUTPUT,
+						TEE_PARAM_TYPE_NONE);
+	uint8_t digest[TEE_SHA512_HASH_SIZE] = { };
+	TEE_Result res = TEE_SUCCESS;
+	size_t sig_size = 0;
+	TEE_Time t = { };
+	uint8_t *sig = NULL;
+	size_t n = 0;
+
+	if (param_types != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	/* Large enough for any RSA key, ECDSA signature or ECDH secret */
+	sig_size = ROUNDUP_DIV(MAX(params[0].value.b, 521U), 8) * 2;
+	sig = malloc(sig_size);
+	if (!sig)
+		return TEE_ERROR_OUT_OF_MEMORY;
+	for (n = 0; n < sizeof(digest); n++)
+		digest[n] = n;
+
+	switch (params[0].value.a) {
+	case PTA_INVOKE_TESTS_ASYM_PERF_RSA:
+		res = rsa_perf(params[0].value.b, params[1].value.a, digest,
+			       TEE_SHA256_HASH_SIZE, sig, sig_size, &t);
+		break;
+	case PTA_INVOKE_TESTS_ASYM_PERF_ECDSA:
+	case PTA_INVOKE_TESTS_ASYM_PERF_ECDSA_VERIFY:
+	case PTA_INVOKE_TESTS_ASYM_PERF_ECDH:
+		res = ecc_perf(params[0].value.a, params[0].value.b,
+			       params[1].value.a, digest, sizeof(digest), sig,
+			       sig_size, &t);
+		break;
+	default:
+		res = TEE_ERROR_BAD_PARAMETERS;
+		break;
+	}
+
+	if (!res)
+		params[2].value.a = t.seconds * 1000 + t.millis;
+
+	free(sig);
+	return res;
+}
@@ -0,0 +1,348 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+
+#include <crypto/crypto.h>
+#include <string.h>
+#include <tee_api_types.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <util.h>
+
+#include "misc.h"
+
+/*
+ * Known answer tests for the X25519 and Ed25519 implementation in
+ * core/lib/libtomcrypt/ec25519_fe51.c, using the test vectors from RFC 7748
+ * and RFC 8032.
+ */
+
+#define EC25519_SIZE	32
+
+#ifdef _CFG_CORE_LTC_X25519
+struct x25519_vect {
+	uint8_t scalar[EC25519_SIZE];
+	uint8_t u[EC25519_SIZE];
+	uint8_t out[EC25519_SIZE];
+};
+
+static const struct x25519_vect x25519_vect[] = {
+	/* RFC 7748 section 5.2 */
+	{
+		.scalar = {
+			0xa5, 0x46, 0xe3, 0x6b, 0xf0, 0x52, 0x7c, 0x9d,
+			0x3b, 0x16, 0x15, 0x4b, 0x82, 0x46, 0x5e, 0xdd,
+			0x62, 0x14, 0x4c, 0x0a, 0xc1, 0xfc, 0x5a, 0x18,
+			0x50, 0x6a, 0x22, 0x44, 0xba, 0x44, 0x9a, 0xc4,
+		},
+		.u = {
+			0xe6, 0xdb, 0x68, 0x67, 0x58, 0x30, 0x30, 0xdb,
+			0x35, 0x94, 0xc1, 0xa4, 0x24, 0xb1, 0x5f, 0x7c,
+			0x72, 0x66, 0x24, 0xec, 0x26, 0xb3, 0x35, 0x3b,
+			0x10, 0xa9, 0x03, 0xa6, 0xd0, 0xab, 0x1c, 0x4c,
+		},
+		.out = {
+			0xc3, 0xda, 0x55, 0x37, 0x9d, 0xe9, 0xc6, 0x90,
+			0x8e, 0x94, 0xea, 0x4d, 0xf2, 0x8d, 0x08, 0x4f,
+			0x32, 0xec, 0xcf, 0x03, 0x49, 0x1c, 0x71, 0xf7,
+			0x54, 0xb4, 0x07, 0x55, 0x77, 0xa2, 0x85, 0x52,
+		},
+	},
+	{
+		.scalar = {
+			0x4b, 0x66, 0xe9, 0xd4, 0xd1, 0xb4, 0x67, 0x3c,
+			0x5a, 0xd2, 0x26, 0x91, 0x95, 0x7d, 0x6a, 0xf5,
+			0xc1, 0x1b, 0x64, 0x21, 0xe0, 0xea, 0x01, 0xd4,
+			0x2c, 0xa4, 0x16, 0x9e, 0x79, 0x18, 0xba, 0x0d,
+		},
+		.u = {
+			0xe5, 0x21, 0x0f, 0x12, 0x78, 0x68, 0x11, 0xd3,
+			0xf4, 0xb7, 0x95, 0x9d, 0x05, 0x38, 0xae, 0x2c,
+			0x31, 0xdb, 0xe7, 0x10, 0x6f, 0xc0, 0x3c, 0x3e,
+			0xfc, 0x4c, 0xd5, 0x49, 0xc7, 0x15, 0xa4, 0x93,
+		},
+		.out = {
+			0x95, 0xcb, 0xde, 0x94, 0x76, 0xe8, 0x90, 0x7d,
+			0x7a, 0xad, 0xe4, 0x5c, 0xb4, 0xb8, 0x73, 0xf8,
+			0x8b, 0x59, 0x5a, 0x68, 0x79, 0x9f, 0xa1, 0x52,
+			0xe6, 0xf8, 0xf7, 0x64, 0x7a, 0xac, 0x79, 0x57,
+		},
+	},
+	/* RFC 7748 section 6.1, Alice's public key */
+	{
+		.scalar = {
+			0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d,
+			0x3c, 0x16, 0xc1, 0x72, 0x51, 0xb2, 0x66, 0x45,
+			0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0, 0x99, 0x2a,
+			0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a,
+		},
+		.u = { 9 },
+		.out = {
+			0x85, 0x20, 0xf0, 0x09, 0x89, 0x30, 0xa7, 0x54,
+			0x74, 0x8b, 0x7d, 0xdc, 0xb4, 0x3e, 0xf7, 0x5a,
+			0x0d, 0xbf, 0x3a, 0x0d, 0x26, 0x38, 0x1a, 0xf4,
+			0xeb, 0xa4, 0xa9, 0x8e, 0xaa, 0x9b, 0x4e, 0x6a,
+		},
+	},
+	/* RFC 7748 section 6.1, Alice's shared secret */
+	{
+		.scalar = {
+			0x77, 0x07, 0x6d, 0x0a, 0x73, 0x18, 0xa5, 0x7d,
+			0x3c, 0x16, 0xc1, 0x72, 0x51, 0xb2, 0x66, 0x45,
+			0xdf, 0x4c, 0x2f, 0x87, 0xeb, 0xc0, 0x99, 0x2a,
+			0xb1, 0x77, 0xfb, 0xa5, 0x1d, 0xb9, 0x2c, 0x2a,
+		},
+		.u = {
+			0xde, 0x9e, 0xdb, 0x7d, 0x7b, 0x7d, 0xc1, 0xb4,
+			0xd3, 0x5b, 0x61, 0xc2, 0xec, 0xe4, 0x35, 0x37,
+			0x3f, 0x83, 0x43, 0xc8, 0x5b, 0x78, 0x67, 0x4d,
+			0xad, 0xfc, 0x7e, 0x14, 0x6f, 0x88, 0x2b, 0x4f,
+		},
+		.out = {
+			0x4a, 0x5d, 0x9d, 0x5b, 0xa4, 0xce, 0x2d, 0xe1,
+			0x72, 0x8e, 0x3b, 0xf4, 0x80, 0x35, 0x0f, 0x25,
+			0xe0, 0x7e, 0x21, 0xc9, 0x47, 0xd1, 0x9e, 0x33,
+			0x76, 0xf0, 0x9b, 0x3c, 0x1e, 0x16, 0x17, 0x42,
+		},
+	},
+	/* RFC 7748 section 6.1, Bob's shared secret */
+	{
+		.scalar = {
+			0x5d, 0xab, 0x08, 0x7e, 0x62, 0x4a, 0x8a, 0x4b,
+			0x79, 0xe1, 0x7f, 0x8b, 0x83, 0x80, 0x0e, 0xe6,
+			0x6f, 0x3b, 0xb1, 0x29, 0x26, 0x18, 0xb6, 0xfd,
+			0x1c, 0x2f, 0x8b, 0x27, 0xff, 0x88, 0xe0, 0xeb,
+		},
+		.u = {
+			0x85, 0x20, 0xf0, 0x09, 0x89, 0x30, 0xa7, 0x54,
+			0x74, 0x8b, 0x7d, 0xdc, 0xb4, 0x3e, 0xf7, 0x5a,
+			0x0d, 0xbf, 0x3a, 0x0d, 0x26, 0x38, 0x1a, 0xf4,
+			0xeb, 0xa4, 0xa9, 0x8e, 0xaa, 0x9b, 0x4e, 0x6a,
+		},
+		.out = {
+			0x4a, 0x5d, 0x9d, 0x5b, 0xa4, 0xce, 0x2d, 0xe1,
+			0x72, 0x8e, 0x3b, 0xf4, 0x80, 0x35, 0x0f, 0x25,
+			0xe0, 0x7e, 0x21, 0xc9, 0x47, 0xd1, 0x9e, 0x33,
+			0x76, 0xf0, 0x9b, 0x3c, 0x1e, 0x16, 0x17, 0x42,
+		},
+	},
+};
+
+static int self_test_x25519(void)
+{
+	uint8_t priv[EC25519_SIZE] = { };
+	uint8_t u[EC25519_SIZE] = { };
+	uint8_t out[EC25519_SIZE] = { };
+	struct montgomery_keypair key = { .priv = priv };
+	const struct x25519_vect *v = NULL;
+	unsigned long out_len = 0;
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(x25519_vect); n++) {
+		v = x25519_vect + n;
+		memcpy(priv, v->scalar, sizeof(priv));
+		memcpy(u, v->u, sizeof(u));
+
+		out_len = sizeof(out);
+		res = crypto_acipher_x25519_shared_secret(&key, u, out,
+							  &out_len);
+		if (res || out_len != sizeof(out) ||
+		    memcmp(out, v->out, sizeof(out))) {
+			EMSG("X25519 vector %zu failed: %#"PRIx32, n, res);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+#else
+static int self_test_x25519(void)
+{
+	return 0;
+}
+#endif
+
+#ifdef _CFG_CORE_LTC_ED25519
+struct ed25519_vect {
+	uint8_t priv[EC25519_SIZE];
+	uint8_t pub[EC25519_SIZE];
+	uint8_t msg[2];
+	size_t msg_len;
+	uint8_t sig[2 * EC25519_SIZE];
+};
+
+/* RFC 8032 section 7.1, tests 1 to 3 */
+static const struct ed25519_vect ed25519_vect[] = {
+	{
+		.priv = {
+			0x9d, 0x61, 0xb1, 0x9d, 0xef, 0xfd, 0x5a, 0x60,
+			0xba, 0x84, 0x4a, 0xf4, 0x92, 0xec, 0x2c, 0xc4,
+			0x44, 0x49, 0xc5, 0x69, 0x7b, 0x32, 0x69, 0x19,
+			0x70, 0x3b, 0xac, 0x03, 0x1c, 0xae, 0x7f, 0x60,
+		},
+		.pub = {
+			0xd7, 0x5a, 0x98, 0x01, 0x82, 0xb1, 0x0a, 0xb7,
+			0xd5, 0x4b, 0xfe, 0xd3, 0xc9, 0x64, 0x07, 0x3a,
+			0x0e, 0xe1, 0x72, 0xf3, 0xda, 0xa6, 0x23, 0x25,
+			0xaf, 0x02, 0x1a, 0x68, 0xf7, 0x07, 0x51, 0x1a,
+		},
+		.msg_len = 0,
+		.sig = {
+			0xe5, 0x56, 0x43, 0x00, 0xc3, 0x60, 0xac, 0x72,
+			0x90, 0x86, 0xe2, 0xcc, 0x80, 0x6e, 0x82, 0x8a,
+			0x84, 0x87, 0x7f, 0x1e, 0xb8, 0xe5, 0xd9, 0x74,
+			0xd8, 0x73, 0xe0, 0x65, 0x22, 0x49, 0x01, 0x55,
+			0x5f, 0xb8, 0x82, 0x15, 0x90, 0xa3, 0x3b, 0xac,
+			0xc6, 0x1e, 0x39, 0x70, 0x1c, 0xf9, 0xb4, 0x6b,
+			0xd2, 0x5b, 0xf5, 0xf0, 0x59, 0x5b, 0xbe, 0x24,
+			0x65, 0x51, 0x41, 0x43, 0x8e, 0x7a, 0x10, 0x0b,
+		},
+	},
+	{
+		.priv = {
+			0x4c, 0xcd, 0x08, 0x9b, 0x28, 0xff, 0x96, 0xda,
+			0x9d, 0xb6, 0xc3, 0x46, 0xec, 0x11, 0x4e, 0x0f,
+			0x5b, 0x8a, 0x31, 0x9f, 0x35, 0xab, 0xa6, 0x24,
+			0xda, 0x8c, 0xf6, 0xed, 0x4f, 0xb8, 0xa6, 0xfb,
+		},
+		.pub = {
+			0x3d, 0x40, 0x17, 0xc3, 0xe8, 0x43, 0x89, 0x5a,
+			0x92, 0xb7, 0x0a, 0xa7, 0x4d, 0x1b, 0x7e, 0xbc,
+			0x9c, 0x98, 0x2c, 0xcf, 0x2e, 0xc4, 0x96, 0x8c,
+			0xc0, 0xcd, 0x55, 0xf1, 0x2a, 0xf4, 0x66, 0x0c,
+		},
+		.msg = { 0x72 },
+		.msg_len = 1,
+		.sig = {
+			0x92, 0xa0, 0x09, 0xa9, 0xf0, 0xd4, 0xca, 0xb8,
+			0x72, 0x0e, 0x82, 0x0b, 0x5f, 0x64, 0x25, 0x40,
+			0xa2, 0xb2, 0x7b, 0x54, 0x16, 0x50, 0x3f, 0x8f,
+			0xb3, 0x76, 0x22, 0x23, 0xeb, 0xdb, 0x69, 0xda,
+			0x08, 0x5a, 0xc1, 0xe4, 0x3e, 0x15, 0x99, 0x6e,
+			0x45, 0x8f, 0x36, 0x13, 0xd0, 0xf1, 0x1d, 0x8c,
+			0x38, 0x7b, 0x2e, 0xae, 0xb4, 0x30, 0x2a, 0xee,
+			0xb0, 0x0d, 0x29, 0x16, 0x12, 0xbb, 0x0c, 0x00,
+		},
+	},
+	{
+		.priv = {
+			0xc5, 0xaa, 0x8d, 0xf4, 0x3f, 0x9f, 0x83, 0x7b,
+			0xed, 0xb7, 0x44, 0x2f, 0x31, 0xdc, 0xb7, 0xb1,
+			0x66, 0xd3, 0x85, 0x35, 0x07, 0x6f, 0x09, 0x4b,
+			0x85, 0xce, 0x3a, 0x2e, 0x0b, 0x44, 0x58, 0xf7,
+		},
+		.pub = {
+			0xfc, 0x51, 0xcd, 0x8e, 0x62, 0x18, 0xa1, 0xa3,
+			0x8d, 0xa4, 0x7e, 0xd0, 0x02, 0x30, 0xf0, 0x58,
+			0x08, 0x16, 0xed, 0x13, 0xba, 0x33, 0x03, 0xac,
+			0x5d, 0xeb, 0x91, 0x15, 0x48, 0x90, 0x80, 0x25,
+		},
+		.msg = { 0xaf, 0x82 },
+		.msg_len = 2,
+		.sig = {
+			0x62, 0x91, 0xd6, 0x57, 0xde, 0xec, 0x24, 0x02,
+			0x48, 0x27, 0xe6, 0x9c, 0x3a, 0xbe, 0x01, 0xa3,
+			0x0c, 0xe5, 0x48, 0xa2, 0x84, 0x74, 0x3a, 0x44,
+			0x5e, 0x36, 0x80, 0xd7, 0xdb, 0x5a, 0xc3, 0xac,
+			0x18, 0xff, 0x9b, 0x53, 0x8d, 0x16, 0xf2, 0x90,
+			0xae, 0x67, 0xf7, 0x60, 0x98, 0x4d, 0xc6, 0x59,
+			0x4a, 0x7c, 0x15, 0xe9, 0x71, 0x6e, 0xd2, 0x8d,
+			0xc0, 0x27, 0xbe, 0xce, 0xea, 0x1e, 0xc4, 0x0a,
+		},
+	},
+};
+
+/*
+ * The order of the base point,
+ * L = 2^252 + 27742317777372353535851937790883648493
+ */
+static const uint8_t ed25519_order[EC25519_SIZE] = {
+	0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58,
+	0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10,
+};
+
+/*
+ * Replaces S in @sig with S + L, which is equivalent modulo L but must
+ * be rejected as non-canonical by RFC 8032 section 5.1.7. S < L so the
+ * sum fits in 256 bits.
+ */
+static void ed25519_add_order(uint8_t sig[2 * EC25519_SIZE])
+{
+	uint8_t *s = sig + EC25519_SIZE;
+	unsigned int carry = 0;
+	size_t n = 0;
+
+	for (n = 0; n < EC25519_SIZE; n++) {
+		carry += s[n] + ed25519_order[n];
+		s[n] = carry;
+		carry >>= 8;
+	}
+}
+
+static int self_test_ed25519(void)
+{
+	uint8_t priv[EC25519_SIZE] = { };
+	uint8_t pub[EC25519_SIZE] = { };
+	uint8_t sig[2 * EC25519_SIZE] = { };
+	struct ed25519_keypair key = { .priv = priv, .pub = pub };
+	struct ed25519_public_key pub_key = { .pub = pub };
+	const struct ed25519_vect *v = NULL;
+	TEE_Result res = TEE_SUCCESS;
+	size_t sig_len = 0;
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(ed25519_vect); n++) {
+		v = ed25519_vect + n;
+		memcpy(priv, v->priv, sizeof(priv));
+		memcpy(pub, v->pub, sizeof(pub));
+
+		sig_len = sizeof(sig);
+		res = crypto_acipher_ed25519_sign(&key, v->msg, v->msg_len,
+						  sig, &sig_len);
+		if (res || sig_len != sizeof(sig) ||
+		    memcmp(sig, v->sig, sizeof(sig))) {
+			EMSG("Ed25519 vector %zu sign failed: %#"PRIx32, n,
+			     res);
+			return -1;
+		}
+
+		res = crypto_acipher_ed25519_verify(&pub_key, v->msg,
+						    v->msg_len, sig,
+						    sizeof(sig));
+		if (res) {
+			EMSG("Ed25519 vector %zu verify failed: %#"PRIx32, n,
+			     res);
+			return -1;
+		}
+
+		ed25519_add_order(sig);
+		res = crypto_acipher_ed25519_verify(&pub_key, v->msg,
+						    v->msg_len, sig,
+						    sizeof(sig));
+		if (res != TEE_ERROR_SIGNATURE_INVALID) {
+			EMSG("Ed25519 vector %zu S >= L accepted: %#"PRIx32, n,
+			     res);
+			return -1;
+		}
+	}
+
+	return 0;
+}
+#else
+static int self_test_ed25519(void)
+{
+	return 0;
+}
+#endif
+
+int self_test_ec25519(void)
+{
+	if (self_test_x25519() || self_test_ed25519())
+		return -1;
+
+	return 0;
+}
@@ -0,0 +1,375 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+
+#include <crypto/crypto.h>
+#include <string.h>
+#include <tee_api_defines.h>
+#include <tee_api_types.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <utee_defines.h>
+#include <util.h>
+
+#include "misc.h"
+
+/*
+ * Known answer tests for the P-256 and P-384 implementation in
+ * core/lib/libtomcrypt/ecc_nistp.c. Each curve checks:
+ * - a multiplication of the base point, which uses the comb, by agreeing
+ *   on a secret with the base point as peer;
+ * - an ECDH shared secret, which multiplies an arbitrary point;
+ * - an ECDSA signature verification, which uses Shamir's trick, and that
+ *   an altered signature is rejected.
+ */
+
+#define NISTP_MAX_SIZE	48
+
+struct ecc_nistp_vect {
+	uint32_t curve;
+	uint32_t algo;
+	size_t key_size;
+	uint8_t gx[NISTP_MAX_SIZE];
+	uint8_t gy[NISTP_MAX_SIZE];
+	uint8_t d[NISTP_MAX_SIZE];
+	uint8_t qx[NISTP_MAX_SIZE];
+	uint8_t qy[NISTP_MAX_SIZE];
+	uint8_t peer_x[NISTP_MAX_SIZE];
+	uint8_t peer_y[NISTP_MAX_SIZE];
+	uint8_t z[NISTP_MAX_SIZE];
+	uint8_t ux[NISTP_MAX_SIZE];
+	uint8_t uy[NISTP_MAX_SIZE];
+	uint8_t digest[NISTP_MAX_SIZE];
+	uint8_t sig[NISTP_MAX_SIZE * 2];
+};
+
+static const struct ecc_nistp_vect ecc_nistp_vect[] = {
+	/* P-256 */
+	{
+		.curve = TEE_ECC_CURVE_NIST_P256,
+		.algo = TEE_ALG_ECDSA_SHA256,
+		.key_size = 256,
+		.gx = {
+			0x6b, 0x17, 0xd1, 0xf2, 0xe1, 0x2c, 0x42, 0x47,
+			0xf8, 0xbc, 0xe6, 0xe5, 0x63, 0xa4, 0x40, 0xf2,
+			0x77, 0x03, 0x7d, 0x81, 0x2d, 0xeb, 0x33, 0xa0,
+			0xf4, 0xa1, 0x39, 0x45, 0xd8, 0x98, 0xc2, 0x96,
+		},
+		.gy = {
+			0x4f, 0xe3, 0x42, 0xe2, 0xfe, 0x1a, 0x7f, 0x9b,
+			0x8e, 0xe7, 0xeb, 0x4a, 0x7c, 0x0f, 0x9e, 0x16,
+			0x2b, 0xce, 0x33, 0x57, 0x6b, 0x31, 0x5e, 0xce,
+			0xcb, 0xb6, 0x40, 0x68, 0x37, 0xbf, 0x51, 0xf5,
+		},
+		/* NIST CAVS ECC CDH Primitive, first vector */
+		.d = {
+			0x7d, 0x7d, 0xc5, 0xf7, 0x1e, 0xb2, 0x9d, 0xda,
+			0xf8, 0x0d, 0x62, 0x14, 0x63, 0x2e, 0xea, 0xe0,
+			0x3d, 0x90, 0x58, 0xaf, 0x1f, 0xb6, 0xd2, 0x2e,
+			0xd8, 0x0b, 0xad, 0xb6, 0x2b, 0xc1, 0xa5, 0x34,
+		},
+		.qx = {
+			0xea, 0xd2, 0x18, 0x59, 0x01, 0x19, 0xe8, 0x87,
+			0x6b, 0x29, 0x14, 0x6f, 0xf8, 0x9c, 0xa6, 0x17,
+			0x70, 0xc4, 0xed, 0xbb, 0xf9, 0x7d, 0x38, 0xce,
+			0x38, 0x5e, 0xd2, 0x81, 0xd8, 0xa6, 0xb2, 0x30,
+		},
+		.qy = {
+			0x28, 0xaf, 0x61, 0x28, 0x1f, 0xd3, 0x5e, 0x2f,
+			0xa7, 0x00, 0x25, 0x23, 0xac, 0xc8, 0x5a, 0x42,
+			0x9c, 0xb0, 0x6e, 0xe6, 0x64, 0x83, 0x25, 0x38,
+			0x9f, 0x59, 0xed, 0xfc, 0xe1, 0x40, 0x51, 0x41,
+		},
+		.peer_x = {
+			0x70, 0x0c, 0x48, 0xf7, 0x7f, 0x56, 0x58, 0x4c,
+			0x5c, 0xc6, 0x32, 0xca, 0x65, 0x64, 0x0d, 0xb9,
+			0x1b, 0x6b, 0xac, 0xce, 0x3a, 0x4d, 0xf6, 0xb4,
+			0x2c, 0xe7, 0xcc, 0x83, 0x88, 0x33, 0xd2, 0x87,
+		},
+		.peer_y = {
+			0xdb, 0x71, 0xe5, 0x09, 0xe3, 0xfd, 0x9b, 0x06,
+			0x0d, 0xdb, 0x20, 0xba, 0x5c, 0x51, 0xdc, 0xc5,
+			0x94, 0x8d, 0x46, 0xfb, 0xf6, 0x40, 0xdf, 0xe0,
+			0x44, 0x17, 0x82, 0xca, 0xb8, 0x5f, 0xa4, 0xac,
+		},
+		.z = {
+			0x46, 0xfc, 0x62, 0x10, 0x64, 0x20, 0xff, 0x01,
+			0x2e, 0x54, 0xa4, 0x34, 0xfb, 0xdd, 0x2d, 0x25,
+			0xcc, 0xc5, 0x85, 0x20, 0x60, 0x56, 0x1e, 0x68,
+			0x04, 0x0d, 0xd7, 0x77, 0x89, 0x97, 0xbd, 0x7b,
+		},
+		/* RFC 6979 section A.2.5, SHA-256 of "sample" */
+		.ux = {
+			0x60, 0xfe, 0xd4, 0xba, 0x25, 0x5a, 0x9d, 0x31,
+			0xc9, 0x61, 0xeb, 0x74, 0xc6, 0x35, 0x6d, 0x68,
+			0xc0, 0x49, 0xb8, 0x92, 0x3b, 0x61, 0xfa, 0x6c,
+			0xe6, 0x69, 0x62, 0x2e, 0x60, 0xf2, 0x9f, 0xb6,
+		},
+		.uy = {
+			0x79, 0x03, 0xfe, 0x10, 0x08, 0xb8, 0xbc, 0x99,
+			0xa4, 0x1a, 0xe9, 0xe9, 0x56, 0x28, 0xbc, 0x64,
+			0xf2, 0xf1, 0xb2, 0x0c, 0x2d, 0x7e, 0x9f, 0x51,
+			0x77, 0xa3, 0xc2, 0x94, 0xd4, 0x46, 0x22, 0x99,
+		},
+		.digest = {
+			0xaf, 0x2b, 0xdb, 0xe1, 0xaa, 0x9b, 0x6e, 0xc1,
+			0xe2, 0xad, 0xe1, 0xd6, 0x94, 0xf4, 0x1f, 0xc7,
+			0x1a, 0x83, 0x1d, 0x02, 0x68, 0xe9, 0x89, 0x15,
+			0x62, 0x11, 0x3d, 0x8a, 0x62, 0xad, 0xd1, 0xbf,
+		},
+		.sig = {
+			0xef, 0xd4, 0x8b, 0x2a, 0xac, 0xb6, 0xa8, 0xfd,
+			0x11, 0x40, 0xdd, 0x9c, 0xd4, 0x5e, 0x81, 0xd6,
+			0x9d, 0x2c, 0x87, 0x7b, 0x56, 0xaa, 0xf9, 0x91,
+			0xc3, 0x4d, 0x0e, 0xa8, 0x4e, 0xaf, 0x37, 0x16,
+			0xf7, 0xcb, 0x1c, 0x94, 0x2d, 0x65, 0x7c, 0x41,
+			0xd4, 0x36, 0xc7, 0xa1, 0xb6, 0xe2, 0x9f, 0x65,
+			0xf3, 0xe9, 0x00, 0xdb, 0xb9, 0xaf, 0xf4, 0x06,
+			0x4d, 0xc4, 0xab, 0x2f, 0x84, 0x3a, 0xcd, 0xa8,
+		},
+	},
+	/* P-384 */
+	{
+		.curve = TEE_ECC_CURVE_NIST_P384,
+		.algo = TEE_ALG_ECDSA_SHA384,
+		.key_size = 384,
+		.gx = {
+			0xaa, 0x87, 0xca, 0x22, 0xbe, 0x8b, 0x05, 0x37,
+			0x8e, 0xb1, 0xc7, 0x1e, 0xf3, 0x20, 0xad, 0x74,
+			0x6e, 0x1d, 0x3b, 0x62, 0x8b, 0xa7, 0x9b, 0x98,
+			0x59, 0xf7, 0x41, 0xe0, 0x82, 0x54, 0x2a, 0x38,
+			0x55, 0x02, 0xf2, 0x5d, 0xbf, 0x55, 0x29, 0x6c,
+			0x3a, 0x54, 0x5e, 0x38, 0x72, 0x76, 0x0a, 0xb7,
+		},
+		.gy = {
+			0x36, 0x17, 0xde, 0x4a, 0x96, 0x26, 0x2c, 0x6f,
+			0x5d, 0x9e, 0x98, 0xbf, 0x92, 0x92, 0xdc, 0x29,
+			0xf8, 0xf4, 0x1d, 0xbd, 0x28, 0x9a, 0x14, 0x7c,
+			0xe9, 0xda, 0x31, 0x13, 0xb5, 0xf0, 0xb8, 0xc0,
+			0x0a, 0x60, 0xb1, 0xce, 0x1d, 0x7e, 0x81, 0x9d,
+			0x7a, 0x43, 0x1d, 0x7c, 0x90, 0xea, 0x0e, 0x5f,
+		},
+		/* NIST CAVS ECC CDH Primitive, first vector */
+		.d = {
+			0x3c, 0xc3, 0x12, 0x2a, 0x68, 0xf0, 0xd9, 0x50,
+			0x27, 0xad, 0x38, 0xc0, 0x67, 0x91, 0x6b, 0xa0,
+			0xeb, 0x8c, 0x38, 0x89, 0x4d, 0x22, 0xe1, 0xb1,
+			0x56, 0x18, 0xb6, 0x81, 0x8a, 0x66, 0x17, 0x74,
+			0xad, 0x46, 0x3b, 0x20, 0x5d, 0xa8, 0x8c, 0xf6,
+			0x99, 0xab, 0x4d, 0x43, 0xc9, 0xcf, 0x98, 0xa1,
+		},
+		.qx = {
+			0x98, 0x03, 0x80, 0x7f, 0x2f, 0x6d, 0x2f, 0xd9,
+			0x66, 0xcd, 0xd0, 0x29, 0x0b, 0xd4, 0x10, 0xc0,
+			0x19, 0x03, 0x52, 0xfb, 0xec, 0x7f, 0xf6, 0x24,
+			0x7d, 0xe1, 0x30, 0x2d, 0xf8, 0x6f, 0x25, 0xd3,
+			0x4f, 0xe4, 0xa9, 0x7b, 0xef, 0x60, 0xcf, 0xf5,
+			0x48, 0x35, 0x5c, 0x01, 0x5d, 0xbb, 0x3e, 0x5f,
+		},
+		.qy = {
+			0xba, 0x26, 0xca, 0x69, 0xec, 0x2f, 0x5b, 0x5d,
+			0x9d, 0xad, 0x20, 0xcc, 0x9d, 0xa7, 0x11, 0x38,
+			0x3a, 0x9d, 0xbe, 0x34, 0xea, 0x3f, 0xa5, 0xa2,
+			0xaf, 0x75, 0xb4, 0x65, 0x02, 0x62, 0x9a, 0xd5,
+			0x4d, 0xd8, 0xb7, 0xd7, 0x3a, 0x8a, 0xbb, 0x06,
+			0xa3, 0xa3, 0xbe, 0x47, 0xd6, 0x50, 0xcc, 0x99,
+		},
+		.peer_x = {
+			0xa7, 0xc7, 0x6b, 0x97, 0x0c, 0x3b, 0x5f, 0xe8,
+			0xb0, 0x5d, 0x28, 0x38, 0xae, 0x04, 0xab, 0x47,
+			0x69, 0x7b, 0x9e, 0xaf, 0x52, 0xe7, 0x64, 0x59,
+			0x2e, 0xfd, 0xa2, 0x7f, 0xe7, 0x51, 0x32, 0x72,
+			0x73, 0x44, 0x66, 0xb4, 0x00, 0x09, 0x1a, 0xdb,
+			0xf2, 0xd6, 0x8c, 0x58, 0xe0, 0xc5, 0x00, 0x66,
+		},
+		.peer_y = {
+			0xac, 0x68, 0xf1, 0x9f, 0x2e, 0x1c, 0xb8, 0x79,
+			0xae, 0xd4, 0x3a, 0x99, 0x69, 0xb9, 0x1a, 0x08,
+			0x39, 0xc4, 0xc3, 0x8a, 0x49, 0x74, 0x9b, 0x66,
+			0x1e, 0xfe, 0xdf, 0x24, 0x34, 0x51, 0x91, 0x5e,
+			0xd0, 0x90, 0x5a, 0x32, 0xb0, 0x60, 0x99, 0x2b,
+			0x46, 0x8c, 0x64, 0x76, 0x6f, 0xc8, 0x43, 0x7a,
+		},
+		.z = {
+			0x5f, 0x9d, 0x29, 0xdc, 0x5e, 0x31, 0xa1, 0x63,
+			0x06, 0x03, 0x56, 0x21, 0x36, 0x69, 0xc8, 0xce,
+			0x13, 0x2e, 0x22, 0xf5, 0x7c, 0x9a, 0x04, 0xf4,
+			0x0b, 0xa7, 0xfc, 0xea, 0xd4, 0x93, 0xb4, 0x57,
+			0xe5, 0x62, 0x1e, 0x76, 0x6c, 0x40, 0xa2, 0xe3,
+			0xd4, 0xd6, 0xa0, 0x4b, 0x25, 0xe5, 0x33, 0xf1,
+		},
+		/* RFC 6979 section A.2.6, SHA-384 of "sample" */
+		.ux = {
+			0xec, 0x3a, 0x4e, 0x41, 0x5b, 0x4e, 0x19, 0xa4,
+			0x56, 0x86, 0x18, 0x02, 0x9f, 0x42, 0x7f, 0xa5,
+			0xda, 0x9a, 0x8b, 0xc4, 0xae, 0x92, 0xe0, 0x2e,
+			0x06, 0xaa, 0xe5, 0x28, 0x6b, 0x30, 0x0c, 0x64,
+			0xde, 0xf8, 0xf0, 0xea, 0x90, 0x55, 0x86, 0x60,
+			0x64, 0xa2, 0x54, 0x51, 0x54, 0x80, 0xbc, 0x13,
+		},
+		.uy = {
+			0x80, 0x15, 0xd9, 0xb7, 0x2d, 0x7d, 0x57, 0x24,
+			0x4e, 0xa8, 0xef, 0x9a, 0xc0, 0xc6, 0x21, 0x89,
+			0x67, 0x08, 0xa5, 0x93, 0x67, 0xf9, 0xdf, 0xb9,
+			0xf5, 0x4c, 0xa8, 0x4b, 0x3f, 0x1c, 0x9d, 0xb1,
+			0x28, 0x8b, 0x23, 0x1c, 0x3a, 0xe0, 0xd4, 0xfe,
+			0x73, 0x44, 0xfd, 0x25, 0x33, 0x26, 0x47, 0x20,
+		},
+		.digest = {
+			0x9a, 0x90, 0x83, 0x50, 0x5b, 0xc9, 0x22, 0x76,
+			0xae, 0xc4, 0xbe, 0x31, 0x26, 0x96, 0xef, 0x7b,
+			0xf3, 0xbf, 0x60, 0x3f, 0x4b, 0xbd, 0x38, 0x11,
+			0x96, 0xa0, 0x29, 0xf3, 0x40, 0x58, 0x53, 0x12,
+			0x31, 0x3b, 0xca, 0x4a, 0x9b, 0x5b, 0x89, 0x0e,
+			0xfe, 0xe4, 0x2c, 0x77, 0xb1, 0xee, 0x25, 0xfe,
+		},
+		.sig = {
+			0x94, 0xed, 0xbb, 0x92, 0xa5, 0xec, 0xb8, 0xaa,
+			0xd4, 0x73, 0x6e, 0x56, 0xc6, 0x91, 0x91, 0x6b,
+			0x3f, 0x88, 0x14, 0x06, 0x66, 0xce, 0x9f, 0xa7,
+			0x3d, 0x64, 0xc4, 0xea, 0x95, 0xad, 0x13, 0x3c,
+			0x81, 0xa6, 0x48, 0x15, 0x2e, 0x44, 0xac, 0xf9,
+			0x6e, 0x36, 0xdd, 0x1e, 0x80, 0xfa, 0xbe, 0x46,
+			0x99, 0xef, 0x4a, 0xeb, 0x15, 0xf1, 0x78, 0xce,
+			0xa1, 0xfe, 0x40, 0xdb, 0x26, 0x03, 0x13, 0x8f,
+			0x13, 0x0e, 0x74, 0x0a, 0x19, 0x62, 0x45, 0x26,
+			0x20, 0x3b, 0x63, 0x51, 0xd0, 0xa3, 0xa9, 0x4f,
+			0xa3, 0x29, 0xc1, 0x45, 0x78, 0x6e, 0x67, 0x9e,
+			0x7b, 0x82, 0xc7, 0x1a, 0x38, 0x62, 0x8a, 0xc8,
+		},
+	},
+};
+
+static TEE_Result set_public_key(struct ecc_public_key *pub, size_t size,
+				 const uint8_t *x, const uint8_t *y)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	res = crypto_bignum_bin2bn(x, size, pub->x);
+	if (res)
+		return res;
+
+	return crypto_bignum_bin2bn(y, size, pub->y);
+}
+
+/* Agrees on a secret between @key and the point (@x, @y) */
+static int check_shared_secret(struct ecc_keypair *key,
+			       struct ecc_public_key *pub, size_t size,
+			       const uint8_t *x, const uint8_t *y,
+			       const uint8_t *expect)
+{
+	uint8_t secret[NISTP_MAX_SIZE] = { };
+	unsigned long secret_len = sizeof(secret);
+	TEE_Result res = TEE_SUCCESS;
+
+	res = set_public_key(pub, size, x, y);
+	if (!res)
+		res = crypto_acipher_ecc_shared_secret(key, pub, secret,
+						       &secret_len);
+	if (res || secret_len != size || memcmp(secret, expect, size)) {
+		EMSG("Shared secret failed: %#"PRIx32, res);
+		return -1;
+	}
+
+	return 0;
+}
+
+static int check_ecdh(const struct ecc_nistp_vect *v)
+{
+	size_t size = v->key_size / 8;
+	struct ecc_public_key pub = { };
+	struct ecc_keypair key = { };
+	TEE_Result res = TEE_SUCCESS;
+	int ret = -1;
+
+	res = crypto_acipher_alloc_ecc_keypair(&key, TEE_TYPE_ECDH_KEYPAIR,
+					       v->key_size);
+	if (res)
+		return -1;
+	res = crypto_acipher_alloc_ecc_public_key(&pub,
+						  TEE_TYPE_ECDH_PUBLIC_KEY,
+						  v->key_size);
+	if (res)
+		goto out;
+	key.curve = v->curve;
+	pub.curve = v->curve;
+
+	if (crypto_bignum_bin2bn(v->d, size, key.d) ||
+	    crypto_bignum_bin2bn(v->qx, size, key.x) ||
+	    crypto_bignum_bin2bn(v->qy, size, key.y))
+		goto out;
+
+	/* d * G, the shared secret is the x coordinate of the public key */
+	if (check_shared_secret(&key, &pub, size, v->gx, v->gy, v->qx))
+		goto out;
+
+	if (check_shared_secret(&key, &pub, size, v->peer_x, v->peer_y,
+				v->z))
+		goto out;
+
+	ret = 0;
+out:
+	if (pub.ops)
+		crypto_acipher_free_ecc_public_key(&pub);
+	crypto_bignum_free(&key.d);
+	crypto_bignum_free(&key.x);
+	crypto_bignum_free(&key.y);
+	return ret;
+}
+
+static int check_ecdsa_verify(const struct ecc_nistp_vect *v)
+{
+	uint8_t sig[NISTP_MAX_SIZE * 2] = { };
+	size_t size = v->key_size / 8;
+	struct ecc_public_key pub = { };
+	TEE_Result res = TEE_SUCCESS;
+	int ret = -1;
+
+	res = crypto_acipher_alloc_ecc_public_key(&pub,
+						  TEE_TYPE_ECDSA_PUBLIC_KEY,
+						  v->key_size);
+	if (res)
+		return -1;
+	pub.curve = v->curve;
+
+	if (set_public_key(&pub, size, v->ux, v->uy))
+		goto out;
+
+	memcpy(sig, v->sig, size * 2);
+	res = crypto_acipher_ecc_verify(v->algo, &pub, v->digest, size, sig,
+					size * 2);
+	if (res) {
+		EMSG("ECDSA verify failed: %#"PRIx32, res);
+		goto out;
+	}
+
+	sig[size * 2 - 1] ^= 1;
+	res = crypto_acipher_ecc_verify(v->algo, &pub, v->digest, size, sig,
+					size * 2);
+	if (res != TEE_ERROR_SIGNATURE_INVALID) {
+		EMSG("ECDSA altered signature accepted: %#"PRIx32, res);
+		goto out;
+	}
+
+	ret = 0;
+out:
+	crypto_acipher_free_ecc_public_key(&pub);
+	return ret;
+}
+
+int self_test_ecc_nistp(void)
+{
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(ecc_nistp_vect); n++) {
+		if (check_ecdh(ecc_nistp_vect + n) ||
+		    check_ecdsa_verify(ecc_nistp_vect + n)) {
+			EMSG("P-%zu vector failed",
+			     ecc_nistp_vect[n].key_size);
+			return -1;
+		}
+	}
+
+	return 0;
+}
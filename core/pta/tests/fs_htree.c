@@ -25,6 +25,7 @@ struct test_aux {
 	size_t data_len;
 	size_t data_alloced;
 	uint8_t *block;
+	uint8_t *blocks;
 };
 
 static TEE_Result test_get_offs_size(enum tee_fs_htree_type type, size_t idx,
@@ -159,12 +160,68 @@ static TEE_Result test_write_final(struct tee_fs_rpc_operation *op)
 
 }
 
+static TEE_Result test_read_blocks_init(void *aux,
+					struct tee_fs_rpc_operation *op,
+					size_t idx, size_t num_blocks,
+					const uint8_t *vers, void **data)
+{
+	struct test_aux *a = aux;
+	uint64_t vers_mask = 0;
+	size_t n = 0;
+
+	if (num_blocks > TEE_FS_RPC_MAX_EXTENTS)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	for (n = 0; n < num_blocks; n++)
+		if (vers[n])
+			vers_mask |= BIT64(n);
+
+	memset(op, 0, sizeof(*op));
+	op->params[0].u.value.a = (vaddr_t)aux;
+	op->params[0].u.value.b = idx;
+	op->params[0].u.value.c = num_blocks;
+	op->params[1].u.value.a = vers_mask;
+	*data = a->blocks;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result test_read_blocks_final(struct tee_fs_rpc_operation *op,
+					 size_t *bytes)
+{
+	struct test_aux *a = uint_to_ptr(op->params[0].u.value.a);
+	size_t idx = op->params[0].u.value.b;
+	size_t num_blocks = op->params[0].u.value.c;
+	uint64_t vers_mask = op->params[1].u.value.a;
+	TEE_Result res = TEE_SUCCESS;
+	size_t offs = 0;
+	size_t sz = 0;
+	size_t n = 0;
+
+	*bytes = 0;
+	for (n = 0; n < num_blocks; n++) {
+		res = test_get_offs_size(TEE_FS_HTREE_TYPE_BLOCK, idx + n,
+					 !!(vers_mask & BIT64(n)), &offs, &sz);
+		if (res)
+			return res;
+		/* A short read ends the transfer */
+		if (offs + sz > a->data_len)
+			break;
+		memcpy(a->blocks + *bytes, a->data + offs, sz);
+		*bytes += sz;
+	}
+
+	return TEE_SUCCESS;
+}
+
 static const struct tee_fs_htree_storage test_htree_ops = {
 	.block_size = TEST_BLOCK_SIZE,
 	.rpc_read_init = test_read_init,
 	.rpc_read_final = test_read_final,
 	.rpc_write_init = test_write_init,
 	.rpc_write_final = test_write_final,
+	.rpc_read_blocks_init = test_read_blocks_init,
+	.rpc_read_blocks_final = test_read_blocks_final,
 };
 
 #define CHECK_RES(res, cleanup)						\
@@ -400,6 +457,7 @@ static void aux_free(struct test_aux *aux)
 	if (aux) {
 		free(aux->data);
 		free(aux->block);
+		free(aux->blocks);
 		free(aux);
 	}
 }
@@ -426,6 +484,10 @@ static struct test_aux *aux_alloc(size_t num_blocks)
 	if (!aux->block)
 		goto err;
 
+	aux->blocks = malloc(TEST_BLOCK_SIZE * TEE_FS_RPC_MAX_EXTENTS);
+	if (!aux->blocks)
+		goto err;
+
 	return aux;
 err:
 	aux_free(aux);
@@ -499,8 +561,10 @@ static TEE_Result test_corrupt_type(const TEE_UUID *uuid, uint8_t *hash,
 		/*
 		 * Errors in head or node is detected by
 		 * tee_fs_htree_open() errors in block is detected when
-		 * actually read by do_range(read_block)
+		 * actually read by do_range(read_block). The cache would
+		 * serve the blocks as they were before the corruption.
 		 */
+		tee_fs_htree_flush_cache();
 		res = tee_fs_htree_open(false, hash, 0, uuid, &test_htree_ops,
 					&aux2, &ht);
 		if (!res) {
@@ -611,6 +675,103 @@ out:
 	return res;
 }
 
+/* Flips a byte in both versions of data block @idx */
+static TEE_Result corrupt_block(struct test_aux *aux, size_t idx)
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t offs = 0;
+	size_t sz = 0;
+	size_t vers = 0;
+
+	for (vers = 0; vers < 2; vers++) {
+		res = test_get_offs_size(TEE_FS_HTREE_TYPE_BLOCK, idx, vers,
+					 &offs, &sz);
+		if (res)
+			return res;
+		aux->data[offs + sz / 2]++;
+	}
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Reads a file sequentially to check that the following blocks are read
+ * ahead and served from the cache, then that a block read ahead which
+ * can't be decrypted doesn't fail the read of the requested block.
+ */
+static TEE_Result test_block_cache(size_t num_blocks)
+{
+	struct ts_session *sess = ts_get_current_session();
+	const TEE_UUID *uuid = &sess->ctx->uuid;
+	uint8_t hash[TEE_FS_HTREE_HASH_SIZE] = { 0 };
+	struct tee_fs_htree_cache_stats stats = { };
+	TEE_Result res = TEE_SUCCESS;
+	struct tee_fs_htree *ht = NULL;
+	struct test_aux *aux = NULL;
+
+	assert(num_blocks > 3);
+
+	tee_fs_htree_get_cache_stats(&stats);
+	if (stats.max_blocks < 3) {
+		DMSG("Block cache too small, skipping test");
+		return TEE_SUCCESS;
+	}
+
+	aux = aux_alloc(num_blocks);
+	if (!aux)
+		return TEE_ERROR_OUT_OF_MEMORY;
+	aux->data_len = 0;
+	memset(aux->data, 0xce, aux->data_alloced);
+
+	res = tee_fs_htree_open(true, hash, 0, uuid, &test_htree_ops, aux, &ht);
+	CHECK_RES(res, goto out);
+	res = do_range(write_block, &ht, 0, num_blocks, 1);
+	CHECK_RES(res, goto out);
+	res = tee_fs_htree_sync_to_storage(&ht, hash, NULL);
+	CHECK_RES(res, goto out);
+	tee_fs_htree_close(&ht);
+
+	tee_fs_htree_flush_cache();
+	res = tee_fs_htree_open(false, hash, 0, uuid, &test_htree_ops, aux,
+				&ht);
+	CHECK_RES(res, goto out);
+	tee_fs_htree_get_cache_stats(&stats);
+	res = do_range(read_block, &ht, 0, num_blocks, 1);
+	CHECK_RES(res, goto out);
+	tee_fs_htree_get_cache_stats(&stats);
+	tee_fs_htree_close(&ht);
+	if (stats.hits + stats.misses != num_blocks || !stats.hits ||
+	    !stats.read_ahead) {
+		EMSG("error: %zu hits %zu misses %zu read ahead",
+		     stats.hits, stats.misses, stats.read_ahead);
+		res = TEE_ERROR_GENERIC;
+		goto out;
+	}
+
+	/* Block 2 is read ahead with block 0 but fails to decrypt */
+	res = corrupt_block(aux, 2);
+	CHECK_RES(res, goto out);
+	tee_fs_htree_flush_cache();
+	res = tee_fs_htree_open(false, hash, 0, uuid, &test_htree_ops, aux,
+				&ht);
+	CHECK_RES(res, goto out);
+	res = do_range(read_block, &ht, 0, 2, 1);
+	CHECK_RES(res, goto out);
+	res = read_block(&ht, 2, 1);
+	if (res == TEE_SUCCESS || res == TEE_ERROR_TIME_NOT_SET) {
+		EMSG("error: corrupt block read ahead");
+		res = TEE_ERROR_SECURITY;
+		goto out;
+	}
+	res = TEE_SUCCESS;
+
+out:
+	tee_fs_htree_close(&ht);
+	tee_fs_htree_flush_cache();
+	aux_free(aux);
+	return res;
+}
+
 TEE_Result core_fs_htree_tests(uint32_t nParamTypes,
 			       TEE_Param pParams[TEE_NUM_PARAMS] __unused)
 {
@@ -623,5 +784,9 @@ TEE_Result core_fs_htree_tests(uint32_t nParamTypes,
 	if (res)
 		return res;
 
+	res = test_block_cache(6);
+	if (res)
+		return res;
+
 	return test_corrupt(5);
 }
@@ -435,6 +435,10 @@ static TEE_Result invoke_command(void *pSessionContext __unused,
 		return core_dt_driver_tests(nParamTypes, pParams);
 	case PTA_INVOKE_TESTS_CMD_TRANSFER_LIST_TESTS:
 		return core_transfer_list_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_REE_FS_PERF:
+		return core_ree_fs_perf_tests(nParamTypes, pParams);
+	case PTA_INVOKE_TESTS_CMD_ASYM_PERF:
+		return core_asym_perf_tests(nParamTypes, pParams);
 	default:
 		break;
 	}
@@ -7,10 +7,15 @@
 #include <config.h>
 #include <kernel/asan.h>
 #include <kernel/dt_driver.h>
+#include <kernel/hash_set.h>
 #include <kernel/linker.h>
 #include <kernel/panic.h>
+#include <kernel/thread.h>
 #include <malloc.h>
+#include <memtag.h>
 #include <mm/core_memprot.h>
+#include <mm/tee_mm.h>
+#include <mm/vm.h>
 #include <setjmp.h>
 #include <stdbool.h>
 #include <trace.h>
@@ -311,6 +316,252 @@ static int self_test_division(void)
 	return ret;
 }
 
+#define HASH_SET_TEST_ELEMS	64
+#define HASH_SET_TEST_DUPS	4
+
+/* Returns the number of elements found with @key */
+static size_t hash_set_test_count(struct hash_set *set, uint64_t key)
+{
+	struct hash_set_elem *e = NULL;
+	size_t count = 0;
+
+	HASH_SET_FOREACH_KEY(e, set, key) {
+		if (e->key != key)
+			return SIZE_MAX;
+		count++;
+	}
+
+	return count;
+}
+
+/*
+ * Elements 0 to HASH_SET_TEST_DUPS - 1 have the key 0 and the other
+ * elements have their index as key. Returns true if they're all found.
+ */
+static bool hash_set_test_lookup(struct hash_set *set,
+				 struct hash_set_elem *elems, size_t begin)
+{
+	size_t n = 0;
+
+	if (begin < HASH_SET_TEST_DUPS &&
+	    hash_set_test_count(set, 0) != HASH_SET_TEST_DUPS - begin)
+		return false;
+
+	for (n = MAX(begin, (size_t)HASH_SET_TEST_DUPS);
+	     n < HASH_SET_TEST_ELEMS; n++)
+		if (hash_set_test_count(set, n) != 1 ||
+		    hash_set_first(set, n) != elems + n)
+			return false;
+
+	return !hash_set_first(set, HASH_SET_TEST_ELEMS);
+}
+
+static int self_test_hash_set(void)
+{
+	struct hash_set_elem *elems = NULL;
+	struct hash_set_elem *next = NULL;
+	struct hash_set_elem *e = NULL;
+	struct hash_set set = { };
+	uint64_t seen = 0;
+	size_t n = 0;
+	int ret = 0;
+	bool r = false;
+
+	LOG("hash set tests:");
+	elems = calloc(HASH_SET_TEST_ELEMS, sizeof(*elems));
+	if (!elems)
+		return -1;
+	hash_set_init(&set);
+
+	/* The set grows each time the load factor is reached */
+	LOG("- add %d elements, %d with the same key", HASH_SET_TEST_ELEMS,
+	    HASH_SET_TEST_DUPS);
+	for (n = 0; n < HASH_SET_TEST_ELEMS; n++)
+		hash_set_add(&set, elems + n, n < HASH_SET_TEST_DUPS ? 0 : n);
+	LOG("  %zu elements in %zu buckets", set.num_elems, set.num_buckets);
+	r = set.num_elems == HASH_SET_TEST_ELEMS &&
+	    set.num_buckets == HASH_SET_TEST_ELEMS / HASH_SET_MAX_LOAD &&
+	    hash_set_test_lookup(&set, elems, 0);
+	if (!r)
+		ret = -1;
+	LOG("  => test %s", r ? "ok" : "FAILED");
+	LOG("");
+
+	/* Each element is visited once, one bit per element */
+	LOG("- iterate over all elements");
+	static_assert(HASH_SET_TEST_ELEMS == 64);
+	HASH_SET_FOREACH(e, &set) {
+		if (e < elems || e >= elems + HASH_SET_TEST_ELEMS ||
+		    (seen & BIT64(e - elems)))
+			break;
+		seen |= BIT64(e - elems);
+	}
+	r = !e && seen == UINT64_MAX;
+	if (!r)
+		ret = -1;
+	LOG("  => test %s", r ? "ok" : "FAILED");
+	LOG("");
+
+	LOG("- remove the elements with key 0 while iterating");
+	n = 0;
+	e = hash_set_first(&set, 0);
+	while (e) {
+		next = hash_set_next(e);
+		hash_set_remove(&set, e);
+		e = next;
+		n++;
+	}
+	r = n == HASH_SET_TEST_DUPS &&
+	    set.num_elems == HASH_SET_TEST_ELEMS - HASH_SET_TEST_DUPS &&
+	    hash_set_test_lookup(&set, elems, HASH_SET_TEST_DUPS);
+	if (!r)
+		ret = -1;
+	LOG("  => test %s", r ? "ok" : "FAILED");
+	LOG("");
+
+	LOG("- remove the other elements");
+	for (n = HASH_SET_TEST_DUPS; n < HASH_SET_TEST_ELEMS; n++) {
+		hash_set_remove(&set, elems + n);
+		if (!hash_set_test_lookup(&set, elems, n + 1))
+			break;
+	}
+	r = n == HASH_SET_TEST_ELEMS && !set.num_elems;
+	if (!r)
+		ret = -1;
+	LOG("  => test %s", r ? "ok" : "FAILED");
+	LOG("");
+	hash_set_destroy(&set);
+
+	/*
+	 * Check the cap on the number of buckets from the number of
+	 * elements alone, rather than adding thousands of elements.
+	 */
+	LOG("- grow to at most %d buckets", HASH_SET_MAX_BUCKETS);
+	set.num_buckets = HASH_SET_MAX_BUCKETS / 2;
+	set.num_elems = set.num_buckets * HASH_SET_MAX_LOAD;
+	r = hash_set_grow_buckets(&set) == HASH_SET_MAX_BUCKETS;
+	set.num_buckets = HASH_SET_MAX_BUCKETS;
+	set.num_elems = set.num_buckets * HASH_SET_MAX_LOAD * 2;
+	r = r && !hash_set_grow_buckets(&set);
+	if (!r)
+		ret = -1;
+	LOG("  => test %s", r ? "ok" : "FAILED");
+	LOG("");
+
+	free(elems);
+	LOG("hash set test done");
+
+	return ret;
+}
+
+#ifdef CFG_CORE_MALLOC_CACHE
+/*
+ * Size of a magazine of the per-core caches and the number of buffers
+ * moved at a time between a magazine and the heap, as in bget_malloc.c
+ */
+#define MALLOC_TEST_MAG_SIZE	16
+#define MALLOC_TEST_BATCH	(MALLOC_TEST_MAG_SIZE / 2)
+#define MALLOC_TEST_BUFS	(MALLOC_TEST_MAG_SIZE * 2)
+
+static bool same_buf(void *p1, void *p2)
+{
+	return memtag_strip_tag(p1) == memtag_strip_tag(p2);
+}
+
+/*
+ * Tests the per-core caches of small buffers in front of the heap. Runs
+ * with foreign interrupts masked to stay on the same core.
+ */
+static int self_test_malloc_cache(void)
+{
+	void *got[MALLOC_TEST_MAG_SIZE] = { };
+	void *bufs[MALLOC_TEST_BUFS] = { };
+	uint32_t exceptions = 0;
+	void *expect = NULL;
+	void *p1 = NULL;
+	void *p2 = NULL;
+	bool r = false;
+	int ret = 0;
+	size_t n = 0;
+
+	LOG("malloc cache tests:");
+	if (IS_ENABLED2(ENABLE_MDBG)) {
+		LOG("  disabled with ENABLE_MDBG");
+		LOG("");
+		return 0;
+	}
+
+	exceptions = thread_mask_exceptions(THREAD_EXCP_FOREIGN_INTR);
+
+	/* An empty magazine is refilled from the heap, then flushed */
+	malloc_flush_caches();
+	p1 = malloc(32);
+	LOG("- p1 = malloc(32)");
+	r = p1 && malloc_flush_caches();
+	LOG("- flush the caches: %s", r ? "refilled" : "empty");
+	r = r && !malloc_flush_caches();
+	if (!r)
+		ret = -1;
+	LOG("  => test %s", r ? "ok" : "FAILED");
+	LOG("");
+
+	/* A freed small buffer is served again from the cache */
+	free(p1);
+	LOG("- free p1");
+	p2 = malloc(32);
+	LOG("- p2 = malloc(32)");
+	LOG("  p1=%p  p2=%p", p1, p2);
+	r = p1 && p2 && same_buf(p1, p2) &&
+	    malloc_buffer_is_within_alloced(p2, 32);
+	if (!r)
+		ret = -1;
+	LOG("  => test %s", r ? "ok" : "FAILED");
+	LOG("");
+	free(p2);
+
+	/*
+	 * Freeing into a full magazine drains MALLOC_TEST_BATCH buffers to
+	 * the heap. Once all buffers are freed the magazine holds the first
+	 * and last MALLOC_TEST_BATCH freed buffers, served last in first
+	 * out.
+	 */
+	LOG("- allocate and free %d buffers", MALLOC_TEST_BUFS);
+	malloc_flush_caches();
+	for (n = 0; n < MALLOC_TEST_BUFS; n++) {
+		bufs[n] = malloc(32);
+		if (!bufs[n])
+			break;
+	}
+	r = n == MALLOC_TEST_BUFS;
+	for (n = 0; n < MALLOC_TEST_BUFS; n++)
+		free(bufs[n]);
+	for (n = 0; n < MALLOC_TEST_MAG_SIZE; n++) {
+		if (n < MALLOC_TEST_BATCH)
+			expect = bufs[MALLOC_TEST_BUFS - 1 - n];
+		else
+			expect = bufs[MALLOC_TEST_MAG_SIZE - 1 - n];
+		got[n] = malloc(32);
+		r = r && got[n] && same_buf(got[n], expect);
+	}
+	for (n = 0; n < MALLOC_TEST_MAG_SIZE; n++)
+		free(got[n]);
+	if (!r)
+		ret = -1;
+	LOG("  => test %s", r ? "ok" : "FAILED");
+	LOG("");
+
+	malloc_flush_caches();
+	thread_unmask_exceptions(exceptions);
+
+	return ret;
+}
+#else
+static int self_test_malloc_cache(void)
+{
+	return 0;
+}
+#endif
+
 /* test malloc support. resulting trace shall be manually checked */
 static int self_test_malloc(void)
 {
@@ -421,6 +672,10 @@ static int self_test_malloc(void)
 	p3 = NULL;
 	p4 = NULL;
 
+	/* test the per-core caches */
+	if (self_test_malloc_cache())
+		ret = -1;
+
 	/* test free(NULL) */
 	LOG("- free NULL");
 	free(NULL);
@@ -556,6 +811,119 @@ static int self_test_nex_malloc(void)
 }
 #endif
 
+#define MM_TEST_SHIFT	SMALL_PAGE_SHIFT
+#define MM_TEST_PAGES	16
+
+static bool check_mm_offset(tee_mm_entry_t *mm, uint32_t offset)
+{
+	return mm && tee_mm_get_offset(mm) == offset;
+}
+
+#ifdef CFG_WITH_STATS
+static int check_mm_pool_stats(tee_mm_pool_t *pool)
+{
+	struct pta_stats_alloc stats = { };
+	uint64_t gap7 = 7 << MM_TEST_SHIFT;
+	uint64_t gap6 = 6 << MM_TEST_SHIFT;
+
+	tee_mm_get_pool_stats(pool, &stats, false);
+
+	if (stats.size != MM_TEST_PAGES << MM_TEST_SHIFT ||
+	    stats.allocated != 3 << MM_TEST_SHIFT ||
+	    stats.max_allocated != 10 << MM_TEST_SHIFT ||
+	    stats.free2_sum != gap7 * gap7 + gap6 * gap6 ||
+	    stats.num_alloc_fail != 1 ||
+	    stats.biggest_alloc_fail != 8 << MM_TEST_SHIFT ||
+	    stats.biggest_alloc_fail_used != 3 << MM_TEST_SHIFT)
+		return -1;
+
+	return 0;
+}
+#else
+static int check_mm_pool_stats(tee_mm_pool_t *pool __unused)
+{
+	return 0;
+}
+#endif
+
+/*
+ * Tests a TEE_MM_POOL_SEG_FIT pool. No memory is accessed so the pool
+ * covers a made up physical range.
+ */
+static int self_test_mm_seg_fit(void)
+{
+	tee_mm_pool_t pool = { };
+	tee_mm_entry_t *mm[4] = { };
+	tee_mm_entry_t *p = NULL;
+	int ret = -1;
+	size_t n = 0;
+
+	LOG("seg-fit tee_mm tests:");
+	if (!tee_mm_init(&pool, 0x10000000, MM_TEST_PAGES << MM_TEST_SHIFT,
+			 MM_TEST_SHIFT, TEE_MM_POOL_SEG_FIT))
+		return -1;
+
+	/* Pages 0-1, 2-4, 5-8 and 9, pages 10-15 remain free */
+	mm[0] = tee_mm_alloc(&pool, 2 << MM_TEST_SHIFT);
+	mm[1] = tee_mm_alloc(&pool, 3 << MM_TEST_SHIFT);
+	mm[2] = tee_mm_alloc(&pool, 4 << MM_TEST_SHIFT);
+	mm[3] = tee_mm_alloc(&pool, 1 << MM_TEST_SHIFT);
+	if (!check_mm_offset(mm[0], 0) || !check_mm_offset(mm[1], 2) ||
+	    !check_mm_offset(mm[2], 5) || !check_mm_offset(mm[3], 9))
+		goto out;
+
+	/* The freed gap of 3 pages fits exactly and is used first */
+	LOG("- free 2-4, alloc 3 pages");
+	tee_mm_free(mm[1]);
+	mm[1] = NULL;
+	p = tee_mm_alloc(&pool, 3 << MM_TEST_SHIFT);
+	if (!check_mm_offset(p, 2))
+		goto out;
+	tee_mm_free(p);
+
+	/* Freeing 5-8 coalesces with the free pages 2-4 */
+	LOG("- free 5-8, alloc 7 pages");
+	tee_mm_free(mm[2]);
+	mm[2] = NULL;
+	p = tee_mm_alloc(&pool, 7 << MM_TEST_SHIFT);
+	if (!check_mm_offset(p, 2))
+		goto out;
+	tee_mm_free(p);
+
+	/* No gap of 8 pages, the largest are 2-8 and 10-15 */
+	LOG("- alloc 8 pages");
+	p = tee_mm_alloc(&pool, 8 << MM_TEST_SHIFT);
+	if (p) {
+		tee_mm_free(p);
+		goto out;
+	}
+
+	if (check_mm_pool_stats(&pool))
+		goto out;
+
+	/* Freeing the rest leaves a single gap covering the whole pool */
+	LOG("- free 9 then 0-1, alloc all");
+	tee_mm_free(mm[3]);
+	mm[3] = NULL;
+	tee_mm_free(mm[0]);
+	mm[0] = NULL;
+	if (!tee_mm_is_empty(&pool))
+		goto out;
+	p = tee_mm_alloc(&pool, MM_TEST_PAGES << MM_TEST_SHIFT);
+	if (!check_mm_offset(p, 0))
+		goto out;
+	tee_mm_free(p);
+
+	ret = 0;
+out:
+	for (n = 0; n < ARRAY_SIZE(mm); n++)
+		tee_mm_free(mm[n]);
+	tee_mm_final(&pool);
+	LOG("seg-fit tee_mm test done");
+
+	return ret;
+}
+
 static int check_virt_to_phys(vaddr_t va, paddr_t exp_pa,
 			      enum teecore_memtypes m)
 {
@@ -660,6 +1028,16 @@ static int self_test_va2pa(void)
 	return ret;
 }
 
+static int self_test_vm_regions(void)
+{
+	TEE_Result res = vm_regions_self_test();
+
+	LOG("vm region index tests: %s", res ? "FAILED" : "ok");
+	LOG("");
+
+	return res ? -1 : 0;
+}
+
 #ifdef CFG_CORE_SANITIZE_KADDRESS
 
 #define ASAN_TEST_SUCCESS 1
@@ -875,9 +1253,11 @@ TEE_Result core_self_tests(uint32_t nParamTypes __unused,
 {
 	if (self_test_mul_signed_overflow() || self_test_add_overflow() ||
 	    self_test_sub_overflow() || self_test_mul_unsigned_overflow() ||
-	    self_test_division() || self_test_malloc() ||
-	    self_test_nex_malloc() || self_test_va2pa() ||
-	    self_test_asan()) {
+	    self_test_division() || self_test_hash_set() ||
+	    self_test_malloc() || self_test_nex_malloc() ||
+	    self_test_mm_seg_fit() || self_test_va2pa() ||
+	    self_test_vm_regions() || self_test_asan() ||
+	    self_test_ec25519() || self_test_ecc_nistp()) {
 		EMSG("some self_test_xxx failed! you should enable local LOG");
 		return TEE_ERROR_GENERIC;
 	}
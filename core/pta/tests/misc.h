@@ -16,6 +16,18 @@ TEE_Result core_self_tests(uint32_t nParamTypes,
 TEE_Result core_fs_htree_tests(uint32_t nParamTypes,
 			       TEE_Param pParams[TEE_NUM_PARAMS]);
 
+#ifdef CFG_REE_FS
+TEE_Result core_ree_fs_perf_tests(uint32_t param_types,
+				  TEE_Param params[TEE_NUM_PARAMS]);
+#else
+static inline TEE_Result
+core_ree_fs_perf_tests(uint32_t param_types __unused,
+		       TEE_Param params[TEE_NUM_PARAMS] __unused)
+{
+	return TEE_ERROR_NOT_SUPPORTED;
+}
+#endif
+
 TEE_Result core_mutex_tests(uint32_t nParamTypes,
 			    TEE_Param pParams[TEE_NUM_PARAMS]);
 
@@ -34,6 +46,27 @@ static inline TEE_Result core_lockdep_tests(
 TEE_Result core_aes_perf_tests(uint32_t param_types,
 			       TEE_Param params[TEE_NUM_PARAMS]);
 
+TEE_Result core_asym_perf_tests(uint32_t param_types,
+				TEE_Param params[TEE_NUM_PARAMS]);
+
+#ifdef _CFG_CORE_LTC_EC25519_FE51
+int self_test_ec25519(void);
+#else
+static inline int self_test_ec25519(void)
+{
+	return 0;
+}
+#endif
+
+#ifdef _CFG_CORE_LTC_ECC_NISTP
+int self_test_ecc_nistp(void);
+#else
+static inline int self_test_ecc_nistp(void)
+{
+	return 0;
+}
+#endif
+
 TEE_Result core_dt_driver_tests(uint32_t param_types,
 				TEE_Param params[TEE_NUM_PARAMS]);
 
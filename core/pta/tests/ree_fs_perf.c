@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: BSD-2-Clause
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+
+#include <kernel/tee_time.h>
+#include <pta_invoke_tests.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <tee_api_defines.h>
+#include <tee_api_types.h>
+#include <tee/tee_fs.h>
+#include <tee/tee_pobj.h>
+#include <trace.h>
+#include <types_ext.h>
+#include <utee_defines.h>
+
+#include "misc.h"
+
+/*
+ * Each invocation works on its own object so that concurrent invocations
+ * from several normal world threads measure how well accesses to
+ * independent files scale. The time spent reading is returned to ease
+ * comparisons.
+ */
+
+#define OBJ_ID_FMT	"ree_fs_perf.%08"PRIx32
+
+static TEE_Result read_object(struct tee_file_handle *fh, uint8_t *buf,
+			      size_t size, uint32_t count, TEE_Time *t)
+{
+	TEE_Result res = TEE_SUCCESS;
+	TEE_Time start = { };
+	uint32_t n = 0;
+	size_t l = 0;
+
+	tee_time_get_sys_time(&start);
+	for (n = 0; n < count; n++) {
+		l = size;
+		res = ree_fs_ops.read(fh, 0, buf, NULL, &l);
+		if (res)
+			return res;
+		if (l != size)
+			return TEE_ERROR_CORRUPT_OBJECT;
+	}
+	tee_time_get_sys_time(t);
+	TEE_TIME_SUB(*t, start, *t);
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result core_ree_fs_perf_tests(uint32_t param_types,
+				  TEE_Param params[TEE_NUM_PARAMS])
+{
+	const uint32_t exp_pt = TEE_PARAM_TYPES(TEE_PARAM_TYPE_VALUE_INPUT,
+						TEE_PARAM_TYPE_VALUE_INPUT,
+						TEE_PARAM_TYPE_VALUE_OUTPUT,
+						TEE_PARAM_TYPE_NONE);
+	const uint32_t flags = TEE_DATA_FLAG_ACCESS_READ |
+			       TEE_DATA_FLAG_ACCESS_WRITE |
+			       TEE_DATA_FLAG_ACCESS_WRITE_META;
+	TEE_UUID uuid = PTA_INVOKE_TESTS_UUID;
+	struct tee_file_handle *fh = NULL;
+	char obj_id[sizeof("ree_fs_perf.") + 8] = { };
+	TEE_Result res = TEE_SUCCESS;
+	struct tee_pobj *po = NULL;
+	TEE_Time t = { };
+	uint8_t *buf = NULL;
+	size_t size = 0;
+	size_t n = 0;
+
+	if (param_types != exp_pt)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	size = params[0].value.b;
+	if (!size)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	buf = malloc(size);
+	if (!buf)
+		return TEE_ERROR_OUT_OF_MEMORY;
+	for (n = 0; n < size; n++)
+		buf[n] = n;
+
+	snprintf(obj_id, sizeof(obj_id), OBJ_ID_FMT, params[0].value.a);
+	res = tee_pobj_get(&uuid, obj_id, strlen(obj_id), flags,
+			   TEE_POBJ_USAGE_CREATE, &ree_fs_ops, &po);
+	if (res)
+		goto out;
+
+	res = ree_fs_ops.create(po, true, NULL, 0, NULL, 0, buf, NULL, size,
+				&fh);
+	if (res)
+		goto out_release;
+	tee_pobj_create_final(po);
+
+	memset(buf, 0, size);
+	res = read_object(fh, buf, size, params[1].value.a, &t);
+	if (!res) {
+		for (n = 0; n < size; n++) {
+			if (buf[n] != (uint8_t)n) {
+				res = TEE_ERROR_CORRUPT_OBJECT;
+				break;
+			}
+		}
+	}
+	if (!res)
+		params[2].value.a = t.seconds * 1000 + t.millis;
+
+	ree_fs_ops.close(&fh);
+	if (ree_fs_ops.remove(po))
+		EMSG("Failed to remove \"%s\"", obj_id);
+out_release:
+	tee_pobj_release(po);
+out:
+	free(buf);
+	return res;
+}
@@ -1,9 +1,13 @@
 srcs-$(call cfg-all-enabled,CFG_REE_FS CFG_WITH_USER_TA) += fs_htree.c
+srcs-$(CFG_REE_FS) += ree_fs_perf.c
 srcs-y += invoke.c
 srcs-$(CFG_LOCKDEP) += lockdep.c
 srcs-y += misc.c
 cflags-misc.c-y += -fno-builtin
 srcs-y += mutex.c
 srcs-y += aes_perf.c
+srcs-y += asym_perf.c
+srcs-$(_CFG_CORE_LTC_EC25519_FE51) += ec25519.c
+srcs-$(_CFG_CORE_LTC_ECC_NISTP) += ecc_nistp.c
 srcs-$(CFG_DT_DRIVER_EMBEDDED_TEST) += dt_driver_test.c
 srcs-$(CFG_TRANSFER_LIST_TEST) += transfer_list.c
@@ -5,11 +5,33 @@
 
 #include <assert.h>
 #include <bitstring.h>
+#include <kernel/hash_set.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <tee/fs_dirfile.h>
 #include <types_ext.h>
+#include <util.h>
+
+/*
+ * In-memory index of the entries in the dirfile
+ *
+ * Each used entry is hashed on (uuid, oid) into @buckets, the entries
+ * of a bucket are chained by index with @dent_next. @dent_keys holds the
+ * full hash value of each entry so only entries with a matching hash
+ * need to be read from the dirfile. @used_dents has a bit set for each
+ * used entry, which allows finding a free entry without reading the
+ * dirfile. The index is built when the dirfile is opened and updated
+ * in write_dent().
+ */
+struct dirfile_index {
+	int *buckets;
+	size_t nbuckets;
+	uint32_t *dent_keys;
+	int *dent_next;
+	bitstr_t *used_dents;
+	size_t max_dents;
+};
 
 struct tee_fs_dirfile_dirh {
 	const struct tee_fs_dirfile_operations *fops;
@@ -17,6 +39,7 @@ struct tee_fs_dirfile_dirh {
 	int nbits;
 	bitstr_t *files;
 	size_t ndents;
+	struct dirfile_index index;
 };
 
 struct dirfile_entry {
@@ -29,6 +52,8 @@ struct dirfile_entry {
 
 #define OID_EMPTY_NAME 1
 
+#define DIRFILE_INDEX_MIN_BUCKETS 16U
+
 /*
  * An object can have an ID of size zero. This object is represented by
  * oidlen == 0 and oid[0] == OID_EMPTY_NAME. When both are zero, the entry is
@@ -41,6 +66,128 @@ static bool is_free(struct dirfile_entry *dent)
 	return !dent->oidlen && !dent->oid[0];
 }
 
+static uint32_t dent_key(const TEE_UUID *uuid, const void *oid,
+			 size_t oidlen)
+{
+	uint32_t h = HASH_FNV1A_INIT;
+
+	h = hash_fnv1a(h, uuid, sizeof(*uuid));
+	return hash_fnv1a(h, oid, oidlen);
+}
+
+static void index_link(struct dirfile_index *index, int idx)
+{
+	size_t b = index->dent_keys[idx] & (index->nbuckets - 1);
+
+	index->dent_next[idx] = index->buckets[b];
+	index->buckets[b] = idx;
+}
+
+static TEE_Result index_grow_buckets(struct dirfile_index *index)
+{
+	size_t nbuckets = MAX(index->nbuckets * 2, DIRFILE_INDEX_MIN_BUCKETS);
+	int *buckets = NULL;
+	size_t n = 0;
+	int i = 0;
+
+	buckets = malloc(nbuckets * sizeof(*buckets));
+	if (!buckets)
+		return TEE_ERROR_OUT_OF_MEMORY;
+	for (n = 0; n < nbuckets; n++)
+		buckets[n] = -1;
+
+	free(index->buckets);
+	index->buckets = buckets;
+	index->nbuckets = nbuckets;
+
+	for (i = 0; (size_t)i < index->max_dents; i++)
+		if (bit_test(index->used_dents, i))
+			index_link(index, i);
+
+	return TEE_SUCCESS;
+}
+
+/* Makes sure that the index can hold an entry at @idx */
+static TEE_Result index_reserve(struct dirfile_index *index, size_t idx)
+{
+	size_t max_dents = MAX(index->max_dents, DIRFILE_INDEX_MIN_BUCKETS);
+	void *p = NULL;
+
+	if (idx >= index->max_dents) {
+		while (max_dents <= idx)
+			max_dents *= 2;
+
+		p = realloc(index->dent_keys,
+			    max_dents * sizeof(*index->dent_keys));
+		if (!p)
+			return TEE_ERROR_OUT_OF_MEMORY;
+		index->dent_keys = p;
+
+		p = realloc(index->dent_next,
+			    max_dents * sizeof(*index->dent_next));
+		if (!p)
+			return TEE_ERROR_OUT_OF_MEMORY;
+		index->dent_next = p;
+
+		p = realloc(index->used_dents, bitstr_size(max_dents));
+		if (!p)
+			return TEE_ERROR_OUT_OF_MEMORY;
+		index->used_dents = p;
+		bit_nclear(index->used_dents, index->max_dents, max_dents - 1);
+		index->max_dents = max_dents;
+	}
+
+	/* Keep on average at most two entries per bucket */
+	if (index->max_dents > index->nbuckets * 2)
+		return index_grow_buckets(index);
+
+	return TEE_SUCCESS;
+}
+
+static void index_add(struct dirfile_index *index, int idx,
+		      const struct dirfile_entry *dent)
+{
+	assert((size_t)idx < index->max_dents);
+	assert(!bit_test(index->used_dents, idx));
+
+	index->dent_keys[idx] = dent_key(&dent->uuid, dent->oid, dent->oidlen);
+	bit_set(index->used_dents, idx);
+	index_link(index, idx);
+}
+
+static void index_remove(struct dirfile_index *index, int idx)
+{
+	int *pn = NULL;
+
+	if ((size_t)idx >= index->max_dents ||
+	    !bit_test(index->used_dents, idx))
+		return;
+
+	pn = index->buckets + (index->dent_keys[idx] & (index->nbuckets - 1));
+	while (*pn != idx) {
+		assert(*pn >= 0);
+		pn = index->dent_next + *pn;
+	}
+	*pn = index->dent_next[idx];
+	bit_clear(index->used_dents, idx);
+}
+
+static bool index_test(struct dirfile_index *index, int idx)
+{
+	if ((size_t)idx < index->max_dents)
+		return bit_test(index->used_dents, idx);
+
+	return false;
+}
+
+static void index_free(struct dirfile_index *index)
+{
+	free(index->buckets);
+	free(index->dent_keys);
+	free(index->dent_next);
+	free(index->used_dents);
+}
+
 /*
  * File layout
  *
@@ -113,12 +260,23 @@ static TEE_Result write_dent(struct tee_fs_dirfile_dirh *dirh, size_t n,
 {
 	TEE_Result res;
 
+	res = index_reserve(&dirh->index, n);
+	if (res)
+		return res;
+
 	res = dirh->fops->write(dirh->fh, sizeof(*dent) * n, dent,
 				sizeof(*dent));
-	if (!res && n >= dirh->ndents)
+	if (res)
+		return res;
+
+	if (n >= dirh->ndents)
 		dirh->ndents = n + 1;
 
-	return res;
+	index_remove(&dirh->index, n);
+	if (!is_free(dent))
+		index_add(&dirh->index, n, dent);
+
+	return TEE_SUCCESS;
 }
 
 TEE_Result tee_fs_dirfile_open(bool create, uint8_t *hash, uint32_t min_counter,
@@ -163,6 +321,11 @@ TEE_Result tee_fs_dirfile_open(bool create, uint8_t *hash, uint32_t min_counter,
 		res = set_file(dirh, dent.file_number);
 		if (res != TEE_SUCCESS)
 			goto out;
+
+		res = index_reserve(&dirh->index, n);
+		if (res != TEE_SUCCESS)
+			goto out;
+		index_add(&dirh->index, n, &dent);
 	}
 out:
 	if (!res) {
@@ -179,6 +342,7 @@ void tee_fs_dirfile_close(struct tee_fs_dirfile_dirh *dirh)
 	if (dirh) {
 		dirh->fops->close(dirh->fh);
 		free(dirh->files);
+		index_free(&dirh->index);
 		free(dirh);
 	}
 }
@@ -212,17 +376,25 @@ TEE_Result tee_fs_dirfile_find(struct tee_fs_dirfile_dirh *dirh,
 			       const TEE_UUID *uuid, const void *oid,
 			       size_t oidlen, struct tee_fs_dirfile_fileh *dfh)
 {
+	struct dirfile_index *index = &dirh->index;
 	TEE_Result res = TEE_SUCCESS;
 	struct dirfile_entry dent = { };
-	int n = 0;
+	uint32_t key = 0;
+	int n = -1;
+
+	key = dent_key(uuid, oid, oidlen);
+	if (index->nbuckets)
+		n = index->buckets[key & (index->nbuckets - 1)];
+
+	for (; n >= 0; n = index->dent_next[n]) {
+		if (index->dent_keys[n] != key)
+			continue;
 
-	for (n = 0;; n++) {
 		res = read_dent(dirh, n, &dent);
 		if (res)
 			return res;
 
-		if (is_free(&dent))
-			continue;
+		assert(!is_free(&dent));
 		if (dent.oidlen != oidlen)
 			continue;
 
@@ -233,6 +405,9 @@ TEE_Result tee_fs_dirfile_find(struct tee_fs_dirfile_dirh *dirh,
 			break;
 	}
 
+	if (n < 0)
+		return TEE_ERROR_ITEM_NOT_FOUND;
+
 	if (dfh) {
 		dfh->idx = n;
 		dfh->file_number = dent.file_number;
@@ -244,19 +419,14 @@ TEE_Result tee_fs_dirfile_find(struct tee_fs_dirfile_dirh *dirh,
 
 static TEE_Result find_empty_idx(struct tee_fs_dirfile_dirh *dh, int *idx)
 {
-	struct dirfile_entry dent = { };
-	TEE_Result res = TEE_SUCCESS;
-	int n = 0;
+	int n = -1;
 
-	for (n = 0;; n++) {
-		res = read_dent(dh, n, &dent);
-		if (res == TEE_ERROR_ITEM_NOT_FOUND)
-			break;
-		if (res)
-			return res;
-		if (is_free(&dent))
-			break;
-	}
+	if (dh->index.max_dents)
+		bit_ffc(dh->index.used_dents, (int)dh->index.max_dents, &n);
+
+	/* Entries at and beyond dh->ndents are free by definition */
+	if (n < 0 || (size_t)n > dh->ndents)
+		n = dh->ndents;
 
 	*idx = n;
 	return TEE_SUCCESS;
@@ -375,6 +545,8 @@ TEE_Result tee_fs_dirfile_get_next(struct tee_fs_dirfile_dirh *dirh,
 		i = 0;
 
 	for (;; i++) {
+		if ((size_t)i < dirh->ndents && !index_test(&dirh->index, i))
+			continue;
 		res = read_dent(dirh, i, &dent);
 		if (res)
 			return res;
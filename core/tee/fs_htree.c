@@ -4,13 +4,18 @@
  */
 
 #include <assert.h>
+#include <atomic.h>
 #include <config.h>
 #include <crypto/crypto.h>
 #include <initcall.h>
+#include <kernel/hash_set.h>
+#include <kernel/mutex.h>
 #include <kernel/tee_common_otp.h>
 #include <stdlib.h>
+#include <stdlib_ext.h>
 #include <string_ext.h>
 #include <string.h>
+#include <sys/queue.h>
 #include <tee/fs_htree.h>
 #include <tee/tee_fs_key_manager.h>
 #include <tee/tee_fs_rpc.h>
@@ -95,6 +100,7 @@ struct tee_fs_htree {
 	const TEE_UUID *uuid;
 	const struct tee_fs_htree_storage *stor;
 	void *stor_aux;
+	size_t next_block;
 };
 
 struct traverse_arg;
@@ -863,6 +869,318 @@ static TEE_Result get_block_node(struct tee_fs_htree *ht, bool create,
 	return res;
 }
 
+/*
+ * Cache of decrypted data blocks shared by all hash trees
+ *
+ * A cached block is identified by the key of the file together with the
+ * IV and tag of the block. A block is encrypted with a new random IV each
+ * time it's written, so an entry can only match the content it was
+ * decrypted from. The cache is because of that still valid when a file
+ * is closed and opened again. Entries are removed when a block is
+ * overwritten, to make room for other blocks, and all entries of a file
+ * when it's truncated. Renaming a file keeps its key so the entries stay
+ * valid, and the key of a removed file is never used again so its entries
+ * are simply evicted over time. Entries hold plain text and are wiped
+ * when freed.
+ *
+ * The entries are spread over shards by a hash of the tag of the block,
+ * each with its own mutex, hash set and list of the most recently used
+ * entries first. At most BLOCK_CACHE_SIZE blocks are cached in total, an
+ * insertion in a full cache evicts the least recently used entry of its
+ * own shard, or of the next non-empty shard.
+ */
+struct block_cache_entry {
+	struct hash_set_elem hash_elem;
+	TAILQ_ENTRY(block_cache_entry) link;
+	uint8_t fek[TEE_FS_HTREE_FEK_SIZE];
+	uint8_t iv[TEE_FS_HTREE_IV_SIZE];
+	uint8_t tag[TEE_FS_HTREE_TAG_SIZE];
+	size_t block_size;
+	uint8_t data[];
+};
+
+#define BLOCK_CACHE_SIZE	CFG_REE_FS_BLOCK_CACHE_SIZE
+#define BLOCK_CACHE_SHARDS	8
+
+/* The blocks read ahead are stored in the cache */
+#define READ_AHEAD_BLOCKS \
+	MIN_UNSAFE(BLOCK_CACHE_SIZE, TEE_FS_RPC_MAX_EXTENTS)
+
+struct block_cache_shard {
+	struct mutex mu;
+	struct hash_set set;
+	TAILQ_HEAD(block_cache_head, block_cache_entry) lru;
+	size_t hits;
+	size_t misses;
+	size_t read_ahead;
+};
+
+static struct block_cache_shard block_cache[BLOCK_CACHE_SHARDS];
+/* Number of cached blocks, including those about to be inserted */
+static unsigned int block_cache_count;
+
+static uint32_t block_cache_key(const struct tee_fs_htree_node_image *ni)
+{
+	return hash_fnv1a(HASH_FNV1A_INIT, ni->tag, sizeof(ni->tag));
+}
+
+static struct block_cache_shard *block_cache_shard(uint32_t key)
+{
+	return block_cache + key % BLOCK_CACHE_SHARDS;
+}
+
+/* Called with the mutex of @shard held */
+static struct block_cache_entry *
+block_cache_find(struct block_cache_shard *shard, struct tee_fs_htree *ht,
+		 const struct tee_fs_htree_node_image *ni, uint32_t key)
+{
+	struct hash_set_elem *elem = NULL;
+	struct block_cache_entry *e = NULL;
+
+	HASH_SET_FOREACH_KEY(elem, &shard->set, key) {
+		e = container_of(elem, struct block_cache_entry, hash_elem);
+		if (!memcmp(e->tag, ni->tag, sizeof(e->tag)) &&
+		    !memcmp(e->iv, ni->iv, sizeof(e->iv)) &&
+		    !memcmp(e->fek, ht->fek, sizeof(e->fek)) &&
+		    e->block_size == ht->stor->block_size)
+			return e;
+	}
+
+	return NULL;
+}
+
+/* Reserves room for one more block, returns false if the cache is full */
+static bool block_cache_reserve(void)
+{
+	unsigned int n = atomic_load_uint(&block_cache_count);
+
+	do {
+		if (n + 1 > BLOCK_CACHE_SIZE)
+			return false;
+	} while (!atomic_cas_uint(&block_cache_count, &n, n + 1));
+
+	return true;
+}
+
+static void block_cache_unreserve(void)
+{
+	unsigned int n = atomic_load_uint(&block_cache_count);
+
+	while (!atomic_cas_uint(&block_cache_count, &n, n - 1))
+		;
+}
+
+/* Called with the mutex of @shard held */
+static void block_cache_unlink(struct block_cache_shard *shard,
+			       struct block_cache_entry *e)
+{
+	TAILQ_REMOVE(&shard->lru, e, link);
+	hash_set_remove(&shard->set, &e->hash_elem);
+	block_cache_unreserve();
+}
+
+/*
+ * Evicts the least recently used entry of @shard, or of the next shard
+ * which isn't empty. Returns false if no entry was evicted.
+ */
+static bool block_cache_evict(struct block_cache_shard *shard)
+{
+	size_t idx = shard - block_cache;
+	struct block_cache_shard *s = NULL;
+	struct block_cache_entry *e = NULL;
+	size_t n = 0;
+
+	for (n = 0; n < BLOCK_CACHE_SHARDS && !e; n++) {
+		s = block_cache + (idx + n) % BLOCK_CACHE_SHARDS;
+		mutex_lock(&s->mu);
+		e = TAILQ_LAST(&s->lru, block_cache_head);
+		if (e)
+			block_cache_unlink(s, e);
+		mutex_unlock(&s->mu);
+	}
+
+	free_wipe(e);
+	return e;
+}
+
+static bool block_cache_get(struct tee_fs_htree *ht,
+			    const struct tee_fs_htree_node_image *ni,
+			    void *block)
+{
+	uint32_t key = block_cache_key(ni);
+	struct block_cache_shard *shard = block_cache_shard(key);
+	struct block_cache_entry *e = NULL;
+
+	if (!BLOCK_CACHE_SIZE)
+		return false;
+
+	mutex_lock(&shard->mu);
+	e = block_cache_find(shard, ht, ni, key);
+	if (e) {
+		memcpy(block, e->data, e->block_size);
+		TAILQ_REMOVE(&shard->lru, e, link);
+		TAILQ_INSERT_HEAD(&shard->lru, e, link);
+		shard->hits++;
+	} else {
+		shard->misses++;
+	}
+	mutex_unlock(&shard->mu);
+
+	return e;
+}
+
+static struct block_cache_entry *block_cache_alloc(struct tee_fs_htree *ht)
+{
+	return malloc(sizeof(struct block_cache_entry) +
+		      ht->stor->block_size);
+}
+
+/* Inserts @e which holds the decrypted block described by @ni */
+static void block_cache_insert(struct tee_fs_htree *ht,
+			       const struct tee_fs_htree_node_image *ni,
+			       struct block_cache_entry *e, bool read_ahead)
+{
+	uint32_t key = block_cache_key(ni);
+	struct block_cache_shard *shard = block_cache_shard(key);
+
+	memcpy(e->fek, ht->fek, sizeof(e->fek));
+	memcpy(e->iv, ni->iv, sizeof(e->iv));
+	memcpy(e->tag, ni->tag, sizeof(e->tag));
+	e->block_size = ht->stor->block_size;
+
+	/* Blocks being inserted concurrently may take the evicted room */
+	if (!block_cache_reserve() &&
+	    (!block_cache_evict(shard) || !block_cache_reserve())) {
+		free_wipe(e);
+		return;
+	}
+
+	mutex_lock(&shard->mu);
+	if (block_cache_find(shard, ht, ni, key)) {
+		/* Added by someone else in the meantime */
+		mutex_unlock(&shard->mu);
+		block_cache_unreserve();
+		free_wipe(e);
+		return;
+	}
+	hash_set_add(&shard->set, &e->hash_elem, key);
+	TAILQ_INSERT_HEAD(&shard->lru, e, link);
+	if (read_ahead)
+		shard->read_ahead++;
+	mutex_unlock(&shard->mu);
+}
+
+static void block_cache_add(struct tee_fs_htree *ht,
+			    const struct tee_fs_htree_node_image *ni,
+			    const void *block)
+{
+	struct block_cache_entry *e = NULL;
+
+	if (!BLOCK_CACHE_SIZE)
+		return;
+
+	e = block_cache_alloc(ht);
+	if (!e)
+		return;
+
+	memcpy(e->data, block, ht->stor->block_size);
+	block_cache_insert(ht, ni, e, false);
+}
+
+static void block_cache_remove(struct tee_fs_htree *ht,
+			       const struct tee_fs_htree_node_image *ni)
+{
+	uint32_t key = block_cache_key(ni);
+	struct block_cache_shard *shard = block_cache_shard(key);
+	struct block_cache_entry *e = NULL;
+
+	if (!BLOCK_CACHE_SIZE)
+		return;
+
+	mutex_lock(&shard->mu);
+	e = block_cache_find(shard, ht, ni, key);
+	if (e)
+		block_cache_unlink(shard, e);
+	mutex_unlock(&shard->mu);
+
+	free_wipe(e);
+}
+
+/* Removes the entries of the file with key @fek, or all if @fek is NULL */
+static void block_cache_purge(const uint8_t *fek)
+{
+	struct block_cache_head head = TAILQ_HEAD_INITIALIZER(head);
+	struct block_cache_shard *shard = NULL;
+	struct block_cache_entry *next = NULL;
+	struct block_cache_entry *e = NULL;
+
+	if (!BLOCK_CACHE_SIZE)
+		return;
+
+	for (shard = block_cache; shard < block_cache + BLOCK_CACHE_SHARDS;
+	     shard++) {
+		mutex_lock(&shard->mu);
+		for (e = TAILQ_FIRST(&shard->lru); e; e = next) {
+			next = TAILQ_NEXT(e, link);
+			if (!fek || !memcmp(e->fek, fek, sizeof(e->fek))) {
+				block_cache_unlink(shard, e);
+				TAILQ_INSERT_TAIL(&head, e, link);
+			}
+		}
+		mutex_unlock(&shard->mu);
+	}
+
+	while ((e = TAILQ_FIRST(&head))) {
+		TAILQ_REMOVE(&head, e, link);
+		free_wipe(e);
+	}
+}
+
+void tee_fs_htree_flush_cache(void)
+{
+	block_cache_purge(NULL);
+}
+
+void tee_fs_htree_get_cache_stats(struct tee_fs_htree_cache_stats *stats)
+{
+	struct block_cache_shard *shard = NULL;
+
+	*stats = (struct tee_fs_htree_cache_stats){
+		.max_blocks = BLOCK_CACHE_SIZE,
+	};
+
+	if (!BLOCK_CACHE_SIZE)
+		return;
+
+	for (shard = block_cache; shard < block_cache + BLOCK_CACHE_SHARDS;
+	     shard++) {
+		mutex_lock(&shard->mu);
+		stats->hits += shard->hits;
+		stats->misses += shard->misses;
+		stats->read_ahead += shard->read_ahead;
+		shard->hits = 0;
+		shard->misses = 0;
+		shard->read_ahead = 0;
+		mutex_unlock(&shard->mu);
+	}
+	stats->num_blocks = atomic_load_uint(&block_cache_count);
+}
+
+static TEE_Result block_cache_init(void)
+{
+	struct block_cache_shard *shard = NULL;
+
+	for (shard = block_cache; shard < block_cache + BLOCK_CACHE_SHARDS;
+	     shard++) {
+		mutex_init(&shard->mu);
+		hash_set_init(&shard->set);
+		TAILQ_INIT(&shard->lru);
+	}
+
+	return TEE_SUCCESS;
+}
+early_init(block_cache_init);
+
 TEE_Result tee_fs_htree_write_block(struct tee_fs_htree **ht_arg,
 				    size_t block_num, const void *block)
 {
@@ -881,6 +1199,8 @@ TEE_Result tee_fs_htree_write_block(struct tee_fs_htree **ht_arg,
 	if (res != TEE_SUCCESS)
 		goto out;
 
+	block_cache_remove(ht, &node->node);
+
 	if (!node->block_updated)
 		node->node.flags ^= HTREE_NODE_COMMITTED_BLOCK;
 
@@ -913,47 +1233,380 @@ out:
 	return res;
 }
 
-TEE_Result tee_fs_htree_read_block(struct tee_fs_htree **ht_arg,
-				   size_t block_num, void *block)
+static TEE_Result read_one_block(struct tee_fs_htree *ht, size_t block_num,
+				 struct htree_node *node, void *block)
 {
-	struct tee_fs_htree *ht = *ht_arg;
 	TEE_Result res;
 	struct tee_fs_rpc_operation op;
-	struct htree_node *node;
 	uint8_t block_vers;
 	size_t len;
 	void *ctx;
 	void *enc_block;
 
-	if (!ht)
-		return TEE_ERROR_CORRUPT_OBJECT;
-
-	res = get_block_node(ht, false, block_num, &node);
-	if (res != TEE_SUCCESS)
-		goto out;
-
 	block_vers = !!(node->node.flags & HTREE_NODE_COMMITTED_BLOCK);
 	res = ht->stor->rpc_read_init(ht->stor_aux, &op,
 				      TEE_FS_HTREE_TYPE_BLOCK, block_num,
 				      block_vers, &enc_block);
 	if (res != TEE_SUCCESS)
-		goto out;
+		return res;
 
 	res = ht->stor->rpc_read_final(&op, &len);
 	if (res != TEE_SUCCESS)
-		goto out;
-	if (len != ht->stor->block_size) {
-		res = TEE_ERROR_CORRUPT_OBJECT;
-		goto out;
+		return res;
+	if (len != ht->stor->block_size)
+		return TEE_ERROR_CORRUPT_OBJECT;
+
+	res = authenc_init(&ctx, TEE_MODE_DECRYPT, ht, &node->node,
+			   ht->stor->block_size);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	return authenc_decrypt_final(ctx, node->node.tag, enc_block,
+				     ht->stor->block_size, block);
+}
+
+/*
+ * Reads @num_blocks encrypted blocks starting at @block_num with a single
+ * RPC, the nodes of the blocks are returned in @nodes and the blocks, back
+ * to back in shared memory, in @enc_blocks.
+ */
+static TEE_Result read_blocks_enc(struct tee_fs_htree *ht, size_t block_num,
+				  size_t num_blocks, struct htree_node **nodes,
+				  uint8_t **enc_blocks)
+{
+	uint8_t vers[TEE_FS_RPC_MAX_EXTENTS] = { };
+	struct tee_fs_rpc_operation op = { };
+	TEE_Result res = TEE_SUCCESS;
+	void *enc = NULL;
+	size_t len = 0;
+	size_t n = 0;
+
+	assert(num_blocks <= TEE_FS_RPC_MAX_EXTENTS);
+
+	for (n = 0; n < num_blocks; n++) {
+		res = get_block_node(ht, false, block_num + n, nodes + n);
+		if (res != TEE_SUCCESS)
+			return res;
+		vers[n] = !!(nodes[n]->node.flags & HTREE_NODE_COMMITTED_BLOCK);
 	}
 
+	res = ht->stor->rpc_read_blocks_init(ht->stor_aux, &op, block_num,
+					     num_blocks, vers, &enc);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	res = ht->stor->rpc_read_blocks_final(&op, &len);
+	if (res != TEE_SUCCESS)
+		return res;
+	if (len != num_blocks * ht->stor->block_size)
+		return TEE_ERROR_CORRUPT_OBJECT;
+
+	*enc_blocks = enc;
+	return TEE_SUCCESS;
+}
+
+static TEE_Result decrypt_block(struct tee_fs_htree *ht,
+				struct htree_node *node,
+				const uint8_t *enc_block, void *block)
+{
+	TEE_Result res = TEE_SUCCESS;
+	void *ctx = NULL;
+
 	res = authenc_init(&ctx, TEE_MODE_DECRYPT, ht, &node->node,
 			   ht->stor->block_size);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	return authenc_decrypt_final(ctx, node->node.tag, enc_block,
+				     ht->stor->block_size, block);
+}
+
+/*
+ * Reads and decrypts @num_blocks blocks starting at @block_num with a
+ * single RPC, the nodes of the blocks are returned in @nodes.
+ */
+static TEE_Result read_blocks(struct tee_fs_htree *ht, size_t block_num,
+			      size_t num_blocks, struct htree_node **nodes,
+			      uint8_t **blocks)
+{
+	const size_t bs = ht->stor->block_size;
+	TEE_Result res = TEE_SUCCESS;
+	uint8_t *enc_blocks = NULL;
+	size_t n = 0;
+
+	res = read_blocks_enc(ht, block_num, num_blocks, nodes, &enc_blocks);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	for (n = 0; n < num_blocks; n++) {
+		res = decrypt_block(ht, nodes[n], enc_blocks + n * bs,
+				    blocks[n]);
+		if (res != TEE_SUCCESS)
+			return res;
+	}
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Reads @block_num into @block and the blocks following it into the
+ * cache, with a single RPC. Blocks read ahead which can't be decrypted
+ * are dropped, they're only reported if requested later on.
+ */
+static TEE_Result read_ahead(struct tee_fs_htree *ht, size_t block_num,
+			     void *block)
+{
+	struct block_cache_entry *entries[TEE_FS_RPC_MAX_EXTENTS] = { };
+	struct htree_node *nodes[TEE_FS_RPC_MAX_EXTENTS] = { };
+	size_t num_blocks = ht->imeta.max_node_id - block_num;
+	const size_t bs = ht->stor->block_size;
+	TEE_Result res = TEE_SUCCESS;
+	uint8_t *enc_blocks = NULL;
+	size_t n = 0;
+
+	num_blocks = MIN(num_blocks, (size_t)READ_AHEAD_BLOCKS);
+	for (n = 1; n < num_blocks; n++) {
+		entries[n] = block_cache_alloc(ht);
+		if (!entries[n])
+			break;
+	}
+	num_blocks = n;
+	if (num_blocks < 2) {
+		res = TEE_ERROR_OUT_OF_MEMORY;
+		goto out;
+	}
+
+	res = read_blocks_enc(ht, block_num, num_blocks, nodes, &enc_blocks);
+	if (res != TEE_SUCCESS)
+		goto out;
+
+	res = decrypt_block(ht, nodes[0], enc_blocks, block);
+	if (res != TEE_SUCCESS)
+		goto out;
+	block_cache_add(ht, &nodes[0]->node, block);
+
+	for (n = 1; n < num_blocks; n++) {
+		if (decrypt_block(ht, nodes[n], enc_blocks + n * bs,
+				  entries[n]->data))
+			break;
+		block_cache_insert(ht, &nodes[n]->node, entries[n], true);
+		entries[n] = NULL;
+	}
+out:
+	for (n = 0; n < ARRAY_SIZE(entries); n++)
+		free_wipe(entries[n]);
+	return res;
+}
+
+/* Reads a block which wasn't found in the cache */
+static TEE_Result read_block_uncached(struct tee_fs_htree *ht,
+				      size_t block_num,
+				      struct htree_node *node, void *block)
+{
+	TEE_Result res = TEE_SUCCESS;
+
+	/*
+	 * When the file is read sequentially the following blocks are
+	 * likely to be requested next. If reading ahead fails for any
+	 * reason the requested block is read alone, so that only its own
+	 * errors are reported.
+	 */
+	if (block_num == ht->next_block && READ_AHEAD_BLOCKS > 1 &&
+	    ht->stor->rpc_read_blocks_init &&
+	    BLOCK_NUM_TO_NODE_ID(block_num) < ht->imeta.max_node_id) {
+		res = read_ahead(ht, block_num, block);
+		if (res == TEE_SUCCESS)
+			return res;
+	}
+
+	res = read_one_block(ht, block_num, node, block);
+	if (res == TEE_SUCCESS)
+		block_cache_add(ht, &node->node, block);
+
+	return res;
+}
+
+TEE_Result tee_fs_htree_read_block(struct tee_fs_htree **ht_arg,
+				   size_t block_num, void *block)
+{
+	struct tee_fs_htree *ht = *ht_arg;
+	TEE_Result res;
+	struct htree_node *node;
+
+	if (!ht)
+		return TEE_ERROR_CORRUPT_OBJECT;
+
+	res = get_block_node(ht, false, block_num, &node);
 	if (res != TEE_SUCCESS)
 		goto out;
 
-	res = authenc_decrypt_final(ctx, node->node.tag, enc_block,
-				    ht->stor->block_size, block);
+	if (!block_cache_get(ht, &node->node, block))
+		res = read_block_uncached(ht, block_num, node, block);
+	if (res == TEE_SUCCESS)
+		ht->next_block = block_num + 1;
+out:
+	if (res != TEE_SUCCESS)
+		tee_fs_htree_close(ht_arg);
+	return res;
+}
+
+static TEE_Result write_blocks(struct tee_fs_htree *ht, size_t block_num,
+			       size_t num_blocks, const uint8_t *blocks)
+{
+	struct htree_node *nodes[TEE_FS_RPC_MAX_EXTENTS] = { };
+	uint8_t vers[TEE_FS_RPC_MAX_EXTENTS] = { };
+	const size_t bs = ht->stor->block_size;
+	struct tee_fs_rpc_operation op = { };
+	TEE_Result res = TEE_SUCCESS;
+	uint8_t *enc_blocks = NULL;
+	void *enc = NULL;
+	void *ctx = NULL;
+	size_t n = 0;
+
+	assert(num_blocks <= TEE_FS_RPC_MAX_EXTENTS);
+
+	for (n = 0; n < num_blocks; n++) {
+		res = get_block_node(ht, true, block_num + n, nodes + n);
+		if (res != TEE_SUCCESS)
+			return res;
+
+		block_cache_remove(ht, &nodes[n]->node);
+
+		if (!nodes[n]->block_updated)
+			nodes[n]->node.flags ^= HTREE_NODE_COMMITTED_BLOCK;
+		vers[n] = !!(nodes[n]->node.flags & HTREE_NODE_COMMITTED_BLOCK);
+	}
+
+	res = ht->stor->rpc_write_blocks_init(ht->stor_aux, &op, block_num,
+					      num_blocks, vers, &enc);
+	if (res != TEE_SUCCESS)
+		return res;
+	enc_blocks = enc;
+
+	for (n = 0; n < num_blocks; n++) {
+		res = authenc_init(&ctx, TEE_MODE_ENCRYPT, ht, &nodes[n]->node,
+				   bs);
+		if (res != TEE_SUCCESS)
+			return res;
+		res = authenc_encrypt_final(ctx, nodes[n]->node.tag,
+					    blocks + n * bs, bs,
+					    enc_blocks + n * bs);
+		if (res != TEE_SUCCESS)
+			return res;
+	}
+
+	res = ht->stor->rpc_write_blocks_final(&op);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	for (n = 0; n < num_blocks; n++) {
+		nodes[n]->block_updated = true;
+		nodes[n]->dirty = true;
+	}
+	ht->dirty = true;
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result tee_fs_htree_write_blocks(struct tee_fs_htree **ht_arg,
+				     size_t block_num, size_t num_blocks,
+				     const void *blocks)
+{
+	struct tee_fs_htree *ht = *ht_arg;
+	TEE_Result res = TEE_SUCCESS;
+	const uint8_t *b = blocks;
+	size_t n = 0;
+
+	if (!ht)
+		return TEE_ERROR_CORRUPT_OBJECT;
+
+	while (num_blocks) {
+		n = MIN(num_blocks, (size_t)TEE_FS_RPC_MAX_EXTENTS);
+		if (n == 1 || !ht->stor->rpc_write_blocks_init) {
+			n = 1;
+			res = tee_fs_htree_write_block(ht_arg, block_num, b);
+			if (res != TEE_SUCCESS)
+				return res;
+		} else {
+			res = write_blocks(ht, block_num, n, b);
+			if (res != TEE_SUCCESS) {
+				tee_fs_htree_close(ht_arg);
+				return res;
+			}
+		}
+		block_num += n;
+		num_blocks -= n;
+		b += n * ht->stor->block_size;
+	}
+
+	return TEE_SUCCESS;
+}
+
+/*
+ * Reads a run of blocks of which the first wasn't found in the cache. The
+ * blocks are added to the cache if @cache is true.
+ */
+static TEE_Result read_run(struct tee_fs_htree *ht, size_t block_num,
+			   size_t num_blocks, uint8_t *b, bool cache)
+{
+	struct htree_node *nodes[TEE_FS_RPC_MAX_EXTENTS] = { };
+	uint8_t *blocks[TEE_FS_RPC_MAX_EXTENTS] = { };
+	TEE_Result res = TEE_SUCCESS;
+	size_t n = 0;
+
+	for (n = 0; n < num_blocks; n++)
+		blocks[n] = b + n * ht->stor->block_size;
+
+	res = read_blocks(ht, block_num, num_blocks, nodes, blocks);
+	if (res != TEE_SUCCESS || !cache)
+		return res;
+
+	for (n = 0; n < num_blocks; n++)
+		block_cache_add(ht, &nodes[n]->node, blocks[n]);
+
+	return TEE_SUCCESS;
+}
+
+TEE_Result tee_fs_htree_read_blocks(struct tee_fs_htree **ht_arg,
+				    size_t block_num, size_t num_blocks,
+				    void *blocks)
+{
+	struct tee_fs_htree *ht = *ht_arg;
+	TEE_Result res = TEE_SUCCESS;
+	struct htree_node *node = NULL;
+	uint8_t *b = blocks;
+	bool cache = false;
+	size_t n = 0;
+
+	if (!ht)
+		return TEE_ERROR_CORRUPT_OBJECT;
+
+	/* Large reads would only push everything else out of the cache */
+	cache = num_blocks <= BLOCK_CACHE_SIZE;
+
+	while (num_blocks) {
+		n = MIN(num_blocks, (size_t)TEE_FS_RPC_MAX_EXTENTS);
+
+		res = get_block_node(ht, false, block_num, &node);
+		if (res != TEE_SUCCESS)
+			goto out;
+
+		if (block_cache_get(ht, &node->node, b)) {
+			n = 1;
+		} else if (n == 1 || !ht->stor->rpc_read_blocks_init) {
+			n = 1;
+			res = read_block_uncached(ht, block_num, node, b);
+		} else {
+			res = read_run(ht, block_num, n, b, cache);
+		}
+		if (res != TEE_SUCCESS)
+			goto out;
+
+		block_num += n;
+		num_blocks -= n;
+		b += n * ht->stor->block_size;
+		ht->next_block = block_num;
+	}
 out:
 	if (res != TEE_SUCCESS)
 		tee_fs_htree_close(ht_arg);
@@ -969,6 +1622,8 @@ TEE_Result tee_fs_htree_truncate(struct tee_fs_htree **ht_arg, size_t block_num)
 	if (!ht)
 		return TEE_ERROR_CORRUPT_OBJECT;
 
+	block_cache_purge(ht->fek);
+
 	while (node_id < ht->imeta.max_node_id) {
 		node = find_closest_node(ht, ht->imeta.max_node_id);
 		assert(node && node->id == ht->imeta.max_node_id);
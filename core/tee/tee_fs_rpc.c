@@ -4,11 +4,13 @@
  */
 
 #include <assert.h>
+#include <atomic.h>
 #include <kernel/tee_misc.h>
 #include <kernel/thread.h>
 #include <mm/core_memprot.h>
 #include <optee_rpc_cmd.h>
 #include <stdlib.h>
+#include <string.h>
 #include <tee/fs_dirfile.h>
 #include <tee/tee_fs.h>
 #include <tee/tee_fs_rpc.h>
@@ -177,6 +179,202 @@ TEE_Result tee_fs_rpc_write_final(struct tee_fs_rpc_operation *op)
 	return operation_commit(op);
 }
 
+/*
+ * Whether tee-supplicant supports vectored requests, probed with the first
+ * one. Without support the ranges are transferred one by one instead.
+ */
+enum vec_support {
+	VEC_SUPPORT_UNKNOWN,
+	VEC_SUPPORTED,
+	VEC_UNSUPPORTED,
+};
+
+static int vec_support = VEC_SUPPORT_UNKNOWN;
+
+static TEE_Result operation_vec_init(struct tee_fs_rpc_operation *op,
+				     uint32_t id, bool read, int fd,
+				     const struct tee_fs_rpc_extent *ext,
+				     size_t num_ext, void **data)
+{
+	size_t ext_size = num_ext * sizeof(*ext);
+	struct mobj *mobj = NULL;
+	size_t data_len = 0;
+	size_t alloc_len = 0;
+	uint8_t *va = NULL;
+	size_t n = 0;
+
+	if (!num_ext || num_ext > TEE_FS_RPC_MAX_EXTENTS)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	for (n = 0; n < num_ext; n++) {
+		if (ext[n].offs > INT64_MAX ||
+		    ADD_OVERFLOW(data_len, ext[n].len, &data_len))
+			return TEE_ERROR_BAD_PARAMETERS;
+	}
+	if (ADD_OVERFLOW(ext_size, data_len, &alloc_len))
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	va = thread_rpc_shm_cache_alloc(THREAD_SHM_CACHE_USER_FS,
+					THREAD_SHM_TYPE_APPLICATION,
+					alloc_len, &mobj);
+	if (!va)
+		return TEE_ERROR_OUT_OF_MEMORY;
+
+	memcpy(va, ext, ext_size);
+
+	*op = (struct tee_fs_rpc_operation){
+		.id = id, .num_params = 3, .num_ext = num_ext,
+	};
+	if (read) {
+		op->params[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_FS_READV, fd,
+						   num_ext);
+		op->params[2] = THREAD_PARAM_MEMREF(OUT, mobj, ext_size,
+						    data_len);
+	} else {
+		op->params[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_FS_WRITEV, fd,
+						   num_ext);
+		op->params[2] = THREAD_PARAM_MEMREF(IN, mobj, ext_size,
+						    data_len);
+	}
+	op->params[1] = THREAD_PARAM_MEMREF(IN, mobj, 0, ext_size);
+	/* Keep a private copy, the one in shared memory can't be trusted */
+	memcpy(op->ext, ext, ext_size);
+
+	*data = va + ext_size;
+
+	return TEE_SUCCESS;
+}
+
+static TEE_Result operation_vec_fallback(struct tee_fs_rpc_operation *op,
+					 struct mobj *mobj, size_t offs,
+					 size_t *data_len)
+{
+	bool read = op->params[0].u.value.a == OPTEE_RPC_FS_READV;
+	int fd = op->params[0].u.value.b;
+	struct tee_fs_rpc_operation op1 = { };
+	TEE_Result res = TEE_SUCCESS;
+	size_t len = 0;
+	size_t n = 0;
+
+	*data_len = 0;
+	for (n = 0; n < op->num_ext; n++) {
+		len = op->ext[n].len;
+		op1 = (struct tee_fs_rpc_operation){
+			.id = op->id, .num_params = 2,
+		};
+		if (read) {
+			op1.params[0] = THREAD_PARAM_VALUE(IN,
+							   OPTEE_RPC_FS_READ,
+							   fd, op->ext[n].offs);
+			op1.params[1] = THREAD_PARAM_MEMREF(OUT, mobj, offs,
+							    len);
+		} else {
+			op1.params[0] = THREAD_PARAM_VALUE(IN,
+							   OPTEE_RPC_FS_WRITE,
+							   fd, op->ext[n].offs);
+			op1.params[1] = THREAD_PARAM_MEMREF(IN, mobj, offs,
+							    len);
+		}
+
+		res = operation_commit(&op1);
+		if (res != TEE_SUCCESS)
+			return res;
+
+		if (read) {
+			*data_len += op1.params[1].u.memref.size;
+			/* A short read ends the transfer */
+			if (op1.params[1].u.memref.size != len)
+				break;
+		} else {
+			*data_len += len;
+		}
+		offs += len;
+	}
+
+	return TEE_SUCCESS;
+}
+
+/* Sends a vectored read of no ranges, which only supporting versions accept */
+static int probe_vec_support(struct tee_fs_rpc_operation *op)
+{
+	struct mobj *mobj = op->params[2].u.memref.mobj;
+	struct tee_fs_rpc_operation probe = {
+		.id = op->id, .num_params = 3, .params = {
+			[0] = THREAD_PARAM_VALUE(IN, OPTEE_RPC_FS_READV,
+						 op->params[0].u.value.b, 0),
+			[1] = THREAD_PARAM_MEMREF(IN, mobj, 0, 0),
+			[2] = THREAD_PARAM_MEMREF(OUT, mobj, 0, 0),
+		},
+	};
+	TEE_Result res = operation_commit(&probe);
+
+	/*
+	 * Older versions of tee-supplicant answer unknown requests with
+	 * TEE_ERROR_BAD_PARAMETERS. Other errors don't tell, probe again
+	 * with the next request.
+	 */
+	if (res == TEE_SUCCESS)
+		return VEC_SUPPORTED;
+	if (res == TEE_ERROR_NOT_SUPPORTED || res == TEE_ERROR_BAD_PARAMETERS) {
+		DMSG("Vectored requests not supported, using fallback");
+		return VEC_UNSUPPORTED;
+	}
+	return VEC_SUPPORT_UNKNOWN;
+}
+
+static TEE_Result operation_vec_commit(struct tee_fs_rpc_operation *op,
+				       size_t *data_len)
+{
+	struct mobj *mobj = op->params[2].u.memref.mobj;
+	size_t offs = op->params[2].u.memref.offs;
+	TEE_Result res = TEE_SUCCESS;
+	int support = atomic_load_int(&vec_support);
+
+	if (support == VEC_SUPPORT_UNKNOWN) {
+		support = probe_vec_support(op);
+		if (support != VEC_SUPPORT_UNKNOWN)
+			atomic_store_int(&vec_support, support);
+	}
+
+	if (support == VEC_SUPPORTED) {
+		res = operation_commit(op);
+		if (res == TEE_SUCCESS)
+			*data_len = op->params[2].u.memref.size;
+		return res;
+	}
+
+	return operation_vec_fallback(op, mobj, offs, data_len);
+}
+
+TEE_Result tee_fs_rpc_readv_init(struct tee_fs_rpc_operation *op,
+				 uint32_t id, int fd,
+				 const struct tee_fs_rpc_extent *ext,
+				 size_t num_ext, void **out_data)
+{
+	return operation_vec_init(op, id, true, fd, ext, num_ext, out_data);
+}
+
+TEE_Result tee_fs_rpc_readv_final(struct tee_fs_rpc_operation *op,
+				  size_t *data_len)
+{
+	return operation_vec_commit(op, data_len);
+}
+
+TEE_Result tee_fs_rpc_writev_init(struct tee_fs_rpc_operation *op,
+				  uint32_t id, int fd,
+				  const struct tee_fs_rpc_extent *ext,
+				  size_t num_ext, void **data)
+{
+	return operation_vec_init(op, id, false, fd, ext, num_ext, data);
+}
+
+TEE_Result tee_fs_rpc_writev_final(struct tee_fs_rpc_operation *op)
+{
+	size_t data_len = 0;
+
+	return operation_vec_commit(op, &data_len);
+}
+
 TEE_Result tee_fs_rpc_truncate(uint32_t id, int fd, size_t len)
 {
 	struct tee_fs_rpc_operation op = {
@@ -11,29 +11,31 @@
 #include <tee/tee_pobj.h>
 #include <tee/tee_svc_cryp.h>
 #include <trace.h>
+#include <util.h>
 
 void tee_obj_add(struct user_ta_ctx *utc, struct tee_obj *o)
 {
 	TAILQ_INSERT_TAIL(&utc->objects, o, link);
+	hash_set_add(&utc->object_set, &o->handle_elem, (vaddr_t)o);
 }
 
 TEE_Result tee_obj_get(struct user_ta_ctx *utc, vaddr_t obj_id,
 		       struct tee_obj **obj)
 {
-	struct tee_obj *o;
+	struct hash_set_elem *e = NULL;
 
-	TAILQ_FOREACH(o, &utc->objects, link) {
-		if (obj_id == (vaddr_t)o) {
-			*obj = o;
-			return TEE_SUCCESS;
-		}
-	}
-	return TEE_ERROR_BAD_STATE;
+	e = hash_set_first(&utc->object_set, obj_id);
+	if (!e)
+		return TEE_ERROR_BAD_STATE;
+
+	*obj = container_of(e, struct tee_obj, handle_elem);
+	return TEE_SUCCESS;
 }
 
 void tee_obj_close(struct user_ta_ctx *utc, struct tee_obj *o)
 {
 	TAILQ_REMOVE(&utc->objects, o, link);
+	hash_set_remove(&utc->object_set, &o->handle_elem);
 
 	if ((o->info.handleFlags & TEE_HANDLE_FLAG_PERSISTENT)) {
 		o->pobj->fops->close(&o->fh);
@@ -3,16 +3,29 @@
  * Copyright (c) 2014, STMicroelectronics International N.V.
  */
 
+#include <kernel/hash_set.h>
 #include <kernel/mutex.h>
 #include <stdlib.h>
 #include <string.h>
 #include <tee/tee_pobj.h>
+#include <util.h>
 
-static TAILQ_HEAD(tee_pobjs, tee_pobj) tee_pobjs =
-		TAILQ_HEAD_INITIALIZER(tee_pobjs);
+/* Open persistent objects indexed by the hash of (uuid, obj_id, fops) */
+static struct hash_set pobjs = HASH_SET_INITIALIZER(pobjs);
 static struct mutex pobjs_mutex = MUTEX_INITIALIZER;
 static struct mutex pobjs_usage_mutex = MUTEX_INITIALIZER;
 
+static uint32_t pobj_hash(const TEE_UUID *uuid, const void *obj_id,
+			  uint32_t obj_id_len,
+			  const struct tee_file_operations *fops)
+{
+	uint32_t h = HASH_FNV1A_INIT;
+
+	h = hash_fnv1a(h, uuid, sizeof(*uuid));
+	h = hash_fnv1a(h, obj_id, obj_id_len);
+	return hash_fnv1a(h, &fops, sizeof(fops));
+}
+
 static bool pobj_need_usage_lock(struct tee_pobj *obj)
 {
 	/* Only lock if we don't have exclusive access to the object */
@@ -82,18 +95,21 @@ TEE_Result tee_pobj_get(TEE_UUID *uuid, void *obj_id, uint32_t obj_id_len,
 			struct tee_pobj **obj)
 {
 	TEE_Result res = TEE_SUCCESS;
+	uint32_t hash = pobj_hash(uuid, obj_id, obj_id_len, fops);
+	struct hash_set_elem *e = NULL;
 	struct tee_pobj *o = NULL;
 
 	*obj = NULL;
 
 	mutex_lock(&pobjs_mutex);
-	/* Check if file is open */
-	TAILQ_FOREACH(o, &tee_pobjs, link) {
-		if ((obj_id_len == o->obj_id_len) &&
-		    (memcmp(obj_id, o->obj_id, obj_id_len) == 0) &&
-		    (memcmp(uuid, &o->uuid, sizeof(TEE_UUID)) == 0) &&
-		    (fops == o->fops)) {
+	/* Check if file is open, there's at most one match */
+	HASH_SET_FOREACH_KEY(e, &pobjs, hash) {
+		o = container_of(e, struct tee_pobj, link);
+		if (obj_id_len == o->obj_id_len && fops == o->fops &&
+		    !memcmp(obj_id, o->obj_id, obj_id_len) &&
+		    !memcmp(uuid, &o->uuid, sizeof(TEE_UUID))) {
 			*obj = o;
+			break;
 		}
 	}
 
@@ -139,7 +155,7 @@ TEE_Result tee_pobj_get(TEE_UUID *uuid, void *obj_id, uint32_t obj_id_len,
 	memcpy(o->obj_id, obj_id, obj_id_len);
 	o->obj_id_len = obj_id_len;
 
-	TAILQ_INSERT_TAIL(&tee_pobjs, o, link);
+	hash_set_add(&pobjs, &o->link, hash);
 	*obj = o;
 
 	res = TEE_SUCCESS;
@@ -166,7 +182,7 @@ TEE_Result tee_pobj_release(struct tee_pobj *obj)
 	mutex_lock(&pobjs_mutex);
 	obj->refcnt--;
 	if (obj->refcnt == 0) {
-		TAILQ_REMOVE(&tee_pobjs, obj, link);
+		hash_set_remove(&pobjs, &obj->link);
 		free(obj->obj_id);
 		free(obj);
 	}
@@ -198,9 +214,12 @@ TEE_Result tee_pobj_rename(struct tee_pobj *obj, void *obj_id,
 	memcpy(new_obj_id, obj_id, obj_id_len);
 
 	/* update internal data */
+	hash_set_remove(&pobjs, &obj->link);
 	free(obj->obj_id);
 	obj->obj_id = new_obj_id;
 	obj->obj_id_len = obj_id_len;
+	hash_set_add(&pobjs, &obj->link,
+		     pobj_hash(&obj->uuid, obj_id, obj_id_len, obj->fops));
 	new_obj_id = NULL;
 
 exit:
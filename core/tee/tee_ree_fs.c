@@ -5,12 +5,12 @@
 
 #include <assert.h>
 #include <config.h>
+#include <kernel/hash_set.h>
 #include <kernel/mutex.h>
 #include <kernel/nv_counter.h>
 #include <kernel/panic.h>
 #include <kernel/thread.h>
 #include <kernel/user_access.h>
-#include <mempool.h>
 #include <mm/core_memprot.h>
 #include <mm/tee_pager.h>
 #include <optee_rpc_cmd.h>
@@ -30,11 +30,41 @@
 
 #define BLOCK_SIZE	(1 << BLOCK_SHIFT)
 
+/*
+ * struct file_lock - lock shared by all handles of a file
+ * @file_number:	number of the file in the dirfile
+ * @refcount:		number of handles using the lock
+ * @mu:			serializes data accesses to the file
+ * @link:		link in file_locks, keyed by @file_number
+ *
+ * Reads of the data of a file only need @mu, so accesses to independent
+ * files can proceed in parallel, including the RPCs to tee-supplicant.
+ * Writes keep @mu held until the new hash of the file is committed to the
+ * dirfile, so the dirfile and the file always agree even with several
+ * handles writing to the same file. Updates of the dirfile need
+ * ree_fs_mutex too, which is always taken after @mu.
+ */
+struct file_lock {
+	uint32_t file_number;
+	unsigned int refcount;
+	struct mutex mu;
+	struct hash_set_elem link;
+};
+
+/*
+ * struct tee_fs_fd - file handle
+ * @ht:		hash tree of the file
+ * @fd:		file descriptor in tee-supplicant
+ * @dfh:	dirfile handle of the file
+ * @uuid:	UUID of the TA owning the file
+ * @lock:	lock of the file, NULL for the dirfile
+ */
 struct tee_fs_fd {
 	struct tee_fs_htree *ht;
 	int fd;
 	struct tee_fs_dirfile_fileh dfh;
 	const TEE_UUID *uuid;
+	struct file_lock *lock;
 };
 
 struct tee_fs_dir {
@@ -51,27 +81,108 @@ static int pos_to_block_num(int position)
 
 static struct mutex ree_fs_mutex = MUTEX_INITIALIZER;
 
-static void *get_tmp_block(void)
+static struct hash_set file_locks = HASH_SET_INITIALIZER(file_locks);
+static struct mutex file_locks_mu = MUTEX_INITIALIZER;
+
+static struct file_lock *file_lock_get(uint32_t file_number)
 {
-	return mempool_alloc(mempool_default, BLOCK_SIZE);
+	struct hash_set_elem *e = NULL;
+	struct file_lock *fl = NULL;
+
+	mutex_lock(&file_locks_mu);
+	/* File numbers are unique, there's at most one match */
+	e = hash_set_first(&file_locks, file_number);
+	if (e) {
+		fl = container_of(e, struct file_lock, link);
+	} else {
+		fl = calloc(1, sizeof(*fl));
+		if (!fl)
+			goto out;
+		fl->file_number = file_number;
+		mutex_init(&fl->mu);
+		hash_set_add(&file_locks, &fl->link, file_number);
+	}
+	fl->refcount++;
+out:
+	mutex_unlock(&file_locks_mu);
+
+	return fl;
 }
 
-static void put_tmp_block(void *tmp_block)
+static void file_lock_put(struct file_lock *fl)
 {
-	mempool_free(mempool_default, tmp_block);
+	if (!fl)
+		return;
+
+	mutex_lock(&file_locks_mu);
+	fl->refcount--;
+	if (!fl->refcount) {
+		hash_set_remove(&file_locks, &fl->link);
+		mutex_destroy(&fl->mu);
+		free(fl);
+	}
+	mutex_unlock(&file_locks_mu);
+}
+
+/*
+ * The temporary blocks are taken from the heap rather than from
+ * mempool_default since a slot of the mempool is reserved by a thread as
+ * long as any buffer is allocated from it, which would compete with Big
+ * Number computations.
+ *
+ * Up to BATCH_BLOCKS blocks are transferred with each RPC, if that much
+ * memory isn't available a single block is used instead.
+ */
+#define BATCH_BLOCKS	TEE_FS_RPC_MAX_EXTENTS
+
+static void *get_tmp_blocks(size_t *num_blocks)
+{
+	void *p = NULL;
+
+	*num_blocks = MIN(*num_blocks, (size_t)BATCH_BLOCKS);
+	if (*num_blocks > 1) {
+		p = malloc(*num_blocks * BLOCK_SIZE);
+		if (p)
+			return p;
+		*num_blocks = 1;
+	}
+
+	return malloc(BLOCK_SIZE);
+}
+
+static void put_tmp_blocks(void *tmp_blocks)
+{
+	free(tmp_blocks);
+}
+
+/*
+ * Gets the current content of a data block which is about to be partially
+ * updated, blocks beyond the end of the file are zero filled.
+ */
+static TEE_Result get_block_for_update(struct tee_fs_fd *fdp,
+				       size_t block_num, uint8_t *block)
+{
+	struct tee_fs_htree_meta *meta = tee_fs_htree_get_meta(fdp->ht);
+
+	if (block_num * BLOCK_SIZE < ROUNDUP(meta->length, BLOCK_SIZE))
+		return tee_fs_htree_read_block(&fdp->ht, block_num, block);
+
+	memset(block, 0, BLOCK_SIZE);
+	return TEE_SUCCESS;
 }
 
 static TEE_Result out_of_place_write(struct tee_fs_fd *fdp, size_t pos,
 				     const void *buf_core,
 				     const void *buf_user, size_t len)
 {
-	TEE_Result res;
+	TEE_Result res = TEE_SUCCESS;
 	size_t start_block_num = pos_to_block_num(pos);
 	size_t end_block_num = pos_to_block_num(pos + len - 1);
 	size_t remain_bytes = len;
 	uint8_t *data_core_ptr = (uint8_t *)buf_core;
 	uint8_t *data_user_ptr = (uint8_t *)buf_user;
-	uint8_t *block;
+	uint8_t *block = NULL;
+	size_t batch = 0;
 	struct tee_fs_htree_meta *meta = tee_fs_htree_get_meta(fdp->ht);
 
 	/*
@@ -82,25 +193,37 @@ static TEE_Result out_of_place_write(struct tee_fs_fd *fdp, size_t pos,
 	if (!len)
 		return TEE_ERROR_BAD_PARAMETERS;
 
-	block = get_tmp_block();
+	batch = end_block_num - start_block_num + 1;
+	block = get_tmp_blocks(&batch);
 	if (!block)
 		return TEE_ERROR_OUT_OF_MEMORY;
 
 	while (start_block_num <= end_block_num) {
+		size_t num_blocks = MIN(end_block_num - start_block_num + 1,
+					batch);
 		size_t offset = pos % BLOCK_SIZE;
-		size_t size_to_write = MIN(remain_bytes, (size_t)BLOCK_SIZE);
-
-		if (size_to_write + offset > BLOCK_SIZE)
-			size_to_write = BLOCK_SIZE - offset;
+		size_t size_to_write = MIN(remain_bytes,
+					   num_blocks * BLOCK_SIZE - offset);
+		size_t last_block_num = start_block_num + num_blocks - 1;
+		uint8_t *last_block = block + (num_blocks - 1) * BLOCK_SIZE;
 
-		if (start_block_num * BLOCK_SIZE <
-		    ROUNDUP(meta->length, BLOCK_SIZE)) {
-			res = tee_fs_htree_read_block(&fdp->ht,
-						      start_block_num, block);
+		/*
+		 * Only the first and the last block can be partially
+		 * updated, the blocks in between are overwritten entirely
+		 * and don't need to be read.
+		 */
+		if (offset) {
+			res = get_block_for_update(fdp, start_block_num,
+						   block);
+			if (res != TEE_SUCCESS)
+				goto exit;
+		}
+		if ((offset + size_to_write) % BLOCK_SIZE &&
+		    (num_blocks > 1 || !offset)) {
+			res = get_block_for_update(fdp, last_block_num,
+						   last_block);
 			if (res != TEE_SUCCESS)
 				goto exit;
-		} else {
-			memset(block, 0, BLOCK_SIZE);
 		}
 
 		if (data_core_ptr) {
@@ -109,13 +232,13 @@ static TEE_Result out_of_place_write(struct tee_fs_fd *fdp, size_t pos,
 			res = copy_from_user(block + offset, data_user_ptr,
 					     size_to_write);
 			if (res)
-				return res;
+				goto exit;
 		} else {
 			memset(block + offset, 0, size_to_write);
 		}
 
-		res = tee_fs_htree_write_block(&fdp->ht, start_block_num,
-					       block);
+		res = tee_fs_htree_write_blocks(&fdp->ht, start_block_num,
+						num_blocks, block);
 		if (res != TEE_SUCCESS)
 			goto exit;
 
@@ -124,7 +247,7 @@ static TEE_Result out_of_place_write(struct tee_fs_fd *fdp, size_t pos,
 		if (data_user_ptr)
 			data_user_ptr += size_to_write;
 		remain_bytes -= size_to_write;
-		start_block_num++;
+		start_block_num += num_blocks;
 		pos += size_to_write;
 	}
 
@@ -134,8 +257,7 @@ static TEE_Result out_of_place_write(struct tee_fs_fd *fdp, size_t pos,
 	}
 
 exit:
-	if (block)
-		put_tmp_block(block);
+	put_tmp_blocks(block);
 	return res;
 }
 
@@ -258,12 +380,90 @@ static TEE_Result ree_fs_rpc_write_init(void *aux,
 				     offs, size, data);
 }
 
+/*
+ * Translates data blocks @idx to @idx + @num_blocks - 1 into ranges of the
+ * file, blocks which happen to be stored next to each other are merged
+ * into one range.
+ */
+static TEE_Result get_blocks_extents(size_t idx, size_t num_blocks,
+				     const uint8_t *vers,
+				     struct tee_fs_rpc_extent *ext,
+				     size_t *num_ext)
+{
+	TEE_Result res = TEE_SUCCESS;
+	size_t offs = 0;
+	size_t size = 0;
+	size_t n = 0;
+	size_t e = 0;
+
+	if (!num_blocks || num_blocks > TEE_FS_RPC_MAX_EXTENTS)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	for (n = 0; n < num_blocks; n++) {
+		res = get_offs_size(TEE_FS_HTREE_TYPE_BLOCK, idx + n, vers[n],
+				    &offs, &size);
+		if (res != TEE_SUCCESS)
+			return res;
+
+		if (e && ext[e - 1].offs + ext[e - 1].len == offs) {
+			ext[e - 1].len += size;
+		} else {
+			ext[e].offs = offs;
+			ext[e].len = size;
+			e++;
+		}
+	}
+
+	*num_ext = e;
+	return TEE_SUCCESS;
+}
+
+static TEE_Result ree_fs_rpc_read_blocks_init(void *aux,
+					      struct tee_fs_rpc_operation *op,
+					      size_t idx, size_t num_blocks,
+					      const uint8_t *vers, void **data)
+{
+	struct tee_fs_rpc_extent ext[TEE_FS_RPC_MAX_EXTENTS] = { };
+	struct tee_fs_fd *fdp = aux;
+	TEE_Result res = TEE_SUCCESS;
+	size_t num_ext = 0;
+
+	res = get_blocks_extents(idx, num_blocks, vers, ext, &num_ext);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	return tee_fs_rpc_readv_init(op, OPTEE_RPC_CMD_FS, fdp->fd, ext,
+				     num_ext, data);
+}
+
+static TEE_Result ree_fs_rpc_write_blocks_init(void *aux,
+					       struct tee_fs_rpc_operation *op,
+					       size_t idx, size_t num_blocks,
+					       const uint8_t *vers, void **data)
+{
+	struct tee_fs_rpc_extent ext[TEE_FS_RPC_MAX_EXTENTS] = { };
+	struct tee_fs_fd *fdp = aux;
+	TEE_Result res = TEE_SUCCESS;
+	size_t num_ext = 0;
+
+	res = get_blocks_extents(idx, num_blocks, vers, ext, &num_ext);
+	if (res != TEE_SUCCESS)
+		return res;
+
+	return tee_fs_rpc_writev_init(op, OPTEE_RPC_CMD_FS, fdp->fd, ext,
+				      num_ext, data);
+}
+
 static const struct tee_fs_htree_storage ree_fs_storage_ops = {
 	.block_size = BLOCK_SIZE,
 	.rpc_read_init = ree_fs_rpc_read_init,
 	.rpc_read_final = tee_fs_rpc_read_final,
 	.rpc_write_init = ree_fs_rpc_write_init,
 	.rpc_write_final = tee_fs_rpc_write_final,
+	.rpc_read_blocks_init = ree_fs_rpc_read_blocks_init,
+	.rpc_read_blocks_final = tee_fs_rpc_readv_final,
+	.rpc_write_blocks_init = ree_fs_rpc_write_blocks_init,
+	.rpc_write_blocks_final = tee_fs_rpc_writev_final,
 };
 
 static TEE_Result ree_fs_ftruncate_internal(struct tee_fs_fd *fdp,
@@ -311,9 +511,10 @@ static TEE_Result ree_fs_read_primitive(struct tee_file_handle *fh, size_t pos,
 					size_t *len)
 {
 	TEE_Result res;
-	int start_block_num;
-	int end_block_num;
+	size_t start_block_num;
+	size_t end_block_num;
 	size_t remain_bytes;
+	size_t batch = 0;
 	uint8_t *data_core_ptr = buf_core;
 	uint8_t *data_user_ptr = buf_user;
 	uint8_t *block = NULL;
@@ -339,20 +540,22 @@ static TEE_Result ree_fs_read_primitive(struct tee_file_handle *fh, size_t pos,
 	start_block_num = pos_to_block_num(pos);
 	end_block_num = pos_to_block_num(pos + remain_bytes - 1);
 
-	block = get_tmp_block();
+	batch = end_block_num - start_block_num + 1;
+	block = get_tmp_blocks(&batch);
 	if (!block) {
 		res = TEE_ERROR_OUT_OF_MEMORY;
 		goto exit;
 	}
 
 	while (start_block_num <= end_block_num) {
+		size_t num_blocks = MIN(end_block_num - start_block_num + 1,
+					batch);
 		size_t offset = pos % BLOCK_SIZE;
-		size_t size_to_read = MIN(remain_bytes, (size_t)BLOCK_SIZE);
-
-		if (size_to_read + offset > BLOCK_SIZE)
-			size_to_read = BLOCK_SIZE - offset;
+		size_t size_to_read = MIN(remain_bytes,
+					  num_blocks * BLOCK_SIZE - offset);
 
-		res = tee_fs_htree_read_block(&fdp->ht, start_block_num, block);
+		res = tee_fs_htree_read_blocks(&fdp->ht, start_block_num,
+					       num_blocks, block);
 		if (res != TEE_SUCCESS)
 			goto exit;
 
@@ -370,23 +573,23 @@ static TEE_Result ree_fs_read_primitive(struct tee_file_handle *fh, size_t pos,
 		remain_bytes -= size_to_read;
 		pos += size_to_read;
 
-		start_block_num++;
+		start_block_num += num_blocks;
 	}
 	res = TEE_SUCCESS;
 exit:
-	if (block)
-		put_tmp_block(block);
+	put_tmp_blocks(block);
 	return res;
 }
 
 static TEE_Result ree_fs_read(struct tee_file_handle *fh, size_t pos,
 			      void *buf_core, void *buf_user, size_t *len)
 {
+	struct tee_fs_fd *fdp = (struct tee_fs_fd *)fh;
 	TEE_Result res;
 
-	mutex_lock(&ree_fs_mutex);
+	mutex_lock(&fdp->lock->mu);
 	res = ree_fs_read_primitive(fh, pos, buf_core, buf_user, len);
-	mutex_unlock(&ree_fs_mutex);
+	mutex_unlock(&fdp->lock->mu);
 
 	return res;
 }
@@ -433,6 +636,13 @@ static TEE_Result ree_fs_open_primitive(bool create, uint8_t *hash,
 		return TEE_ERROR_OUT_OF_MEMORY;
 	fdp->fd = -1;
 	fdp->uuid = uuid;
+	if (dfh) {
+		fdp->lock = file_lock_get(dfh->file_number);
+		if (!fdp->lock) {
+			free(fdp);
+			return TEE_ERROR_OUT_OF_MEMORY;
+		}
+	}
 
 	if (create)
 		res = tee_fs_rpc_create_dfh(OPTEE_RPC_CMD_FS,
@@ -459,6 +669,7 @@ out:
 			tee_fs_rpc_close(OPTEE_RPC_CMD_FS, fdp->fd);
 		if (create)
 			tee_fs_rpc_remove_dfh(OPTEE_RPC_CMD_FS, dfh);
+		file_lock_put(fdp->lock);
 		free(fdp);
 	}
 
@@ -472,6 +683,7 @@ static void ree_fs_close_primitive(struct tee_file_handle *fh)
 	if (fdp) {
 		tee_fs_htree_close(&fdp->ht);
 		tee_fs_rpc_close(OPTEE_RPC_CMD_FS, fdp->fd);
+		file_lock_put(fdp->lock);
 		free(fdp);
 	}
 }
@@ -785,10 +997,11 @@ static void ree_fs_close(struct tee_file_handle **fh)
 	if (*fh) {
 		mutex_lock(&ree_fs_mutex);
 		put_dirh_primitive(false);
-		ree_fs_close_primitive(*fh);
-		*fh = NULL;
 		mutex_unlock(&ree_fs_mutex);
 
+		/* Only the dirfile is shared, the file is closed unlocked */
+		ree_fs_close_primitive(*fh);
+		*fh = NULL;
 	}
 }
 
@@ -863,22 +1076,45 @@ out:
 	return res;
 }
 
+/*
+ * Records the new hash of a file which has been synced to storage in the
+ * dirfile. The file data is written before the dirfile is updated, until
+ * the dirfile is committed the previous version of the file is still the
+ * one referenced.
+ */
+static TEE_Result update_dirh_hash(struct tee_fs_fd *fdp)
+{
+	struct tee_fs_dirfile_dirh *dirh = NULL;
+	TEE_Result res = TEE_SUCCESS;
+
+	mutex_lock(&ree_fs_mutex);
+
+	res = get_dirh(&dirh);
+	if (res)
+		goto out;
+
+	res = tee_fs_dirfile_update_hash(dirh, &fdp->dfh);
+	if (res)
+		goto out;
+	res = commit_dirh_writes(dirh);
+out:
+	put_dirh(dirh, res);
+	mutex_unlock(&ree_fs_mutex);
+
+	return res;
+}
+
 static TEE_Result ree_fs_write(struct tee_file_handle *fh, size_t pos,
 			       const void *buf_core, const void *buf_user,
 			       size_t len)
 {
 	TEE_Result res;
-	struct tee_fs_dirfile_dirh *dirh = NULL;
 	struct tee_fs_fd *fdp = (struct tee_fs_fd *)fh;
 
 	/* One of buf_core and buf_user must be NULL */
 	assert(!buf_core || !buf_user);
 
-	mutex_lock(&ree_fs_mutex);
-
-	res = get_dirh(&dirh);
-	if (res)
-		goto out;
+	mutex_lock(&fdp->lock->mu);
 
 	res = ree_fs_write_primitive(fh, pos, buf_core, buf_user, len);
 	if (res)
@@ -888,13 +1124,9 @@ static TEE_Result ree_fs_write(struct tee_file_handle *fh, size_t pos,
 	if (res)
 		goto out;
 
-	res = tee_fs_dirfile_update_hash(dirh, &fdp->dfh);
-	if (res)
-		goto out;
-	res = commit_dirh_writes(dirh);
+	res = update_dirh_hash(fdp);
 out:
-	put_dirh(dirh, res);
-	mutex_unlock(&ree_fs_mutex);
+	mutex_unlock(&fdp->lock->mu);
 
 	return res;
 }
@@ -944,7 +1176,6 @@ static TEE_Result ree_fs_rename(struct tee_pobj *old, struct tee_pobj *new,
 
 	if (remove_dfh.idx != -1)
 		tee_fs_rpc_remove_dfh(OPTEE_RPC_CMD_FS, &remove_dfh);
-
 out:
 	put_dirh(dirh, res);
 	mutex_unlock(&ree_fs_mutex);
@@ -991,14 +1222,9 @@ out:
 static TEE_Result ree_fs_truncate(struct tee_file_handle *fh, size_t len)
 {
 	TEE_Result res;
-	struct tee_fs_dirfile_dirh *dirh = NULL;
 	struct tee_fs_fd *fdp = (struct tee_fs_fd *)fh;
 
-	mutex_lock(&ree_fs_mutex);
-
-	res = get_dirh(&dirh);
-	if (res)
-		goto out;
+	mutex_lock(&fdp->lock->mu);
 
 	res = ree_fs_ftruncate_internal(fdp, len);
 	if (res)
@@ -1008,13 +1234,9 @@ static TEE_Result ree_fs_truncate(struct tee_file_handle *fh, size_t len)
 	if (res)
 		goto out;
 
-	res = tee_fs_dirfile_update_hash(dirh, &fdp->dfh);
-	if (res)
-		goto out;
-	res = commit_dirh_writes(dirh);
+	res = update_dirh_hash(fdp);
 out:
-	put_dirh(dirh, res);
-	mutex_unlock(&ree_fs_mutex);
+	mutex_unlock(&fdp->lock->mu);
 
 	return res;
 }
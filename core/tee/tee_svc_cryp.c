@@ -10,6 +10,7 @@
 #include <compiler.h>
 #include <config.h>
 #include <crypto/crypto.h>
+#include <kernel/hash_set.h>
 #include <kernel/tee_ta_manager.h>
 #include <kernel/user_access.h>
 #include <memtag.h>
@@ -47,6 +48,7 @@ enum cryp_state {
 typedef void (*tee_cryp_ctx_finalize_func_t) (void *ctx);
 struct tee_cryp_state {
 	TAILQ_ENTRY(tee_cryp_state) link;
+	struct hash_set_elem handle_elem;
 	uint32_t algo;
 	uint32_t mode;
 	vaddr_t key1;
@@ -2579,16 +2581,15 @@ static TEE_Result tee_svc_cryp_get_state(struct ts_session *sess,
 					 vaddr_t state_id,
 					 struct tee_cryp_state **state)
 {
-	struct tee_cryp_state *s;
 	struct user_ta_ctx *utc = to_user_ta_ctx(sess->ctx);
+	struct hash_set_elem *e = NULL;
 
-	TAILQ_FOREACH(s, &utc->cryp_states, link) {
-		if (state_id == (vaddr_t)s) {
-			*state = s;
-			return TEE_SUCCESS;
-		}
-	}
-	return TEE_ERROR_BAD_PARAMETERS;
+	e = hash_set_first(&utc->cryp_state_set, state_id);
+	if (!e)
+		return TEE_ERROR_BAD_PARAMETERS;
+
+	*state = container_of(e, struct tee_cryp_state, handle_elem);
+	return TEE_SUCCESS;
 }
 
 static void cryp_state_free(struct user_ta_ctx *utc, struct tee_cryp_state *cs)
@@ -2601,6 +2602,7 @@ static void cryp_state_free(struct user_ta_ctx *utc, struct tee_cryp_state *cs)
 		tee_obj_close(utc, o);
 
 	TAILQ_REMOVE(&utc->cryp_states, cs, link);
+	hash_set_remove(&utc->cryp_state_set, &cs->handle_elem);
 	if (cs->ctx_finalize != NULL)
 		cs->ctx_finalize(cs->ctx);
 
@@ -2814,6 +2816,7 @@ TEE_Result syscall_cryp_state_alloc(unsigned long algo, unsigned long mode,
 	if (!cs)
 		return TEE_ERROR_OUT_OF_MEMORY;
 	TAILQ_INSERT_TAIL(&utc->cryp_states, cs, link);
+	hash_set_add(&utc->cryp_state_set, &cs->handle_elem, (vaddr_t)cs);
 	cs->algo = algo;
 	cs->mode = mode;
 	cs->state = CRYP_STATE_UNINITIALIZED;
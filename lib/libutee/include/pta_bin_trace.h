@@ -0,0 +1,114 @@
+/* SPDX-License-Identifier: BSD-2-Clause */
+/*
+ * Copyright (c) 2026, Linaro Limited
+ */
+#ifndef __PTA_BIN_TRACE_H
+#define __PTA_BIN_TRACE_H
+
+#include <stdint.h>
+
+/*
+ * Interface to the binary trace pseudo-TA, which lets a normal world
+ * daemon collect the TEE core trace messages as compact binary records
+ * in a shared memory ring instead of text on the secure console.
+ *
+ * A record holds the link address of the format string, the decoder
+ * (scripts/bin_trace_decode.py) looks it up in tee.elf and formats the
+ * arguments saved in the record.
+ */
+#define PTA_BIN_TRACE_UUID { 0x5f8a1c3e, 0x0b7d, 0x4c2a, { \
+			     0x9e, 0x61, 0x3d, 0x27, 0xc4, 0x58, 0xa0, 0x19 } }
+
+/*
+ * Register a ring for the binary trace records
+ *
+ * Only one ring can be registered at a time, it stays in use until the
+ * session is closed or PTA_BIN_TRACE_CMD_UNREGISTER is invoked.
+ * The memory reference must be registered shared memory, a
+ * struct pta_bin_trace_ring with at least PTA_BIN_TRACE_MIN_SIZE bytes
+ * of data. The TEE initializes the header of the ring.
+ *
+ * [in/out] memref[0]: ring
+ * [in]     value[1].a: PTA_BIN_TRACE_FLAG_* flags
+ *
+ * Return codes:
+ * TEE_SUCCESS - Invoke command success
+ * TEE_ERROR_BAD_PARAMETERS - Incorrect input param
+ * TEE_ERROR_BUSY - A ring is already registered
+ */
+#define PTA_BIN_TRACE_CMD_REGISTER	0
+
+/*
+ * Unregister the ring registered in this session
+ *
+ * Return codes:
+ * TEE_SUCCESS - Invoke command success
+ * TEE_ERROR_BAD_STATE - No ring registered by this session
+ */
+#define PTA_BIN_TRACE_CMD_UNREGISTER	1
+
+/* Keep printing messages as text on the secure console too */
+#define PTA_BIN_TRACE_FLAG_CONSOLE	(1U << 0)
+
+#define PTA_BIN_TRACE_MIN_SIZE		4096
+
+/*
+ * struct pta_bin_trace_ring - Shared memory ring
+ * @size:	Size of @data in bytes, a power of 2, set by the TEE
+ * @cntfrq:	Frequency of the record timestamps, set by the TEE
+ * @head:	Free running offset of the next record, updated by the TEE
+ * @tail:	Free running offset of the next record to be read, updated
+ *		by normal world
+ * @dropped:	Number of records dropped due to a full ring
+ * @data:	Records
+ *
+ * Records are 8 bytes aligned and never wrap around the end of @data,
+ * a PTA_BIN_TRACE_REC_PAD record fills the unused space when needed.
+ */
+struct pta_bin_trace_ring {
+	uint32_t size;
+	uint32_t cntfrq;
+	uint64_t head;
+	uint64_t tail;
+	uint64_t dropped;
+	uint8_t data[];
+};
+
+#define PTA_BIN_TRACE_REC_MSG		0
+#define PTA_BIN_TRACE_REC_PAD		1
+
+#define PTA_BIN_TRACE_NO_THREAD		0xffff
+
+/*
+ * struct pta_bin_trace_rec - Binary trace record
+ * @size:	Size of the record in bytes including this header
+ * @type:	PTA_BIN_TRACE_REC_*, only @size and @type are valid in a
+ *		padding record
+ * @level:	Trace level, 0 for messages printed regardless of level
+ * @core:	Core position
+ * @thread:	Thread ID or PTA_BIN_TRACE_NO_THREAD
+ * @line:	Source line of the message
+ * @timestamp:	Counter value when the message was logged
+ * @fmt:	Link address of the format string
+ * @func:	Link address of the function name or 0
+ * @args:	Arguments in format string order. An integer, a pointer or
+ *		a '*' width or precision uses one word. A %s string uses one
+ *		word with its length followed by the characters padded to a
+ *		word. A %pUl UUID uses two words with its 16 bytes. A
+ *		pointer is recorded relative to the link address like @fmt.
+ */
+struct pta_bin_trace_rec {
+	uint16_t size;
+	uint8_t type;
+	uint8_t level;
+	uint16_t core;
+	uint16_t thread;
+	uint32_t line;
+	uint32_t reserved;
+	uint64_t timestamp;
+	uint64_t fmt;
+	uint64_t func;
+	uint64_t args[];
+};
+
+#endif /* __PTA_BIN_TRACE_H */
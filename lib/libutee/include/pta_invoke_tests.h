@@ -113,5 +113,35 @@
  */
 #define PTA_INVOKE_TESTS_CMD_TRANSFER_LIST_TESTS	12
 
+/*
+ * REE FS performance test: creates an object of its own, reads it back
+ * repeatedly and removes it. Concurrent invocations from several threads
+ * use independent objects and show how secure storage accesses scale.
+ *
+ * [in]     value[0].a	Instance number, selects the object used
+ * [in]     value[0].b	Object size in bytes
+ * [in]     value[1].a	Number of times the object is read
+ * [out]    value[2].a	Time spent reading in milliseconds
+ */
+#define PTA_INVOKE_TESTS_CMD_REE_FS_PERF	13
+
+/*
+ * Asymmetric crypto performance test: generates a key of its own and
+ * signs, verifies or agrees on a secret with it repeatedly. Concurrent
+ * invocations from several threads show how Big Number computations
+ * scale.
+ *
+ * [in]     value[0].a	Algorithm, PTA_INVOKE_TESTS_ASYM_PERF_*
+ * [in]     value[0].b	Key size in bits, 256, 384 or 521 for ECC
+ * [in]     value[1].a	Number of operations
+ * [out]    value[2].a	Time spent in the operations in milliseconds
+ */
+#define PTA_INVOKE_TESTS_CMD_ASYM_PERF		14
+
+#define PTA_INVOKE_TESTS_ASYM_PERF_RSA		0 /* PKCS#1 v1.5 SHA-256 */
+#define PTA_INVOKE_TESTS_ASYM_PERF_ECDSA	1 /* NIST curves */
+#define PTA_INVOKE_TESTS_ASYM_PERF_ECDSA_VERIFY	2
+#define PTA_INVOKE_TESTS_ASYM_PERF_ECDH		3
+
 #endif /*__PTA_INVOKE_TESTS_H*/
 
@@ -93,4 +93,158 @@ struct pta_stats_ta {
 #define STATS_DRIVER_TYPE_CLOCK		0
 #define STATS_DRIVER_TYPE_REGULATOR	1
 
+/*
+ * STATS_CMD_THREAD_STATS - Get statistics on core threads
+ *
+ * [out]    value[0].a        Number of configured threads
+ * [out]    value[0].b        Number of busy (active or suspended) threads
+ * [out]    value[1].a        Max busy threads since last stats dump
+ * [out]    value[1].b        Calls rejected with no free thread since last
+ *                            stats dump
+ */
+#define STATS_CMD_THREAD_STATS		6
+
+/*
+ * STATS_CMD_FS_CACHE_STATS - Get statistics on the REE FS block cache
+ *
+ * [out]    value[0].a        Cache hits since last stats dump
+ * [out]    value[0].b        Cache misses since last stats dump
+ * [out]    value[1].a        Blocks read ahead since last stats dump
+ * [out]    value[1].b        Number of cached blocks
+ * [out]    value[2].a        Maximal number of cached blocks
+ */
+#define STATS_CMD_FS_CACHE_STATS	7
+
+/*
+ * STATS_CMD_TRACE_RING_STATS - Get statistics on the trace ring of a core
+ *
+ * [in]     value[0].a        Core number
+ * [out]    value[1].a        Trace lines added to the ring
+ * [out]    value[1].b        Trace lines dropped because the ring was full
+ * [out]    value[2].a        Bytes of the dropped trace lines
+ * [out]    value[2].b        Highest number of bytes waiting in the ring
+ */
+#define STATS_CMD_TRACE_RING_STATS	8
+
+/*
+ * STATS_CMD_MALLOC_CACHE_STATS - Get statistics on the per-core caches of
+ * small core heap buffers
+ *
+ * [out]    value[0].a        Allocations served from a cache since last
+ *                            stats dump
+ * [out]    value[0].b        Allocations finding their cache empty since
+ *                            last stats dump
+ * [out]    value[1].a        Full caches drained to the heap since last
+ *                            stats dump
+ * [out]    value[1].b        Bytes currently held in the caches
+ */
+#define STATS_CMD_MALLOC_CACHE_STATS	9
+
+/*
+ * STATS_CMD_LOCK_PROF_STATS - Get lock contention statistics per lock site
+ *
+ * [in]     value[0].a        Non-zero to reset the statistics once read
+ * [out]    memref[1]         Array of struct pta_stats_lock_site
+ *
+ * Returns TEE_ERROR_SHORT_BUFFER with the required size in memref[1] if
+ * the array is too small, the statistics are not reset in that case.
+ */
+#define STATS_CMD_LOCK_PROF_STATS	10
+
+#define STATS_LOCK_TYPE_MUTEX		0
+#define STATS_LOCK_TYPE_SPINLOCK	1
+
+/*
+ * struct pta_stats_lock_site - Statistics of a lock site
+ * @file:		End of the source file name, null terminated
+ * @line:		Source line where the lock is taken
+ * @type:		STATS_LOCK_TYPE_*
+ * @acquired:		Number of times the lock was taken
+ * @contended:		Number of times the lock had to be waited for
+ * @spin_acquired:	Contended mutex locks acquired by spinning instead of
+ *			waiting in normal world
+ * @sleeps:		Number of times a mutex was waited for in normal world
+ * @wait_us:		Total time spent waiting in microseconds
+ * @max_hold_us:	Longest time the lock was held in microseconds
+ */
+struct pta_stats_lock_site {
+	char file[40];
+	uint32_t line;
+	uint32_t type;
+	uint32_t acquired;
+	uint32_t contended;
+	uint32_t spin_acquired;
+	uint32_t sleeps;
+	uint64_t wait_us;
+	uint64_t max_hold_us;
+};
+
+/*
+ * STATS_CMD_TA_CACHE_FLUSH - Release the TA binaries cached with
+ * CFG_REE_FS_TA_CACHE=y
+ *
+ * Returns TEE_ERROR_NOT_SUPPORTED if the cache isn't enabled.
+ */
+#define STATS_CMD_TA_CACHE_FLUSH	11
+
+/*
+ * STATS_CMD_TA_LOAD_STATS - Get where the time loading TAs from the REE
+ * filesystem is spent
+ *
+ * [out]    value[0].a        TA binaries loaded from tee-supplicant since
+ *                            last stats dump
+ * [out]    value[0].b        TA binaries served from the cache since last
+ *                            stats dump
+ * [out]    value[1].a        Milliseconds spent loading from tee-supplicant
+ * [out]    value[1].b        Milliseconds spent checking signed headers
+ * [out]    value[2].a        Milliseconds spent decrypting or copying, and
+ *                            hashing the binaries
+ * [out]    value[2].b        Kilobytes of binaries read
+ */
+#define STATS_CMD_TA_LOAD_STATS		12
+
+/*
+ * STATS_CMD_BOOT_PROF_STATS - Get the time spent in each initcall and DT
+ * driver probe during boot
+ *
+ * With CFG_NS_VIRTUALIZATION only the nexus boot is recorded, not the
+ * initcalls done for each guest.
+ *
+ * [out]    memref[0]         Array of struct pta_stats_boot_rec, in the
+ *                            order the calls were made
+ *
+ * Returns TEE_ERROR_SHORT_BUFFER with the required size in memref[0] if
+ * the array is too small.
+ */
+#define STATS_CMD_BOOT_PROF_STATS	13
+
+#define STATS_BOOT_PHASE_PREINIT	0
+#define STATS_BOOT_PHASE_EARLY_INIT	1
+#define STATS_BOOT_PHASE_SERVICE_INIT	2
+#define STATS_BOOT_PHASE_DRIVER_INIT	3
+#define STATS_BOOT_PHASE_FINAL		4
+#define STATS_BOOT_PHASE_DT_PROBE	5
+
+/*
+ * struct pta_stats_boot_rec - Time spent in an initcall or DT driver probe
+ * @name:	Initcall function or DT driver name, null terminated
+ * @node:	Probed DT node name, null terminated, empty for initcalls
+ * @phase:	STATS_BOOT_PHASE_*
+ * @level:	Initcall level, 0 for DT driver probes
+ * @result:	Returned result
+ * @reserved:	Reserved, zero
+ * @start_us:	Counter time when called in microseconds
+ * @duration_us: Time spent in microseconds
+ */
+struct pta_stats_boot_rec {
+	char name[32];
+	char node[32];
+	uint32_t phase;
+	uint32_t level;
+	uint32_t result;
+	uint32_t reserved;
+	uint64_t start_us;
+	uint64_t duration_us;
+};
+
 #endif /*__PTA_STATS_H*/
@@ -10,11 +10,13 @@
 
 /*
  * Memory pool for large temporary memory allocations that must not fail.
- * With the first allocation from an unused (idle or free) pool the pool
- * becomes reserved for that particular thread, until all allocations are
- * freed again. In order to avoid dead-lock and ease code review it is good
- * practise to free everything allocated by a certain function before
- * returning.
+ * The pool is divided in one or more slots. With the first allocation
+ * from an unused (idle or free) slot the slot becomes reserved for that
+ * particular thread, until all allocations from it are freed again. When
+ * no slot is available the thread waits for one, or uses the heap instead
+ * with CFG_CORE_MEMPOOL_HEAP_FALLBACK=y. In order to avoid dead-lock and
+ * ease code review it is good practise to free everything allocated by a
+ * certain function before returning.
  */
 
 /*
@@ -49,6 +51,23 @@ extern struct mempool *mempool_default;
 struct mempool *mempool_alloc_pool(void *data, size_t size,
 				   void (*release_mem)(void *ptr, size_t size));
 
+/*
+ * mempool_alloc_pool_slots() - Allocate a new memory pool divided in slots
+ * @data:		a block of memory to carve out items from, must
+ *			have an alignment of MEMPOOL_ALIGN.
+ * @size:		size fo the block of memory
+ * @num_slots:		number of equally sized slots to divide @data in,
+ *			allowing that many threads to use the pool
+ *			concurrently. Always 1 in user mode.
+ * @release_mem:	function to call when a slot has been emptied,
+ *			ignored if NULL.
+ * returns a pointer to a valid pool on success or NULL on failure.
+ */
+struct mempool *mempool_alloc_pool_slots(void *data, size_t size,
+					 size_t num_slots,
+					 void (*release_mem)(void *ptr,
+							     size_t size));
+
 /*
  * mempool_alloc() - Allocate an item from a memory pool
  * @pool:		A memory pool created with mempool_alloc_pool()
@@ -30,6 +30,12 @@ int trace_ext_get_guest_id(void);
 void trace_set_level(int level);
 int trace_get_level(void);
 void plat_trace_ext_puts(const char *str);
+/*
+ * Provided by TEE core with CFG_CORE_BINARY_TRACE=y, returns true if the
+ * message was logged as a binary record and doesn't need to be printed.
+ */
+bool trace_ext_bin_vprintf(const char *func, int line, int level,
+			   bool level_ok, const char *fmt, va_list ap);
 
 /* Internal functions used by the macros below */
 void trace_vprintf(const char *func, int line, int level, bool level_ok,
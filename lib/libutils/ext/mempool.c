@@ -7,15 +7,18 @@
 
 #include <assert.h>
 #include <compiler.h>
+#include <config.h>
 #include <malloc.h>
 #include <mempool.h>
 #include <pta_stats.h>
+#include <stdlib.h>
 #include <string.h>
 #include <util.h>
 
 #if defined(__KERNEL__)
 #include <kernel/mutex.h>
 #include <kernel/panic.h>
+#include <kernel/thread.h>
 #endif
 
 /*
@@ -53,27 +56,54 @@
  */
 
 
-struct mempool {
-	size_t size;  /* size of the memory pool, in bytes */
+/*
+ * In the kernel the pool is split into a number of equally sized slots.
+ * With the first allocation from an idle slot the slot becomes reserved
+ * for the calling thread, until all allocations from the slot are freed
+ * again. A thread keeps allocating from the slot it has reserved, other
+ * threads reserve another idle slot or wait for one to become idle. This
+ * lets independent threads do Big Number computations in parallel instead
+ * of being serialized on a single pool.
+ *
+ * With CFG_CORE_MEMPOOL_HEAP_FALLBACK=y the item is allocated from the
+ * heap instead when no slot can be reserved or the reserved slot is
+ * exhausted. A thread without a reserved slot then only waits when the
+ * heap is exhausted too. Items are freed to the slot or the heap depending
+ * on the address.
+ */
+struct mempool_slot {
 	vaddr_t data;
+	size_t size;
 	struct malloc_ctx *mctx;
 #ifdef CFG_MEMPOOL_REPORT_LAST_OFFSET
 	size_t max_allocated;
 #endif
+#if defined(__KERNEL__)
+	short int owner;	/* Thread reserving the slot */
+	unsigned int depth;	/* Number of items allocated from the slot */
+#endif
+};
+
+struct mempool {
+	size_t size;  /* size of the memory pool, in bytes */
+	vaddr_t data;
 #if defined(__KERNEL__)
 	void (*release_mem)(void *ptr, size_t size);
-	struct recursive_mutex mu;
+	struct mutex mu;	/* Protects owner and depth of the slots */
+	struct condvar cv;	/* Signalled when a slot becomes idle */
 #endif
+	size_t num_slots;
+	struct mempool_slot slots[];
 };
 
 #if defined(__KERNEL__)
 struct mempool *mempool_default;
 #endif
 
-static void init_mpool(struct mempool *pool)
+static void init_mpool(struct mempool_slot *slot)
 {
-	size_t sz = pool->size - raw_malloc_get_ctx_size();
-	vaddr_t v = ROUNDDOWN(pool->data + sz, sizeof(long) * 2);
+	size_t sz = slot->size - raw_malloc_get_ctx_size();
+	vaddr_t v = ROUNDDOWN(slot->data + sz, sizeof(long) * 2);
 
 	/*
 	 * v is the placed as close to the end of the data pool as possible
@@ -82,88 +112,185 @@ static void init_mpool(struct mempool *pool)
 	 * locality since raw_malloc() starts to allocate from the end of
 	 * the supplied data pool.
 	 */
-	assert(v > pool->data);
-	pool->mctx = (struct malloc_ctx *)v;
-	raw_malloc_init_ctx(pool->mctx);
-	raw_malloc_add_pool(pool->mctx, (void *)pool->data, v - pool->data);
+	assert(v > slot->data);
+	slot->mctx = (struct malloc_ctx *)v;
+	raw_malloc_init_ctx(slot->mctx);
+	raw_malloc_add_pool(slot->mctx, (void *)slot->data, v - slot->data);
 }
 
-static void get_pool(struct mempool *pool __maybe_unused)
+static void *slot_alloc(struct mempool_slot *slot, size_t size)
 {
-#if defined(__KERNEL__)
-	mutex_lock_recursive(&pool->mu);
-	if (!pool->mctx)
-		init_mpool(pool);
+	void *p = raw_malloc(0, 0, size, slot->mctx);
 
-#endif
-}
+#ifdef CFG_MEMPOOL_REPORT_LAST_OFFSET
+	if (p) {
+		struct pta_stats_alloc stats = { };
 
-static void put_pool(struct mempool *pool __maybe_unused)
-{
-#if defined(__KERNEL__)
-	if (mutex_get_recursive_lock_depth(&pool->mu) == 1) {
-		/*
-		 * As the refcount is about to become 0 there should be no items
-		 * left
-		 */
-		if (pool->release_mem) {
-			pool->mctx = NULL;
-			pool->release_mem((void *)pool->data, pool->size);
+		raw_malloc_get_stats(slot->mctx, &stats);
+		if (stats.max_allocated > slot->max_allocated) {
+			slot->max_allocated = stats.max_allocated;
+			DMSG("Max memory usage increased to %zu",
+			     slot->max_allocated);
 		}
 	}
-	mutex_unlock_recursive(&pool->mu);
 #endif
+
+	return p;
 }
 
 struct mempool *
-mempool_alloc_pool(void *data, size_t size,
-		   void (*release_mem)(void *ptr, size_t size) __maybe_unused)
+mempool_alloc_pool_slots(void *data, size_t size, size_t num_slots,
+			 void (*release_mem)(void *ptr,
+					     size_t size) __maybe_unused)
 {
-	struct mempool *pool = calloc(1, sizeof(*pool));
+	struct mempool *pool = NULL;
+	size_t slot_size = 0;
+	size_t n = 0;
 
 	COMPILE_TIME_ASSERT(MEMPOOL_ALIGN >= __alignof__(struct mempool_item));
 	assert(!((vaddr_t)data & (MEMPOOL_ALIGN - 1)));
 
-	if (pool) {
-		pool->size = size;
-		pool->data = (vaddr_t)data;
+	if (!num_slots)
+		return NULL;
+#if !defined(__KERNEL__)
+	/* Only one thread in user mode */
+	num_slots = 1;
+#endif
+	slot_size = ROUNDDOWN(size / num_slots, MEMPOOL_ALIGN);
+
+	pool = calloc(1, sizeof(*pool) + num_slots * sizeof(pool->slots[0]));
+	if (!pool)
+		return NULL;
+
+	pool->size = size;
+	pool->data = (vaddr_t)data;
+	pool->num_slots = num_slots;
+	for (n = 0; n < num_slots; n++) {
+		pool->slots[n].data = pool->data + n * slot_size;
+		pool->slots[n].size = slot_size;
 #if defined(__KERNEL__)
-		pool->release_mem = release_mem;
-		mutex_init_recursive(&pool->mu);
+		pool->slots[n].owner = THREAD_ID_INVALID;
 #else
-		init_mpool(pool);
+		init_mpool(pool->slots + n);
 #endif
 	}
+#if defined(__KERNEL__)
+	pool->release_mem = release_mem;
+	mutex_init(&pool->mu);
+	condvar_init(&pool->cv);
+#endif
 
 	return pool;
 }
 
-void *mempool_alloc(struct mempool *pool, size_t size)
+struct mempool *
+mempool_alloc_pool(void *data, size_t size,
+		   void (*release_mem)(void *ptr, size_t size) __maybe_unused)
 {
-	void *p = NULL;
+	return mempool_alloc_pool_slots(data, size, 1, release_mem);
+}
 
-	get_pool(pool);
+#if defined(__KERNEL__)
+/* Called with pool->mu held */
+static struct mempool_slot *reserve_slot(struct mempool *pool, short int ct)
+{
+	struct mempool_slot *slot = NULL;
+	size_t n = 0;
 
-	p = raw_malloc(0, 0, size, pool->mctx);
-	if (p) {
-#ifdef CFG_MEMPOOL_REPORT_LAST_OFFSET
-		struct pta_stats_alloc stats = { };
+	for (n = 0; n < pool->num_slots; n++) {
+		slot = pool->slots + n;
+		if (slot->owner == ct)
+			goto out;
+	}
 
-		raw_malloc_get_stats(pool->mctx, &stats);
-		if (stats.max_allocated > pool->max_allocated) {
-			pool->max_allocated = stats.max_allocated;
-			DMSG("Max memory usage increased to %zu",
-			     pool->max_allocated);
+	for (n = 0; n < pool->num_slots; n++) {
+		slot = pool->slots + n;
+		if (!slot->depth) {
+			slot->owner = ct;
+			if (!slot->mctx)
+				init_mpool(slot);
+			goto out;
 		}
-#endif
-		return p;
 	}
 
-	EMSG("Failed to allocate %zu bytes, please tune the pool size", size);
-	put_pool(pool);
 	return NULL;
+out:
+	slot->depth++;
+	return slot;
+}
+
+static void put_slot(struct mempool *pool, struct mempool_slot *slot)
+{
+	mutex_lock(&pool->mu);
+	assert(slot->depth && slot->owner == thread_get_id());
+	slot->depth--;
+	if (!slot->depth) {
+		/*
+		 * As the refcount is now 0 there should be no items
+		 * left
+		 */
+		slot->owner = THREAD_ID_INVALID;
+		if (pool->release_mem) {
+			slot->mctx = NULL;
+			pool->release_mem((void *)slot->data, slot->size);
+		}
+		condvar_signal(&pool->cv);
+	}
+	mutex_unlock(&pool->mu);
 }
 
+void *mempool_alloc(struct mempool *pool, size_t size)
+{
+	struct mempool_slot *slot = NULL;
+	short int ct = thread_get_id();
+	void *p = NULL;
+
+	mutex_lock(&pool->mu);
+	slot = reserve_slot(pool, ct);
+	mutex_unlock(&pool->mu);
+
+	if (slot) {
+		p = slot_alloc(slot, size);
+		if (p)
+			return p;
+		put_slot(pool, slot);
+		if (!IS_ENABLED(CFG_CORE_MEMPOOL_HEAP_FALLBACK))
+			goto out;
+	}
+
+	if (IS_ENABLED(CFG_CORE_MEMPOOL_HEAP_FALLBACK)) {
+		p = malloc(size);
+		if (p || slot)
+			goto out;
+	}
+
+	/* Wait for a slot to become idle */
+	mutex_lock(&pool->mu);
+	while (!(slot = reserve_slot(pool, ct)))
+		condvar_wait(&pool->cv, &pool->mu);
+	mutex_unlock(&pool->mu);
+
+	p = slot_alloc(slot, size);
+	if (!p)
+		put_slot(pool, slot);
+out:
+	if (!p)
+		EMSG("Failed to allocate %zu bytes, please tune the pool size",
+		     size);
+	return p;
+}
+#else
+void *mempool_alloc(struct mempool *pool, size_t size)
+{
+	void *p = slot_alloc(pool->slots, size);
+
+	if (!p)
+		EMSG("Failed to allocate %zu bytes, please tune the pool size",
+		     size);
+	return p;
+}
+#endif
+
 void *mempool_calloc(struct mempool *pool, size_t nmemb, size_t size)
 {
 	size_t sz;
@@ -181,8 +308,28 @@ void *mempool_calloc(struct mempool *pool, size_t nmemb, size_t size)
 
 void mempool_free(struct mempool *pool, void *ptr)
 {
-	if (ptr) {
-		raw_free(ptr, pool->mctx, false /*!wipe*/);
-		put_pool(pool);
+#if defined(__KERNEL__)
+	struct mempool_slot *slot = NULL;
+	vaddr_t va = (vaddr_t)ptr;
+	size_t n = 0;
+
+	if (!ptr)
+		return;
+
+	for (n = 0; n < pool->num_slots; n++) {
+		slot = pool->slots + n;
+		if (va >= slot->data && va < slot->data + slot->size) {
+			raw_free(ptr, slot->mctx, false /*!wipe*/);
+			put_slot(pool, slot);
+			return;
+		}
 	}
+
+	/* Allocated from the heap as a fallback */
+	assert(IS_ENABLED(CFG_CORE_MEMPOOL_HEAP_FALLBACK));
+	free(ptr);
+#else
+	if (ptr)
+		raw_free(ptr, pool->slots->mctx, false /*!wipe*/);
+#endif
 }
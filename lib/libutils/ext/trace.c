@@ -134,6 +134,11 @@ void trace_vprintf(const char *function, int line, int level, bool level_ok,
 	if (level_ok && level > trace_level)
 		return;
 
+#if defined(__KERNEL__) && defined(CFG_CORE_BINARY_TRACE)
+	if (trace_ext_bin_vprintf(function, line, level, level_ok, fmt, ap))
+		return;
+#endif
+
 	/* Print the type of message */
 	res = snprintk(buf, sizeof(buf), "%c/",
 		       trace_level_to_string(level, level_ok));
@@ -94,7 +94,9 @@
 #if defined(__KERNEL__)
 /* Compiling for TEE Core */
 #include <kernel/asan.h>
+#include <kernel/misc.h>
 #include <kernel/spinlock.h>
+#include <kernel/thread.h>
 #include <kernel/unwind.h>
 
 static void *memset_unchecked(void *s, int c, size_t n)
@@ -278,22 +280,41 @@ static void tag_asan_free(void *buf __maybe_unused, size_t len __maybe_unused)
 #endif
 }
 
+static size_t malloc_cache_bytes(void);
+
 #ifdef BufStats
 
+/* Heap in use, buffers held in the per-core caches don't count */
+static size_t heap_in_use(struct malloc_ctx *ctx)
+{
+	size_t used = ctx->poolset.totalloc;
+
+	if (ctx == &malloc_ctx)
+		used -= MIN(used, malloc_cache_bytes());
+
+	return used;
+}
+
+static void update_max_allocated(struct malloc_ctx *ctx)
+{
+	size_t used = heap_in_use(ctx);
+
+	if (used > ctx->mstats.max_allocated)
+		ctx->mstats.max_allocated = used;
+}
+
 static void *raw_malloc_return_hook(void *p, size_t hdr_size,
 				    size_t requested_size,
 				    struct malloc_ctx *ctx)
 {
-	if (ctx->poolset.totalloc > ctx->mstats.max_allocated)
-		ctx->mstats.max_allocated = ctx->poolset.totalloc;
+	update_max_allocated(ctx);
 
 	if (!p) {
 		ctx->mstats.num_alloc_fail++;
 		print_oom(requested_size, ctx);
 		if (requested_size > ctx->mstats.biggest_alloc_fail) {
 			ctx->mstats.biggest_alloc_fail = requested_size;
-			ctx->mstats.biggest_alloc_fail_used =
-				ctx->poolset.totalloc;
+			ctx->mstats.biggest_alloc_fail_used = heap_in_use(ctx);
 		}
 	}
 
@@ -321,6 +342,8 @@ static void gen_malloc_get_stats(struct malloc_ctx *ctx,
 {
 	uint32_t exceptions = malloc_lock(ctx);
 
+	/* Buffers taken from the caches are only accounted for here */
+	update_max_allocated(ctx);
 	raw_malloc_get_stats(ctx, stats);
 	malloc_unlock(ctx, exceptions);
 }
@@ -328,6 +351,8 @@ static void gen_malloc_get_stats(struct malloc_ctx *ctx,
 void malloc_get_stats(struct pta_stats_alloc *stats)
 {
 	gen_malloc_get_stats(&malloc_ctx, stats);
+	/* Buffers held in the per-core caches aren't in use */
+	stats->allocated -= MIN(stats->allocated, malloc_cache_bytes());
 }
 
 #else /* BufStats */
@@ -605,6 +630,309 @@ static struct malloc_ctx *get_ctx(uint32_t flags __maybe_unused)
 	return &malloc_ctx;
 }
 
+#if defined(__KERNEL__) && defined(CFG_CORE_MALLOC_CACHE)
+/*
+ * Per-core caches of small buffers in front of the default heap
+ *
+ * Each core keeps a magazine of free buffers for each size class which is
+ * used with exceptions masked and the lock of the core's cache held, but
+ * without taking the heap lock. The lock of the cache is only contended
+ * when an allocation fails and the caches of all cores are flushed. An
+ * empty magazine is refilled, and a full one is drained,
+ * MALLOC_CACHE_BATCH buffers at a time with a single heap lock round trip.
+ *
+ * Cached buffers are still allocated as far as bget is concerned, but
+ * they are tagged as free so ASan and MTE catch use after free.
+ */
+#define MALLOC_CACHE_MAG_SIZE	16
+#define MALLOC_CACHE_BATCH	(MALLOC_CACHE_MAG_SIZE / 2)
+
+static const uint16_t malloc_cache_sizes[] = {
+	16, 32, 48, 64, 96, 128, 192, 256
+};
+
+struct malloc_cache_mag {
+	void *bufs[MALLOC_CACHE_MAG_SIZE];
+	size_t count;
+};
+
+struct malloc_cache {
+	struct malloc_cache_mag mags[ARRAY_SIZE(malloc_cache_sizes)];
+	unsigned int lock;
+	size_t bytes;
+	size_t hits;
+	size_t misses;
+	size_t flushes;
+};
+
+static struct malloc_cache malloc_cache[CFG_TEE_CORE_NB_CORE];
+
+static int malloc_cache_alloc_idx(size_t size)
+{
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(malloc_cache_sizes); n++)
+		if (size <= malloc_cache_sizes[n])
+			return n;
+
+	return -1;
+}
+
+/* Largest size class that a free buffer of @size bytes can serve */
+static int malloc_cache_free_idx(size_t size)
+{
+	int n = ARRAY_SIZE(malloc_cache_sizes) - 1;
+
+	if (size > malloc_cache_sizes[n])
+		return -1;
+
+	for (; n >= 0; n--)
+		if (size >= malloc_cache_sizes[n])
+			return n;
+
+	return -1;
+}
+
+/* Heap space used by a buffer, as accounted in poolset.totalloc */
+static size_t malloc_cache_buf_size(void *buf)
+{
+	return bget_buf_size(buf) + sizeof(struct bhead);
+}
+
+static bool malloc_cache_enabled(uint32_t flags, size_t alignment)
+{
+	return !IS_ENABLED2(ENABLE_MDBG) && alignment <= SizeQuant &&
+	       get_ctx(flags) == &malloc_ctx;
+}
+
+static void malloc_cache_refill(struct malloc_cache *cache,
+				struct malloc_cache_mag *mag, size_t size)
+{
+	struct malloc_ctx *ctx = &malloc_ctx;
+	uint32_t exceptions = malloc_lock(ctx);
+	void *p = NULL;
+
+	raw_malloc_validate_pools(ctx);
+
+	while (mag->count < MALLOC_CACHE_BATCH) {
+		p = bget(1, 0, size, &ctx->poolset);
+		if (!p)
+			break;
+		cache->bytes += malloc_cache_buf_size(p);
+		mag->bufs[mag->count] = p;
+		mag->count++;
+	}
+
+#ifdef BufStats
+	update_max_allocated(ctx);
+#endif
+
+	malloc_unlock(ctx, exceptions);
+}
+
+/* Gives buffers of @mag back to the heap until @keep are left */
+static void malloc_cache_flush(struct malloc_cache *cache,
+			       struct malloc_cache_mag *mag, size_t keep)
+{
+	struct malloc_ctx *ctx = &malloc_ctx;
+	uint32_t exceptions = malloc_lock(ctx);
+	void *p = NULL;
+
+	raw_malloc_validate_pools(ctx);
+
+	while (mag->count > keep) {
+		mag->count--;
+		p = mag->bufs[mag->count];
+		cache->bytes -= malloc_cache_buf_size(p);
+		brel(p, &ctx->poolset, false /*!wipe*/);
+	}
+	cache->flushes++;
+
+	malloc_unlock(ctx, exceptions);
+}
+
+bool malloc_flush_caches(void)
+{
+	struct malloc_cache *cache = NULL;
+	uint32_t exceptions = 0;
+	bool ret = false;
+	size_t n = 0;
+	size_t m = 0;
+
+	for (n = 0; n < ARRAY_SIZE(malloc_cache); n++) {
+		cache = malloc_cache + n;
+		exceptions = cpu_spin_lock_xsave(&cache->lock);
+		for (m = 0; m < ARRAY_SIZE(cache->mags); m++) {
+			if (cache->mags[m].count) {
+				malloc_cache_flush(cache, cache->mags + m, 0);
+				ret = true;
+			}
+		}
+		cpu_spin_unlock_xrestore(&cache->lock, exceptions);
+	}
+
+	return ret;
+}
+
+static bool __maybe_unused malloc_cache_contains(struct malloc_cache_mag *mag,
+						 void *buf)
+{
+	size_t n = 0;
+
+	for (n = 0; n < mag->count; n++)
+		if (mag->bufs[n] == buf)
+			return true;
+
+	return false;
+}
+
+/* Returns NULL if the allocation isn't served by the cache */
+static void *malloc_cache_get(uint32_t flags, void *ptr, size_t alignment,
+			      size_t nmemb, size_t size)
+{
+	struct malloc_cache_mag *mag = NULL;
+	struct malloc_cache *cache = NULL;
+	uint32_t exceptions = 0;
+	void *p = NULL;
+	size_t s = 0;
+	int idx = 0;
+
+	if (ptr || !malloc_cache_enabled(flags, alignment))
+		return NULL;
+	if (MUL_OVERFLOW(nmemb, size, &s))
+		return NULL;
+	idx = malloc_cache_alloc_idx(s);
+	if (idx < 0)
+		return NULL;
+
+	exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+	cache = malloc_cache + get_core_pos();
+	mag = cache->mags + idx;
+	cpu_spin_lock(&cache->lock);
+
+	if (mag->count) {
+		cache->hits++;
+	} else {
+		cache->misses++;
+		malloc_cache_refill(cache, mag, malloc_cache_sizes[idx]);
+	}
+
+	if (mag->count) {
+		mag->count--;
+		p = mag->bufs[mag->count];
+		cache->bytes -= malloc_cache_buf_size(p);
+	}
+
+	cpu_spin_unlock(&cache->lock);
+	thread_unmask_exceptions(exceptions);
+
+	if (!p)
+		return NULL;
+
+	if (flags & MAF_ZERO_INIT)
+		memset_unchecked(p, 0, s);
+
+	return maybe_tag_buf(p, 0, s);
+}
+
+/* Returns true if @ptr was put in the cache instead of freed */
+static bool malloc_cache_put(uint32_t flags, void *ptr)
+{
+	struct malloc_cache_mag *mag = NULL;
+	struct malloc_cache *cache = NULL;
+	uint32_t exceptions = 0;
+	size_t bsize = 0;
+	int idx = 0;
+
+	if (!ptr || (flags & MAF_FREE_WIPE) ||
+	    !malloc_cache_enabled(flags, 1))
+		return false;
+
+	bsize = bget_buf_size(strip_tag(ptr));
+	idx = malloc_cache_free_idx(bsize);
+	if (idx < 0)
+		return false;
+
+	ptr = strip_tag(maybe_untag_buf(ptr));
+
+	exceptions = thread_mask_exceptions(THREAD_EXCP_ALL);
+	cache = malloc_cache + get_core_pos();
+	mag = cache->mags + idx;
+	cpu_spin_lock(&cache->lock);
+
+	assert(!malloc_cache_contains(mag, ptr));
+	if (mag->count == MALLOC_CACHE_MAG_SIZE)
+		malloc_cache_flush(cache, mag,
+				   MALLOC_CACHE_MAG_SIZE - MALLOC_CACHE_BATCH);
+	mag->bufs[mag->count] = ptr;
+	mag->count++;
+	cache->bytes += malloc_cache_buf_size(ptr);
+
+	cpu_spin_unlock(&cache->lock);
+	thread_unmask_exceptions(exceptions);
+
+	return true;
+}
+
+static size_t __maybe_unused malloc_cache_bytes(void)
+{
+	size_t bytes = 0;
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(malloc_cache); n++)
+		bytes += malloc_cache[n].bytes;
+
+	return bytes;
+}
+
+#ifdef BufStats
+/* Counters at the last malloc_get_cache_stats(), protected by the heap lock */
+static struct malloc_cache_stats malloc_cache_stats_base;
+
+void malloc_get_cache_stats(struct malloc_cache_stats *stats)
+{
+	struct malloc_cache_stats cur = { };
+	uint32_t exceptions = 0;
+	size_t n = 0;
+
+	for (n = 0; n < ARRAY_SIZE(malloc_cache); n++) {
+		cur.hits += malloc_cache[n].hits;
+		cur.misses += malloc_cache[n].misses;
+		cur.flushes += malloc_cache[n].flushes;
+	}
+
+	exceptions = malloc_lock(&malloc_ctx);
+	stats->hits = cur.hits - malloc_cache_stats_base.hits;
+	stats->misses = cur.misses - malloc_cache_stats_base.misses;
+	stats->flushes = cur.flushes - malloc_cache_stats_base.flushes;
+	malloc_cache_stats_base = cur;
+	malloc_unlock(&malloc_ctx, exceptions);
+
+	stats->bytes = malloc_cache_bytes();
+}
+#endif /*BufStats*/
+
+#else /*__KERNEL__ && CFG_CORE_MALLOC_CACHE*/
+
+static void *malloc_cache_get(uint32_t flags __unused, void *ptr __unused,
+			      size_t alignment __unused, size_t nmemb __unused,
+			      size_t size __unused)
+{
+	return NULL;
+}
+
+static bool malloc_cache_put(uint32_t flags __unused, void *ptr __unused)
+{
+	return false;
+}
+
+static size_t __maybe_unused malloc_cache_bytes(void)
+{
+	return 0;
+}
+
+#endif /*__KERNEL__ && CFG_CORE_MALLOC_CACHE*/
+
 static void *mem_alloc(uint32_t flags, void *ptr, size_t alignment,
 		       size_t nmemb, size_t size, const char *fname, int lineno)
 {
@@ -612,11 +940,23 @@ static void *mem_alloc(uint32_t flags, void *ptr, size_t alignment,
 	uint32_t exceptions = 0;
 	void *p = NULL;
 
+	p = malloc_cache_get(flags, ptr, alignment, nmemb, size);
+	if (p)
+		return p;
+
 	exceptions = malloc_lock(ctx);
 	p = mem_alloc_unlocked(flags, ptr, alignment, nmemb, size, fname,
 			       lineno, ctx);
 	malloc_unlock(ctx, exceptions);
 
+	/* The memory may be held in the per-core caches, retry once */
+	if (!p && ctx == &malloc_ctx && malloc_flush_caches()) {
+		exceptions = malloc_lock(ctx);
+		p = mem_alloc_unlocked(flags, ptr, alignment, nmemb, size,
+				       fname, lineno, ctx);
+		malloc_unlock(ctx, exceptions);
+	}
+
 	return p;
 }
 
@@ -625,6 +965,9 @@ void free_flags(uint32_t flags, void *ptr)
 	struct malloc_ctx *ctx = get_ctx(flags);
 	uint32_t exceptions = 0;
 
+	if (malloc_cache_put(flags, ptr))
+		return;
+
 	exceptions = malloc_lock(ctx);
 
 	if (IS_ENABLED2(ENABLE_MDBG) && ptr) {
@@ -80,10 +80,48 @@ bool malloc_buffer_overlaps_heap(void *buf, size_t len);
  */
 void malloc_add_pool(void *buf, size_t len);
 
+#if defined(__KERNEL__) && defined(CFG_CORE_MALLOC_CACHE)
+/*
+ * Gives the buffers held in the per-core caches back to the heap. Returns
+ * true if any buffer was given back.
+ */
+bool malloc_flush_caches(void);
+#else
+static inline bool malloc_flush_caches(void)
+{
+	return false;
+}
+#endif
+
 #ifdef CFG_WITH_STATS
 /* Get/reset allocation statistics */
 void malloc_get_stats(struct pta_stats_alloc *stats);
 void malloc_reset_stats(void);
+
+/*
+ * struct malloc_cache_stats - Statistics of the per-core small buffer caches
+ * @hits:	Allocations served from a cache since last call
+ * @misses:	Allocations which found their cache empty since last call
+ * @flushes:	Full caches drained back to the heap since last call
+ * @bytes:	Bytes currently held in the caches
+ */
+struct malloc_cache_stats {
+	size_t hits;
+	size_t misses;
+	size_t flushes;
+	size_t bytes;
+};
+
+#if defined(__KERNEL__) && defined(CFG_CORE_MALLOC_CACHE)
+/* Get statistics of the caches and reset the counters */
+void malloc_get_cache_stats(struct malloc_cache_stats *stats);
+#else
+static inline void
+malloc_get_cache_stats(struct malloc_cache_stats *stats)
+{
+	*stats = (struct malloc_cache_stats){ };
+}
+#endif
 #endif /* CFG_WITH_STATS */
 
 #ifdef CFG_NS_VIRTUALIZATION
@@ -42,5 +42,10 @@
  */
 #define MAF_GUARD_HEAD	0x40
 #define MAF_GUARD_TAIL	0x80
+/*
+ * Used by tee_mm_init() to indicate that the pool should find free space
+ * with segregated free lists instead of a first-fit search.
+ */
+#define MAF_SEG_FIT	0x100
 
 #endif /*__MALLOC_FLAGS_H*/
@@ -158,6 +158,13 @@ CFG_REE_FS ?= y
 # REE FS content.
 CFG_REE_FS_HTREE_HASH_SIZE_COMPAT ?= y
 
+# CFG_REE_FS_BLOCK_CACHE_SIZE is the maximal number of decrypted data
+# blocks of REE FS files kept in a cache shared by all files. Blocks
+# following a block that is read sequentially are read ahead into the
+# cache, up to 8 at a time. Each block takes 4 KiB of core heap when
+# cached, 0 disables the cache.
+CFG_REE_FS_BLOCK_CACHE_SIZE ?= 4
+
 # RPMB file system support
 CFG_RPMB_FS ?= n
 
@@ -371,6 +378,23 @@ _CFG_TA_STACK_PROTECTOR := $(call cfg-one-enabled, CFG_TA_STACK_PROTECTOR \
 # Load user TAs from the REE filesystem via tee-supplicant
 CFG_REE_FS_TA ?= y
 
+# When CFG_REE_FS_TA_CACHE=y:
+# Keep the authenticated binaries of recently used TAs from the REE
+# filesystem in secure memory after the last instance of the TA has exited.
+# The signed header of a TA opened again is still loaded from tee-supplicant
+# and verified, if the signed hash matches the cached binary the decryption
+# and hashing of the binary are skipped. A TA updated in the REE filesystem
+# has another hash and replaces the cached binary. The read-only pages
+# shared by the instances of a TA are kept while its binary is cached. The
+# binaries are evicted least recently used first when
+# CFG_REE_FS_TA_CACHE_SIZE bytes are exceeded or when TA memory runs out.
+# Enables CFG_REE_FS_TA_BUFFERED.
+CFG_REE_FS_TA_CACHE ?= n
+CFG_REE_FS_TA_CACHE_SIZE ?= 1048576
+ifeq ($(CFG_REE_FS_TA_CACHE),y)
+$(call force,CFG_REE_FS_TA_BUFFERED,y,required by CFG_REE_FS_TA_CACHE)
+endif
+
 # Pre-authentication of TA binaries loaded from the REE filesystem
 #
 # - If CFG_REE_FS_TA_BUFFERED=y: load TA binary into a temporary buffer in the
@@ -380,6 +404,7 @@ CFG_REE_FS_TA ?= y
 #   signature as a last step.
 CFG_REE_FS_TA_BUFFERED ?= n
 $(eval $(call cfg-depends-all,CFG_REE_FS_TA_BUFFERED,CFG_REE_FS_TA))
+$(eval $(call cfg-depends-all,CFG_REE_FS_TA_CACHE,CFG_REE_FS_TA_BUFFERED))
 
 # When CFG_REE_FS=y:
 # Allow secure storage in the REE FS to be entirely deleted without causing
@@ -460,6 +485,49 @@ CFG_CORE_PAGE_TAG_AND_IV ?= $(CFG_PAGED_USER_TA)
 CFG_LOCKDEP ?= n
 CFG_LOCKDEP_RECORD_STACK ?= y
 
+# CFG_CORE_MUTEX_ADAPTIVE, when enabled, makes a thread trying to lock a
+# mutex held by a thread executing on another core spin up to
+# CFG_CORE_MUTEX_SPIN_LOOPS times waiting for it to be unlocked before
+# sleeping in normal world. This saves the RPCs to sleep and to be woken
+# up when the mutex is only held for a short time. With
+# CFG_CORE_LOCK_PROF=y the lock sites also count the locks acquired by
+# spinning and the sleeps in normal world.
+CFG_CORE_MUTEX_ADAPTIVE ?= n
+CFG_CORE_MUTEX_SPIN_LOOPS ?= 1000
+
+# CFG_CORE_LOCK_PROF, when enabled, records per lock site (source location
+# of mutex_lock() and cpu_spin_lock() calls) how many times a lock was
+# taken, how often and for how long it had to be waited for, how often a
+# mutex was acquired by spinning or waited for in normal world, and the
+# longest time it was held. With CFG_WITH_STATS=y the statistics are
+# retrieved with the STATS_CMD_LOCK_PROF_STATS command of the stats pseudo
+# TA, for instance with scripts/lock_prof.py.
+# Expect a performance impact when enabling this.
+CFG_CORE_LOCK_PROF ?= n
+
+ifeq ($(CFG_CORE_LOCK_PROF),y)
+$(call force,CFG_MUTEX_DEBUG,y,required by CFG_CORE_LOCK_PROF)
+endif
+
+ifeq (y-y,$(CFG_CORE_LOCK_PROF)-$(CFG_WITH_PAGER))
+$(error CFG_CORE_LOCK_PROF and CFG_WITH_PAGER are not compatible)
+endif
+
+# CFG_CORE_INITCALL_PROF, when enabled, records the time spent in each
+# initcall and DT driver probe during boot, up to
+# CFG_CORE_INITCALL_PROF_RECS records. With CFG_WITH_STATS=y the records
+# are retrieved with the STATS_CMD_BOOT_PROF_STATS command of the stats
+# pseudo TA. With CFG_NS_VIRTUALIZATION=y only the nexus boot is recorded.
+# CFG_CORE_INITCALL_PROF_PRINT, when enabled, prints the records at info
+# level after each round of initcalls, followed by the total time spent
+# in each initcall level.
+CFG_CORE_INITCALL_PROF_PRINT ?= n
+ifeq ($(CFG_CORE_INITCALL_PROF_PRINT),y)
+$(call force,CFG_CORE_INITCALL_PROF,y,required by CFG_CORE_INITCALL_PROF_PRINT)
+endif
+CFG_CORE_INITCALL_PROF ?= n
+CFG_CORE_INITCALL_PROF_RECS ?= 256
+
 # BestFit algorithm in bget reduces the fragmentation of the heap when running
 # with the pager enabled or lockdep
 CFG_CORE_BGET_BESTFIT ?= $(call cfg-one-enabled, CFG_WITH_PAGER CFG_LOCKDEP)
@@ -772,6 +840,20 @@ CFG_CRYPTOLIB_DIR ?= core/lib/libtomcrypt
 # that would set = n.
 $(call force,CFG_CORE_MBEDTLS_MPI,y)
 
+# CFG_CORE_MPI_MEMPOOL_SLOTS is the number of threads that can do Big
+# Number computations from the statically allocated scratch memory pool
+# at the same time, each slot takes 46 KiB. Threads finding all slots busy
+# wait for one to become idle. The default, 1, keeps the memory footprint
+# of a single scratch pool. 0 gives one slot per thread that can run at the
+# same time, that is MIN(CFG_NUM_THREADS, CFG_TEE_CORE_NB_CORE).
+CFG_CORE_MPI_MEMPOOL_SLOTS ?= 1
+
+# When enabled, CFG_CORE_MEMPOOL_HEAP_FALLBACK lets threads finding all
+# slots of a core memory pool busy, or their slot exhausted, allocate from
+# the heap instead of waiting. This trades heap memory, up to a full slot
+# per thread, for parallelism.
+CFG_CORE_MEMPOOL_HEAP_FALLBACK ?= n
+
 # When enabled, CFG_NS_VIRTUALIZATION embeds support for virtualization in
 # the non-secure world. OP-TEE will not work without a compatible hypervisor
 # in the non-secure world if this option is enabled.
@@ -1162,6 +1244,18 @@ ifeq (y-y,$(CFG_CORE_PREALLOC_EL0_TBLS)-$(CFG_WITH_PAGER))
 $(error "CFG_WITH_PAGER can't support CFG_CORE_PREALLOC_EL0_TBLS")
 endif
 
+# CFG_PHYS_MEM_SEG_FIT, when enabled, makes the core and TA physical memory
+# pools find free space using segregated free lists of the gaps between
+# allocations instead of a first-fit walk of all allocations. This keeps
+# allocation time low with many TAs loaded and fragmented TA memory.
+CFG_PHYS_MEM_SEG_FIT ?= n
+
+# CFG_CORE_MALLOC_CACHE, when enabled, puts per-core caches of small free
+# buffers (up to 256 bytes) in front of the core heap. Most small
+# allocations and frees are then served without taking the heap lock, at
+# the cost of a few KiB of heap per core kept in the caches.
+CFG_CORE_MALLOC_CACHE ?= n
+
 # CFG_PGT_CACHE_ENTRIES defines the number of entries on the memory
 # mapping page table cache used for Trusted Application mapping.
 # CFG_PGT_CACHE_ENTRIES is ignored when CFG_CORE_PREALLOC_EL0_TBLS
@@ -1310,6 +1404,21 @@ CFG_FFA_CONSOLE ?= n
 CFG_CONSOLE_RUNTIME_SET ?= n
 CFG_CONSOLE_RUNTIME_LOG_LEVEL ?= 0
 
+# CFG_CORE_TRACE_RING, when enabled, makes core trace messages go through a
+# lock-free ring buffer of CFG_CORE_TRACE_RING_SIZE bytes per core instead
+# of waiting for the console. The rings are written to the console by any
+# core finding it idle, by threads returning to normal world and when
+# panicking. Messages not fitting in a ring are dropped and counted.
+CFG_CORE_TRACE_RING ?= n
+CFG_CORE_TRACE_RING_SIZE ?= 4096
+
+# CFG_CORE_BINARY_TRACE, when enabled, adds a pseudo TA letting a normal
+# world daemon register a shared memory ring where core trace messages are
+# logged as binary records (format string address and arguments) instead
+# of being formatted as text. Error messages are still printed on the
+# console. The records are decoded with scripts/bin_trace_decode.py.
+CFG_CORE_BINARY_TRACE ?= n
+
 # CFG_CORE_UNSAFE_MODEXP, when enabled, makes modular exponentiation on TEE
 # core use 'unsafe' algorithm having better performance. To resist against
 # timing attacks, 'safe' one is designed to take constant-time that is
@@ -0,0 +1,185 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-2-Clause
+#
+# Copyright (c) 2026, Linaro Limited
+#
+# Converts binary trace records logged by the TEE core with
+# CFG_CORE_BINARY_TRACE=y to text. The input file holds the records read
+# from the ring registered with the binary trace pseudo TA, in order, as
+# described by struct pta_bin_trace_rec in
+# lib/libutee/include/pta_bin_trace.h.
+# Format strings and function names are read from the tee.elf of the
+# running TEE core.
+
+import argparse
+import re
+import struct
+import sys
+import uuid
+try:
+    from elftools.elf.elffile import ELFFile
+except ImportError:
+    print("""
+***
+Can't find elftools module. Probably it is not installed on your system.
+You can install this module with
+
+$ apt install python3-pyelftools
+
+if you are using Ubuntu. Or try to search for "pyelftools" or "elftools" in
+your package manager if you are using some other distribution.
+***
+""")
+    raise
+
+REC_HDR = struct.Struct('<HBBHHIIQQQ')
+REC_MSG = 0
+REC_PAD = 1
+NO_THREAD = 0xffff
+LEVELS = 'MEIDF'
+
+# Same conversions as the encoder in core/pta/bin_trace.c
+CONV_RE = re.compile(r'%([ #\-+0]*)(\*|\d+)?(?:\.(\*|\d*))?'
+                     r'(hh|h|ll|l|j|q|z|t)?(pUl|[%cdDiouOUxXps])')
+
+
+def get_args():
+    parser = argparse.ArgumentParser(
+        description='Converts binary trace records of the TEE core to text')
+
+    parser.add_argument('--elf', required=True,
+                        help='The tee.elf matching the running TEE core')
+    parser.add_argument('--freq', type=int, default=0,
+                        help='Timestamp frequency in Hz (cntfrq field of '
+                             'the ring), timestamps are printed as raw '
+                             'counter values if not given')
+    parser.add_argument('input', nargs='?', default='-',
+                        help='File with the records, default stdin')
+
+    return parser.parse_args()
+
+
+class ElfStrings:
+    def __init__(self, path):
+        self.segments = []
+        with open(path, 'rb') as f:
+            elf = ELFFile(f)
+            for seg in elf.iter_segments():
+                if seg['p_type'] == 'PT_LOAD':
+                    self.segments.append((seg['p_vaddr'], seg.data()))
+
+    def get(self, addr):
+        for vaddr, data in self.segments:
+            if vaddr <= addr < vaddr + len(data):
+                offs = addr - vaddr
+                end = data.find(b'\0', offs)
+                if end < 0:
+                    end = len(data)
+                return data[offs:end].decode(errors='replace')
+        return f'<unknown format 0x{addr:x}>'
+
+
+class Args:
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def word(self):
+        if self.pos + 8 > len(self.data):
+            raise ValueError('truncated record')
+        v = struct.unpack_from('<Q', self.data, self.pos)[0]
+        self.pos += 8
+        return v
+
+    def signed(self):
+        v = self.word()
+        return v - (1 << 64) if v & (1 << 63) else v
+
+    def raw(self, size):
+        v = self.data[self.pos:self.pos + size]
+        self.pos += (size + 7) & ~7
+        return v
+
+
+def format_msg(fmt, args):
+    def conv(m):
+        flags, width, prec, _, c = m.groups()
+        if c == '%':
+            return '%'
+        if width == '*':
+            w = args.signed()
+            if w < 0:
+                flags += '-'
+            width = str(abs(w))
+        if prec == '*':
+            prec = str(max(args.signed(), 0))
+        spec = '%' + flags + (width or '')
+        if prec is not None:
+            spec += '.' + (prec or '0')
+
+        if c in 'dDi':
+            return (spec + 'd') % args.signed()
+        if c in 'uU':
+            return (spec + 'd') % args.word()
+        if c in 'oO':
+            return (spec + 'o') % args.word()
+        if c in 'xX':
+            return (spec + c) % args.word()
+        if c == 'c':
+            return (spec + 'c') % chr(args.word())
+        if c == 's':
+            s = args.raw(args.word()).decode(errors='replace')
+            return (spec + 's') % s
+        if c == 'pUl':
+            return str(uuid.UUID(bytes_le=bytes(args.raw(16))))
+        return (spec + 's') % f'0x{args.word():x}'
+
+    return CONV_RE.sub(conv, fmt).rstrip('\n')
+
+
+def format_time(ts, freq):
+    if not freq:
+        return f'{ts:>16}'
+    return f'{ts / freq:16.6f}'
+
+
+def decode(data, strings, freq):
+    pos = 0
+    while pos + 8 <= len(data):
+        size, rec_type = struct.unpack_from('<HB', data, pos)
+        if size < 8 or size & 7 or pos + size > len(data):
+            print(f'Bad record at offset {pos}', file=sys.stderr)
+            return 1
+        if rec_type == REC_MSG:
+            (_, _, level, core, thread, line, _, ts, fmt,
+             func) = REC_HDR.unpack_from(data, pos)
+            args = Args(data[pos + REC_HDR.size:pos + size])
+            try:
+                msg = format_msg(strings.get(fmt), args)
+            except (ValueError, TypeError, OverflowError) as e:
+                msg = f'<bad arguments: {e}>'
+            lvl = LEVELS[level] if level < len(LEVELS) else '?'
+            thr = '-' if thread == NO_THREAD else str(thread)
+            where = f'{strings.get(func)}:{line} ' if func else ''
+            print(f'[{format_time(ts, freq)}] {lvl}/TC:{core} {thr} ' +
+                  where + msg)
+        pos += size
+
+    return 0
+
+
+def main():
+    args = get_args()
+    strings = ElfStrings(args.elf)
+
+    if args.input == '-':
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.input, 'rb') as f:
+            data = f.read()
+
+    sys.exit(decode(data, strings, args.freq))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,179 @@
+#!/usr/bin/env python3
+# SPDX-License-Identifier: BSD-2-Clause
+#
+# Copyright (c) 2026, Linaro Limited
+#
+# Prints the lock contention statistics recorded by a TEE core built with
+# CFG_CORE_LOCK_PROF=y and CFG_WITH_STATS=y. Runs in normal world and
+# retrieves the statistics with the STATS_CMD_LOCK_PROF_STATS command of
+# the stats pseudo TA through libteec, see struct pta_stats_lock_site in
+# lib/libutee/include/pta_stats.h.
+
+import argparse
+import ctypes
+import struct
+import sys
+
+STATS_UUID = (0xd96a5b40, 0xe2c7, 0xb1af,
+              (0x87, 0x94, 0x10, 0x02, 0xa5, 0xd5, 0xc6, 0x1b))
+STATS_CMD_LOCK_PROF_STATS = 10
+
+TEEC_SUCCESS = 0
+TEEC_ERROR_SHORT_BUFFER = 0xffff0010
+TEEC_LOGIN_PUBLIC = 0
+TEEC_VALUE_INPUT = 1
+TEEC_MEMREF_TEMP_OUTPUT = 6
+
+SITE = struct.Struct('<40sIIIIIIQQ')
+LOCK_TYPES = {0: 'mutex', 1: 'spin'}
+
+SORT_KEYS = {
+    'wait': lambda s: s['wait_us'],
+    'contended': lambda s: s['contended'],
+    'acquired': lambda s: s['acquired'],
+    'sleeps': lambda s: s['sleeps'],
+    'hold': lambda s: s['max_hold_us'],
+}
+
+
+class TEEC_UUID(ctypes.Structure):
+    _fields_ = [('timeLow', ctypes.c_uint32),
+                ('timeMid', ctypes.c_uint16),
+                ('timeHiAndVersion', ctypes.c_uint16),
+                ('clockSeqAndNode', ctypes.c_uint8 * 8)]
+
+
+class TEEC_TempMemoryReference(ctypes.Structure):
+    _fields_ = [('buffer', ctypes.c_void_p),
+                ('size', ctypes.c_size_t)]
+
+
+class TEEC_Value(ctypes.Structure):
+    _fields_ = [('a', ctypes.c_uint32),
+                ('b', ctypes.c_uint32)]
+
+
+class TEEC_Parameter(ctypes.Union):
+    # The largest member, TEEC_RegisteredMemoryReference, is three words
+    _fields_ = [('tmpref', TEEC_TempMemoryReference),
+                ('value', TEEC_Value),
+                ('pad', ctypes.c_void_p * 3)]
+
+
+class TEEC_Operation(ctypes.Structure):
+    _fields_ = [('started', ctypes.c_uint32),
+                ('paramTypes', ctypes.c_uint32),
+                ('params', TEEC_Parameter * 4),
+                ('session', ctypes.c_void_p)]
+
+
+def param_types(t0, t1=0, t2=0, t3=0):
+    return t0 | t1 << 4 | t2 << 8 | t3 << 12
+
+
+def get_args():
+    parser = argparse.ArgumentParser(
+        description='Prints lock contention statistics of the TEE core')
+
+    parser.add_argument('--reset', action='store_true',
+                        help='Reset the statistics once read')
+    parser.add_argument('--sort', choices=SORT_KEYS.keys(), default='wait',
+                        help='Sort lock sites by this field, default wait')
+    parser.add_argument('--lib', default='libteec.so.2',
+                        help='TEE client library, default libteec.so.2')
+
+    return parser.parse_args()
+
+
+class Tee:
+    # TEEC_Context and TEEC_Session are opaque here, allocate plenty
+    CTX_SIZE = 256
+
+    def __init__(self, lib):
+        self.lib = ctypes.CDLL(lib)
+        self.ctx = ctypes.create_string_buffer(self.CTX_SIZE)
+        self.sess = ctypes.create_string_buffer(self.CTX_SIZE)
+        self.check(self.lib.TEEC_InitializeContext(None, self.ctx),
+                   'TEEC_InitializeContext')
+
+        uuid = TEEC_UUID(STATS_UUID[0], STATS_UUID[1], STATS_UUID[2],
+                         (ctypes.c_uint8 * 8)(*STATS_UUID[3]))
+        origin = ctypes.c_uint32()
+        res = self.lib.TEEC_OpenSession(self.ctx, self.sess,
+                                        ctypes.byref(uuid),
+                                        TEEC_LOGIN_PUBLIC, None, None,
+                                        ctypes.byref(origin))
+        if res != TEEC_SUCCESS:
+            self.lib.TEEC_FinalizeContext(self.ctx)
+        self.check(res, 'TEEC_OpenSession')
+
+    @staticmethod
+    def check(res, what):
+        res &= 0xffffffff
+        if res != TEEC_SUCCESS:
+            sys.exit(f'{what} failed: 0x{res:08x}')
+
+    def close(self):
+        self.lib.TEEC_CloseSession(self.sess)
+        self.lib.TEEC_FinalizeContext(self.ctx)
+
+    def get_sites(self, reset):
+        size = 64 * SITE.size
+        while True:
+            buf = ctypes.create_string_buffer(size)
+            op = TEEC_Operation()
+            op.paramTypes = param_types(TEEC_VALUE_INPUT,
+                                        TEEC_MEMREF_TEMP_OUTPUT)
+            op.params[0].value.a = int(reset)
+            op.params[1].tmpref.buffer = ctypes.cast(buf, ctypes.c_void_p)
+            op.params[1].tmpref.size = size
+            origin = ctypes.c_uint32()
+            res = self.lib.TEEC_InvokeCommand(self.sess,
+                                              STATS_CMD_LOCK_PROF_STATS,
+                                              ctypes.byref(op),
+                                              ctypes.byref(origin))
+            res &= 0xffffffff
+            if res == TEEC_ERROR_SHORT_BUFFER:
+                # More sites may show up before the next try
+                size = op.params[1].tmpref.size + 16 * SITE.size
+                continue
+            self.check(res, 'STATS_CMD_LOCK_PROF_STATS')
+            data = buf.raw[:op.params[1].tmpref.size]
+            return [parse_site(data, offs)
+                    for offs in range(0, len(data), SITE.size)]
+
+
+def parse_site(data, offs):
+    (file, line, lock_type, acquired, contended, spin_acquired, sleeps,
+     wait_us, max_hold_us) = SITE.unpack_from(data, offs)
+    file = file.split(b'\0')[0].decode(errors='replace')
+    return {
+        'site': f'{file}:{line}',
+        'type': LOCK_TYPES.get(lock_type, '?'),
+        'acquired': acquired,
+        'contended': contended,
+        'spin_acquired': spin_acquired,
+        'sleeps': sleeps,
+        'wait_us': wait_us,
+        'max_hold_us': max_hold_us,
+    }
+
+
+def main():
+    args = get_args()
+    tee = Tee(args.lib)
+    sites = tee.get_sites(args.reset)
+    tee.close()
+
+    sites.sort(key=SORT_KEYS[args.sort], reverse=True)
+    print(f'{"site":<46} {"type":<5} {"acquired":>10} {"contended":>10} '
+          f'{"spun":>8} {"sleeps":>8} {"wait us":>12} {"max hold us":>12}')
+    for s in sites:
+        print(f'{s["site"]:<46} {s["type"]:<5} {s["acquired"]:>10} '
+              f'{s["contended"]:>10} {s["spin_acquired"]:>8} '
+              f'{s["sleeps"]:>8} {s["wait_us"]:>12} '
+              f'{s["max_hold_us"]:>12}')
+
+
+if __name__ == "__main__":
+    main()
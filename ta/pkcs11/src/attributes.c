@@ -10,6 +10,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <string_ext.h>
+#include <sys/queue.h>
 #include <tee_internal_api.h>
 #include <trace.h>
 #include <util.h>
@@ -18,6 +19,132 @@
 #include "pkcs11_helpers.h"
 #include "serializer.h"
 
+/*
+ * Attributes are serialized one after the other, finding one means
+ * walking the list from its start. The attribute lists of objects are
+ * looked up a lot so they can be indexed: a table of their IDs, offsets
+ * and sizes sorted by ID, found from the address of the list. The index
+ * is rebuilt by the functions here adding or removing attributes and must
+ * be released with unindex_attributes() before the list is freed.
+ */
+#define ATTR_INDEX_BUCKETS	32
+
+struct attr_index_entry {
+	uint32_t id;
+	uint32_t offset;
+	uint32_t size;
+};
+
+struct attr_index {
+	LIST_ENTRY(attr_index) link;
+	struct obj_attrs *head;
+	uint32_t attrs_size;
+	uint32_t attrs_count;
+	struct attr_index_entry entries[];
+};
+
+static LIST_HEAD(attr_index_bucket, attr_index)
+	attr_indexes[ATTR_INDEX_BUCKETS];
+
+static struct attr_index_bucket *index_bucket(struct obj_attrs *head)
+{
+	uint32_t h = (uintptr_t)head >> 4;
+
+	return attr_indexes + (h * 0x9e3779b1U >> 16) % ATTR_INDEX_BUCKETS;
+}
+
+static struct attr_index *find_index(struct obj_attrs *head)
+{
+	struct attr_index *idx = NULL;
+
+	LIST_FOREACH(idx, index_bucket(head), link)
+		if (idx->head == head)
+			return idx;
+
+	return NULL;
+}
+
+void index_attributes(struct obj_attrs *head)
+{
+	struct attr_index_entry e = { };
+	struct attr_index *idx = NULL;
+	char *cur = (char *)head->attrs;
+	char *end = cur + head->attrs_size;
+	size_t next_off = 0;
+	size_t n = 0;
+	size_t m = 0;
+
+	unindex_attributes(head);
+
+	/* The index is an optimization, lookups work without it */
+	idx = TEE_Malloc(sizeof(*idx) + head->attrs_count * sizeof(e),
+			 TEE_MALLOC_FILL_ZERO);
+	if (!idx)
+		return;
+
+	for (; cur < end; cur += next_off, n++) {
+		struct pkcs11_attribute_head pkcs11_ref = { };
+
+		if (n == head->attrs_count)
+			goto err;
+
+		TEE_MemMove(&pkcs11_ref, cur, sizeof(pkcs11_ref));
+		next_off = sizeof(pkcs11_ref) + pkcs11_ref.size;
+
+		e.id = pkcs11_ref.id;
+		e.offset = cur - (char *)head->attrs;
+		e.size = pkcs11_ref.size;
+
+		/* Insertion sort, keeping duplicated IDs in list order */
+		for (m = n; m && idx->entries[m - 1].id > e.id; m--)
+			idx->entries[m] = idx->entries[m - 1];
+		idx->entries[m] = e;
+	}
+
+	if (cur != end || n != head->attrs_count)
+		goto err;
+
+	idx->head = head;
+	idx->attrs_size = head->attrs_size;
+	idx->attrs_count = head->attrs_count;
+	LIST_INSERT_HEAD(index_bucket(head), idx, link);
+	return;
+err:
+	DMSG("Can't index malformed attribute list");
+	TEE_Free(idx);
+}
+
+bool unindex_attributes(struct obj_attrs *head)
+{
+	struct attr_index *idx = find_index(head);
+
+	if (!idx)
+		return false;
+
+	LIST_REMOVE(idx, link);
+	TEE_Free(idx);
+	return true;
+}
+
+/* Returns the index of @head or NULL if the list has to be walked */
+static struct attr_index *get_index(struct obj_attrs *head)
+{
+	struct attr_index *idx = find_index(head);
+
+	if (!idx)
+		return NULL;
+
+	/* Modified behind our back or freed and reallocated */
+	if (idx->attrs_size != head->attrs_size ||
+	    idx->attrs_count != head->attrs_count) {
+		DMSG("Dropping stale attribute index");
+		unindex_attributes(head);
+		return NULL;
+	}
+
+	return idx;
+}
+
 enum pkcs11_rc init_attributes_head(struct obj_attrs **head)
 {
 	*head = TEE_Malloc(sizeof(**head), TEE_MALLOC_FILL_ZERO);
@@ -27,8 +154,9 @@ enum pkcs11_rc init_attributes_head(struct obj_attrs **head)
 	return PKCS11_CKR_OK;
 }
 
-enum pkcs11_rc add_attribute(struct obj_attrs **head, uint32_t attribute,
-			     void *data, size_t size)
+static enum pkcs11_rc _add_attribute(struct obj_attrs **head,
+				     uint32_t attribute, void *data,
+				     size_t size)
 {
 	size_t buf_len = sizeof(struct obj_attrs) + (*head)->attrs_size;
 	char **bstart = (void *)head;
@@ -57,6 +185,20 @@ enum pkcs11_rc add_attribute(struct obj_attrs **head, uint32_t attribute,
 	return rc;
 }
 
+enum pkcs11_rc add_attribute(struct obj_attrs **head, uint32_t attribute,
+			     void *data, size_t size)
+{
+	bool indexed = unindex_attributes(*head);
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+
+	rc = _add_attribute(head, attribute, data, size);
+
+	if (indexed)
+		index_attributes(*head);
+
+	return rc;
+}
+
 static enum pkcs11_rc _remove_attribute(struct obj_attrs **head,
 					uint32_t attribute, bool empty)
 {
@@ -97,7 +239,61 @@ static enum pkcs11_rc _remove_attribute(struct obj_attrs **head,
 enum pkcs11_rc remove_empty_attribute(struct obj_attrs **head,
 				      uint32_t attribute)
 {
-	return _remove_attribute(head, attribute, true /* empty */);
+	bool indexed = unindex_attributes(*head);
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+
+	rc = _remove_attribute(head, attribute, true /* empty */);
+
+	if (indexed)
+		index_attributes(*head);
+
+	return rc;
+}
+
+static void get_indexed_attribute_ptrs(struct obj_attrs *head,
+				       struct attr_index *idx,
+				       uint32_t attribute, void **attr,
+				       uint32_t *attr_size, size_t *count)
+{
+	struct attr_index_entry *e = NULL;
+	size_t max_found = *count;
+	size_t found = 0;
+	size_t lo = 0;
+	size_t hi = idx->attrs_count;
+	size_t mid = 0;
+
+	/* Lower bound of @attribute */
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (idx->entries[mid].id < attribute)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	for (e = idx->entries + lo;
+	     e < idx->entries + idx->attrs_count && e->id == attribute; e++) {
+		found++;
+
+		if (!max_found)
+			continue;	/* only count matching attributes */
+
+		if (attr) {
+			if (e->size)
+				*attr++ = head->attrs + e->offset +
+					  sizeof(struct pkcs11_attribute_head);
+			else
+				*attr++ = NULL;
+		}
+
+		if (attr_size)
+			*attr_size++ = e->size;
+
+		if (found == max_found)
+			break;
+	}
+
+	*count = found;
 }
 
 void get_attribute_ptrs(struct obj_attrs *head, uint32_t attribute,
@@ -110,6 +306,13 @@ void get_attribute_ptrs(struct obj_attrs *head, uint32_t attribute,
 	size_t found = 0;
 	void **attr_ptr = attr;
 	uint32_t *attr_size_ptr = attr_size;
+	struct attr_index *idx = get_index(head);
+
+	if (idx) {
+		get_indexed_attribute_ptrs(head, idx, attribute, attr,
+					   attr_size, count);
+		return;
+	}
 
 	for (; cur < end; cur += next_off) {
 		/* Structure aligned copy of the pkcs11_ref in the object */
@@ -191,8 +394,9 @@ enum pkcs11_rc get_attribute(struct obj_attrs *head, uint32_t attribute,
 	return PKCS11_CKR_OK;
 }
 
-enum pkcs11_rc set_attribute(struct obj_attrs **head, uint32_t attribute,
-			     void *data, size_t size)
+static enum pkcs11_rc _set_attribute(struct obj_attrs **head,
+				     uint32_t attribute, void *data,
+				     size_t size)
 {
 	enum pkcs11_rc rc = PKCS11_CKR_OK;
 
@@ -200,7 +404,21 @@ enum pkcs11_rc set_attribute(struct obj_attrs **head, uint32_t attribute,
 	if (rc != PKCS11_CKR_OK && rc != PKCS11_RV_NOT_FOUND)
 		return rc;
 
-	return add_attribute(head, attribute, data, size);
+	return _add_attribute(head, attribute, data, size);
+}
+
+enum pkcs11_rc set_attribute(struct obj_attrs **head, uint32_t attribute,
+			     void *data, size_t size)
+{
+	bool indexed = unindex_attributes(*head);
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+
+	rc = _set_attribute(head, attribute, data, size);
+
+	if (indexed)
+		index_attributes(*head);
+
+	return rc;
 }
 
 enum pkcs11_rc modify_attributes_list(struct obj_attrs **dst,
@@ -208,9 +426,11 @@ enum pkcs11_rc modify_attributes_list(struct obj_attrs **dst,
 {
 	char *cur = (char *)head + sizeof(struct obj_attrs);
 	char *end = cur + head->attrs_size;
+	bool indexed = unindex_attributes(*dst);
 	size_t len = 0;
 	enum pkcs11_rc rc = PKCS11_CKR_OK;
 
+	/* Reindex once when done instead of for each attribute */
 	for (; cur < end; cur += len) {
 		struct pkcs11_attribute_head *cli_ref = (void *)cur;
 		/* Structure aligned copy of the pkcs11_ref in the object */
@@ -219,14 +439,17 @@ enum pkcs11_rc modify_attributes_list(struct obj_attrs **dst,
 		TEE_MemMove(&cli_head, cur, sizeof(cli_head));
 		len = sizeof(cli_head) + cli_head.size;
 
-		rc = set_attribute(dst, cli_head.id,
-				   cli_head.size ? cli_ref->data : NULL,
-				   cli_head.size);
+		rc = _set_attribute(dst, cli_head.id,
+				    cli_head.size ? cli_ref->data : NULL,
+				    cli_head.size);
 		if (rc)
-			return rc;
+			break;
 	}
 
-	return PKCS11_CKR_OK;
+	if (indexed)
+		index_attributes(*dst);
+
+	return rc;
 }
 
 bool get_bool(struct obj_attrs *head, uint32_t attribute)
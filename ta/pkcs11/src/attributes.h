@@ -71,6 +71,27 @@ struct obj_attrs {
  */
 enum pkcs11_rc init_attributes_head(struct obj_attrs **head);
 
+/*
+ * index_attributes() - Index serialized attributes for faster lookups
+ * @head:	Pointer to serialized attributes
+ *
+ * The index follows @head through add_attribute(), set_attribute() and
+ * the other functions modifying the attribute list. It is meant for the
+ * attributes of objects which are looked up repeatedly, failing to
+ * allocate it only makes lookups slower.
+ */
+void index_attributes(struct obj_attrs *head);
+
+/*
+ * unindex_attributes() - Release the index of serialized attributes
+ * @head:	Pointer to serialized attributes
+ *
+ * Must be called before freeing attributes given to index_attributes().
+ *
+ * Return true if @head was indexed.
+ */
+bool unindex_attributes(struct obj_attrs *head);
+
 /*
  * add_attribute() - Update serialized attributes to add an entry.
  *
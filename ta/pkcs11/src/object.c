@@ -93,7 +93,10 @@ static void cleanup_volatile_obj_ref(struct pkcs11_object *obj)
 	if (obj->attribs_hdl != TEE_HANDLE_NULL)
 		TEE_CloseObject(obj->attribs_hdl);
 
+	if (obj->attributes)
+		unindex_attributes(obj->attributes);
 	TEE_Free(obj->attributes);
+	TEE_Free(obj->summary);
 	TEE_Free(obj->uuid);
 	TEE_Free(obj);
 }
@@ -183,6 +186,9 @@ static struct pkcs11_object *create_obj_instance(struct obj_attrs *head,
 	obj->attributes = head;
 	obj->token = token;
 
+	if (head)
+		index_attributes(head);
+
 	return obj;
 }
 
@@ -265,6 +271,10 @@ enum pkcs11_rc create_object(void *sess, struct obj_attrs *head,
 			goto err;
 		}
 
+		rc = set_persistent_object_summary(obj);
+		if (rc)
+			goto err;
+
 		rc = register_persistent_object(get_session_token(session),
 						obj->uuid);
 		if (rc)
@@ -287,6 +297,7 @@ enum pkcs11_rc create_object(void *sess, struct obj_attrs *head,
 	return PKCS11_CKR_OK;
 err:
 	/* make sure that supplied "head" isn't freed */
+	unindex_attributes(head);
 	obj->attributes = NULL;
 	handle_put(get_object_handle_db(session), obj_handle);
 	if (get_bool(head, PKCS11_CKA_TOKEN))
@@ -509,6 +520,7 @@ enum pkcs11_rc entry_find_objects_init(struct pkcs11_client *client,
 	struct pkcs11_object *obj = NULL;
 	struct pkcs11_find_objects *find_ctx = NULL;
 	struct handle_db *object_db = NULL;
+	bool private_ok = false;
 
 	if (!client || ptypes != exp_pt)
 		return PKCS11_CKR_ARGUMENTS_BAD;
@@ -601,12 +613,18 @@ enum pkcs11_rc entry_find_objects_init(struct pkcs11_client *client,
 	}
 
 	object_db = get_object_handle_db(session);
+	private_ok = !pkcs11_session_is_public(session) &&
+		     !pkcs11_session_is_so(session);
 
 	/* Scan token objects */
 	LIST_FOREACH(obj, &session->token->object_list, link) {
 		uint32_t handle = 0;
 		bool new_load = false;
 
+		/* Only load the objects which may match */
+		if (!persistent_object_may_match(obj, req_attrs, private_ok))
+			continue;
+
 		if (!obj->attributes) {
 			rc = load_persistent_object_attributes(obj);
 			if (rc) {
@@ -617,6 +635,11 @@ enum pkcs11_rc entry_find_objects_init(struct pkcs11_client *client,
 			new_load = true;
 		}
 
+		/* If it fails, the object is loaded again next search */
+		if (!obj->summary && obj->attributes &&
+		    set_persistent_object_summary(obj))
+			DMSG("Object summary not stored");
+
 		if (!obj->attributes ||
 		    check_access_attrs_against_token(session,
 						     obj->attributes) ||
@@ -1090,16 +1113,19 @@ enum pkcs11_rc entry_set_attribute_value(struct pkcs11_client *client,
 	head_old = obj->attributes;
 	obj->attributes = head_new;
 	head_new = NULL;
+	index_attributes(obj->attributes);
 
 	if (get_bool(obj->attributes, PKCS11_CKA_TOKEN)) {
 		rc = update_persistent_object_attributes(obj);
 		if (rc) {
+			unindex_attributes(obj->attributes);
 			TEE_Free(obj->attributes);
 			obj->attributes = head_old;
 			goto out;
 		}
 	}
 
+	unindex_attributes(head_old);
 	TEE_Free(head_old);
 
 	DMSG("PKCS11 session %"PRIu32": set attributes %#"PRIx32,
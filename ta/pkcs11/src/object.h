@@ -14,6 +14,7 @@ struct ck_token;
 struct obj_attrs;
 struct pkcs11_client;
 struct pkcs11_session;
+struct token_obj_summary;
 
 /*
  * link: objects are referenced in a double-linked list
@@ -23,6 +24,8 @@ struct pkcs11_session;
  * token: associated token for the object
  * uuid: object UUID in the persistent database if a persistent object, or NULL
  * attribs_hdl: GPD TEE attributes handles if persistent object
+ * summary: searchable attributes if persistent object, or NULL if unknown
+ * summary_slot: slot of @summary in the token summaries file
  */
 struct pkcs11_object {
 	LIST_ENTRY(pkcs11_object) link;
@@ -32,6 +35,8 @@ struct pkcs11_object {
 	struct ck_token *token;
 	TEE_UUID *uuid;
 	TEE_ObjectHandle attribs_hdl;
+	struct token_obj_summary *summary;
+	int summary_slot;
 };
 
 LIST_HEAD(object_list, pkcs11_object);
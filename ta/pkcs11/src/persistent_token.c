@@ -5,6 +5,7 @@
 
 #include <assert.h>
 #include <pkcs11_ta.h>
+#include <stdlib.h>
 #include <string.h>
 #include <string_ext.h>
 #include <tee_internal_api_extensions.h>
@@ -35,6 +36,17 @@ static TEE_Result get_db_file_name(struct ck_token *token,
 		return TEE_SUCCESS;
 }
 
+static TEE_Result get_summaries_file_name(struct ck_token *token,
+					  char *name, size_t size)
+{
+	int n = snprintf(name, size, "token.idx.%u", get_token_id(token));
+
+	if (n < 0 || (size_t)n >= size)
+		return TEE_ERROR_SECURITY;
+	else
+		return TEE_SUCCESS;
+}
+
 static TEE_Result open_db_file(struct ck_token *token,
 			       TEE_ObjectHandle *out_hdl)
 {
@@ -325,11 +337,24 @@ enum pkcs11_rc create_object_uuid(struct ck_token *token,
 	return PKCS11_CKR_OK;
 }
 
-void destroy_object_uuid(struct ck_token *token __maybe_unused,
-			 struct pkcs11_object *obj)
+static enum pkcs11_rc drop_persistent_object_summary(struct pkcs11_object *obj);
+
+void destroy_object_uuid(struct ck_token *token, struct pkcs11_object *obj)
 {
 	assert(get_persistent_obj_idx(token, obj->uuid) < 0);
 
+	/*
+	 * A slot left with the summary of an unregistered object is freed
+	 * when the token is loaded again, failing to clear it is harmless.
+	 */
+	if (obj->summary && drop_persistent_object_summary(obj)) {
+		DMSG("Failed to clear object summary slot %d",
+		     obj->summary_slot);
+		bit_clear(token->summary_slots, obj->summary_slot);
+		TEE_Free(obj->summary);
+		obj->summary = NULL;
+	}
+
 	TEE_Free(obj->uuid);
 	obj->uuid = NULL;
 }
@@ -350,6 +375,422 @@ enum pkcs11_rc get_persistent_objects_list(struct ck_token *token,
 	return PKCS11_CKR_OK;
 }
 
+/*
+ * Searching token objects used to load the attributes of each of them
+ * from secure storage. The class, key type, access flags and hashes of
+ * the label and ID of the objects are kept in memory and in a file next
+ * to the database, so searches only load the objects which may match.
+ *
+ * Each summary is stored in a fixed size slot of the file, so creating,
+ * modifying or destroying an object only rewrites its own slot. Freed
+ * slots are reused, the file is as large as the most summaries stored
+ * at once.
+ *
+ * A stored summary must never be older than the object attributes or
+ * matching objects would be missed. Objects without a summary are loaded
+ * when searched, so the slot of an object is cleared before changing its
+ * attributes. A slot holding the summary of an object which isn't
+ * registered is free.
+ */
+static uint32_t summary_hash(const void *data, size_t size)
+{
+	const uint8_t *p = data;
+	/* 32-bit FNV-1a, seeded with the size */
+	uint32_t h = 0x811c9dc5 ^ size;
+	size_t n = 0;
+
+	for (n = 0; n < size; n++)
+		h = (h ^ p[n]) * 0x01000193;
+
+	return h;
+}
+
+static void summarize_attributes(struct token_obj_summary *sum,
+				 struct obj_attrs *head)
+{
+	uint32_t size = 0;
+	void *val = NULL;
+
+	sum->class = get_class(head);
+	sum->key_type = get_key_type(head);
+	sum->flags = 0;
+	sum->label_hash = 0;
+	sum->id_hash = 0;
+
+	if (!get_attribute_ptr(head, PKCS11_CKA_KEY_TYPE, NULL, NULL))
+		sum->flags |= TOKEN_OBJ_HAS_KEY_TYPE;
+	if (object_is_private(head))
+		sum->flags |= TOKEN_OBJ_PRIVATE;
+	if (!get_attribute_ptr(head, PKCS11_CKA_LABEL, &val, &size)) {
+		sum->flags |= TOKEN_OBJ_HAS_LABEL;
+		sum->label_hash = summary_hash(val, size);
+	}
+	if (!get_attribute_ptr(head, PKCS11_CKA_ID, &val, &size)) {
+		sum->flags |= TOKEN_OBJ_HAS_ID;
+		sum->id_hash = summary_hash(val, size);
+	}
+}
+
+static TEE_Result open_summaries_file(struct ck_token *token,
+				      TEE_ObjectHandle *hdl)
+{
+	struct token_persistent_summaries head = {
+		.version = TOKEN_OBJ_SUMMARY_VERSION,
+	};
+	char file[PERSISTENT_OBJECT_ID_LEN] = { };
+	TEE_Result res = TEE_ERROR_GENERIC;
+
+	res = get_summaries_file_name(token, file, sizeof(file));
+	if (res)
+		return res;
+
+	res = TEE_OpenPersistentObject(TEE_STORAGE_PRIVATE, file, sizeof(file),
+				       TEE_DATA_FLAG_ACCESS_WRITE, hdl);
+	if (res != TEE_ERROR_ITEM_NOT_FOUND)
+		return res;
+
+	return TEE_CreatePersistentObject(TEE_STORAGE_PRIVATE,
+					  file, sizeof(file),
+					  TEE_DATA_FLAG_ACCESS_WRITE,
+					  TEE_HANDLE_NULL, &head, sizeof(head),
+					  hdl);
+}
+
+static enum pkcs11_rc write_summary_slot(struct ck_token *token, int slot,
+					 const struct token_obj_summary *sum)
+{
+	TEE_ObjectHandle hdl = TEE_HANDLE_NULL;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	size_t offs = 0;
+
+	res = open_summaries_file(token, &hdl);
+	if (res)
+		goto out;
+
+	offs = sizeof(struct token_persistent_summaries) + slot * sizeof(*sum);
+	res = TEE_SeekObjectData(hdl, offs, TEE_DATA_SEEK_SET);
+	if (res)
+		goto out;
+
+	res = TEE_WriteObjectData(hdl, sum, sizeof(*sum));
+out:
+	if (res)
+		EMSG("Failed to write object summary: %#"PRIx32, res);
+	TEE_CloseObject(hdl);
+
+	return tee2pkcs_error(res);
+}
+
+static enum pkcs11_rc alloc_summary_slot(struct ck_token *token, int *slot)
+{
+	int count = token->summary_slot_count;
+	bitstr_t *slots = NULL;
+	int idx = -1;
+
+	bit_ffc(token->summary_slots, count, &idx);
+	if (idx < 0) {
+		slots = TEE_Realloc(token->summary_slots,
+				    bitstr_size(count + 1));
+		if (!slots)
+			return PKCS11_CKR_DEVICE_MEMORY;
+
+		bit_clear(slots, count);
+		token->summary_slots = slots;
+		token->summary_slot_count++;
+		idx = count;
+	}
+
+	bit_set(token->summary_slots, idx);
+	*slot = idx;
+
+	return PKCS11_CKR_OK;
+}
+
+enum pkcs11_rc set_persistent_object_summary(struct pkcs11_object *obj)
+{
+	struct ck_token *token = obj->token;
+	struct token_obj_summary *sum = NULL;
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+	int slot = 0;
+
+	assert(obj->uuid && obj->attributes && !obj->summary);
+
+	sum = TEE_Malloc(sizeof(*sum), TEE_MALLOC_FILL_ZERO);
+	if (!sum)
+		return PKCS11_CKR_DEVICE_MEMORY;
+
+	sum->uuid = *obj->uuid;
+	summarize_attributes(sum, obj->attributes);
+
+	rc = alloc_summary_slot(token, &slot);
+	if (rc)
+		goto err;
+
+	rc = write_summary_slot(token, slot, sum);
+	if (rc) {
+		bit_clear(token->summary_slots, slot);
+		goto err;
+	}
+
+	obj->summary = sum;
+	obj->summary_slot = slot;
+
+	return PKCS11_CKR_OK;
+err:
+	TEE_Free(sum);
+	return rc;
+}
+
+static enum pkcs11_rc drop_persistent_object_summary(struct pkcs11_object *obj)
+{
+	struct token_obj_summary free_slot = { };
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+
+	if (!obj->summary)
+		return PKCS11_CKR_OK;
+
+	rc = write_summary_slot(obj->token, obj->summary_slot, &free_slot);
+	if (rc)
+		return rc;
+
+	bit_clear(obj->token->summary_slots, obj->summary_slot);
+	TEE_Free(obj->summary);
+	obj->summary = NULL;
+
+	return PKCS11_CKR_OK;
+}
+
+static bool summary_value_matches(const struct token_obj_summary *sum,
+				  uint32_t flag, uint32_t hash,
+				  const void *val, size_t size)
+{
+	return (sum->flags & flag) && hash == summary_hash(val, size);
+}
+
+/*
+ * Return false if the object can't match reference attributes @ref with
+ * attributes_match_reference() or can't be accessed according to
+ * @private_ok, true if it may or if the object has no summary.
+ */
+bool persistent_object_may_match(struct pkcs11_object *obj,
+				 struct obj_attrs *ref, bool private_ok)
+{
+	struct token_obj_summary *sum = obj->summary;
+	unsigned char *ref_attr = ref->attrs;
+	uint32_t val32 = 0;
+	size_t n = 0;
+
+	if (!sum)
+		return true;
+
+	/* Same as check_access_attrs_against_token() */
+	switch (sum->class) {
+	case PKCS11_CKO_SECRET_KEY:
+	case PKCS11_CKO_PRIVATE_KEY:
+	case PKCS11_CKO_PUBLIC_KEY:
+	case PKCS11_CKO_DATA:
+	case PKCS11_CKO_CERTIFICATE:
+		break;
+	default:
+		return false;
+	}
+	if ((sum->flags & TOKEN_OBJ_PRIVATE) && !private_ok)
+		return false;
+
+	for (n = 0; n < ref->attrs_count; n++) {
+		struct pkcs11_attribute_head pkcs11_ref = { };
+		void *val = NULL;
+
+		TEE_MemMove(&pkcs11_ref, ref_attr, sizeof(pkcs11_ref));
+		val = ref_attr + sizeof(pkcs11_ref);
+		ref_attr += sizeof(pkcs11_ref) + pkcs11_ref.size;
+
+		switch (pkcs11_ref.id) {
+		case PKCS11_CKA_CLASS:
+			if (pkcs11_ref.size != sizeof(val32))
+				return false;
+			TEE_MemMove(&val32, val, sizeof(val32));
+			if (val32 != sum->class)
+				return false;
+			break;
+		case PKCS11_CKA_KEY_TYPE:
+			if (pkcs11_ref.size != sizeof(val32) ||
+			    !(sum->flags & TOKEN_OBJ_HAS_KEY_TYPE))
+				return false;
+			TEE_MemMove(&val32, val, sizeof(val32));
+			if (val32 != sum->key_type)
+				return false;
+			break;
+		case PKCS11_CKA_LABEL:
+			if (!summary_value_matches(sum, TOKEN_OBJ_HAS_LABEL,
+						   sum->label_hash, val,
+						   pkcs11_ref.size))
+				return false;
+			break;
+		case PKCS11_CKA_ID:
+			if (!summary_value_matches(sum, TOKEN_OBJ_HAS_ID,
+						   sum->id_hash, val,
+						   pkcs11_ref.size))
+				return false;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return true;
+}
+
+struct summary_ref {
+	struct token_obj_summary sum;
+	int slot;
+};
+
+static int cmp_summary_ref_uuid(const void *a, const void *b)
+{
+	const struct summary_ref *ra = a;
+	const struct summary_ref *rb = b;
+
+	return TEE_MemCompare(&ra->sum.uuid, &rb->sum.uuid, sizeof(TEE_UUID));
+}
+
+static struct summary_ref *find_summary(struct summary_ref *refs,
+					size_t count, TEE_UUID *uuid)
+{
+	struct summary_ref *ref = NULL;
+	size_t lo = 0;
+	size_t hi = count;
+	size_t mid = 0;
+	int cmp = 0;
+
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		ref = refs + mid;
+		cmp = TEE_MemCompare(uuid, &ref->sum.uuid, sizeof(*uuid));
+		if (!cmp)
+			return ref;
+		if (cmp < 0)
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	return NULL;
+}
+
+/* Clears the summaries file of @token, any stored summary is discarded */
+static void reset_persistent_summaries(struct ck_token *token)
+{
+	struct token_persistent_summaries head = {
+		.version = TOKEN_OBJ_SUMMARY_VERSION,
+	};
+	char file[PERSISTENT_OBJECT_ID_LEN] = { };
+	TEE_ObjectHandle hdl = TEE_HANDLE_NULL;
+
+	if (get_summaries_file_name(token, file, sizeof(file)))
+		return;
+
+	if (!TEE_CreatePersistentObject(TEE_STORAGE_PRIVATE,
+					file, sizeof(file),
+					TEE_DATA_FLAG_ACCESS_WRITE |
+					TEE_DATA_FLAG_OVERWRITE,
+					TEE_HANDLE_NULL, &head, sizeof(head),
+					&hdl))
+		TEE_CloseObject(hdl);
+}
+
+/*
+ * Attach stored summaries to the objects of @token, if there are any, and
+ * mark the slots holding them as used. All other slots are free.
+ */
+static void load_persistent_summaries(struct ck_token *token)
+{
+	char file[PERSISTENT_OBJECT_ID_LEN] = { };
+	struct token_persistent_summaries head = { };
+	struct token_obj_summary *sums = NULL;
+	struct summary_ref *refs = NULL;
+	TEE_ObjectHandle hdl = TEE_HANDLE_NULL;
+	TEE_Result res = TEE_ERROR_GENERIC;
+	struct summary_ref *ref = NULL;
+	struct pkcs11_object *obj = NULL;
+	TEE_ObjectInfo info = { };
+	size_t ref_count = 0;
+	size_t count = 0;
+	size_t size = 0;
+	size_t n = 0;
+
+	if (get_summaries_file_name(token, file, sizeof(file)))
+		return;
+
+	res = TEE_OpenPersistentObject(TEE_STORAGE_PRIVATE, file, sizeof(file),
+				       TEE_DATA_FLAG_ACCESS_READ, &hdl);
+	if (res)
+		return;
+
+	res = TEE_GetObjectInfo1(hdl, &info);
+	if (res || info.dataSize < sizeof(head))
+		goto reset;
+
+	size = sizeof(head);
+	res = TEE_ReadObjectData(hdl, &head, size, &size);
+	if (res || size != sizeof(head) ||
+	    head.version != TOKEN_OBJ_SUMMARY_VERSION)
+		goto reset;
+
+	count = (info.dataSize - sizeof(head)) / sizeof(*sums);
+	if (!count || count > INT32_MAX)
+		goto out;
+
+	token->summary_slots = TEE_Malloc(bitstr_size(count),
+					  TEE_MALLOC_FILL_ZERO);
+	if (!token->summary_slots)
+		goto out;
+	token->summary_slot_count = count;
+
+	sums = TEE_Malloc(count * sizeof(*sums),
+			  TEE_USER_MEM_HINT_NO_FILL_ZERO);
+	refs = TEE_Malloc(count * sizeof(*refs),
+			  TEE_USER_MEM_HINT_NO_FILL_ZERO);
+	if (!sums || !refs)
+		goto out;
+
+	size = count * sizeof(*sums);
+	res = TEE_ReadObjectData(hdl, sums, size, &size);
+	if (res || size != count * sizeof(*sums))
+		goto out;
+
+	for (n = 0; n < count; n++) {
+		if (!(sums[n].flags & TOKEN_OBJ_SLOT_USED))
+			continue;
+		refs[ref_count].sum = sums[n];
+		refs[ref_count].slot = n;
+		ref_count++;
+	}
+	qsort(refs, ref_count, sizeof(*refs), cmp_summary_ref_uuid);
+
+	LIST_FOREACH(obj, &token->object_list, link) {
+		ref = find_summary(refs, ref_count, obj->uuid);
+		if (!ref)
+			continue;
+
+		obj->summary = TEE_Malloc(sizeof(ref->sum),
+					  TEE_USER_MEM_HINT_NO_FILL_ZERO);
+		if (!obj->summary)
+			break;
+		*obj->summary = ref->sum;
+		obj->summary_slot = ref->slot;
+		bit_set(token->summary_slots, ref->slot);
+	}
+out:
+	TEE_Free(refs);
+	TEE_Free(sums);
+	TEE_CloseObject(hdl);
+	return;
+reset:
+	TEE_CloseObject(hdl);
+	reset_persistent_summaries(token);
+}
+
 enum pkcs11_rc unregister_persistent_object(struct ck_token *token,
 					    TEE_UUID *uuid)
 {
@@ -523,6 +964,7 @@ enum pkcs11_rc load_persistent_object_attributes(struct pkcs11_object *obj)
 
 	obj->attributes = attr;
 	attr = NULL;
+	index_attributes(obj->attributes);
 
 	rc = PKCS11_CKR_OK;
 
@@ -537,6 +979,8 @@ out:
 
 void release_persistent_object_attributes(struct pkcs11_object *obj)
 {
+	if (obj->attributes)
+		unindex_attributes(obj->attributes);
 	TEE_Free(obj->attributes);
 	obj->attributes = NULL;
 }
@@ -548,8 +992,15 @@ enum pkcs11_rc update_persistent_object_attributes(struct pkcs11_object *obj)
 	uint32_t tee_obj_flags = TEE_DATA_FLAG_ACCESS_WRITE;
 	size_t size = 0;
 
+	enum pkcs11_rc rc = PKCS11_CKR_OK;
+
 	assert(obj && obj->attributes);
 
+	/* Don't leave a stale summary if the update is interrupted */
+	rc = drop_persistent_object_summary(obj);
+	if (rc)
+		return rc;
+
 	res = TEE_OpenPersistentObject(TEE_STORAGE_PRIVATE,
 				       obj->uuid, sizeof(*obj->uuid),
 				       tee_obj_flags, &hdl);
@@ -565,7 +1016,12 @@ enum pkcs11_rc update_persistent_object_attributes(struct pkcs11_object *obj)
 		goto out;
 
 	res = TEE_TruncateObjectData(hdl, size);
+	if (res)
+		goto out;
 
+	/* Without a summary, the object is loaded when searched */
+	if (set_persistent_object_summary(obj))
+		DMSG("Object summary not stored");
 out:
 	TEE_CloseObject(hdl);
 	return tee2pkcs_error(res);
@@ -704,6 +1160,8 @@ struct ck_token *init_persistent_db(unsigned int token_id)
 	token->db_objs = db_objs;
 	TEE_CloseObject(db_hdl);
 
+	load_persistent_summaries(token);
+
 	return token;
 
 error:
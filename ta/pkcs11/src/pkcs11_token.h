@@ -5,10 +5,12 @@
 #ifndef PKCS11_TA_PKCS11_TOKEN_H
 #define PKCS11_TA_PKCS11_TOKEN_H
 
+#include <bitstring.h>
 #include <sys/queue.h>
 #include <tee_api_types.h>
 #include <tee_internal_api.h>
 #include <utee_defines.h>
+#include <util.h>
 
 #include "handle.h"
 #include "object.h"
@@ -86,6 +88,49 @@ struct token_persistent_objs {
 	TEE_UUID uuids[];
 };
 
+#define TOKEN_OBJ_SUMMARY_VERSION	2
+
+#define TOKEN_OBJ_HAS_KEY_TYPE		BIT(0)
+#define TOKEN_OBJ_HAS_LABEL		BIT(1)
+#define TOKEN_OBJ_HAS_ID		BIT(2)
+#define TOKEN_OBJ_PRIVATE		BIT(3)
+#define TOKEN_OBJ_SLOT_USED		BIT(4)
+
+/*
+ * Searchable attributes of a persistent object, used to skip objects not
+ * matching a search without loading their attributes
+ *
+ * @uuid - object reference/UUID
+ * @class - CKA_CLASS of the object
+ * @key_type - CKA_KEY_TYPE if TOKEN_OBJ_HAS_KEY_TYPE is set
+ * @flags - TOKEN_OBJ_* bit flags
+ * @label_hash - hash of CKA_LABEL if TOKEN_OBJ_HAS_LABEL is set
+ * @id_hash - hash of CKA_ID if TOKEN_OBJ_HAS_ID is set
+ */
+struct token_obj_summary {
+	TEE_UUID uuid;
+	uint32_t class;
+	uint32_t key_type;
+	uint32_t flags;
+	uint32_t label_hash;
+	uint32_t id_hash;
+};
+
+/*
+ * Header of the file storing the searchable attributes of the persistent
+ * objects in the token. It's followed by fixed size slots, each holding a
+ * struct token_obj_summary with TOKEN_OBJ_SLOT_USED set or free. A slot is
+ * rewritten in place when its object is created, modified or destroyed.
+ * Objects missing are loaded when searched and added.
+ *
+ * @version - TOKEN_OBJ_SUMMARY_VERSION
+ * @reserved - 0
+ */
+struct token_persistent_summaries {
+	uint32_t version;
+	uint32_t reserved;
+};
+
 /*
  * Runtime state of the token, complies with pkcs11
  *
@@ -95,6 +140,8 @@ struct token_persistent_objs {
  * @object_list - List of the objects owned by the token
  * @db_main - Volatile copy of the persistent main database
  * @db_objs - Volatile copy of the persistent object database
+ * @summary_slots - Bitmap of the used slots in the object summaries file
+ * @summary_slot_count - Number of bits in @summary_slots
  */
 struct ck_token {
 	enum pkcs11_token_state state;
@@ -104,6 +151,8 @@ struct ck_token {
 	/* Copy in RAM of the persistent database */
 	struct token_persistent_main *db_main;
 	struct token_persistent_objs *db_objs;
+	bitstr_t *summary_slots;
+	int summary_slot_count;
 };
 
 /*
@@ -264,6 +313,11 @@ enum pkcs11_rc register_persistent_object(struct ck_token *token,
 enum pkcs11_rc get_persistent_objects_list(struct ck_token *token,
 					   TEE_UUID *array, size_t *size);
 
+/* Summaries of the searchable attributes of token persistent objects */
+enum pkcs11_rc set_persistent_object_summary(struct pkcs11_object *obj);
+bool persistent_object_may_match(struct pkcs11_object *obj,
+				 struct obj_attrs *ref, bool private_ok);
+
 /*
  * Pkcs11 session support
  */